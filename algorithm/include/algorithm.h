@@ -1,7 +1,23 @@
 #pragma once
 
+#include <cstddef>
+#include <type_traits>
+
 namespace ytl
 {
+    /**
+     * @brief Default orderings of the comparator overloads, a < b and b < a
+     */
+    struct less;
+    struct greater;
+
+    namespace detail
+    {
+        template<typename T>
+        concept radix_key = (std::is_integral_v<T> && !std::is_same_v<T, bool>) ||
+                            (std::is_floating_point_v<T> && (sizeof(T) == 4 || sizeof(T) == 8));
+    }
+
     template<typename T>
     T lower_bound(const T *t, size_t n, T x);
 
@@ -32,15 +48,53 @@ namespace ytl
     template<typename T>
     T *rotate(T *t, size_t n, size_t mid);
 
+    /**
+     * @brief Pattern-defeating quicksort, O(n log n) in the worst case and
+     * linear on sorted, reversed and all equal input. Not stable.
+     */
     template<typename T>
     void sort(T *t, size_t num);
 
+    /**
+     * @param comp Strict weak ordering, comp(a, b) is true when a goes before b
+     */
+    template<typename T, typename Compare>
+    void sort(T *t, size_t num, Compare comp);
+
     template<typename T>
     void partial_sort(T *t, size_t num, size_t m);
 
+    template<typename T, typename Compare>
+    void partial_sort(T *t, size_t num, size_t m, Compare comp);
+
     template<typename T>
     void nth_element(T *t, size_t num, size_t nth);
 
+    template<typename T, typename Compare>
+    void nth_element(T *t, size_t num, size_t nth, Compare comp);
+
+    /**
+     * @brief Stable LSD radix sort of integers and floats, several times
+     * faster than sort on large inputs. Floats order as -NaN, -inf, ..., -0,
+     * +0, ..., +inf, +NaN. Allocates a copy of the input.
+     */
+    template<detail::radix_key T>
+    void radix_sort(T *t, size_t num);
+
+    /**
+     * @brief Stable LSD radix sort of keys, each value follows its key
+     * @param values Trivially copyable, typically indices into the records the keys came from
+     */
+    template<detail::radix_key K, typename V>
+    void radix_sort(K *keys, V *values, size_t num);
+
+    /**
+     * @brief MSD radix sort in place, for when the copy radix_sort makes does
+     * not fit. Slower than radix_sort and not stable, same order.
+     */
+    template<detail::radix_key T>
+    void radix_sort_in_place(T *t, size_t num);
+
     template<typename T>
     const T &min(const T &a, const T &b);
 
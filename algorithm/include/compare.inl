@@ -2,6 +2,24 @@
 
 namespace ytl
 {
+    struct less
+    {
+        template<typename T>
+        constexpr bool operator()(const T &a, const T &b) const
+        {
+            return a < b;
+        }
+    };
+
+    struct greater
+    {
+        template<typename T>
+        constexpr bool operator()(const T &a, const T &b) const
+        {
+            return b < a;
+        }
+    };
+
     template<typename T>
     const T &min(const T &a, const T &b)
     {
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <new>
+
+namespace ytl
+{
+    /**
+     * @brief Allocator with the static interface of ytl::allocator
+     */
+    template<typename A>
+    concept raw_allocator = requires(size_t size, void *ptr)
+    {
+        { A::allocate(size) } -> std::same_as<void *>;
+        A::deallocate(ptr);
+    };
+
+    /**
+     * @brief Default raw_allocator on the global operator new, returns nullptr when out of memory
+     */
+    struct heap_allocator
+    {
+        static void *allocate(const size_t size) noexcept
+        {
+            return ::operator new(size, std::nothrow);
+        }
+
+        static void deallocate(void *ptr) noexcept
+        {
+            ::operator delete(ptr);
+        }
+    };
+}
@@ -1,41 +1,139 @@
 #pragma once
 
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
 namespace ytl
 {
     namespace detail
     {
-        template<typename T>
-        size_t partition(T *t, const size_t n)
+        /**
+         * @brief Pattern-defeating quicksort tuning. Ranges below the insertion
+         * threshold are insertion sorted, larger ones than the ninther threshold
+         * pick their pivot as the median of three medians. Partitions leave their
+         * offsets in blocks of BLOCK_SIZE so the element moves do not branch.
+         */
+        constexpr size_t INSERTION_THRESHOLD = 24;
+        constexpr size_t NINTHER_THRESHOLD = 128;
+        constexpr size_t PARTIAL_INSERTION_LIMIT = 8;
+        constexpr size_t BLOCK_SIZE = 64;
+        constexpr size_t CACHELINE_SIZE = 64;
+
+        struct radix_less;
+
+        /**
+         * @brief Block partitioning only pays when comparing is a cheap
+         * instruction, it does two comparisons per element where branchy
+         * partitioning mispredicts one
+         */
+        template<typename T, typename Compare>
+        constexpr bool BRANCHLESS_PARTITION =
+                std::is_arithmetic_v<T> && (std::is_same_v<Compare, less> || std::is_same_v<Compare, greater> ||
+                                            std::is_same_v<Compare, radix_less>);
+
+        template<typename T, typename Compare>
+        void sort2(T *a, T *b, Compare &comp)
         {
-            T pivot = t[n - 1];
-            size_t i = 0;
+            if (comp(*b, *a))
+                swap(*a, *b);
+        }
 
-            for (size_t j = 0; j < n - 1; ++j)
+        template<typename T, typename Compare>
+        void sort3(T *a, T *b, T *c, Compare &comp)
+        {
+            sort2(a, b, comp);
+            sort2(b, c, comp);
+            sort2(a, b, comp);
+        }
+
+        template<typename T, typename Compare>
+        void insertion_sort(T *begin, T *end, Compare &comp)
+        {
+            if (begin == end)
+                return;
+
+            for (T *cur = begin + 1; cur != end; ++cur)
             {
-                if (t[j] <= pivot)
+                T *sift = cur;
+                T *sift_1 = cur - 1;
+                if (comp(*sift, *sift_1))
                 {
-                    swap(t[i], t[j]);
-                    ++i;
+                    T tmp = static_cast<T &&>(*sift);
+                    do
+                    {
+                        *sift-- = static_cast<T &&>(*sift_1);
+                    }
+                    while (sift != begin && comp(tmp, *--sift_1));
+                    *sift = static_cast<T &&>(tmp);
                 }
             }
-
-            swap(t[i], t[n - 1]);
-            return i;
         }
 
-        template<typename T>
-        void quick_sort(T *t, size_t n)
+        /**
+         * @brief Insertion sort that relies on begin[-1] being no greater than
+         * any element of the range, so it needs no bounds check
+         */
+        template<typename T, typename Compare>
+        void unguarded_insertion_sort(T *begin, T *end, Compare &comp)
         {
-            if (n <= 1)
+            if (begin == end)
                 return;
 
-            size_t p = partition(t, n);
-            quick_sort(t, p);
-            quick_sort(t + p + 1, n - p - 1);
+            for (T *cur = begin + 1; cur != end; ++cur)
+            {
+                T *sift = cur;
+                T *sift_1 = cur - 1;
+                if (comp(*sift, *sift_1))
+                {
+                    T tmp = static_cast<T &&>(*sift);
+                    do
+                    {
+                        *sift-- = static_cast<T &&>(*sift_1);
+                    }
+                    while (comp(tmp, *--sift_1));
+                    *sift = static_cast<T &&>(tmp);
+                }
+            }
+        }
+
+        /**
+         * @brief Insertion sort that gives up once it has moved elements
+         * PARTIAL_INSERTION_LIMIT places in total
+         * @return True if the range is sorted
+         */
+        template<typename T, typename Compare>
+        bool partial_insertion_sort(T *begin, T *end, Compare &comp)
+        {
+            if (begin == end)
+                return true;
+
+            size_t moved = 0;
+            for (T *cur = begin + 1; cur != end; ++cur)
+            {
+                T *sift = cur;
+                T *sift_1 = cur - 1;
+                if (comp(*sift, *sift_1))
+                {
+                    T tmp = static_cast<T &&>(*sift);
+                    do
+                    {
+                        *sift-- = static_cast<T &&>(*sift_1);
+                    }
+                    while (sift != begin && comp(tmp, *--sift_1));
+                    *sift = static_cast<T &&>(tmp);
+                    moved += static_cast<size_t>(cur - sift);
+                }
+                if (moved > PARTIAL_INSERTION_LIMIT)
+                    return false;
+            }
+            return true;
         }
 
-        template<typename T>
-        void sift_down(T *t, const size_t start, const size_t end)
+        template<typename T, typename Compare>
+        void sift_down_to(T *t, const size_t start, const size_t end, Compare &comp)
         {
             size_t root = start;
 
@@ -44,10 +142,10 @@ namespace ytl
                 size_t child = root * 2 + 1;
                 size_t swap_idx = root;
 
-                if (t[swap_idx] < t[child])
+                if (comp(t[swap_idx], t[child]))
                     swap_idx = child;
 
-                if (child + 1 <= end && t[swap_idx] < t[child + 1])
+                if (child + 1 <= end && comp(t[swap_idx], t[child + 1]))
                     swap_idx = child + 1;
 
                 if (swap_idx == root)
@@ -57,62 +155,875 @@ namespace ytl
                 root = swap_idx;
             }
         }
+
+        template<typename T, typename Compare>
+        void heap_sort(T *t, const size_t n, Compare &comp)
+        {
+            if (n <= 1)
+                return;
+
+            for (size_t i = n / 2; i > 0; --i)
+                sift_down_to(t, i - 1, n - 1, comp);
+
+            for (size_t i = n - 1; i > 0; --i)
+            {
+                swap(t[0], t[i]);
+                sift_down_to(t, 0, i - 1, comp);
+            }
+        }
+
+        template<typename T, typename Compare>
+        void select_pivot(T *begin, T *end, Compare &comp)
+        {
+            const size_t size = static_cast<size_t>(end - begin);
+            const size_t s2 = size / 2;
+            if (size > NINTHER_THRESHOLD)
+            {
+                sort3(begin, begin + s2, end - 1, comp);
+                sort3(begin + 1, begin + (s2 - 1), end - 2, comp);
+                sort3(begin + 2, begin + (s2 + 1), end - 3, comp);
+                sort3(begin + (s2 - 1), begin + s2, begin + (s2 + 1), comp);
+                swap(*begin, begin[s2]);
+            }
+            else
+                sort3(begin + s2, begin, end - 1, comp);
+        }
+
+        /**
+         * @brief Partition around *begin, elements equal to the pivot go right
+         * @param already_partitioned Set when no element had to move
+         * @return Final position of the pivot
+         */
+        template<typename T, typename Compare>
+        T *partition_right(T *begin, T *end, Compare &comp, bool &already_partitioned)
+        {
+            T pivot = static_cast<T &&>(*begin);
+            T *first = begin;
+            T *last = end;
+
+            // The median selection left an element no less than the pivot at the end, a guard for the left scan
+            while (comp(*++first, pivot))
+                ;
+            if (first - 1 == begin)
+            {
+                while (first < last && !comp(*--last, pivot))
+                    ;
+            }
+            else
+            {
+                while (!comp(*--last, pivot))
+                    ;
+            }
+
+            already_partitioned = first >= last;
+            while (first < last)
+            {
+                swap(*first, *last);
+                while (comp(*++first, pivot))
+                    ;
+                while (!comp(*--last, pivot))
+                    ;
+            }
+
+            T *pivot_pos = first - 1;
+            *begin = static_cast<T &&>(*pivot_pos);
+            *pivot_pos = static_cast<T &&>(pivot);
+            return pivot_pos;
+        }
+
+        /**
+         * @brief Move the elements at the offsets across, a cyclic permutation
+         * where the counts differ saves a move per element over swapping
+         */
+        template<typename T>
+        void swap_offsets(T *first, T *last, const uint8_t *offsets_l, const uint8_t *offsets_r, const size_t num,
+                          const bool use_swaps)
+        {
+            if (use_swaps)
+            {
+                for (size_t i = 0; i < num; ++i)
+                    swap(first[offsets_l[i]], *(last - offsets_r[i]));
+                return;
+            }
+            if (!num)
+                return;
+
+            T *l = first + offsets_l[0];
+            T *r = last - offsets_r[0];
+            T tmp = static_cast<T &&>(*l);
+            *l = static_cast<T &&>(*r);
+            for (size_t i = 1; i < num; ++i)
+            {
+                l = first + offsets_l[i];
+                *r = static_cast<T &&>(*l);
+                r = last - offsets_r[i];
+                *l = static_cast<T &&>(*r);
+            }
+            *r = static_cast<T &&>(tmp);
+        }
+
+        /**
+         * @brief partition_right that first records which elements of a block
+         * are misplaced, with the comparison result added to a count instead
+         * of branched on, then moves them in one pass
+         */
+        template<typename T, typename Compare>
+        T *partition_right_branchless(T *begin, T *end, Compare &comp, bool &already_partitioned)
+        {
+            T pivot = static_cast<T &&>(*begin);
+            T *first = begin;
+            T *last = end;
+
+            while (comp(*++first, pivot))
+                ;
+            if (first - 1 == begin)
+            {
+                while (first < last && !comp(*--last, pivot))
+                    ;
+            }
+            else
+            {
+                while (!comp(*--last, pivot))
+                    ;
+            }
+
+            already_partitioned = first >= last;
+            if (!already_partitioned)
+            {
+                swap(*first, *last);
+                ++first;
+
+                alignas(CACHELINE_SIZE) uint8_t offsets_l[BLOCK_SIZE];
+                alignas(CACHELINE_SIZE) uint8_t offsets_r[BLOCK_SIZE];
+                T *offsets_l_base = first;
+                T *offsets_r_base = last;
+                size_t num_l = 0;
+                size_t num_r = 0;
+                size_t start_l = 0;
+                size_t start_r = 0;
+
+                while (first < last)
+                {
+                    // Fill whichever offset buffers are empty, splitting the unknown elements if both are
+                    const auto num_unknown = static_cast<size_t>(last - first);
+                    const size_t left_split = num_l == 0 ? (num_r == 0 ? num_unknown / 2 : num_unknown) : 0;
+                    const size_t right_split = num_r == 0 ? num_unknown - left_split : 0;
+
+                    if (left_split >= BLOCK_SIZE)
+                    {
+                        for (size_t i = 0; i < BLOCK_SIZE; ++i)
+                        {
+                            offsets_l[num_l] = static_cast<uint8_t>(i);
+                            num_l += !comp(*first, pivot);
+                            ++first;
+                        }
+                    }
+                    else
+                    {
+                        for (size_t i = 0; i < left_split; ++i)
+                        {
+                            offsets_l[num_l] = static_cast<uint8_t>(i);
+                            num_l += !comp(*first, pivot);
+                            ++first;
+                        }
+                    }
+
+                    if (right_split >= BLOCK_SIZE)
+                    {
+                        for (size_t i = 0; i < BLOCK_SIZE;)
+                        {
+                            offsets_r[num_r] = static_cast<uint8_t>(++i);
+                            num_r += comp(*--last, pivot);
+                        }
+                    }
+                    else
+                    {
+                        for (size_t i = 0; i < right_split;)
+                        {
+                            offsets_r[num_r] = static_cast<uint8_t>(++i);
+                            num_r += comp(*--last, pivot);
+                        }
+                    }
+
+                    const size_t num = num_l < num_r ? num_l : num_r;
+                    swap_offsets(offsets_l_base, offsets_r_base, offsets_l + start_l, offsets_r + start_r, num,
+                                 num_l == num_r);
+                    num_l -= num;
+                    num_r -= num;
+                    start_l += num;
+                    start_r += num;
+
+                    if (num_l == 0)
+                    {
+                        start_l = 0;
+                        offsets_l_base = first;
+                    }
+                    if (num_r == 0)
+                    {
+                        start_r = 0;
+                        offsets_r_base = last;
+                    }
+                }
+
+                // One buffer may still hold misplaced elements, move them to the boundary
+                if (num_l)
+                {
+                    while (num_l--)
+                        swap(offsets_l_base[offsets_l[start_l + num_l]], *--last);
+                    first = last;
+                }
+                if (num_r)
+                {
+                    while (num_r--)
+                    {
+                        swap(*(offsets_r_base - offsets_r[start_r + num_r]), *first);
+                        ++first;
+                    }
+                    last = first;
+                }
+            }
+
+            T *pivot_pos = first - 1;
+            *begin = static_cast<T &&>(*pivot_pos);
+            *pivot_pos = static_cast<T &&>(pivot);
+            return pivot_pos;
+        }
+
+        /**
+         * @brief Partition around *begin, elements equal to the pivot go left.
+         * Used when the pivot equals the element before the range, everything
+         * that ends up left of it is then equal to it and already in place.
+         */
+        template<typename T, typename Compare>
+        T *partition_left(T *begin, T *end, Compare &comp)
+        {
+            T pivot = static_cast<T &&>(*begin);
+            T *first = begin;
+            T *last = end;
+
+            while (comp(pivot, *--last))
+                ;
+            if (last + 1 == end)
+            {
+                while (first < last && !comp(pivot, *++first))
+                    ;
+            }
+            else
+            {
+                while (!comp(pivot, *++first))
+                    ;
+            }
+
+            while (first < last)
+            {
+                swap(*first, *last);
+                while (comp(pivot, *--last))
+                    ;
+                while (!comp(pivot, *++first))
+                    ;
+            }
+
+            T *pivot_pos = last;
+            *begin = static_cast<T &&>(*pivot_pos);
+            *pivot_pos = static_cast<T &&>(pivot);
+            return pivot_pos;
+        }
+
+        /**
+         * @brief Swap a few elements of a badly split side to break up the pattern that caused it
+         */
+        template<typename T>
+        void break_patterns(T *begin, T *end)
+        {
+            const auto size = static_cast<size_t>(end - begin);
+            if (size < INSERTION_THRESHOLD)
+                return;
+
+            const size_t quarter = size / 4;
+            swap(begin[0], begin[quarter]);
+            swap(end[-1], *(end - quarter));
+            if (size > NINTHER_THRESHOLD)
+            {
+                swap(begin[1], begin[quarter + 1]);
+                swap(begin[2], begin[quarter + 2]);
+                swap(end[-2], *(end - (quarter + 1)));
+                swap(end[-3], *(end - (quarter + 2)));
+            }
+        }
+
+        /**
+         * @param bad_allowed Highly unbalanced partitions left before switching to heapsort
+         * @param leftmost False when begin[-1] is no greater than any element of the range
+         */
+        template<bool BRANCHLESS, typename T, typename Compare>
+        void pdq_sort(T *begin, T *end, Compare &comp, size_t bad_allowed, bool leftmost)
+        {
+            while (true)
+            {
+                const auto size = static_cast<size_t>(end - begin);
+                if (size < INSERTION_THRESHOLD)
+                {
+                    if (leftmost)
+                        insertion_sort(begin, end, comp);
+                    else
+                        unguarded_insertion_sort(begin, end, comp);
+                    return;
+                }
+
+                select_pivot(begin, end, comp);
+
+                // A pivot equal to its predecessor has no smaller elements on its right, so put the equal
+                // ones left of it and continue past them. Many duplicates take linear time this way.
+                if (!leftmost && !comp(begin[-1], *begin))
+                {
+                    begin = partition_left(begin, end, comp) + 1;
+                    continue;
+                }
+
+                bool already_partitioned;
+                T *pivot_pos;
+                if constexpr (BRANCHLESS)
+                    pivot_pos = partition_right_branchless(begin, end, comp, already_partitioned);
+                else
+                    pivot_pos = partition_right(begin, end, comp, already_partitioned);
+
+                const auto l_size = static_cast<size_t>(pivot_pos - begin);
+                const auto r_size = static_cast<size_t>(end - (pivot_pos + 1));
+                if (l_size < size / 8 || r_size < size / 8)
+                {
+                    if (--bad_allowed == 0)
+                    {
+                        heap_sort(begin, size, comp);
+                        return;
+                    }
+                    break_patterns(begin, pivot_pos);
+                    break_patterns(pivot_pos + 1, end);
+                }
+                else if (already_partitioned && partial_insertion_sort(begin, pivot_pos, comp) &&
+                         partial_insertion_sort(pivot_pos + 1, end, comp))
+                    return;
+
+                // Recursing into the smaller side bounds the stack depth by log2 of the size
+                if (l_size < r_size)
+                {
+                    pdq_sort<BRANCHLESS>(begin, pivot_pos, comp, bad_allowed, leftmost);
+                    begin = pivot_pos + 1;
+                    leftmost = false;
+                }
+                else
+                {
+                    pdq_sort<BRANCHLESS>(pivot_pos + 1, end, comp, bad_allowed, false);
+                    end = pivot_pos;
+                }
+            }
+        }
+
+        inline size_t floor_log2(size_t n)
+        {
+            size_t log = 0;
+            while (n >>= 1)
+                ++log;
+            return log;
+        }
     }
 
-    template<typename T>
-    void sort(T *t, size_t num)
+    template<typename T, typename Compare>
+    void sort(T *t, const size_t num, Compare comp)
     {
-        detail::quick_sort(t, num);
+        if (num <= 1)
+            return;
+        detail::pdq_sort<detail::BRANCHLESS_PARTITION<T, Compare>>(t, t + num, comp, detail::floor_log2(num), true);
     }
 
     template<typename T>
-    void partial_sort(T *t, size_t num, size_t m)
+    void sort(T *t, const size_t num)
+    {
+        sort(t, num, less());
+    }
+
+    template<typename T, typename Compare>
+    void partial_sort(T *t, const size_t num, const size_t m, Compare comp)
     {
         if (m >= num)
         {
-            sort(t, num);
+            sort(t, num, comp);
             return;
         }
+        if (!m)
+            return;
 
         for (size_t i = (m - 1) / 2; i != static_cast<size_t>(-1); --i)
-            detail::sift_down(t, i, m - 1);
+            detail::sift_down_to(t, i, m - 1, comp);
 
         for (size_t i = m; i < num; ++i)
         {
-            if (t[i] < t[0])
+            if (comp(t[i], t[0]))
             {
                 swap(t[0], t[i]);
-                detail::sift_down(t, 0, m - 1);
+                detail::sift_down_to(t, 0, m - 1, comp);
             }
         }
 
         for (size_t i = m - 1; i > 0; --i)
         {
             swap(t[0], t[i]);
-            detail::sift_down(t, 0, i - 1);
+            detail::sift_down_to(t, 0, i - 1, comp);
         }
     }
 
     template<typename T>
-    void nth_element(T *t, const size_t num, const size_t nth)
+    void partial_sort(T *t, const size_t num, const size_t m)
+    {
+        partial_sort(t, num, m, less());
+    }
+
+    template<typename T, typename Compare>
+    void nth_element(T *t, const size_t num, const size_t nth, Compare comp)
     {
         if (nth >= num)
             return;
 
-        size_t left = 0;
-        size_t right = num - 1;
-
+        // Quickselect on the pdqsort partitions, heap selection once too many splits went badly
+        T *begin = t;
+        T *end = t + num;
+        T *target = t + nth;
+        size_t bad_allowed = detail::floor_log2(num);
+        bool leftmost = true;
         while (true)
         {
-            size_t p = detail::partition(t + left, right - left + 1);
-            p += left;
+            const auto size = static_cast<size_t>(end - begin);
+            if (size < detail::INSERTION_THRESHOLD)
+            {
+                detail::insertion_sort(begin, end, comp);
+                return;
+            }
+
+            detail::select_pivot(begin, end, comp);
+            if (!leftmost && !comp(begin[-1], *begin))
+            {
+                // Everything up to the pivot equals begin[-1] and is in its final place
+                T *pivot_pos = detail::partition_left(begin, end, comp);
+                if (target <= pivot_pos)
+                    return;
+                begin = pivot_pos + 1;
+                continue;
+            }
 
-            if (p == nth)
+            bool already_partitioned;
+            T *pivot_pos;
+            if constexpr (detail::BRANCHLESS_PARTITION<T, Compare>)
+                pivot_pos = detail::partition_right_branchless(begin, end, comp, already_partitioned);
+            else
+                pivot_pos = detail::partition_right(begin, end, comp, already_partitioned);
+            if (pivot_pos == target)
                 return;
-            if (p < nth)
-                left = p + 1;
+
+            const auto l_size = static_cast<size_t>(pivot_pos - begin);
+            const auto r_size = static_cast<size_t>(end - (pivot_pos + 1));
+            if (l_size < size / 8 || r_size < size / 8)
+            {
+                if (--bad_allowed == 0)
+                {
+                    partial_sort(begin, size, static_cast<size_t>(target - begin) + 1, comp);
+                    return;
+                }
+                detail::break_patterns(begin, pivot_pos);
+                detail::break_patterns(pivot_pos + 1, end);
+            }
+
+            if (target < pivot_pos)
+                end = pivot_pos;
             else
-                right = p - 1;
+            {
+                begin = pivot_pos + 1;
+                leftmost = false;
+            }
         }
     }
+
+    template<typename T>
+    void nth_element(T *t, const size_t num, const size_t nth)
+    {
+        nth_element(t, num, nth, less());
+    }
+}
+
+namespace ytl
+{
+    namespace detail
+    {
+        /**
+         * @brief Radix sort tuning. Ranges below the threshold are left to
+         * sort, it grows with the passes a key needs. Large ranges take 11-bit
+         * digits so they need fewer passes, ranges beyond the cache size are
+         * split on their top byte first, and MSD buckets below the bucket
+         * threshold are finished by comparison.
+         */
+        template<typename T>
+        constexpr size_t RADIX_THRESHOLD = 64 * sizeof(T) * sizeof(T);
+        constexpr size_t WIDE_DIGIT_THRESHOLD = size_t { 1 } << 16;
+        constexpr size_t MSD_BUCKET_THRESHOLD = 64;
+        constexpr size_t RADIX_CACHE_BYTES = size_t { 1 } << 20;
+
+        template<size_t SIZE>
+        struct radix_unsigned;
+
+        template<>
+        struct radix_unsigned<1>
+        {
+            using type = uint8_t;
+        };
+
+        template<>
+        struct radix_unsigned<2>
+        {
+            using type = uint16_t;
+        };
+
+        template<>
+        struct radix_unsigned<4>
+        {
+            using type = uint32_t;
+        };
+
+        template<>
+        struct radix_unsigned<8>
+        {
+            using type = uint64_t;
+        };
+
+        /**
+         * @brief Unsigned image of a key that orders like the key. Signed
+         * integers flip the sign bit, floats flip it when positive and all bits
+         * when negative.
+         */
+        template<radix_key T>
+        typename radix_unsigned<sizeof(T)>::type to_radix(const T value)
+        {
+            using U = typename radix_unsigned<sizeof(T)>::type;
+            constexpr U SIGN = U { 1 } << (sizeof(T) * 8 - 1);
+            const auto bits = std::bit_cast<U>(value);
+            if constexpr (std::is_floating_point_v<T>)
+                return bits ^ (static_cast<U>(-static_cast<U>(bits >> (sizeof(T) * 8 - 1))) | SIGN);
+            else if constexpr (std::is_signed_v<T>)
+                return bits ^ SIGN;
+            else
+                return bits;
+        }
+
+        /**
+         * @brief The order radix sort produces, used for the ranges it leaves to sort
+         */
+        struct radix_less
+        {
+            template<typename T>
+            bool operator()(const T &a, const T &b) const
+            {
+                return to_radix(a) < to_radix(b);
+            }
+        };
+
+        /**
+         * @brief Stand-in value type of the key only sorts
+         */
+        struct no_values
+        {
+        };
+
+        /**
+         * @brief Uninitialized storage for the scatter passes, freed on scope exit
+         */
+        class radix_scratch
+        {
+        public:
+            explicit radix_scratch(const size_t bytes) : data(::operator new(bytes))
+            {
+            }
+
+            radix_scratch(const radix_scratch &) = delete;
+
+            radix_scratch &operator=(const radix_scratch &) = delete;
+
+            ~radix_scratch()
+            {
+                ::operator delete(data);
+            }
+
+            template<typename T>
+            T *at(const size_t offset) const
+            {
+                return reinterpret_cast<T *>(static_cast<char *>(data) + offset);
+            }
+
+        private:
+            void *data;
+        };
+
+        constexpr size_t align_up(const size_t n, const size_t alignment)
+        {
+            return (n + alignment - 1) / alignment * alignment;
+        }
+
+        /**
+         * @brief Stable LSD passes over the low width bits. One read fills the
+         * histograms of all digits, passes whose digit is the same for every
+         * key are skipped.
+         * @tparam BITS Digit width
+         * @param counts Room for the histograms, ceil(width / BITS) << BITS entries
+         * @return Whichever of src and dst holds the result, the values are in the matching one
+         */
+        template<size_t BITS, typename T, typename V>
+        T *lsd_passes(T *src, T *dst, V *src_values, V *dst_values, const size_t num, const size_t width,
+                      size_t *counts)
+        {
+            constexpr size_t RADIX = size_t { 1 } << BITS;
+            constexpr size_t MASK = RADIX - 1;
+            constexpr bool WITH_VALUES = !std::is_same_v<V, no_values>;
+            const size_t digits = (width + BITS - 1) / BITS;
+
+            for (size_t i = 0; i < digits * RADIX; ++i)
+                counts[i] = 0;
+            for (size_t i = 0; i < num; ++i)
+            {
+                const auto key = to_radix(src[i]);
+                for (size_t d = 0; d < digits; ++d)
+                    counts[d * RADIX + (key >> d * BITS & MASK)]++;
+            }
+
+            T *result = src;
+            for (size_t d = 0; d < digits; ++d)
+            {
+                size_t *count = counts + d * RADIX;
+                if (count[to_radix(src[0]) >> d * BITS & MASK] == num)
+                    continue;
+
+                size_t offset = 0;
+                for (size_t b = 0; b < RADIX; ++b)
+                {
+                    const size_t n = count[b];
+                    count[b] = offset;
+                    offset += n;
+                }
+
+                for (size_t i = 0; i < num; ++i)
+                {
+                    const size_t at = count[to_radix(src[i]) >> d * BITS & MASK]++;
+                    dst[at] = src[i];
+                    if constexpr (WITH_VALUES)
+                        dst_values[at] = src_values[i];
+                }
+                swap(src, dst);
+                if constexpr (WITH_VALUES)
+                    swap(src_values, dst_values);
+                result = src;
+            }
+            return result;
+        }
+
+        template<typename T>
+        void copy_back(T *dest, const T *src, const size_t num)
+        {
+            for (size_t i = 0; i < num; ++i)
+                dest[i] = src[i];
+        }
+
+        /**
+         * @brief Stable radix sort. Ranges that outgrow the cache are first
+         * split on the highest byte in which keys differ, then each bucket gets
+         * its LSD passes while it sits in cache. Spreading every pass over the
+         * whole range would miss the cache on most writes.
+         * @param values Moved along with the keys, unless V is no_values
+         */
+        template<typename T, typename V>
+        void lsd_sort(T *keys, V *values, const size_t num)
+        {
+            constexpr size_t WIDTH = sizeof(T) * 8;
+            constexpr size_t WIDE = 11;
+            constexpr bool WITH_VALUES = !std::is_same_v<V, no_values>;
+            constexpr size_t RADIX = 256;
+
+            const size_t counts_bytes = ((WIDTH + WIDE - 1) / WIDE << WIDE) * sizeof(size_t);
+            const size_t keys_offset = align_up(counts_bytes, alignof(T));
+            const size_t values_offset = align_up(keys_offset + num * sizeof(T), alignof(V));
+            radix_scratch scratch(WITH_VALUES ? values_offset + num * sizeof(V) : keys_offset + num * sizeof(T));
+            auto *counts = scratch.at<size_t>(0);
+            T *buffer = scratch.at<T>(keys_offset);
+            V *value_buffer = WITH_VALUES ? scratch.at<V>(values_offset) : nullptr;
+
+            // Sort a range by its low width bits with the digits that suit its size, the result lands in keys
+            const auto lsd = [&](T *range, T *spare, V *range_values, V *spare_values, const size_t n,
+                                 const size_t width, T *dest, V *dest_values)
+            {
+                T *result = n >= WIDE_DIGIT_THRESHOLD && width > 16
+                                ? lsd_passes<WIDE>(range, spare, range_values, spare_values, n, width, counts)
+                                : lsd_passes<8>(range, spare, range_values, spare_values, n, width, counts);
+                if (result != dest)
+                {
+                    copy_back(dest, result, n);
+                    if constexpr (WITH_VALUES)
+                        copy_back(dest_values, result == range ? range_values : spare_values, n);
+                }
+            };
+
+            // Bits above the highest one that differs between keys need no pass
+            bool sorted = true;
+            const auto first = to_radix(keys[0]);
+            auto previous = first;
+            decltype(previous) differ = 0;
+            for (size_t i = 0; i < num; ++i)
+            {
+                const auto key = to_radix(keys[i]);
+                sorted &= previous <= key;
+                differ |= key ^ first;
+                previous = key;
+            }
+            if (sorted)
+                return;
+
+            const auto width = static_cast<size_t>(std::bit_width(differ));
+            if (width <= 8 || num * sizeof(T) <= RADIX_CACHE_BYTES)
+            {
+                lsd(keys, buffer, values, value_buffer, num, width, keys, values);
+                return;
+            }
+
+            const size_t shift = width - 8;
+            size_t count[RADIX] {};
+            for (size_t i = 0; i < num; ++i)
+                count[to_radix(keys[i]) >> shift & 0xFF]++;
+
+            size_t heads[RADIX];
+            size_t offset = 0;
+            for (size_t b = 0; b < RADIX; ++b)
+            {
+                heads[b] = offset;
+                offset += count[b];
+            }
+            for (size_t i = 0; i < num; ++i)
+            {
+                const size_t at = heads[to_radix(keys[i]) >> shift & 0xFF]++;
+                buffer[at] = keys[i];
+                if constexpr (WITH_VALUES)
+                    value_buffer[at] = values[i];
+            }
+
+            radix_less comp;
+            size_t start = 0;
+            for (size_t b = 0; b < RADIX; ++b)
+            {
+                const size_t n = count[b];
+                if (!n)
+                    continue;
+                T *bucket = buffer + start;
+                V *bucket_values = WITH_VALUES ? value_buffer + start : nullptr;
+                V *dest_values = WITH_VALUES ? values + start : nullptr;
+                if (!WITH_VALUES && n < RADIX_THRESHOLD<T>)
+                {
+                    copy_back(keys + start, bucket, n);
+                    if (n > 1)
+                        pdq_sort<true>(keys + start, keys + start + n, comp, floor_log2(n), true);
+                }
+                else
+                    lsd(bucket, keys + start, bucket_values, dest_values, n, shift, keys + start, dest_values);
+                start += n;
+            }
+        }
+
+        /**
+         * @brief In-place MSD radix sort on 8-bit digits, American flag style:
+         * each bucket is filled by chasing the misplaced key out of its next
+         * free slot into the bucket it belongs to, until the chain comes back
+         */
+        template<typename T>
+        void msd_sort(T *t, size_t num, size_t shift)
+        {
+            constexpr size_t RADIX = 256;
+            radix_less comp;
+            while (true)
+            {
+                if (num < MSD_BUCKET_THRESHOLD)
+                {
+                    if (num > 1)
+                        pdq_sort<true>(t, t + num, comp, floor_log2(num), true);
+                    return;
+                }
+
+                size_t count[RADIX] {};
+                for (size_t i = 0; i < num; ++i)
+                    count[to_radix(t[i]) >> shift & 0xFF]++;
+
+                // A digit shared by every key says nothing, move on to the next one
+                if (count[to_radix(t[0]) >> shift & 0xFF] == num)
+                {
+                    if (!shift)
+                        return;
+                    shift -= 8;
+                    continue;
+                }
+
+                size_t heads[RADIX];
+                size_t tails[RADIX];
+                size_t offset = 0;
+                for (size_t b = 0; b < RADIX; ++b)
+                {
+                    heads[b] = offset;
+                    offset += count[b];
+                    tails[b] = offset;
+                }
+
+                for (size_t b = 0; b < RADIX; ++b)
+                {
+                    while (heads[b] < tails[b])
+                    {
+                        T value = t[heads[b]];
+                        size_t digit = to_radix(value) >> shift & 0xFF;
+                        while (digit != b)
+                        {
+                            swap(value, t[heads[digit]++]);
+                            digit = to_radix(value) >> shift & 0xFF;
+                        }
+                        t[heads[b]++] = value;
+                    }
+                }
+
+                if (!shift)
+                    return;
+                size_t start = 0;
+                for (size_t b = 0; b < RADIX; ++b)
+                {
+                    if (count[b] > 1)
+                        msd_sort(t + start, count[b], shift - 8);
+                    start += count[b];
+                }
+                return;
+            }
+        }
+    }
+
+    template<detail::radix_key T>
+    void radix_sort(T *t, const size_t num)
+    {
+        if (num < detail::RADIX_THRESHOLD<T>)
+        {
+            sort(t, num, detail::radix_less());
+            return;
+        }
+        detail::no_values *none = nullptr;
+        detail::lsd_sort(t, none, num);
+    }
+
+    template<detail::radix_key K, typename V>
+    void radix_sort(K *keys, V *values, const size_t num)
+    {
+        static_assert(std::is_trivially_copyable_v<V>, "values are moved by copying, make them indices into the payload");
+        if (num <= 1)
+            return;
+        detail::lsd_sort(keys, values, num);
+    }
+
+    template<detail::radix_key T>
+    void radix_sort_in_place(T *t, const size_t num)
+    {
+        detail::msd_sort(t, num, sizeof(T) * 8 - 8);
+    }
 }
@@ -0,0 +1,246 @@
+#include <bit>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <charconv.h>
+
+namespace
+{
+    size_t count = 1 << 20;
+    size_t rounds = 8;
+
+    struct text
+    {
+        // Numbers separated by zeros, so strtod and friends see terminated strings
+        std::vector<char> chars;
+        std::vector<uint32_t> starts;
+    };
+
+    template<typename T>
+    text format_all(const std::vector<T> &values)
+    {
+        text out;
+        char buf[64];
+        for (const T v: values)
+        {
+            const auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), v);
+            out.starts.push_back(static_cast<uint32_t>(out.chars.size()));
+            out.chars.insert(out.chars.end(), buf, end);
+            out.chars.push_back('\0');
+        }
+        return out;
+    }
+
+    /**
+     * @brief Time rounds passes of fn over count numbers and print the best one
+     */
+    template<typename Fn>
+    void measure(const char *workload, const char *impl, const size_t bytes, Fn &&fn)
+    {
+        double best = 1e300;
+        uint64_t sink = 0;
+        for (size_t r = 0; r < rounds; ++r)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            sink += fn();
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            best = seconds < best ? seconds : best;
+        }
+        std::printf("%-14s %-10s %10.2f %10.1f %20llu\n", workload, impl, best * 1e9 / static_cast<double>(count),
+                    static_cast<double>(bytes) / best / 1e6, static_cast<unsigned long long>(sink));
+    }
+
+    template<typename T>
+    void format_integers(const char *workload, const std::vector<T> &values, const char *spec)
+    {
+        const size_t bytes = format_all(values).chars.size();
+        char out[64];
+        measure(workload, "ytl", bytes, [&]
+        {
+            uint64_t n = 0;
+            for (const T v: values)
+                n += static_cast<uint64_t>(ytl::to_chars(out, out + sizeof(out), v).ptr - out);
+            return n;
+        });
+        measure(workload, "std", bytes, [&]
+        {
+            uint64_t n = 0;
+            for (const T v: values)
+                n += static_cast<uint64_t>(std::to_chars(out, out + sizeof(out), v).ptr - out);
+            return n;
+        });
+        measure(workload, "snprintf", bytes, [&]
+        {
+            uint64_t n = 0;
+            for (const T v: values)
+                n += static_cast<uint64_t>(std::snprintf(out, sizeof(out), spec, v));
+            return n;
+        });
+    }
+
+    template<typename T>
+    void format_floats(const char *workload, const std::vector<T> &values)
+    {
+        const size_t bytes = format_all(values).chars.size();
+        char out[64];
+        measure(workload, "ytl", bytes, [&]
+        {
+            uint64_t n = 0;
+            for (const T v: values)
+                n += static_cast<uint64_t>(ytl::to_chars(out, out + sizeof(out), v).ptr - out);
+            return n;
+        });
+        measure(workload, "std", bytes, [&]
+        {
+            uint64_t n = 0;
+            for (const T v: values)
+                n += static_cast<uint64_t>(std::to_chars(out, out + sizeof(out), v).ptr - out);
+            return n;
+        });
+        // %.17g round trips but is not shortest, the usual libc stand-in
+        measure(workload, "snprintf", bytes, [&]
+        {
+            uint64_t n = 0;
+            for (const T v: values)
+                n += static_cast<uint64_t>(std::snprintf(out, sizeof(out), sizeof(T) == 4 ? "%.9g" : "%.17g", v));
+            return n;
+        });
+    }
+
+    template<typename T, typename Libc>
+    void parse_all(const char *workload, const std::vector<T> &values, Libc &&libc)
+    {
+        const text in = format_all(values);
+        const char *chars = in.chars.data();
+        const auto sum = [](const T v)
+        {
+            if constexpr (std::is_integral_v<T>)
+                return static_cast<uint64_t>(v);
+            else
+                return static_cast<uint64_t>(std::bit_cast<std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t> >(v));
+        };
+
+        measure(workload, "ytl", in.chars.size(), [&]
+        {
+            uint64_t n = 0;
+            for (size_t i = 0; i < in.starts.size(); ++i)
+            {
+                const char *s = chars + in.starts[i];
+                const char *e = i + 1 < in.starts.size() ? chars + in.starts[i + 1] - 1 : chars + in.chars.size() - 1;
+                T v {};
+                ytl::from_chars(s, e, v);
+                n += sum(v);
+            }
+            return n;
+        });
+        measure(workload, "std", in.chars.size(), [&]
+        {
+            uint64_t n = 0;
+            for (size_t i = 0; i < in.starts.size(); ++i)
+            {
+                const char *s = chars + in.starts[i];
+                const char *e = i + 1 < in.starts.size() ? chars + in.starts[i + 1] - 1 : chars + in.chars.size() - 1;
+                T v {};
+                std::from_chars(s, e, v);
+                n += sum(v);
+            }
+            return n;
+        });
+        measure(workload, "libc", in.chars.size(), [&]
+        {
+            uint64_t n = 0;
+            for (const uint32_t start: in.starts)
+                n += sum(static_cast<T>(libc(chars + start)));
+            return n;
+        });
+    }
+
+    /**
+     * @brief Integers with evenly spread bit lengths, so short numbers are as common as long ones
+     */
+    std::vector<uint64_t> mixed_lengths(std::mt19937_64 &rng)
+    {
+        std::vector<uint64_t> values(count);
+        for (auto &v: values)
+            v = rng() >> (rng() % 64);
+        return values;
+    }
+
+    bool parse(const int argc, char **argv)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string_view arg = argv[i];
+            if (arg == "--quick")
+            {
+                count >>= 4;
+                rounds = 3;
+            }
+            else
+                return false;
+        }
+        return true;
+    }
+}
+
+int main(const int argc, char **argv)
+{
+    if (!parse(argc, argv))
+    {
+        std::fprintf(stderr, "usage: %s [--quick]\n", argv[0]);
+        return 1;
+    }
+
+    std::mt19937_64 rng(42);
+
+    std::vector<uint32_t> u32(count);
+    for (auto &v: u32)
+        v = static_cast<uint32_t>(rng());
+    const std::vector<uint64_t> u64 = mixed_lengths(rng);
+    std::vector<int64_t> i64(count);
+    for (auto &v: i64)
+        v = static_cast<int64_t>(rng() >> (rng() % 64)) * (rng() & 1 ? 1 : -1);
+
+    // Arbitrary bit patterns need 16 to 17 digits, prices and readings only a few
+    std::vector<double> f64(count);
+    for (auto &v: f64)
+    {
+        do
+            v = std::bit_cast<double>(rng());
+        while (v != v || v - v != 0);
+    }
+    std::vector<double> short_f64(count);
+    for (auto &v: short_f64)
+        v = static_cast<double>(rng() % 1000000) / 100;
+    std::vector<float> f32(count);
+    for (auto &v: f32)
+    {
+        do
+            v = std::bit_cast<float>(static_cast<uint32_t>(rng()));
+        while (v != v || v - v != 0);
+    }
+
+    std::printf("%-14s %-10s %10s %10s %20s\n", "workload", "impl", "ns/op", "MB/s", "checksum");
+
+    format_integers("format_u32", u32, "%u");
+    format_integers("format_u64", u64, "%llu");
+    format_integers("format_i64", i64, "%lld");
+    format_floats("format_f64", f64);
+    format_floats("format_short", short_f64);
+    format_floats("format_f32", f32);
+
+    parse_all("parse_u32", u32, [](const char *s) { return std::strtoul(s, nullptr, 10); });
+    parse_all("parse_u64", u64, [](const char *s) { return std::strtoull(s, nullptr, 10); });
+    parse_all("parse_i64", i64, [](const char *s) { return std::strtoll(s, nullptr, 10); });
+    parse_all("parse_f64", f64, [](const char *s) { return std::strtod(s, nullptr); });
+    parse_all("parse_short", short_f64, [](const char *s) { return std::strtod(s, nullptr); });
+    parse_all("parse_f32", f32, [](const char *s) { return std::strtof(s, nullptr); });
+    return 0;
+}
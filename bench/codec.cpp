@@ -0,0 +1,119 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include <codec.h>
+
+namespace
+{
+    size_t text_bytes = size_t { 1 } << 24;
+    size_t rounds = 8;
+
+    /**
+     * @brief Time rounds passes of fn and print the best one, in input bytes per second
+     */
+    template<typename Fn>
+    void measure(const char *operation, const char *impl, const size_t bytes, Fn &&fn)
+    {
+        double best = 1e300;
+        uint64_t sink = 0;
+        for (size_t r = 0; r < rounds; ++r)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            sink += fn();
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            best = seconds < best ? seconds : best;
+        }
+        std::printf("%-16s %-10s %10.2f %20llu\n", operation, impl, static_cast<double>(bytes) / best / 1e9,
+                    static_cast<unsigned long long>(sink));
+    }
+
+    /**
+     * @brief Run fn on the portable kernels, then on the ones picked for this CPU
+     */
+    template<typename Fn>
+    void compare(const char *operation, const size_t bytes, Fn &&fn)
+    {
+        const ytl::simd_level best = ytl::active_simd();
+        ytl::select_simd(ytl::simd_level::SCALAR);
+        measure(operation, "scalar", bytes, fn);
+        ytl::select_simd(best);
+        measure(operation, "ytl", bytes, fn);
+    }
+
+    bool parse(const int argc, char **argv)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string_view arg = argv[i];
+            if (arg == "--quick")
+            {
+                text_bytes >>= 4;
+                rounds = 3;
+            }
+            else
+                return false;
+        }
+        return true;
+    }
+}
+
+int main(const int argc, char **argv)
+{
+    if (!parse(argc, argv))
+    {
+        std::fprintf(stderr, "usage: %s [--quick]\n", argv[0]);
+        return 1;
+    }
+
+    std::mt19937_64 rng(42);
+    std::vector<char> binary(text_bytes);
+    for (char &c: binary)
+        c = static_cast<char>(rng());
+    // URL text: mostly unreserved characters with a few that need escaping
+    constexpr std::string_view URL_CHARS = "abcdefghijklmnopqrstuvwxyz0123456789-._~/?=&: ";
+    std::vector<char> url(text_bytes);
+    for (char &c: url)
+        c = URL_CHARS[rng() % URL_CHARS.size()];
+
+    const size_t n = binary.size();
+    std::vector<char> encoded(ytl::base64_encoded_length(n));
+    std::vector<char> decoded(n);
+    std::vector<char> hex(2 * n);
+    std::vector<char> escaped(3 * n);
+
+    std::printf("%-16s %-10s %10s %20s\n", "operation", "impl", "GB/s", "checksum");
+    compare("base64_encode", n, [&]
+    {
+        return ytl::base64_encode(binary.data(), n, encoded.data());
+    });
+    compare("base64_decode", encoded.size(), [&]
+    {
+        return ytl::base64_decode(encoded.data(), encoded.size(), decoded.data()).written;
+    });
+    compare("base64url_encode", n, [&]
+    {
+        return ytl::base64_encode(binary.data(), n, encoded.data(), ytl::base64_alphabet::URL);
+    });
+    compare("hex_encode", n, [&]
+    {
+        return ytl::hex_encode(binary.data(), n, hex.data());
+    });
+    compare("hex_decode", hex.size(), [&]
+    {
+        return ytl::hex_decode(hex.data(), hex.size(), decoded.data()).written;
+    });
+    compare("percent_encode", url.size(), [&]
+    {
+        return ytl::percent_encode(url.data(), url.size(), escaped.data());
+    });
+    const size_t escaped_length = ytl::percent_encode(url.data(), url.size(), escaped.data());
+    compare("percent_decode", escaped_length, [&]
+    {
+        return ytl::percent_decode(escaped.data(), escaped_length, decoded.data()).written;
+    });
+    return 0;
+}
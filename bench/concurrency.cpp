@@ -0,0 +1,720 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <executor.h>
+#include <parallel.h>
+#include <strand.h>
+#include <task.h>
+
+namespace
+{
+    using steady = std::chrono::steady_clock;
+
+    enum class format
+    {
+        TEXT,
+        CSV,
+        JSON
+    };
+
+    /**
+     * @brief One measurement, ops counts workload units: tasks, elements,
+     * pipeline items, fib evaluations or timers
+     */
+    struct result
+    {
+        const char *workload;
+        const char *impl;
+        size_t threads;
+        size_t ops;
+        double seconds;
+        uint64_t p50_ns;
+        uint64_t p99_ns;
+    };
+
+    struct settings
+    {
+        format output { format::TEXT };
+        size_t max_threads { 0 };
+        size_t shift { 0 };
+    };
+
+    settings config;
+    std::vector<result> results;
+
+    size_t scaled(const size_t n) noexcept
+    {
+        return std::max<size_t>(n >> config.shift, 1);
+    }
+
+    double seconds_since(const steady::time_point start) noexcept
+    {
+        return std::chrono::duration<double>(steady::now() - start).count();
+    }
+
+    uint64_t nanos(const steady::duration d) noexcept
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count());
+    }
+
+    uint64_t percentile(std::vector<uint64_t> &samples, const double q)
+    {
+        if (samples.empty())
+            return 0;
+        const auto k = static_cast<size_t>(q * static_cast<double>(samples.size() - 1));
+        std::nth_element(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(k), samples.end());
+        return samples[k];
+    }
+
+    void record(const char *workload, const char *impl, const size_t threads, const size_t ops,
+                const double seconds, std::vector<uint64_t> samples = {})
+    {
+        const uint64_t p50 = percentile(samples, 0.50);
+        const uint64_t p99 = percentile(samples, 0.99);
+        results.push_back({ workload, impl, threads, ops, seconds, p50, p99 });
+
+        if (config.output == format::TEXT)
+            std::printf("%-14s %-12s %3zu %12zu %10.4f %14.0f %10llu %10llu\n", workload, impl, threads, ops,
+                        seconds, static_cast<double>(ops) / seconds, static_cast<unsigned long long>(p50),
+                        static_cast<unsigned long long>(p99));
+    }
+
+    /**
+     * @brief Run fn on a pool and block until it finished
+     */
+    template<typename Fn>
+    void run_on(ytl::executor &ex, Fn &&fn)
+    {
+        std::atomic<bool> done { false };
+        ex.submit([&]
+        {
+            fn();
+            ex.complete(done);
+        });
+        ex.wait(done);
+    }
+
+    /**
+     * @brief Start count units of work in waves of at most width threads
+     */
+    template<typename Spawn>
+    void in_waves(const size_t count, const size_t width, Spawn &&spawn)
+    {
+        for (size_t i = 0; i < count; i += width)
+            spawn(std::min(width, count - i));
+    }
+
+    // Empty tasks: pure scheduling overhead
+
+    void spawn_empty(const size_t threads)
+    {
+        const size_t n = scaled(1 << 18);
+        {
+            ytl::executor ex(threads);
+            std::atomic<size_t> left { n };
+            std::atomic<bool> done { false };
+            const auto start = steady::now();
+            for (size_t i = 0; i < n; ++i)
+            {
+                ytl::task::post(ex, ytl::priority::NORMAL, [&]
+                {
+                    if (left.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                        ex.complete(done);
+                });
+            }
+            ex.wait(done);
+            record("spawn_empty", "ytl_task", threads, n, seconds_since(start));
+        }
+        {
+            ytl::executor ex(threads);
+            std::atomic<size_t> left { n };
+            std::atomic<bool> done { false };
+            const auto start = steady::now();
+            for (size_t i = 0; i < n; ++i)
+            {
+                ex.submit([&]
+                {
+                    if (left.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                        ex.complete(done);
+                });
+            }
+            ex.wait(done);
+            record("spawn_empty", "ytl_submit", threads, n, seconds_since(start));
+        }
+
+        const size_t m = scaled(1 << 12);
+        {
+            const auto start = steady::now();
+            in_waves(m, threads, [](const size_t width)
+            {
+                std::vector<std::future<void> > futures;
+                for (size_t i = 0; i < width; ++i)
+                    futures.push_back(std::async(std::launch::async, [] {}));
+                for (auto &f: futures)
+                    f.get();
+            });
+            record("spawn_empty", "std_async", threads, m, seconds_since(start));
+        }
+        {
+            const auto start = steady::now();
+            in_waves(m, threads, [](const size_t width)
+            {
+                std::vector<std::thread> pool;
+                for (size_t i = 0; i < width; ++i)
+                    pool.emplace_back([] {});
+                for (auto &t: pool)
+                    t.join();
+            });
+            record("spawn_empty", "std_thread", threads, m, seconds_since(start));
+        }
+    }
+
+    // Submit to start latency, one task in flight at a time
+
+    void spawn_latency(const size_t threads)
+    {
+        const size_t n = scaled(1 << 13);
+        {
+            ytl::executor ex(threads);
+            std::vector<uint64_t> samples(n);
+            const auto start = steady::now();
+            for (size_t i = 0; i < n; ++i)
+            {
+                std::atomic<bool> done { false };
+                const auto posted = steady::now();
+                ytl::task::post(ex, ytl::priority::NORMAL, [&]
+                {
+                    samples[i] = nanos(steady::now() - posted);
+                    ex.complete(done);
+                });
+                ex.wait(done);
+            }
+            record("spawn_latency", "ytl_task", threads, n, seconds_since(start), std::move(samples));
+        }
+
+        const size_t m = scaled(1 << 10);
+        {
+            std::vector<uint64_t> samples(m);
+            const auto start = steady::now();
+            for (size_t i = 0; i < m; ++i)
+            {
+                const auto posted = steady::now();
+                samples[i] = std::async(std::launch::async, [posted]
+                {
+                    return nanos(steady::now() - posted);
+                }).get();
+            }
+            record("spawn_latency", "std_async", threads, m, seconds_since(start), std::move(samples));
+        }
+        {
+            std::vector<uint64_t> samples(m);
+            const auto start = steady::now();
+            for (size_t i = 0; i < m; ++i)
+            {
+                const auto posted = steady::now();
+                std::thread([&samples, i, posted]
+                {
+                    samples[i] = nanos(steady::now() - posted);
+                }).join();
+            }
+            record("spawn_latency", "std_thread", threads, m, seconds_since(start), std::move(samples));
+        }
+    }
+
+    // Fork-join fib: deep recursion of small tasks
+
+    constexpr unsigned FIB_N = 30;
+    constexpr unsigned FIB_CUTOFF = 16;
+
+    uint64_t fib_serial(const unsigned n) noexcept
+    {
+        return n < 2 ? n : fib_serial(n - 1) + fib_serial(n - 2);
+    }
+
+    uint64_t fib_ytl(ytl::executor &ex, const unsigned n)
+    {
+        if (n < FIB_CUTOFF)
+            return fib_serial(n);
+
+        uint64_t left = 0;
+        std::atomic<bool> done { false };
+        ex.submit([&]
+        {
+            left = fib_ytl(ex, n - 1);
+            ex.complete(done);
+        });
+        const uint64_t right = fib_ytl(ex, n - 2);
+        ex.wait(done);
+        return left + right;
+    }
+
+    template<typename Fork>
+    uint64_t fib_forked(const unsigned n, const unsigned depth, Fork &&fork)
+    {
+        if (n < FIB_CUTOFF || !depth)
+            return fib_serial(n);
+        return fork([&] { return fib_forked(n - 1, depth - 1, fork); },
+                    [&] { return fib_forked(n - 2, depth - 1, fork); });
+    }
+
+    unsigned fork_depth(const size_t threads) noexcept
+    {
+        unsigned depth = 1;
+        while ((size_t { 1 } << depth) < threads * 4)
+            depth++;
+        return depth;
+    }
+
+    void fib(const size_t threads)
+    {
+        const unsigned n = FIB_N - static_cast<unsigned>(std::min<size_t>(config.shift, 8));
+        const uint64_t expected = fib_serial(n);
+        auto check = [expected](const uint64_t value)
+        {
+            if (value != expected)
+                std::fprintf(stderr, "fib mismatch\n");
+        };
+
+        {
+            ytl::executor ex(threads);
+            uint64_t value = 0;
+            const auto start = steady::now();
+            run_on(ex, [&] { value = fib_ytl(ex, n); });
+            record("fib", "ytl_submit", threads, 1, seconds_since(start));
+            check(value);
+        }
+        {
+            const auto start = steady::now();
+            check(fib_forked(n, fork_depth(threads), [](auto &&a, auto &&b)
+            {
+                auto future = std::async(std::launch::async, a);
+                const uint64_t right = b();
+                return future.get() + right;
+            }));
+            record("fib", "std_async", threads, 1, seconds_since(start));
+        }
+        {
+            const auto start = steady::now();
+            check(fib_forked(n, fork_depth(threads), [](auto &&a, auto &&b)
+            {
+                uint64_t left = 0;
+                std::thread thread([&] { left = a(); });
+                const uint64_t right = b();
+                thread.join();
+                return left + right;
+            }));
+            record("fib", "std_thread", threads, 1, seconds_since(start));
+        }
+    }
+
+    // Data parallel loop over a large array
+
+    constexpr size_t LOOP_REPEATS = 3;
+
+    void scale_range(float *data, const size_t begin, const size_t end) noexcept
+    {
+        for (size_t i = begin; i < end; ++i)
+            data[i] = data[i] * 1.0001f + 0.5f;
+    }
+
+    template<typename Body>
+    double best_of(Body &&body)
+    {
+        double best = 0;
+        for (size_t r = 0; r < LOOP_REPEATS; ++r)
+        {
+            const auto start = steady::now();
+            body();
+            const double elapsed = seconds_since(start);
+            best = r ? std::min(best, elapsed) : elapsed;
+        }
+        return best;
+    }
+
+    void parallel_for(const size_t threads)
+    {
+        const size_t n = scaled(1 << 24);
+        std::vector<float> data(n, 1.0f);
+        float *ptr = data.data();
+
+        {
+            ytl::executor ex(threads);
+            record("parallel_for", "ytl_parallel", threads, n, best_of([&]
+            {
+                ytl::parallel_for(ex, 0, n, 0, [ptr](const size_t b, const size_t e) { scale_range(ptr, b, e); });
+            }));
+        }
+        record("parallel_for", "std_async", threads, n, best_of([&]
+        {
+            std::vector<std::future<void> > futures;
+            for (size_t t = 0; t < threads; ++t)
+            {
+                futures.push_back(std::async(std::launch::async, [=]
+                {
+                    scale_range(ptr, n * t / threads, n * (t + 1) / threads);
+                }));
+            }
+            for (auto &f: futures)
+                f.get();
+        }));
+        record("parallel_for", "std_thread", threads, n, best_of([&]
+        {
+            std::vector<std::thread> pool;
+            for (size_t t = 0; t < threads; ++t)
+                pool.emplace_back([=] { scale_range(ptr, n * t / threads, n * (t + 1) / threads); });
+            for (auto &t: pool)
+                t.join();
+        }));
+    }
+
+    // Sorting and selection over a large random array
+
+    template<typename Body>
+    double best_on_copy(const std::vector<uint64_t> &input, std::vector<uint64_t> &work, Body &&body)
+    {
+        double best = 0;
+        for (size_t r = 0; r < LOOP_REPEATS; ++r)
+        {
+            work = input;
+            const auto start = steady::now();
+            body();
+            const double elapsed = seconds_since(start);
+            best = r ? std::min(best, elapsed) : elapsed;
+        }
+        return best;
+    }
+
+    void sort(const size_t threads)
+    {
+        const size_t n = scaled(1 << 24);
+        std::vector<uint64_t> input(n);
+        uint64_t state = 42;
+        for (uint64_t &value: input)
+            value = state = state * 6364136223846793005ull + 1442695040888963407ull;
+        std::vector<uint64_t> work;
+
+        {
+            ytl::executor ex(threads);
+            record("sort", "ytl_parallel", threads, n, best_on_copy(input, work, [&]
+            {
+                ytl::parallel_sort(work.data(), n, ex);
+            }));
+            if (!std::is_sorted(work.begin(), work.end()))
+                std::fprintf(stderr, "sort mismatch\n");
+            record("nth_element", "ytl_parallel", threads, n, best_on_copy(input, work, [&]
+            {
+                ytl::parallel_nth_element(work.data(), n, n / 3, ex);
+            }));
+        }
+        const uint64_t third = work[n / 3];
+        record("sort", "ytl_serial", threads, n, best_on_copy(input, work, [&] { ytl::sort(work.data(), n); }));
+        record("nth_element", "ytl_serial", threads, n, best_on_copy(input, work, [&]
+        {
+            ytl::nth_element(work.data(), n, n / 3);
+        }));
+        if (work[n / 3] != third)
+            std::fprintf(stderr, "nth_element mismatch\n");
+    }
+
+    // Two stage producer/consumer pipelines, one per thread
+
+    uint64_t stage(const uint64_t value) noexcept
+    {
+        uint64_t x = value * 0x9e3779b97f4a7c15ull;
+        for (int i = 0; i < 16; ++i)
+        {
+            x ^= x >> 29;
+            x *= 0xbf58476d1ce4e5b9ull;
+        }
+        return x;
+    }
+
+    class channel
+    {
+    public:
+        void push(const uint64_t value)
+        {
+            {
+                std::lock_guard lock(mutex);
+                items.push_back(value);
+            }
+            ready.notify_one();
+        }
+
+        uint64_t pop()
+        {
+            std::unique_lock lock(mutex);
+            ready.wait(lock, [this] { return !items.empty(); });
+            const uint64_t value = items.front();
+            items.pop_front();
+            return value;
+        }
+
+    private:
+        std::mutex mutex;
+        std::condition_variable ready;
+        std::deque<uint64_t> items;
+    };
+
+    void pipeline(const size_t threads)
+    {
+        const size_t n = scaled(1 << 16);
+        const size_t total = n * threads;
+
+        uint64_t expected = 0;
+        for (size_t i = 0; i < n; ++i)
+            expected += stage(stage(i));
+        auto check = [expected](const uint64_t sum)
+        {
+            if (sum != expected)
+                std::fprintf(stderr, "pipeline checksum mismatch\n");
+        };
+
+        {
+            struct line
+            {
+                ytl::strand first;
+                ytl::strand second;
+                uint64_t sum { 0 };
+
+                explicit line(ytl::executor &ex) : first(ex), second(ex) {}
+            };
+
+            ytl::executor ex(threads);
+            std::vector<std::unique_ptr<line> > lines;
+            for (size_t p = 0; p < threads; ++p)
+                lines.push_back(std::make_unique<line>(ex));
+
+            std::atomic<size_t> left { total };
+            std::atomic<bool> done { false };
+            const auto start = steady::now();
+            for (size_t i = 0; i < n; ++i)
+            {
+                for (auto &l: lines)
+                {
+                    line *self = l.get();
+                    self->first.post([self, i, &left, &done, &ex]
+                    {
+                        const uint64_t value = stage(i);
+                        self->second.post([self, value, &left, &done, &ex]
+                        {
+                            self->sum += stage(value);
+                            if (left.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                                ex.complete(done);
+                        });
+                    });
+                }
+            }
+            ex.wait(done);
+            record("pipeline", "ytl_strand", threads, total, seconds_since(start));
+            for (const auto &l: lines)
+                check(l->sum);
+        }
+        {
+            std::vector<std::unique_ptr<channel[]> > channels;
+            std::vector<uint64_t> sums(threads);
+            std::vector<std::thread> pool;
+            const auto start = steady::now();
+            for (size_t p = 0; p < threads; ++p)
+            {
+                channel *ch = channels.emplace_back(std::make_unique<channel[]>(2)).get();
+                pool.emplace_back([ch, n]
+                {
+                    for (size_t i = 0; i < n; ++i)
+                        ch[1].push(stage(ch[0].pop()));
+                });
+                pool.emplace_back([ch, n, sum = &sums[p]]
+                {
+                    for (size_t i = 0; i < n; ++i)
+                        *sum += stage(ch[1].pop());
+                });
+            }
+            for (size_t i = 0; i < n; ++i)
+            {
+                for (auto &ch: channels)
+                    ch[0].push(i);
+            }
+            for (auto &t: pool)
+                t.join();
+            record("pipeline", "std_thread", threads, total, seconds_since(start));
+            for (const uint64_t sum: sums)
+                check(sum);
+        }
+    }
+
+    // Many short timers, latency is how late each one fired
+
+    constexpr auto TIMER_HORIZON = std::chrono::milliseconds(20);
+
+    std::vector<steady::time_point> deadlines(const size_t n)
+    {
+        std::vector<steady::time_point> out(n);
+        const auto base = steady::now() + std::chrono::milliseconds(1);
+        for (size_t i = 0; i < n; ++i)
+            out[i] = base + TIMER_HORIZON * i / n;
+        return out;
+    }
+
+    /**
+     * @brief How late a timer fired, task::delay rounds down to whole
+     * milliseconds so early firings count as on time
+     */
+    uint64_t lateness(const steady::time_point due) noexcept
+    {
+        const auto now = steady::now();
+        return now > due ? nanos(now - due) : 0;
+    }
+
+    void timers(const size_t threads)
+    {
+        const size_t n = scaled(1 << 9);
+
+        {
+            ytl::executor ex(threads);
+            std::vector<uint64_t> samples(n);
+            std::atomic<size_t> left { n };
+            std::atomic<bool> done { false };
+            const auto start = steady::now();
+            const auto due = deadlines(n);
+            for (size_t i = 0; i < n; ++i)
+            {
+                ytl::task::post(ex, ytl::priority::NORMAL, [&, i]
+                {
+                    const auto wait = std::chrono::duration<float>(due[i] - steady::now()).count();
+                    ytl::task::delay(std::max(wait, 0.0f), [&, i]
+                    {
+                        samples[i] = lateness(due[i]);
+                        if (left.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                            ex.complete(done);
+                    });
+                });
+            }
+            ex.wait(done);
+            record("timers", "ytl_task", threads, n, seconds_since(start), std::move(samples));
+        }
+        {
+            std::vector<uint64_t> samples(n);
+            const auto start = steady::now();
+            const auto due = deadlines(n);
+            std::vector<std::future<void> > futures;
+            for (size_t i = 0; i < n; ++i)
+            {
+                futures.push_back(std::async(std::launch::async, [&, i]
+                {
+                    std::this_thread::sleep_until(due[i]);
+                    samples[i] = lateness(due[i]);
+                }));
+            }
+            for (auto &f: futures)
+                f.get();
+            record("timers", "std_async", threads, n, seconds_since(start), std::move(samples));
+        }
+        {
+            std::vector<uint64_t> samples(n);
+            const auto start = steady::now();
+            const auto due = deadlines(n);
+            std::vector<std::thread> pool;
+            for (size_t i = 0; i < n; ++i)
+            {
+                pool.emplace_back([&, i]
+                {
+                    std::this_thread::sleep_until(due[i]);
+                    samples[i] = lateness(due[i]);
+                });
+            }
+            for (auto &t: pool)
+                t.join();
+            record("timers", "std_thread", threads, n, seconds_since(start), std::move(samples));
+        }
+    }
+
+    void print_csv()
+    {
+        std::printf("workload,impl,threads,ops,seconds,ops_per_sec,p50_ns,p99_ns\n");
+        for (const auto &r: results)
+            std::printf("%s,%s,%zu,%zu,%.6f,%.1f,%llu,%llu\n", r.workload, r.impl, r.threads, r.ops, r.seconds,
+                        static_cast<double>(r.ops) / r.seconds, static_cast<unsigned long long>(r.p50_ns),
+                        static_cast<unsigned long long>(r.p99_ns));
+    }
+
+    void print_json()
+    {
+        std::printf("{\"benchmarks\":[");
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const auto &r = results[i];
+            std::printf("%s\n{\"workload\":\"%s\",\"impl\":\"%s\",\"threads\":%zu,\"ops\":%zu,\"seconds\":%.6f,"
+                        "\"ops_per_sec\":%.1f,\"p50_ns\":%llu,\"p99_ns\":%llu}", i ? "," : "", r.workload, r.impl,
+                        r.threads, r.ops, r.seconds, static_cast<double>(r.ops) / r.seconds,
+                        static_cast<unsigned long long>(r.p50_ns), static_cast<unsigned long long>(r.p99_ns));
+        }
+        std::printf("\n]}\n");
+    }
+
+    bool parse(const int argc, char **argv)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const char *arg = argv[i];
+            if (!std::strcmp(arg, "--csv"))
+                config.output = format::CSV;
+            else if (!std::strcmp(arg, "--json"))
+                config.output = format::JSON;
+            else if (!std::strcmp(arg, "--quick"))
+                config.shift = 4;
+            else if (!std::strncmp(arg, "--threads=", 10))
+                config.max_threads = std::strtoul(arg + 10, nullptr, 10);
+            else
+                return false;
+        }
+        return true;
+    }
+}
+
+int main(const int argc, char **argv)
+{
+    if (!parse(argc, argv))
+    {
+        std::fprintf(stderr, "usage: %s [--csv|--json] [--threads=N] [--quick]\n", argv[0]);
+        return 1;
+    }
+
+    const size_t hardware = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    const size_t max_threads = config.max_threads ? config.max_threads : hardware;
+    std::vector<size_t> counts;
+    for (size_t t = 1; t < max_threads; t <<= 1)
+        counts.push_back(t);
+    counts.push_back(max_threads);
+
+    if (config.output == format::TEXT)
+        std::printf("%-14s %-12s %3s %12s %10s %14s %10s %10s\n", "workload", "impl", "thr", "ops", "seconds",
+                    "ops/s", "p50 ns", "p99 ns");
+
+    for (const size_t threads: counts)
+    {
+        spawn_empty(threads);
+        spawn_latency(threads);
+        fib(threads);
+        parallel_for(threads);
+        sort(threads);
+        pipeline(threads);
+        timers(threads);
+    }
+
+    if (config.output == format::CSV)
+        print_csv();
+    else if (config.output == format::JSON)
+        print_json();
+    return 0;
+}
@@ -0,0 +1,113 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include <hash.h>
+
+namespace
+{
+    size_t total_bytes = size_t { 1 } << 28;
+    size_t rounds = 8;
+
+    /**
+     * @brief Time rounds passes of fn over total_bytes of keys and print the best one
+     */
+    template<typename Fn>
+    void measure(const size_t length, const char *impl, const size_t keys, Fn &&fn)
+    {
+        double best = 1e300;
+        uint64_t sink = 0;
+        for (size_t r = 0; r < rounds; ++r)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            sink += fn();
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            best = seconds < best ? seconds : best;
+        }
+        std::printf("%10zu %-10s %10.2f %10.1f %20llu\n", length, impl, best * 1e9 / static_cast<double>(keys),
+                    static_cast<double>(keys * length) / best / 1e6, static_cast<unsigned long long>(sink));
+    }
+
+    void run(const std::vector<char> &data, const size_t length)
+    {
+        // Keys start at odd offsets, the way they sit in real buffers
+        const size_t stride = length + 1;
+        const size_t keys = (data.size() - length) / stride;
+        const size_t passes = total_bytes / (keys * length + 1) + 1;
+        const size_t calls = keys * passes;
+
+        measure(length, "ytl", calls, [&]
+        {
+            uint64_t h = 0;
+            for (size_t pass = 0; pass < passes; ++pass)
+            {
+                for (size_t i = 0; i < keys; ++i)
+                    h += ytl::hash(data.data() + i * stride, length, pass);
+            }
+            return h;
+        });
+        measure(length, "streaming", calls, [&]
+        {
+            uint64_t h = 0;
+            for (size_t pass = 0; pass < passes; ++pass)
+            {
+                for (size_t i = 0; i < keys; ++i)
+                {
+                    ytl::hasher hasher(pass);
+                    hasher.update(data.data() + i * stride, length);
+                    h += hasher.digest();
+                }
+            }
+            return h;
+        });
+        measure(length, "std", calls, [&]
+        {
+            uint64_t h = 0;
+            for (size_t pass = 0; pass < passes; ++pass)
+            {
+                for (size_t i = 0; i < keys; ++i)
+                    h += std::hash<std::string_view> {}(std::string_view(data.data() + i * stride, length)) + pass;
+            }
+            return h;
+        });
+    }
+
+    bool parse(const int argc, char **argv)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string_view arg = argv[i];
+            if (arg == "--quick")
+            {
+                total_bytes >>= 4;
+                rounds = 3;
+            }
+            else
+                return false;
+        }
+        return true;
+    }
+}
+
+int main(const int argc, char **argv)
+{
+    if (!parse(argc, argv))
+    {
+        std::fprintf(stderr, "usage: %s [--quick]\n", argv[0]);
+        return 1;
+    }
+
+    std::mt19937_64 rng(42);
+    std::vector<char> data(size_t { 1 } << 20);
+    for (char &c: data)
+        c = static_cast<char>(rng());
+
+    std::printf("%10s %-10s %10s %10s %20s\n", "bytes", "impl", "ns/op", "MB/s", "checksum");
+    for (const size_t length: { 4, 8, 16, 24, 32, 64, 100, 256, 1024, 4096, 65536 })
+        run(data, length);
+    return 0;
+}
@@ -0,0 +1,134 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <string_interner.h>
+
+namespace
+{
+    size_t unique_keys = size_t { 1 } << 16;
+    size_t lookups = size_t { 1 } << 22;
+    size_t rounds = 5;
+
+    /**
+     * @brief The interner most code starts with: a locked map from owned strings to ids
+     */
+    class locked_map
+    {
+    public:
+        uint32_t intern(const std::string_view s)
+        {
+            std::lock_guard lock(mutex);
+            const auto [it, inserted] = ids.try_emplace(std::string(s), static_cast<uint32_t>(ids.size()));
+            return it->second;
+        }
+
+    private:
+        std::mutex mutex;
+        std::unordered_map<std::string, uint32_t> ids;
+    };
+
+    /**
+     * @brief Time rounds of threads each interning lookups keys and print the best one
+     */
+    template<typename Fn>
+    void measure(const char *impl, const size_t threads, Fn &&fn)
+    {
+        double best = 1e300;
+        uint64_t sink = 0;
+        for (size_t r = 0; r < rounds; ++r)
+        {
+            std::vector<uint64_t> sums(threads);
+            std::vector<std::thread> workers;
+            const auto start = std::chrono::steady_clock::now();
+            for (size_t t = 0; t < threads; ++t)
+                workers.emplace_back([&, t] { sums[t] = fn(t); });
+            for (std::thread &worker: workers)
+                worker.join();
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            best = seconds < best ? seconds : best;
+            for (const uint64_t s: sums)
+                sink += s;
+        }
+        std::printf("%-10s %8zu %10.1f %20llu\n", impl, threads,
+                    static_cast<double>(lookups * threads) / best / 1e6, static_cast<unsigned long long>(sink));
+    }
+
+    /**
+     * @brief Header names and metric tags: a shared prefix and a short varying tail
+     */
+    std::vector<std::string> make_keys(std::mt19937_64 &rng)
+    {
+        static constexpr const char *PREFIXES[] = { "x-request-", "http.server.", "host-eu-west-", "tag:" };
+        std::vector<std::string> keys;
+        for (size_t i = 0; i < unique_keys; ++i)
+            keys.push_back(PREFIXES[rng() % 4] + std::to_string(rng() % 1000000) + "." + std::to_string(i));
+        return keys;
+    }
+
+    void run(const std::vector<std::string> &keys, const size_t threads)
+    {
+        // Every thread walks the same stream of mostly repeated keys from its own offset
+        std::vector<uint32_t> stream(lookups);
+        std::mt19937_64 rng(7);
+        for (uint32_t &k: stream)
+            k = static_cast<uint32_t>(rng() % keys.size());
+
+        measure("locked", threads, [&, map = std::make_shared<locked_map>()](const size_t t)
+        {
+            uint64_t sum = 0;
+            for (size_t i = 0; i < lookups; ++i)
+                sum += map->intern(keys[stream[(i + t * 4099) % lookups]]);
+            return sum;
+        });
+        measure("ytl", threads, [&, interner = std::make_shared<ytl::string_interner>()](const size_t t)
+        {
+            uint64_t sum = 0;
+            for (size_t i = 0; i < lookups; ++i)
+                sum += interner->intern(std::string_view(keys[stream[(i + t * 4099) % lookups]])).id;
+            return sum;
+        });
+    }
+
+    bool parse(const int argc, char **argv)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string_view arg = argv[i];
+            if (arg == "--quick")
+            {
+                lookups >>= 4;
+                rounds = 2;
+            }
+            else
+                return false;
+        }
+        return true;
+    }
+}
+
+int main(const int argc, char **argv)
+{
+    if (!parse(argc, argv))
+    {
+        std::fprintf(stderr, "usage: %s [--quick]\n", argv[0]);
+        return 1;
+    }
+
+    std::mt19937_64 rng(42);
+    const std::vector<std::string> keys = make_keys(rng);
+    const size_t cores = std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1;
+
+    std::printf("%-10s %8s %10s %20s\n", "impl", "threads", "Mops/s", "checksum");
+    for (size_t threads = 1; threads <= cores; threads *= 2)
+        run(keys, threads);
+    return 0;
+}
@@ -0,0 +1,165 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <queue.h>
+
+namespace
+{
+    constexpr size_t ITEMS = 1 << 22;
+    constexpr size_t CAPACITY = 1 << 12;
+    constexpr size_t BATCH = 32;
+
+    class mutex_queue
+    {
+    public:
+        bool try_push(const uint64_t value)
+        {
+            std::lock_guard lock(mutex);
+            items.push_back(value);
+            return true;
+        }
+
+        bool try_pop(uint64_t &out)
+        {
+            std::lock_guard lock(mutex);
+            if (items.empty())
+                return false;
+            out = items.front();
+            items.pop_front();
+            return true;
+        }
+
+    private:
+        std::mutex mutex;
+        std::deque<uint64_t> items;
+    };
+
+    template<typename Queue>
+    double run(Queue &queue, const size_t producers, const size_t consumers, const bool batched)
+    {
+        const size_t per_producer = ITEMS / producers;
+        const size_t total = per_producer * producers;
+        std::atomic<size_t> consumed { 0 };
+        std::atomic<uint64_t> checksum { 0 };
+        std::vector<std::thread> threads;
+
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t p = 0; p < producers; ++p)
+        {
+            threads.emplace_back([&queue, per_producer, batched]
+            {
+                if constexpr (requires { queue.try_push_batch(nullptr, 0); })
+                {
+                    if (batched)
+                    {
+                        uint64_t buf[BATCH];
+                        for (size_t i = 0; i < per_producer;)
+                        {
+                            const size_t n = per_producer - i < BATCH ? per_producer - i : BATCH;
+                            for (size_t j = 0; j < n; ++j)
+                                buf[j] = i + j + 1;
+                            for (size_t sent = 0; sent < n;)
+                            {
+                                const size_t pushed = queue.try_push_batch(buf + sent, n - sent);
+                                if (!pushed)
+                                    std::this_thread::yield();
+                                sent += pushed;
+                            }
+                            i += n;
+                        }
+                        return;
+                    }
+                }
+
+                for (size_t i = 1; i <= per_producer; ++i)
+                {
+                    while (!queue.try_push(i))
+                        std::this_thread::yield();
+                }
+            });
+        }
+
+        for (size_t c = 0; c < consumers; ++c)
+        {
+            threads.emplace_back([&queue, &consumed, &checksum, total, batched]
+            {
+                uint64_t sum = 0;
+                if constexpr (requires { queue.try_pop_batch(nullptr, 0); })
+                {
+                    if (batched)
+                    {
+                        uint64_t buf[BATCH];
+                        while (consumed.load(std::memory_order_relaxed) < total)
+                        {
+                            const size_t n = queue.try_pop_batch(buf, BATCH);
+                            for (size_t j = 0; j < n; ++j)
+                                sum += buf[j];
+                            if (n)
+                                consumed.fetch_add(n, std::memory_order_relaxed);
+                            else
+                                std::this_thread::yield();
+                        }
+                        checksum.fetch_add(sum);
+                        return;
+                    }
+                }
+
+                uint64_t value;
+                while (consumed.load(std::memory_order_relaxed) < total)
+                {
+                    if (queue.try_pop(value))
+                    {
+                        sum += value;
+                        consumed.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    else
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+                checksum.fetch_add(sum);
+            });
+        }
+
+        for (auto &t: threads)
+            t.join();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        const uint64_t expected = producers * (per_producer * (per_producer + 1) / 2);
+        if (checksum.load() != expected)
+            std::fprintf(stderr, "checksum mismatch\n");
+
+        return static_cast<double>(total) / elapsed.count() / 1e6;
+    }
+
+    template<typename Queue, typename... Args>
+    void report(const char *name, const size_t producers, const size_t consumers, const bool batched, Args... args)
+    {
+        Queue queue(args...);
+        const double mops = run(queue, producers, consumers, batched);
+        std::printf("%-24s %zuP/%zuC %-6s %10.2f Mops/s\n", name, producers, consumers,
+                    batched ? "batch" : "single", mops);
+    }
+}
+
+int main()
+{
+    report<mutex_queue>("mutex_queue", 1, 1, false);
+    report<ytl::spsc_queue<uint64_t> >("spsc_queue", 1, 1, false, CAPACITY);
+    report<ytl::spsc_queue<uint64_t> >("spsc_queue", 1, 1, true, CAPACITY);
+    report<ytl::spsc_queue<uint64_t, ytl::blocking_wait> >("spsc_queue<blocking>", 1, 1, false, CAPACITY);
+
+    for (const size_t threads: { 1, 2, 4 })
+    {
+        report<mutex_queue>("mutex_queue", threads, threads, false);
+        report<ytl::mpmc_queue<uint64_t> >("mpmc_queue", threads, threads, false, CAPACITY);
+        report<ytl::mpmc_queue<uint64_t> >("mpmc_queue", threads, threads, true, CAPACITY);
+        report<ytl::mpmc_queue<uint64_t, ytl::blocking_wait> >("mpmc_queue<blocking>", threads, threads, false, CAPACITY);
+    }
+    return 0;
+}
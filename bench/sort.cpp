@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <algorithm.h>
+
+namespace
+{
+    size_t count = size_t { 1 } << 22;
+    size_t rounds = 5;
+
+    /**
+     * @brief Sort a fresh copy of input rounds times and print the best time per element
+     */
+    template<typename T, typename Fn>
+    void measure(const char *type, const char *pattern, const char *impl, const std::vector<T> &input, Fn &&fn)
+    {
+        double best = 1e300;
+        std::vector<T> work;
+        bool sorted = true;
+        for (size_t r = 0; r < rounds; ++r)
+        {
+            work = input;
+            const auto start = std::chrono::steady_clock::now();
+            fn(work);
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            best = seconds < best ? seconds : best;
+            sorted = sorted && std::is_sorted(work.begin(), work.end());
+        }
+        std::printf("%-8s %-12s %-6s %10.2f%s\n", type, pattern, impl, best * 1e9 / static_cast<double>(input.size()),
+                    sorted ? "" : "  NOT SORTED");
+    }
+
+    template<typename T>
+    void compare(const char *type, const char *pattern, const std::vector<T> &input)
+    {
+        measure(type, pattern, "ytl", input, [](std::vector<T> &v) { ytl::sort(v.data(), v.size()); });
+        measure(type, pattern, "std", input, [](std::vector<T> &v) { std::sort(v.begin(), v.end()); });
+        if constexpr (std::is_arithmetic_v<T>)
+        {
+            measure(type, pattern, "radix", input, [](std::vector<T> &v) { ytl::radix_sort(v.data(), v.size()); });
+            measure(type, pattern, "msd", input,
+                    [](std::vector<T> &v) { ytl::radix_sort_in_place(v.data(), v.size()); });
+            // Sorting records by key through an index, the payload is permuted afterwards if at all
+            std::vector<uint32_t> index(input.size());
+            measure(type, pattern, "kv", input, [&](std::vector<T> &v)
+            {
+                for (size_t i = 0; i < index.size(); ++i)
+                    index[i] = static_cast<uint32_t>(i);
+                ytl::radix_sort(v.data(), index.data(), v.size());
+            });
+        }
+    }
+
+    /**
+     * @brief Inputs that take plain quicksorts to their worst case, and random ones
+     */
+    std::vector<uint64_t> pattern(const int kind, std::mt19937_64 &rng)
+    {
+        std::vector<uint64_t> v(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            switch (kind)
+            {
+            case 0:
+                v[i] = rng();
+                break;
+            case 1:
+                v[i] = rng() % 16;
+                break;
+            case 2:
+                v[i] = i;
+                break;
+            case 3:
+                v[i] = count - i;
+                break;
+            case 4:
+                v[i] = i < count / 2 ? i : count - i;
+                break;
+            default:
+                // Sorted with one percent of the elements replaced
+                v[i] = rng() % 100 ? i : rng() % count;
+                break;
+            }
+        }
+        return v;
+    }
+
+    constexpr const char *PATTERNS[] = { "random", "few_unique", "sorted", "reversed", "organ_pipe", "nearly" };
+
+    bool parse(const int argc, char **argv)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string_view arg = argv[i];
+            if (arg == "--quick")
+            {
+                count >>= 4;
+                rounds = 2;
+            }
+            else
+                return false;
+        }
+        return true;
+    }
+}
+
+int main(const int argc, char **argv)
+{
+    if (!parse(argc, argv))
+    {
+        std::fprintf(stderr, "usage: %s [--quick]\n", argv[0]);
+        return 1;
+    }
+
+    std::printf("%-8s %-12s %-6s %10s\n", "type", "pattern", "impl", "ns/elem");
+    std::mt19937_64 rng(42);
+    for (int kind = 0; kind < 6; ++kind)
+    {
+        const std::vector<uint64_t> keys = pattern(kind, rng);
+        compare("uint64", PATTERNS[kind], keys);
+        compare("uint32", PATTERNS[kind], std::vector<uint32_t>(keys.begin(), keys.end()));
+        compare("double", PATTERNS[kind], std::vector<double>(keys.begin(), keys.end()));
+        if (kind == 0 || kind == 2)
+        {
+            std::vector<std::string> strings;
+            strings.reserve(keys.size() / 8);
+            for (size_t i = 0; i < keys.size() / 8; ++i)
+                strings.push_back(std::to_string(keys[i]));
+            compare("string", PATTERNS[kind], strings);
+        }
+    }
+    return 0;
+}
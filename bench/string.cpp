@@ -0,0 +1,322 @@
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include <string.h>
+
+// string/include shadows the libc header, so the baselines are declared here
+extern "C"
+{
+    size_t strlen(const char *s);
+    size_t strnlen(const char *s, size_t maxlen);
+    char *strcpy(char *dest, const char *src);
+    char *strncpy(char *dest, const char *src, size_t count);
+    char *strcat(char *dest, const char *src);
+    char *strncat(char *dest, const char *src, size_t count);
+    int strcmp(const char *s1, const char *s2);
+    int strncmp(const char *s1, const char *s2, size_t count);
+    int strcasecmp(const char *s1, const char *s2);
+    int strncasecmp(const char *s1, const char *s2, size_t count);
+    char *strchr(const char *s, int ch);
+    char *strrchr(const char *s, int ch);
+    char *strstr(const char *haystack, const char *needle);
+    void *memchr(const void *s, int ch, size_t count);
+    void *memcpy(void *dest, const void *src, size_t count);
+    void *memmem(const void *haystack, size_t length, const void *needle, size_t count);
+}
+
+namespace
+{
+    constexpr size_t MAX_LENGTH = size_t { 1 } << 20;
+    constexpr size_t NEEDLE = 8;
+
+    size_t rounds = 5;
+    // Bytes each timed pass walks, short strings repeat until they add up to it
+    size_t pass_bytes = size_t { 1 } << 24;
+    std::string_view only;
+
+    /**
+     * @brief Inputs of one measurement. s1 and s2 hold the same length random
+     * letters without 'z', s2 differs only in its last byte, and the needle is
+     * the tail of s1, so every function scans the whole string.
+     */
+    struct inputs
+    {
+        const char *s1;
+        const char *s2;
+        const char *needle;
+        char *dest;
+        size_t length;
+    };
+
+    using kernel = size_t (*)(const inputs &);
+
+    struct function
+    {
+        const char *name;
+        kernel ytl;
+        // libc has no exact counterpart for some, they are timed against the nearest composition
+        kernel baseline;
+        const char *baseline_name;
+    };
+
+    size_t address(const void *p)
+    {
+        return reinterpret_cast<uintptr_t>(p);
+    }
+
+    const function FUNCTIONS[] = {
+        {
+            "strlen", [](const inputs &in) { return ytl::strlen(in.s1); },
+            [](const inputs &in) { return ::strlen(in.s1); }, "glibc"
+        },
+        {
+            "strnlen", [](const inputs &in) { return ytl::strnlen(in.s1, in.length); },
+            [](const inputs &in) { return ::strnlen(in.s1, in.length); }, "glibc"
+        },
+        {
+            "strcpy", [](const inputs &in) { return address(ytl::strcpy(in.dest, in.s1)); },
+            [](const inputs &in) { return address(::strcpy(in.dest, in.s1)); }, "glibc"
+        },
+        {
+            "strncpy", [](const inputs &in) { return address(ytl::strncpy(in.dest, in.s1, in.length + 1)); },
+            [](const inputs &in) { return address(::strncpy(in.dest, in.s1, in.length + 1)); }, "glibc"
+        },
+        {
+            "strlcpy", [](const inputs &in) { return ytl::strlcpy(in.dest, in.s1, in.length + 1); },
+            [](const inputs &in)
+            {
+                const size_t n = ::strlen(in.s1);
+                ::memcpy(in.dest, in.s1, n + 1);
+                return n;
+            },
+            "strlen+memcpy"
+        },
+        {
+            // The first half of s1 is appended to a copy of the second half, the copy is cut back after each call
+            "strcat", [](const inputs &in)
+            {
+                in.dest[in.length - in.length / 2] = '\0';
+                return address(ytl::strcat(in.dest, in.s1 + in.length / 2));
+            },
+            [](const inputs &in)
+            {
+                in.dest[in.length - in.length / 2] = '\0';
+                return address(::strcat(in.dest, in.s1 + in.length / 2));
+            },
+            "glibc"
+        },
+        {
+            "strncat", [](const inputs &in)
+            {
+                in.dest[in.length - in.length / 2] = '\0';
+                return address(ytl::strncat(in.dest, in.s1 + in.length / 2, in.length));
+            },
+            [](const inputs &in)
+            {
+                in.dest[in.length - in.length / 2] = '\0';
+                return address(::strncat(in.dest, in.s1 + in.length / 2, in.length));
+            },
+            "glibc"
+        },
+        {
+            "strlcat", [](const inputs &in)
+            {
+                in.dest[in.length - in.length / 2] = '\0';
+                return ytl::strlcat(in.dest, in.s1 + in.length / 2, in.length + 1);
+            },
+            [](const inputs &in)
+            {
+                in.dest[in.length - in.length / 2] = '\0';
+                const size_t d = ::strlen(in.dest);
+                const size_t n = ::strlen(in.s1 + in.length / 2);
+                ::memcpy(in.dest + d, in.s1 + in.length / 2, n + 1);
+                return d + n;
+            },
+            "strlen+memcpy"
+        },
+        {
+            "strcmp", [](const inputs &in) { return static_cast<size_t>(ytl::strcmp(in.s1, in.s2)); },
+            [](const inputs &in) { return static_cast<size_t>(::strcmp(in.s1, in.s2)); }, "glibc"
+        },
+        {
+            "strncmp", [](const inputs &in) { return static_cast<size_t>(ytl::strncmp(in.s1, in.s2, in.length)); },
+            [](const inputs &in) { return static_cast<size_t>(::strncmp(in.s1, in.s2, in.length)); }, "glibc"
+        },
+        {
+            "strcasecmp", [](const inputs &in) { return static_cast<size_t>(ytl::strcasecmp(in.s1, in.s2)); },
+            [](const inputs &in) { return static_cast<size_t>(::strcasecmp(in.s1, in.s2)); }, "glibc"
+        },
+        {
+            "strncasecmp",
+            [](const inputs &in) { return static_cast<size_t>(ytl::strncasecmp(in.s1, in.s2, in.length)); },
+            [](const inputs &in) { return static_cast<size_t>(::strncasecmp(in.s1, in.s2, in.length)); }, "glibc"
+        },
+        {
+            "memcasecmp", [](const inputs &in) { return static_cast<size_t>(ytl::memcasecmp(in.s1, in.s2, in.length)); },
+            [](const inputs &in) { return static_cast<size_t>(::strncasecmp(in.s1, in.s2, in.length)); },
+            "strncasecmp"
+        },
+        {
+            "strchr", [](const inputs &in) { return address(ytl::strchr(in.s1, 'z')); },
+            [](const inputs &in) { return address(::strchr(in.s1, 'z')); }, "glibc"
+        },
+        {
+            "strrchr", [](const inputs &in) { return address(ytl::strrchr(in.s1, 'a')); },
+            [](const inputs &in) { return address(::strrchr(in.s1, 'a')); }, "glibc"
+        },
+        {
+            "strnchr", [](const inputs &in) { return address(ytl::strnchr(in.s1, in.length, 'z')); },
+            [](const inputs &in) { return address(::memchr(in.s1, 'z', ::strnlen(in.s1, in.length))); },
+            "strnlen+memchr"
+        },
+        {
+            "strstr", [](const inputs &in) { return address(ytl::strstr(in.s1, in.needle)); },
+            [](const inputs &in) { return address(::strstr(in.s1, in.needle)); }, "glibc"
+        },
+        {
+            "strnstr", [](const inputs &in) { return address(ytl::strnstr(in.s1, in.needle, in.length)); },
+            [](const inputs &in)
+            {
+                return address(::memmem(in.s1, ::strnlen(in.s1, in.length), in.needle, ::strlen(in.needle)));
+            },
+            "strnlen+memmem"
+        },
+        {
+            "to_lower", [](const inputs &in)
+            {
+                ytl::to_lower(in.dest, in.s1, in.length);
+                return static_cast<size_t>(in.dest[0]);
+            },
+            [](const inputs &in)
+            {
+                for (size_t i = 0; i < in.length; ++i)
+                    in.dest[i] = static_cast<char>(std::tolower(static_cast<unsigned char>(in.s1[i])));
+                return static_cast<size_t>(in.dest[0]);
+            },
+            "tolower"
+        },
+        {
+            "to_upper", [](const inputs &in)
+            {
+                ytl::to_upper(in.dest, in.s1, in.length);
+                return static_cast<size_t>(in.dest[0]);
+            },
+            [](const inputs &in)
+            {
+                for (size_t i = 0; i < in.length; ++i)
+                    in.dest[i] = static_cast<char>(std::toupper(static_cast<unsigned char>(in.s1[i])));
+                return static_cast<size_t>(in.dest[0]);
+            },
+            "toupper"
+        },
+        {
+            "casehash", [](const inputs &in) { return static_cast<size_t>(ytl::casehash(in.s1, in.length)); },
+            nullptr, "-"
+        },
+    };
+
+    /**
+     * @brief Best time of one call over rounds passes, in nanoseconds
+     */
+    double measure(const kernel fn, const inputs &in, uint64_t &sink)
+    {
+        const size_t reps = pass_bytes / (in.length + 16) + 1;
+        double best = 1e300;
+        for (size_t r = 0; r < rounds; ++r)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < reps; ++i)
+                sink += fn(in);
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            best = seconds < best ? seconds : best;
+        }
+        return best * 1e9 / static_cast<double>(reps);
+    }
+
+    bool parse(const int argc, char **argv)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string_view arg = argv[i];
+            if (arg == "--quick")
+            {
+                pass_bytes >>= 4;
+                rounds = 2;
+            }
+            else if (arg == "--only" && i + 1 < argc)
+                only = argv[++i];
+            else
+                return false;
+        }
+        return true;
+    }
+}
+
+int main(const int argc, char **argv)
+{
+    if (!parse(argc, argv))
+    {
+        std::fprintf(stderr, "usage: %s [--quick] [--only function]\n", argv[0]);
+        return 1;
+    }
+
+    // Room for the largest string at the largest misalignment, in 64 byte aligned blocks
+    constexpr size_t ALIGNMENTS[] = { 0, 1, 33 };
+    constexpr size_t SPAN = MAX_LENGTH + 128;
+    std::vector<uint64_t> storage(4 * SPAN / sizeof(uint64_t) + 8);
+    char *base = reinterpret_cast<char *>((reinterpret_cast<uintptr_t>(storage.data()) + 63) & ~uintptr_t { 63 });
+    char *s1_block = base;
+    char *s2_block = base + SPAN;
+    char *dest_block = base + 2 * SPAN;
+    char *needle = base + 3 * SPAN;
+
+    std::mt19937_64 rng(42);
+    std::vector<char> letters(MAX_LENGTH);
+    for (char &c: letters)
+        c = static_cast<char>('a' + rng() % 25);
+
+    std::printf("%-12s %8s %5s %12s %12s %10s %8s  %s\n", "function", "length", "align", "ytl ns", "base ns",
+                "ytl GB/s", "speedup", "baseline");
+    uint64_t sink = 0;
+    for (const function &f: FUNCTIONS)
+    {
+        if (!only.empty() && only != f.name)
+            continue;
+        for (size_t length = 0; length <= MAX_LENGTH; length = length ? length * 2 : 1)
+        {
+            for (const size_t align: ALIGNMENTS)
+            {
+                // s2 sits at a different misalignment, so the pair is never aligned alike by accident
+                char *s1 = s1_block + align;
+                char *s2 = s2_block + (align + 7) % 64;
+                for (size_t i = 0; i < length; ++i)
+                    s1[i] = s2[i] = letters[i];
+                s1[length] = s2[length] = '\0';
+                if (length)
+                    s2[length - 1] = 'z';
+                const size_t tail = length < NEEDLE ? length : NEEDLE;
+                for (size_t i = 0; i < tail; ++i)
+                    needle[i] = s1[length - tail + i];
+                needle[tail] = '\0';
+                char *dest = dest_block + (align + 3) % 64;
+                for (size_t i = 0; i < length; ++i)
+                    dest[i] = letters[i];
+                dest[length - length / 2] = '\0';
+
+                const inputs in { s1, s2, needle, dest, length };
+                const double ytl_ns = measure(f.ytl, in, sink);
+                const double base_ns = f.baseline ? measure(f.baseline, in, sink) : 0;
+                std::printf("%-12s %8zu %5zu %12.2f %12.2f %10.2f %8.2f  %s\n", f.name, length, align, ytl_ns, base_ns,
+                            static_cast<double>(length) / ytl_ns, f.baseline ? base_ns / ytl_ns : 0.0,
+                            f.baseline_name);
+            }
+        }
+    }
+    std::printf("checksum %llu\n", static_cast<unsigned long long>(sink));
+    return 0;
+}
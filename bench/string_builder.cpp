@@ -0,0 +1,107 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+#include <vector>
+
+#include <string_builder.h>
+
+namespace
+{
+    size_t total_bytes = size_t { 1 } << 24;
+    size_t rounds = 5;
+
+    /**
+     * @brief Time rounds of building total_bytes from pieces and print the best one
+     */
+    template<typename Fn>
+    void measure(const size_t piece, const char *impl, const size_t bytes, Fn &&fn)
+    {
+        double best = 1e300;
+        uint64_t sink = 0;
+        for (size_t r = 0; r < rounds; ++r)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            sink += fn();
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            best = seconds < best ? seconds : best;
+        }
+        std::printf("%10zu %-10s %10.2f %20llu\n", piece, impl, static_cast<double>(bytes) / best / 1e9,
+                    static_cast<unsigned long long>(sink));
+    }
+
+    void run(const size_t piece)
+    {
+        const std::vector<char> text(piece + 1, 'x');
+        const char *s = text.data();
+        const size_t pieces = total_bytes / piece;
+
+        // Quadratic, so it only builds a slice of the output
+        const size_t strcat_pieces = pieces < (size_t { 1 } << 20) / piece ? pieces : (size_t { 1 } << 20) / piece;
+        std::vector<char> buffer(strcat_pieces * piece + 1);
+        const std::vector<char> terminated = [&]
+        {
+            std::vector<char> t(text);
+            t[piece] = '\0';
+            return t;
+        }();
+        measure(piece, "strcat", strcat_pieces * piece, [&]
+        {
+            buffer[0] = '\0';
+            for (size_t i = 0; i < strcat_pieces; ++i)
+                ytl::strcat(buffer.data(), terminated.data());
+            return ytl::strlen(buffer.data());
+        });
+        measure(piece, "string", pieces * piece, [&]
+        {
+            ytl::string out;
+            for (size_t i = 0; i < pieces; ++i)
+                out.append(s, piece);
+            return out.size();
+        });
+        measure(piece, "builder", pieces * piece, [&]
+        {
+            ytl::string_builder out;
+            for (size_t i = 0; i < pieces; ++i)
+                out.append(s, piece);
+            return out.size();
+        });
+        measure(piece, "flatten", pieces * piece, [&]
+        {
+            ytl::string_builder out;
+            for (size_t i = 0; i < pieces; ++i)
+                out.append(s, piece);
+            return out.flatten().size();
+        });
+    }
+
+    bool parse(const int argc, char **argv)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string_view arg = argv[i];
+            if (arg == "--quick")
+            {
+                total_bytes >>= 4;
+                rounds = 2;
+            }
+            else
+                return false;
+        }
+        return true;
+    }
+}
+
+int main(const int argc, char **argv)
+{
+    if (!parse(argc, argv))
+    {
+        std::fprintf(stderr, "usage: %s [--quick]\n", argv[0]);
+        return 1;
+    }
+
+    std::printf("%10s %-10s %10s %20s\n", "piece", "impl", "GB/s", "checksum");
+    for (const size_t piece: { 8, 32, 128, 1024, 16384 })
+        run(piece);
+    return 0;
+}
@@ -0,0 +1,179 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include <string.h>
+#include <utf8.h>
+
+namespace
+{
+    size_t text_bytes = size_t { 1 } << 24;
+    size_t rounds = 8;
+
+    /**
+     * @brief The usual byte at a time validator, decoding each sequence by its lead byte
+     */
+    bool naive_validate(const unsigned char *p, const size_t length) noexcept
+    {
+        size_t i = 0;
+        while (i < length)
+        {
+            const unsigned c = p[i];
+            size_t n;
+            uint32_t cp;
+            if (c < 0x80)
+            {
+                i++;
+                continue;
+            }
+            if ((c & 0xE0) == 0xC0)
+            {
+                n = 2;
+                cp = c & 0x1F;
+            }
+            else if ((c & 0xF0) == 0xE0)
+            {
+                n = 3;
+                cp = c & 0x0F;
+            }
+            else if ((c & 0xF8) == 0xF0)
+            {
+                n = 4;
+                cp = c & 0x07;
+            }
+            else
+                return false;
+            if (length - i < n)
+                return false;
+            for (size_t k = 1; k < n; ++k)
+            {
+                if ((p[i + k] & 0xC0) != 0x80)
+                    return false;
+                cp = cp << 6 | (p[i + k] & 0x3F);
+            }
+            constexpr uint32_t SMALLEST[] = { 0, 0, 0x80, 0x800, 0x10000 };
+            if (cp < SMALLEST[n] || cp > 0x10FFFF || (cp >= 0xD800 && cp < 0xE000))
+                return false;
+            i += n;
+        }
+        return true;
+    }
+
+    size_t naive_count(const unsigned char *p, const size_t length) noexcept
+    {
+        size_t count = 0;
+        for (size_t i = 0; i < length; ++i)
+            count += (p[i] & 0xC0) != 0x80;
+        return count;
+    }
+
+    /**
+     * @brief Time rounds passes of fn over the text and print the best one
+     */
+    template<typename Fn>
+    void measure(const char *workload, const char *operation, const char *impl, const size_t bytes, Fn &&fn)
+    {
+        double best = 1e300;
+        uint64_t sink = 0;
+        for (size_t r = 0; r < rounds; ++r)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            sink += fn();
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            best = seconds < best ? seconds : best;
+        }
+        std::printf("%-10s %-10s %-10s %10.2f %20llu\n", workload, operation, impl,
+                    static_cast<double>(bytes) / best / 1e9, static_cast<unsigned long long>(sink));
+    }
+
+    /**
+     * @brief Random text whose code points are ASCII with the given odds, the rest
+     * drawn from the Unicode range [low, high)
+     */
+    std::vector<char> make_text(std::mt19937_64 &rng, const unsigned ascii_percent, const char32_t low,
+                                const char32_t high)
+    {
+        std::u32string points;
+        size_t bytes = 0;
+        while (bytes < text_bytes)
+        {
+            char32_t c = static_cast<char32_t>(rng() % 95 + 32);
+            if (rng() % 100 >= ascii_percent)
+            {
+                do
+                    c = static_cast<char32_t>(low + rng() % (high - low));
+                while (c >= 0xD800 && c < 0xE000);
+            }
+            points.push_back(c);
+            bytes += 1 + (c >= 0x80) + (c >= 0x800) + (c >= 0x10000);
+        }
+        std::vector<char> text(ytl::utf8_length(points.data(), points.size()));
+        ytl::utf32_to_utf8(points.data(), points.size(), text.data(), text.size());
+        return text;
+    }
+
+    void run(const char *workload, const std::vector<char> &text)
+    {
+        const char *s = text.data();
+        const auto *u = reinterpret_cast<const unsigned char *>(s);
+        const size_t n = text.size();
+
+        measure(workload, "validate", "naive", n, [&] { return naive_validate(u, n); });
+        const ytl::simd_level best = ytl::active_simd();
+        ytl::select_simd(ytl::simd_level::SCALAR);
+        measure(workload, "validate", "scalar", n, [&] { return ytl::validate_utf8(s, n); });
+        ytl::select_simd(best);
+        measure(workload, "validate", "ytl", n, [&] { return ytl::validate_utf8(s, n); });
+
+        measure(workload, "count", "naive", n, [&] { return naive_count(u, n); });
+        measure(workload, "count", "ytl", n, [&] { return ytl::count_utf8(s, n); });
+
+        std::vector<char16_t> utf16(ytl::utf16_length(s, n));
+        measure(workload, "to_utf16", "ytl", n, [&]
+        {
+            return ytl::utf8_to_utf16(s, n, utf16.data(), utf16.size()).written;
+        });
+        std::vector<char> utf8(n);
+        measure(workload, "from_utf16", "ytl", n, [&]
+        {
+            return ytl::utf16_to_utf8(utf16.data(), utf16.size(), utf8.data(), utf8.size()).written;
+        });
+    }
+
+    bool parse(const int argc, char **argv)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string_view arg = argv[i];
+            if (arg == "--quick")
+            {
+                text_bytes >>= 4;
+                rounds = 3;
+            }
+            else
+                return false;
+        }
+        return true;
+    }
+}
+
+int main(const int argc, char **argv)
+{
+    if (!parse(argc, argv))
+    {
+        std::fprintf(stderr, "usage: %s [--quick]\n", argv[0]);
+        return 1;
+    }
+
+    std::mt19937_64 rng(42);
+    std::printf("%-10s %-10s %-10s %10s %20s\n", "workload", "operation", "impl", "GB/s", "checksum");
+    run("ascii", make_text(rng, 100, 0, 1));
+    run("latin", make_text(rng, 80, 0xA0, 0x180));
+    run("cjk", make_text(rng, 10, 0x4E00, 0x9FFF));
+    run("emoji", make_text(rng, 50, 0x1F300, 0x1FAFF));
+    run("mixed", make_text(rng, 40, 0x80, 0x10FFFF));
+    return 0;
+}
@@ -0,0 +1,265 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "function.h"
+#include "queue.h"
+
+namespace ytl
+{
+    namespace detail
+    {
+        /**
+         * @brief Intrusive unit of work scheduled by the executor.
+         * Jobs are not owned by the executor, the invoke callback is responsible
+         * for releasing any storage once it has run.
+         */
+        struct job
+        {
+            void (*invoke)(job *self) { nullptr };
+#ifdef YTL_TRACING
+            uint64_t trace_id { 0 };
+            uint64_t enqueued { 0 };
+#endif
+        };
+    }
+
+    enum class priority : uint8_t
+    {
+        NORMAL,
+        URGENT
+    };
+
+    /**
+     * @brief Work-stealing thread pool.
+     * Each worker owns a lock-free deque, jobs pushed from a worker stay local
+     * and are stolen by idle workers, jobs from other threads enter through a
+     * shared injection queue. Urgent jobs go through a separate lane that every
+     * worker drains before touching bulk work.
+     */
+    class executor
+    {
+    public:
+        struct options
+        {
+            /**
+             * @brief Pool name, used for lookup and as worker thread name prefix
+             */
+            std::string name;
+
+            /**
+             * @brief Number of worker threads, 0 picks the hardware concurrency
+             */
+            size_t threads { 0 };
+
+            /**
+             * @brief CPUs the workers may run on, empty leaves affinity untouched
+             */
+            std::vector<int> cpus;
+
+            /**
+             * @brief Pin worker i to cpus[i % cpus.size()] instead of the whole set
+             */
+            bool pin_workers { false };
+
+            /**
+             * @brief Nice value applied to every worker, 0 leaves it untouched
+             */
+            int nice { 0 };
+
+            /**
+             * @brief SCHED_FIFO priority in [1, 99], 0 keeps the default policy
+             */
+            int fifo_priority { 0 };
+        };
+
+        /**
+         * @brief Create a pool
+         * @param threads Number of worker threads, 0 picks the hardware concurrency
+         */
+        explicit executor(size_t threads = 0);
+
+        /**
+         * @brief Create a configured pool, named pools can be looked up with find
+         * @param opts Pool configuration
+         */
+        explicit executor(options opts);
+
+        ~executor();
+
+        executor(const executor &) = delete;
+
+        executor &operator=(const executor &) = delete;
+
+        /**
+         * @brief Process wide pool sized to the hardware concurrency
+         */
+        static executor &global();
+
+        /**
+         * @brief Look up a live pool by name. The handle pins the pool: its
+         * destructor waits until every handle is released, so do not hold one
+         * on the pool's own workers across its destruction.
+         * @param name Pool name given at construction
+         * @return Pool, or nullptr if none is registered under that name
+         */
+        static std::shared_ptr<executor> find(std::string_view name);
+
+        [[nodiscard]] const std::string &name() const noexcept
+        {
+            return opts.name;
+        }
+
+        /**
+         * @brief Whether every worker applied the requested affinity and scheduling.
+         * False if a worker failed, e.g. SCHED_FIFO without CAP_SYS_NICE. Final
+         * once the constructor returned, which waits for every worker to configure.
+         */
+        [[nodiscard]] bool configured() const noexcept
+        {
+            return !config_failed.load(std::memory_order_acquire);
+        }
+
+        [[nodiscard]] size_t size() const noexcept
+        {
+            return workers.size();
+        }
+
+        /**
+         * @brief Whether the calling thread is one of this pool's workers
+         */
+        [[nodiscard]] bool is_worker() const noexcept;
+
+        /**
+         * @brief Whether the calling worker has nothing queued locally
+         */
+        [[nodiscard]] bool local_empty() const noexcept;
+
+        /**
+         * @brief Schedule an intrusive job, the job must outlive its execution.
+         * Never blocks and never runs the job on the caller. When the bounded
+         * queues are full, i.e. the worker's deque and the injection queue or
+         * the urgent lane, the job spills to an unbounded list taken under a
+         * lock, urgent ones still ahead of bulk work.
+         * @param job Job to schedule
+         * @param prio URGENT jobs are picked before any queued bulk work
+         */
+        void submit(detail::job *job, priority prio = priority::NORMAL);
+
+        /**
+         * @brief Schedule a callable
+         * @tparam Fn Function or lambda type
+         * @param fn Function to execute
+         * @param prio URGENT jobs are picked before any queued bulk work
+         */
+        template<typename Fn>
+            requires std::is_invocable_v<std::decay_t<Fn> &>
+        void submit(Fn &&fn, const priority prio = priority::NORMAL)
+        {
+            submit(new function_job(std::forward<Fn>(fn)), prio);
+        }
+
+        /**
+         * @brief Run at most one pending job on the calling worker
+         * @return Whether a job was executed
+         */
+        bool try_run_one();
+
+        /**
+         * @brief Keep the calling thread busy until the flag is raised.
+         * Workers execute other jobs while waiting, other threads block.
+         * @param flag Completion flag to wait for, raised with complete
+         */
+        void wait(const std::atomic<bool> &flag);
+
+        /**
+         * @brief Raise a flag a wait call may be blocked on. The waiter may
+         * return and release the flag as soon as it is set, so blocked waiters
+         * are woken through the executor and the flag is not touched again.
+         * @param flag Completion flag to raise
+         */
+        void complete(std::atomic<bool> &flag) noexcept;
+
+    private:
+        static constexpr size_t INJECT_CAPACITY = 4096;
+        static constexpr size_t URGENT_CAPACITY = 1024;
+
+        struct worker;
+
+        /**
+         * @brief Spill list behind a bounded queue, size lets workers skip the lock while it is empty
+         */
+        struct overflow_list
+        {
+            std::mutex mutex;
+            std::deque<detail::job *> jobs;
+            std::atomic<size_t> size { 0 };
+        };
+
+        static thread_local worker *current;
+
+        struct function_job : detail::job
+        {
+            unique_function<void()> fn;
+
+            template<typename Fn>
+            explicit function_job(Fn &&f) : fn(std::forward<Fn>(f))
+            {
+                invoke = [](detail::job *self)
+                {
+                    auto *job = static_cast<function_job *>(self);
+                    job->fn();
+                    delete job;
+                };
+            }
+        };
+
+        std::vector<std::unique_ptr<worker> > workers;
+
+        options opts;
+        mpmc_queue<detail::job *> injected { INJECT_CAPACITY };
+        mpmc_queue<detail::job *> urgent { URGENT_CAPACITY };
+        overflow_list injected_overflow;
+        overflow_list urgent_overflow;
+        std::atomic<bool> config_failed { false };
+        std::atomic<size_t> configuring { 0 };
+        // Handles find gave out, guarded by the registry mutex
+        size_t pins { 0 };
+
+        std::atomic<uint32_t> signal { 0 };
+        std::atomic<uint32_t> sleepers { 0 };
+        std::atomic<uint32_t> completions { 0 };
+        std::atomic<uint32_t> blocked { 0 };
+        std::atomic<bool> stopping { false };
+
+        void run(size_t index);
+
+        void configure(size_t index);
+
+        void notify();
+
+        detail::job *find_work(worker *self);
+
+        /**
+         * @brief Queue on the bounded queue, or behind it once it is full or
+         * has spilled already, which keeps the order of jobs from one thread
+         */
+        static void enqueue(mpmc_queue<detail::job *> &queue, overflow_list &overflow, detail::job *job);
+
+        static detail::job *dequeue(mpmc_queue<detail::job *> &queue, overflow_list &overflow);
+
+        static void run_job(detail::job *job);
+
+        [[nodiscard]] bool has_work() const noexcept;
+    };
+}
@@ -0,0 +1,226 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include <raw_allocator.h>
+
+namespace ytl
+{
+    template<typename Signature, size_t Capacity = 48, raw_allocator Allocator = heap_allocator>
+    class unique_function;
+
+    /**
+     * @brief Move-only type-erased callable with a small inline buffer
+     * @tparam R Return type
+     * @tparam Args Argument types
+     * @tparam Capacity Inline buffer size in bytes, callables up to this size are stored without allocating
+     * @tparam Allocator Storage hook used for callables that exceed the inline buffer
+     */
+    template<typename R, typename... Args, size_t Capacity, raw_allocator Allocator>
+    class unique_function<R(Args...), Capacity, Allocator>
+    {
+        static_assert(Capacity >= sizeof(void *), "Inline buffer must hold at least a pointer");
+
+        struct vtable
+        {
+            R (*invoke)(void *storage, Args &&... args);
+            void (*move)(void *dst, void *src) noexcept;
+            void (*destroy)(void *storage) noexcept;
+        };
+
+        template<typename Fn>
+        static constexpr bool fits_inline = sizeof(Fn) <= Capacity &&
+                                            alignof(Fn) <= alignof(void *) &&
+                                            std::is_nothrow_move_constructible_v<Fn>;
+
+        /**
+         * @brief std::invoke converted to R, so member pointers are callable and void discards any result
+         */
+        template<typename Fn>
+        static R call(Fn &fn, Args &&... args)
+        {
+            if constexpr (std::is_void_v<R>)
+                std::invoke(fn, std::forward<Args>(args)...);
+            else
+                return std::invoke(fn, std::forward<Args>(args)...);
+        }
+
+        template<typename Fn>
+        struct inline_ops
+        {
+            static R invoke(void *storage, Args &&... args)
+            {
+                return call(*std::launder(static_cast<Fn *>(storage)), std::forward<Args>(args)...);
+            }
+
+            static void move(void *dst, void *src) noexcept
+            {
+                Fn *fn = std::launder(static_cast<Fn *>(src));
+                ::new(dst) Fn(std::move(*fn));
+                fn->~Fn();
+            }
+
+            static void destroy(void *storage) noexcept
+            {
+                std::launder(static_cast<Fn *>(storage))->~Fn();
+            }
+
+            static constexpr vtable table { &invoke, &move, &destroy };
+        };
+
+        template<typename Fn>
+        struct heap_ops
+        {
+            static Fn *&target(void *storage) noexcept
+            {
+                return *static_cast<Fn **>(storage);
+            }
+
+            static R invoke(void *storage, Args &&... args)
+            {
+                return call(*target(storage), std::forward<Args>(args)...);
+            }
+
+            static void move(void *dst, void *src) noexcept
+            {
+                ::new(dst) Fn *(target(src));
+            }
+
+            static void destroy(void *storage) noexcept
+            {
+                Fn *fn = target(storage);
+                fn->~Fn();
+                Allocator::deallocate(fn);
+            }
+
+            static constexpr vtable table { &invoke, &move, &destroy };
+        };
+
+    public:
+        unique_function() noexcept = default;
+
+        unique_function(std::nullptr_t) noexcept {}
+
+        template<typename F, typename Fn = std::decay_t<F>>
+            requires (!std::is_same_v<Fn, unique_function> && std::is_invocable_r_v<R, Fn &, Args...>)
+        unique_function(F &&f)
+        {
+            static_assert(alignof(Fn) <= alignof(std::max_align_t), "Over-aligned callables are not supported");
+
+            if constexpr (std::is_pointer_v<Fn> || std::is_member_pointer_v<Fn>)
+            {
+                if (f == nullptr)
+                    return;
+            }
+
+            if constexpr (fits_inline<Fn>)
+            {
+                ::new(static_cast<void *>(storage)) Fn(std::forward<F>(f));
+                ops = &inline_ops<Fn>::table;
+            }
+            else
+            {
+                void *mem = Allocator::allocate(sizeof(Fn));
+                if (!mem)
+                    throw std::bad_alloc();
+                try
+                {
+                    ::new(static_cast<void *>(storage)) Fn *(::new(mem) Fn(std::forward<F>(f)));
+                }
+                catch (...)
+                {
+                    Allocator::deallocate(mem);
+                    throw;
+                }
+                ops = &heap_ops<Fn>::table;
+            }
+        }
+
+        unique_function(unique_function &&other) noexcept : ops(other.ops)
+        {
+            if (ops)
+            {
+                ops->move(storage, other.storage);
+                other.ops = nullptr;
+            }
+        }
+
+        unique_function &operator=(unique_function &&other) noexcept
+        {
+            if (this != &other)
+            {
+                reset();
+                if (other.ops)
+                {
+                    other.ops->move(storage, other.storage);
+                    ops = other.ops;
+                    other.ops = nullptr;
+                }
+            }
+            return *this;
+        }
+
+        unique_function &operator=(std::nullptr_t) noexcept
+        {
+            reset();
+            return *this;
+        }
+
+        template<typename F>
+            requires (!std::is_same_v<std::decay_t<F>, unique_function>)
+        unique_function &operator=(F &&f)
+        {
+            unique_function(std::forward<F>(f)).swap(*this);
+            return *this;
+        }
+
+        unique_function(const unique_function &) = delete;
+
+        unique_function &operator=(const unique_function &) = delete;
+
+        ~unique_function()
+        {
+            reset();
+        }
+
+        /**
+         * @brief Call the target
+         * @throws std::bad_function_call If empty
+         */
+        R operator()(Args... args)
+        {
+            if (!ops)
+                throw std::bad_function_call();
+            return ops->invoke(storage, std::forward<Args>(args)...);
+        }
+
+        explicit operator bool() const noexcept
+        {
+            return ops != nullptr;
+        }
+
+        void swap(unique_function &other) noexcept
+        {
+            unique_function tmp(std::move(other));
+            other = std::move(*this);
+            *this = std::move(tmp);
+        }
+
+        void reset() noexcept
+        {
+            if (ops)
+            {
+                ops->destroy(storage);
+                ops = nullptr;
+            }
+        }
+
+    private:
+        alignas(void *) unsigned char storage[Capacity];
+        const vtable *ops { nullptr };
+    };
+}
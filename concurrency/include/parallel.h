@@ -0,0 +1,575 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <algorithm.h>
+
+#include "executor.h"
+
+namespace ytl
+{
+    namespace detail
+    {
+        struct empty_result {};
+
+        /**
+         * @brief Lazy binary splitting over [begin, end).
+         * The owner walks its range one grain at a time and only forks off the
+         * right half while its own deque is empty, i.e. while nobody has work to
+         * steal. Idle workers therefore drive the amount of splitting and a busy
+         * pool degenerates to a plain loop.
+         */
+        template<typename T, typename Body, typename Reduce>
+        class range_splitter
+        {
+            static constexpr size_t MAX_FORKS = 64;
+
+            struct fork : job
+            {
+                const range_splitter *owner;
+                size_t begin;
+                size_t end;
+                T result;
+                std::atomic<bool> done { false };
+
+                fork(const range_splitter *owner, const size_t begin, const size_t end)
+                    : owner(owner), begin(begin), end(end), result(owner->identity)
+                {
+                    invoke = [](job *self)
+                    {
+                        auto *f = static_cast<fork *>(self);
+                        f->result = f->owner->run(f->begin, f->end);
+                        f->owner->ex.complete(f->done);
+                    };
+                }
+            };
+
+        public:
+            range_splitter(executor &ex, const size_t grain, const T &identity, Body &body, Reduce &reduce)
+                : ex(ex), grain(grain), identity(identity), body(body), reduce(reduce) {}
+
+            T run(size_t begin, size_t end) const
+            {
+                alignas(fork) unsigned char storage[MAX_FORKS][sizeof(fork)];
+                size_t forks = 0;
+
+                T acc = identity;
+                while (begin < end)
+                {
+                    if (end - begin > grain && forks < MAX_FORKS && ex.local_empty())
+                    {
+                        const size_t mid = begin + (end - begin) / 2;
+                        ex.submit(::new(storage[forks++]) fork(this, mid, end));
+                        end = mid;
+                        continue;
+                    }
+
+                    const size_t stop = end - begin > grain ? begin + grain : end;
+                    acc = body(begin, stop, std::move(acc));
+                    begin = stop;
+                }
+
+                while (forks)
+                {
+                    auto *f = std::launder(reinterpret_cast<fork *>(storage[--forks]));
+                    ex.wait(f->done);
+                    acc = reduce(std::move(acc), std::move(f->result));
+                    f->~fork();
+                }
+                return acc;
+            }
+
+        private:
+            executor &ex;
+            size_t grain;
+            T identity;
+            Body &body;
+            Reduce &reduce;
+        };
+
+        template<typename T, typename Body, typename Reduce>
+        T run_range(executor &ex, const size_t begin, const size_t end, size_t grain,
+                     const T &identity, Body &body, Reduce &reduce)
+        {
+            if (begin >= end)
+                return identity;
+
+            if (!grain)
+                grain = ytl::max<size_t>(1, (end - begin) / (8 * ex.size()));
+
+            range_splitter<T, Body, Reduce> splitter(ex, grain, identity, body, reduce);
+            if (end - begin <= grain || ex.is_worker())
+                return splitter.run(begin, end);
+
+            struct root : job
+            {
+                executor *ex;
+                range_splitter<T, Body, Reduce> *splitter;
+                size_t begin;
+                size_t end;
+                T result;
+                std::atomic<bool> done { false };
+            } r { {}, &ex, &splitter, begin, end, identity };
+
+            r.invoke = [](job *self)
+            {
+                auto *r = static_cast<root *>(self);
+                r->result = r->splitter->run(r->begin, r->end);
+                r->ex->complete(r->done);
+            };
+
+            ex.submit(&r);
+            ex.wait(r.done);
+            return std::move(r.result);
+        }
+    }
+
+    /**
+     * @brief Execute fn over [begin, end) on the executor
+     * @tparam Fn Either fn(i) or fn(begin, end) for a contiguous sub-range
+     * @param ex Executor to run on
+     * @param begin First index
+     * @param end One past the last index
+     * @param grain Smallest sub-range handed to fn, 0 picks one from the pool size
+     * @param fn Loop body, must not throw
+     */
+    template<typename Fn>
+    void parallel_for(executor &ex, const size_t begin, const size_t end, const size_t grain, Fn &&fn)
+    {
+        auto body = [&fn](const size_t b, const size_t e, detail::empty_result acc)
+        {
+            if constexpr (std::is_invocable_v<Fn &, size_t, size_t>)
+            {
+                fn(b, e);
+            }
+            else
+            {
+                for (size_t i = b; i < e; ++i)
+                    fn(i);
+            }
+            return acc;
+        };
+        auto reduce = [](detail::empty_result acc, detail::empty_result) { return acc; };
+        detail::run_range(ex, begin, end, grain, detail::empty_result {}, body, reduce);
+    }
+
+    template<typename Fn>
+    void parallel_for(const size_t begin, const size_t end, const size_t grain, Fn &&fn)
+    {
+        parallel_for(executor::global(), begin, end, grain, std::forward<Fn>(fn));
+    }
+
+    /**
+     * @brief Reduce [begin, end) on the executor
+     * @tparam T Result type
+     * @param ex Executor to run on
+     * @param begin First index
+     * @param end One past the last index
+     * @param grain Smallest sub-range handed to fn, 0 picks one from the pool size
+     * @param identity Neutral element of reduce
+     * @param fn fn(begin, end, acc) folds a contiguous sub-range into acc
+     * @param reduce reduce(lhs, rhs) combines partial results, must be associative
+     * @return Reduction of every sub-range in index order
+     */
+    template<typename T, typename Fn, typename Reduce>
+    T parallel_reduce(executor &ex, const size_t begin, const size_t end, const size_t grain,
+                      const T &identity, Fn &&fn, Reduce &&reduce)
+    {
+        return detail::run_range(ex, begin, end, grain, identity, fn, reduce);
+    }
+
+    template<typename T, typename Fn, typename Reduce>
+    T parallel_reduce(const size_t begin, const size_t end, const size_t grain,
+                      const T &identity, Fn &&fn, Reduce &&reduce)
+    {
+        return parallel_reduce(executor::global(), begin, end, grain, identity,
+                               std::forward<Fn>(fn), std::forward<Reduce>(reduce));
+    }
+
+    template<typename T>
+    T parallel_accumulate(const T *t, const size_t n, T init, executor &ex = executor::global())
+    {
+        return init + parallel_reduce(ex, 0, n, 0, T {},
+                                      [t](const size_t b, const size_t e, T acc)
+                                      {
+                                          return ytl::accumulate(t + b, e - b, acc);
+                                      },
+                                      [](T lhs, T rhs) { return lhs + rhs; });
+    }
+
+    template<typename T>
+    size_t parallel_count(const T *t, const size_t n, const T &value, executor &ex = executor::global())
+    {
+        return parallel_reduce(ex, 0, n, 0, size_t { 0 },
+                               [t, &value](const size_t b, const size_t e, const size_t acc)
+                               {
+                                   return acc + ytl::count(t + b, e - b, value);
+                               },
+                               [](const size_t lhs, const size_t rhs) { return lhs + rhs; });
+    }
+
+    template<typename T>
+    void parallel_fill(T *t, const size_t n, const T &value, executor &ex = executor::global())
+    {
+        parallel_for(ex, 0, n, 0, [t, &value](const size_t b, const size_t e)
+        {
+            ytl::fill(t + b, e - b, value);
+        });
+    }
+
+    template<typename T>
+    void parallel_copy(const T *src, T *dest, const size_t n, executor &ex = executor::global())
+    {
+        if (dest < src + n && src < dest + n)
+        {
+            ytl::copy(src, dest, n);
+            return;
+        }
+
+        parallel_for(ex, 0, n, 0, [src, dest](const size_t b, const size_t e)
+        {
+            ytl::copy(src + b, dest + b, e - b);
+        });
+    }
+
+    namespace detail
+    {
+        /**
+         * @brief Parallel sort tuning. Ranges below the threshold are sorted
+         * sequentially. Sample sort cuts the input into about
+         * RANGES_PER_THREAD ranges per worker, so stealing evens out their
+         * sizes, and draws OVERSAMPLING sample elements per range. Selection
+         * keeps SELECT_MARGIN sample ranks on either side of the target
+         * between its pivots, three standard deviations of the sample rank.
+         */
+        constexpr size_t PARALLEL_SORT_THRESHOLD = size_t { 1 } << 16;
+        constexpr size_t MAX_SPLITTERS = 127;
+        constexpr size_t RANGES_PER_THREAD = 8;
+        constexpr size_t MIN_RANGE = size_t { 1 } << 12;
+        constexpr size_t OVERSAMPLING = 32;
+        constexpr size_t SELECT_SAMPLE = 4096;
+        constexpr size_t SELECT_MARGIN = 96;
+        constexpr size_t MIN_CHUNK = size_t { 1 } << 14;
+
+        /**
+         * @brief Uninitialized room for n elements, freed on scope exit
+         */
+        template<typename T>
+        class sort_scratch
+        {
+        public:
+            explicit sort_scratch(const size_t n) : n(n), data(std::allocator<T>().allocate(n))
+            {
+            }
+
+            sort_scratch(const sort_scratch &) = delete;
+
+            sort_scratch &operator=(const sort_scratch &) = delete;
+
+            ~sort_scratch()
+            {
+                std::allocator<T>().deallocate(data, n);
+            }
+
+            T *get() const noexcept
+            {
+                return data;
+            }
+
+        private:
+            size_t n;
+            T *data;
+        };
+
+        inline uint64_t splitmix64(uint64_t &state) noexcept
+        {
+            uint64_t z = state += 0x9e3779b97f4a7c15;
+            z = (z ^ z >> 30) * 0xbf58476d1ce4e5b9;
+            z = (z ^ z >> 27) * 0x94d049bb133111eb;
+            return z ^ z >> 31;
+        }
+
+        /**
+         * @brief Move a random sample of count elements to the front of [t, t + n) and sort it
+         */
+        template<typename T, typename Compare>
+        void sample_front(T *t, const size_t n, const size_t count, Compare &comp)
+        {
+            uint64_t state = n;
+            for (size_t i = 0; i < count; ++i)
+                ytl::swap(t[i], t[i + splitmix64(state) % (n - i)]);
+            ytl::sort(t, count, comp);
+        }
+
+        /**
+         * @brief Move-construct every element of [t, t + n) into buffer, grouped
+         * by bucket. Chunks are classified in parallel and their bucket of each
+         * element remembered, the counts give every chunk its own slots so the
+         * scatter needs no synchronization. The pivots classify compares
+         * against live in the sample at the front, which is therefore moved
+         * last and by the calling thread.
+         * @param sample Length of the sample at the front
+         * @param buckets Number of buckets, at most 256
+         * @param classify classify(x) is the bucket of x
+         * @param begins Receives buckets + 1 offsets of the buckets in buffer
+         */
+        template<typename T, typename Classify>
+        void distribute(executor &ex, T *t, const size_t n, const size_t sample, T *buffer, const size_t buckets,
+                        Classify &classify, size_t *begins)
+        {
+            const size_t rest = n - sample;
+            const size_t chunks = ytl::max<size_t>(1, ytl::min(4 * ex.size(), rest / MIN_CHUNK));
+            const auto first = [=](const size_t c) { return c == chunks ? 0 : sample + rest * c / chunks; };
+            const auto last = [=](const size_t c) { return c == chunks ? sample : sample + rest * (c + 1) / chunks; };
+
+            // Chunk index chunks is the sample
+            std::vector<size_t> offsets((chunks + 1) * buckets);
+            const auto oracle = std::make_unique_for_overwrite<uint8_t[]>(n);
+            parallel_for(ex, 0, chunks + 1, 1, [&](const size_t c)
+            {
+                size_t counts[256] = {};
+                for (size_t i = first(c); i < last(c); ++i)
+                {
+                    const size_t b = classify(t[i]);
+                    oracle[i] = static_cast<uint8_t>(b);
+                    counts[b]++;
+                }
+                ytl::copy(counts, offsets.data() + c * buckets, buckets);
+            });
+
+            size_t offset = 0;
+            for (size_t b = 0; b < buckets; ++b)
+            {
+                begins[b] = offset;
+                for (size_t c = 0; c <= chunks; ++c)
+                {
+                    const size_t count = offsets[c * buckets + b];
+                    offsets[c * buckets + b] = offset;
+                    offset += count;
+                }
+            }
+            begins[buckets] = offset;
+
+            auto scatter = [&](const size_t c)
+            {
+                size_t *slot = offsets.data() + c * buckets;
+                for (size_t i = first(c); i < last(c); ++i)
+                    ::new(static_cast<void *>(buffer + slot[oracle[i]]++)) T(std::move(t[i]));
+            };
+            parallel_for(ex, 0, chunks, 1, scatter);
+            scatter(chunks);
+        }
+
+        /**
+         * @brief Move [src, src + n) back over dest and destroy the source
+         */
+        template<typename T>
+        void move_back(T *dest, T *src, const size_t n)
+        {
+            for (size_t i = 0; i < n; ++i)
+            {
+                dest[i] = std::move(src[i]);
+                src[i].~T();
+            }
+        }
+
+        template<typename T, typename Compare>
+        bool parallel_is_sorted(executor &ex, const T *t, const size_t n, Compare &comp)
+        {
+            return parallel_reduce(ex, 0, n - 1, 0, true,
+                                   [t, &comp](const size_t b, const size_t e, bool acc)
+                                   {
+                                       for (size_t i = b; acc && i < e; ++i)
+                                           acc = !comp(t[i + 1], t[i]);
+                                       return acc;
+                                   },
+                                   [](const bool lhs, const bool rhs) { return lhs && rhs; });
+        }
+
+        /**
+         * @brief Sample sort. Splitters drawn from a sorted sample cut the input
+         * into ranges, one distribution pass moves each element to its range in
+         * a buffer, and the ranges are sorted and moved back in parallel. Equal
+         * splitters are merged and every splitter gets a bucket of the elements
+         * equal to it, which needs no sorting, so heavy keys do not pile up in
+         * one range.
+         */
+        template<typename T, typename Compare>
+        void sample_sort(executor &ex, T *t, const size_t n, Compare &comp)
+        {
+            if (parallel_is_sorted(ex, t, n, comp))
+                return;
+
+            const size_t ranges = ytl::min(ytl::min(MAX_SPLITTERS + 1, RANGES_PER_THREAD * ex.size()), n / MIN_RANGE);
+            const size_t sample = ranges * OVERSAMPLING;
+            sample_front(t, n, sample, comp);
+
+            const T *splitters[MAX_SPLITTERS];
+            size_t count = 0;
+            for (size_t i = 1; i < ranges; ++i)
+            {
+                const T *s = t + i * OVERSAMPLING;
+                if (!count || comp(*splitters[count - 1], *s))
+                    splitters[count++] = s;
+            }
+
+            // Bucket 2j holds the elements between splitters j - 1 and j, bucket 2j + 1 those equal to splitter j
+            auto classify = [&](const T &x) -> size_t
+            {
+                // Branchless upper bound, the comparisons are unpredictable by design
+                size_t lo = 0;
+                for (size_t len = count; len > 1; len -= len / 2)
+                    lo = comp(x, *splitters[lo + len / 2]) ? lo : lo + len / 2;
+                lo += !comp(x, *splitters[lo]);
+                return lo && !comp(*splitters[lo - 1], x) ? 2 * lo - 1 : 2 * lo;
+            };
+
+            const size_t buckets = 2 * count + 1;
+            size_t begins[2 * MAX_SPLITTERS + 2];
+            sort_scratch<T> scratch(n);
+            T *buffer = scratch.get();
+            distribute(ex, t, n, sample, buffer, buckets, classify, begins);
+            parallel_for(ex, 0, buckets, 1, [&](const size_t b)
+            {
+                const size_t size = begins[b + 1] - begins[b];
+                if (!(b & 1))
+                    ytl::sort(buffer + begins[b], size, comp);
+                move_back(t + begins[b], buffer + begins[b], size);
+            });
+        }
+
+        /**
+         * @brief Sample select. Two pivots from a sorted sample bracket the
+         * target rank, one distribution pass splits the range into the elements
+         * below, between and above them, and the part holding the target is
+         * narrowed down the same way until it is small enough for nth_element.
+         */
+        template<typename T, typename Compare>
+        void sample_select(executor &ex, T *t, const size_t n, const size_t nth, Compare &comp)
+        {
+            sort_scratch<T> scratch(n);
+            T *buffer = scratch.get();
+            size_t begin = 0;
+            size_t end = n;
+            while (end - begin >= PARALLEL_SORT_THRESHOLD)
+            {
+                T *range = t + begin;
+                const size_t size = end - begin;
+                const size_t target = nth - begin;
+                sample_front(range, size, SELECT_SAMPLE, comp);
+
+                const size_t rank = static_cast<size_t>(static_cast<double>(target) / static_cast<double>(size) *
+                                                        SELECT_SAMPLE);
+                const T &low = range[rank > SELECT_MARGIN ? rank - SELECT_MARGIN : 0];
+                const T &high = range[ytl::min(rank + SELECT_MARGIN, SELECT_SAMPLE - 1)];
+                const bool flat = !comp(low, high);
+                // Nothing is both below low and above high, so the two tests add up to the part
+                auto classify = [&](const T &x) -> size_t
+                {
+                    return static_cast<size_t>(!comp(x, low)) + static_cast<size_t>(comp(high, x));
+                };
+
+                size_t begins[4];
+                distribute(ex, range, size, SELECT_SAMPLE, buffer, 3, classify, begins);
+                parallel_for(ex, 0, size, 0, [&](const size_t b, const size_t e)
+                {
+                    move_back(range + b, buffer + b, e - b);
+                });
+
+                const size_t part = target < begins[1] ? 0 : target < begins[2] ? 1 : 2;
+                // Between two equal pivots every element is equal, the target is in place
+                if (part == 1 && flat)
+                    return;
+                if (begins[part + 1] - begins[part] == size)
+                    break;
+                end = begin + begins[part + 1];
+                begin += begins[part];
+            }
+            ytl::nth_element(t + begin, end - begin, nth - begin, comp);
+        }
+    }
+
+    /**
+     * @brief Sort on the executor, sample sort above a sequential cutoff and
+     * sort below it. Takes a buffer of n elements. Not stable.
+     * @param t Elements to sort
+     * @param n Number of elements
+     * @param comp Strict weak ordering, called concurrently, must not throw
+     * @param ex Executor to run on
+     */
+    template<typename T, typename Compare>
+        requires std::is_invocable_r_v<bool, Compare &, const T &, const T &>
+    void parallel_sort(T *t, const size_t n, Compare comp, executor &ex = executor::global())
+    {
+        if (n < detail::PARALLEL_SORT_THRESHOLD || ex.size() < 2)
+        {
+            ytl::sort(t, n, comp);
+            return;
+        }
+        detail::sample_sort(ex, t, n, comp);
+    }
+
+    template<typename T>
+    void parallel_sort(T *t, const size_t n, executor &ex = executor::global())
+    {
+        parallel_sort(t, n, less(), ex);
+    }
+
+    /**
+     * @brief Rearrange so that t[nth] is the element a sort would put there,
+     * with no greater element before and no smaller one after it. Selects on
+     * the executor above a sequential cutoff and takes a buffer of n elements.
+     * @param comp Strict weak ordering, called concurrently, must not throw
+     * @param ex Executor to run on
+     */
+    template<typename T, typename Compare>
+        requires std::is_invocable_r_v<bool, Compare &, const T &, const T &>
+    void parallel_nth_element(T *t, const size_t n, const size_t nth, Compare comp,
+                              executor &ex = executor::global())
+    {
+        if (nth >= n)
+            return;
+        if (n < detail::PARALLEL_SORT_THRESHOLD || ex.size() < 2)
+        {
+            ytl::nth_element(t, n, nth, comp);
+            return;
+        }
+        detail::sample_select(ex, t, n, nth, comp);
+    }
+
+    template<typename T>
+    void parallel_nth_element(T *t, const size_t n, const size_t nth, executor &ex = executor::global())
+    {
+        parallel_nth_element(t, n, nth, less(), ex);
+    }
+
+    /**
+     * @brief Sort the m smallest elements into [t, t + m), the rest is left in
+     * unspecified order. Selects the m-th element and sorts what is before it.
+     * @param comp Strict weak ordering, called concurrently, must not throw
+     * @param ex Executor to run on
+     */
+    template<typename T, typename Compare>
+        requires std::is_invocable_r_v<bool, Compare &, const T &, const T &>
+    void parallel_partial_sort(T *t, const size_t n, const size_t m, Compare comp,
+                               executor &ex = executor::global())
+    {
+        if (!m)
+            return;
+        parallel_nth_element(t, n, m, comp, ex);
+        parallel_sort(t, ytl::min(m, n), comp, ex);
+    }
+
+    template<typename T>
+    void parallel_partial_sort(T *t, const size_t n, const size_t m, executor &ex = executor::global())
+    {
+        parallel_partial_sort(t, n, m, less(), ex);
+    }
+}
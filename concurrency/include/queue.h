@@ -0,0 +1,562 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "sync.h"
+
+namespace ytl
+{
+    inline constexpr size_t QUEUE_CACHE_LINE = 64;
+
+    namespace detail
+    {
+        constexpr size_t round_pow2(size_t n) noexcept
+        {
+            size_t p = 1;
+            while (p < n)
+                p <<= 1;
+            return p;
+        }
+    }
+
+    /**
+     * @brief Wait strategy that never sleeps: pause, then yield the time slice.
+     * Lowest hand-off latency, burns a core while the queue is idle.
+     */
+    struct spin_wait
+    {
+        static constexpr uint32_t SPINS_BEFORE_YIELD = 128;
+
+        /**
+         * @brief Back off for one retry round
+         * @return Whether the caller should park now, never for this strategy
+         */
+        bool spin(const uint32_t round) noexcept
+        {
+            if (round < SPINS_BEFORE_YIELD)
+                detail::cpu_relax();
+            else
+                std::this_thread::yield();
+            return false;
+        }
+
+        uint32_t prepare() noexcept
+        {
+            return 0;
+        }
+
+        void wait(uint32_t) noexcept {}
+
+        void cancel() noexcept {}
+
+        void notify() noexcept {}
+    };
+
+    /**
+     * @brief Wait strategy that spins briefly and then parks on a futex.
+     * A thread registers as a waiter only on the round it parks, so producers
+     * and consumers only pay for a wake-up when somebody is parked.
+     */
+    struct blocking_wait
+    {
+        static constexpr uint32_t SPINS_BEFORE_PARK = 256;
+
+        bool spin(const uint32_t round) noexcept
+        {
+            if (round >= SPINS_BEFORE_PARK)
+                return true;
+            detail::cpu_relax();
+            return false;
+        }
+
+        /**
+         * @brief Register as a waiter, the caller retries once more before it parks
+         * @return Epoch to pass to wait
+         */
+        uint32_t prepare() noexcept
+        {
+            waiters.fetch_add(1, std::memory_order_seq_cst);
+            return epoch.load(std::memory_order_seq_cst);
+        }
+
+        void wait(const uint32_t seen) noexcept
+        {
+            epoch.wait(seen, std::memory_order_seq_cst);
+            waiters.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        void cancel() noexcept
+        {
+            waiters.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        void notify() noexcept
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (waiters.load(std::memory_order_relaxed))
+            {
+                epoch.fetch_add(1, std::memory_order_seq_cst);
+                epoch.notify_all();
+            }
+        }
+
+        /**
+         * @brief Number of notify calls that found a parked or parking waiter
+         */
+        [[nodiscard]] uint32_t wakeups() const noexcept
+        {
+            return epoch.load(std::memory_order_relaxed);
+        }
+
+    private:
+        std::atomic<uint32_t> epoch { 0 };
+        std::atomic<uint32_t> waiters { 0 };
+    };
+
+    /**
+     * @brief Bounded single-producer single-consumer ring buffer.
+     * Head and tail live on separate cache lines and each side caches the
+     * other's index, so the common case touches no shared line.
+     * @tparam T Element type
+     * @tparam Wait Wait strategy used by the blocking push/pop
+     */
+    template<typename T, typename Wait = spin_wait>
+    class spsc_queue
+    {
+    public:
+        /**
+         * @brief Create a queue
+         * @param capacity Minimum number of elements, rounded up to a power of two
+         */
+        explicit spsc_queue(const size_t capacity)
+            : mask(detail::round_pow2(capacity < 2 ? 2 : capacity) - 1),
+              slots(static_cast<T *>(::operator new((mask + 1) * sizeof(T), std::align_val_t { alignof(T) }))) {}
+
+        ~spsc_queue()
+        {
+            if constexpr (!std::is_trivially_destructible_v<T>)
+            {
+                T tmp;
+                while (try_pop(tmp)) {}
+            }
+            ::operator delete(slots, std::align_val_t { alignof(T) });
+        }
+
+        spsc_queue(const spsc_queue &) = delete;
+
+        spsc_queue &operator=(const spsc_queue &) = delete;
+
+        template<typename... Args>
+        bool try_emplace(Args &&... args)
+        {
+            const size_t t = tail.load(std::memory_order_relaxed);
+            if (t - head_cache > mask)
+            {
+                head_cache = head.load(std::memory_order_acquire);
+                if (t - head_cache > mask)
+                    return false;
+            }
+
+            ::new(&slots[t & mask]) T(std::forward<Args>(args)...);
+            tail.store(t + 1, std::memory_order_release);
+            not_empty.notify();
+            return true;
+        }
+
+        bool try_push(const T &value)
+        {
+            return try_emplace(value);
+        }
+
+        bool try_push(T &&value)
+        {
+            return try_emplace(std::move(value));
+        }
+
+        bool try_pop(T &out)
+        {
+            const size_t h = head.load(std::memory_order_relaxed);
+            if (h == tail_cache)
+            {
+                tail_cache = tail.load(std::memory_order_acquire);
+                if (h == tail_cache)
+                    return false;
+            }
+
+            T *slot = std::launder(&slots[h & mask]);
+            out = std::move(*slot);
+            slot->~T();
+            head.store(h + 1, std::memory_order_release);
+            not_full.notify();
+            return true;
+        }
+
+        /**
+         * @brief Push up to n elements with a single index publication
+         * @return Number of elements pushed, moved-from in items
+         */
+        size_t try_push_batch(T *items, const size_t n)
+        {
+            const size_t t = tail.load(std::memory_order_relaxed);
+            size_t room = mask + 1 - (t - head_cache);
+            if (room < n)
+            {
+                head_cache = head.load(std::memory_order_acquire);
+                room = mask + 1 - (t - head_cache);
+            }
+
+            const size_t count = n < room ? n : room;
+            for (size_t i = 0; i < count; ++i)
+                ::new(&slots[(t + i) & mask]) T(std::move(items[i]));
+
+            if (count)
+            {
+                tail.store(t + count, std::memory_order_release);
+                not_empty.notify();
+            }
+            return count;
+        }
+
+        /**
+         * @brief Pop up to n elements with a single index publication
+         * @return Number of elements written to out
+         */
+        size_t try_pop_batch(T *out, const size_t n)
+        {
+            const size_t h = head.load(std::memory_order_relaxed);
+            size_t avail = tail_cache - h;
+            if (avail < n)
+            {
+                tail_cache = tail.load(std::memory_order_acquire);
+                avail = tail_cache - h;
+            }
+
+            const size_t count = n < avail ? n : avail;
+            for (size_t i = 0; i < count; ++i)
+            {
+                T *slot = std::launder(&slots[(h + i) & mask]);
+                out[i] = std::move(*slot);
+                slot->~T();
+            }
+
+            if (count)
+            {
+                head.store(h + count, std::memory_order_release);
+                not_full.notify();
+            }
+            return count;
+        }
+
+        void push(T value)
+        {
+            for (uint32_t round = 0; !try_push(std::move(value)); ++round)
+            {
+                if (!not_full.spin(round))
+                    continue;
+                const uint32_t seen = not_full.prepare();
+                if (try_push(std::move(value)))
+                {
+                    not_full.cancel();
+                    return;
+                }
+                not_full.wait(seen);
+            }
+        }
+
+        T pop()
+        {
+            T out;
+            for (uint32_t round = 0; !try_pop(out); ++round)
+            {
+                if (!not_empty.spin(round))
+                    continue;
+                const uint32_t seen = not_empty.prepare();
+                if (try_pop(out))
+                {
+                    not_empty.cancel();
+                    break;
+                }
+                not_empty.wait(seen);
+            }
+            return out;
+        }
+
+        [[nodiscard]] size_t size() const noexcept
+        {
+            return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+        }
+
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return size() == 0;
+        }
+
+        [[nodiscard]] size_t capacity() const noexcept
+        {
+            return mask + 1;
+        }
+
+    private:
+        const size_t mask;
+        T *const slots;
+
+        alignas(QUEUE_CACHE_LINE) std::atomic<size_t> tail { 0 };
+        size_t head_cache { 0 };
+        Wait not_empty {};
+
+        alignas(QUEUE_CACHE_LINE) std::atomic<size_t> head { 0 };
+        size_t tail_cache { 0 };
+        Wait not_full {};
+    };
+
+    /**
+     * @brief Bounded multi-producer multi-consumer queue (Vyukov).
+     * Every cell carries a sequence number that tells producers and consumers
+     * which lap it belongs to, so each operation is one CAS on the position
+     * counter plus one release store on the cell.
+     * @tparam T Element type
+     * @tparam Wait Wait strategy used by the blocking push/pop
+     */
+    template<typename T, typename Wait = spin_wait>
+    class mpmc_queue
+    {
+        struct cell
+        {
+            std::atomic<size_t> sequence;
+            alignas(T) unsigned char storage[sizeof(T)];
+
+            T *value() noexcept
+            {
+                return std::launder(reinterpret_cast<T *>(storage));
+            }
+        };
+
+    public:
+        /**
+         * @brief Create a queue
+         * @param capacity Minimum number of elements, rounded up to a power of two
+         */
+        explicit mpmc_queue(const size_t capacity)
+            : mask(detail::round_pow2(capacity < 2 ? 2 : capacity) - 1),
+              cells(new cell[mask + 1])
+        {
+            for (size_t i = 0; i <= mask; ++i)
+                cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        ~mpmc_queue()
+        {
+            if constexpr (!std::is_trivially_destructible_v<T>)
+            {
+                T tmp;
+                while (try_pop(tmp)) {}
+            }
+            delete[] cells;
+        }
+
+        mpmc_queue(const mpmc_queue &) = delete;
+
+        mpmc_queue &operator=(const mpmc_queue &) = delete;
+
+        template<typename... Args>
+        bool try_emplace(Args &&... args)
+        {
+            size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+            cell *c;
+            while (true)
+            {
+                c = &cells[pos & mask];
+                const size_t seq = c->sequence.load(std::memory_order_acquire);
+                const auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+                if (diff == 0)
+                {
+                    if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (diff < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    pos = enqueue_pos.load(std::memory_order_relaxed);
+                }
+            }
+
+            ::new(c->storage) T(std::forward<Args>(args)...);
+            c->sequence.store(pos + 1, std::memory_order_release);
+            not_empty.notify();
+            return true;
+        }
+
+        bool try_push(const T &value)
+        {
+            return try_emplace(value);
+        }
+
+        bool try_push(T &&value)
+        {
+            return try_emplace(std::move(value));
+        }
+
+        bool try_pop(T &out)
+        {
+            size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+            cell *c;
+            while (true)
+            {
+                c = &cells[pos & mask];
+                const size_t seq = c->sequence.load(std::memory_order_acquire);
+                const auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+                if (diff == 0)
+                {
+                    if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (diff < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    pos = dequeue_pos.load(std::memory_order_relaxed);
+                }
+            }
+
+            out = std::move(*c->value());
+            c->value()->~T();
+            c->sequence.store(pos + mask + 1, std::memory_order_release);
+            not_full.notify();
+            return true;
+        }
+
+        /**
+         * @brief Claim a run of free cells with one CAS and fill them
+         * @return Number of elements pushed, moved-from in items
+         */
+        size_t try_push_batch(T *items, const size_t n)
+        {
+            size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+            size_t count;
+            do
+            {
+                count = 0;
+                while (count < n && count <= mask &&
+                       cells[(pos + count) & mask].sequence.load(std::memory_order_acquire) == pos + count)
+                    ++count;
+                if (!count)
+                    return 0;
+            }
+            while (!enqueue_pos.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed));
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                cell &c = cells[(pos + i) & mask];
+                ::new(c.storage) T(std::move(items[i]));
+                c.sequence.store(pos + i + 1, std::memory_order_release);
+            }
+            not_empty.notify();
+            return count;
+        }
+
+        /**
+         * @brief Claim a run of filled cells with one CAS and drain them
+         * @return Number of elements written to out
+         */
+        size_t try_pop_batch(T *out, const size_t n)
+        {
+            size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+            size_t count;
+            do
+            {
+                count = 0;
+                while (count < n && count <= mask &&
+                       cells[(pos + count) & mask].sequence.load(std::memory_order_acquire) == pos + count + 1)
+                    ++count;
+                if (!count)
+                    return 0;
+            }
+            while (!dequeue_pos.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed));
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                cell &c = cells[(pos + i) & mask];
+                out[i] = std::move(*c.value());
+                c.value()->~T();
+                c.sequence.store(pos + i + mask + 1, std::memory_order_release);
+            }
+            not_full.notify();
+            return count;
+        }
+
+        void push(T value)
+        {
+            for (uint32_t round = 0; !try_push(std::move(value)); ++round)
+            {
+                if (!not_full.spin(round))
+                    continue;
+                const uint32_t seen = not_full.prepare();
+                if (try_push(std::move(value)))
+                {
+                    not_full.cancel();
+                    return;
+                }
+                not_full.wait(seen);
+            }
+        }
+
+        T pop()
+        {
+            T out;
+            for (uint32_t round = 0; !try_pop(out); ++round)
+            {
+                if (!not_empty.spin(round))
+                    continue;
+                const uint32_t seen = not_empty.prepare();
+                if (try_pop(out))
+                {
+                    not_empty.cancel();
+                    break;
+                }
+                not_empty.wait(seen);
+            }
+            return out;
+        }
+
+        /**
+         * @brief Approximate number of queued elements
+         */
+        [[nodiscard]] size_t size() const noexcept
+        {
+            const size_t tail = enqueue_pos.load(std::memory_order_acquire);
+            const size_t head = dequeue_pos.load(std::memory_order_acquire);
+            return tail > head ? tail - head : 0;
+        }
+
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return size() == 0;
+        }
+
+        [[nodiscard]] size_t capacity() const noexcept
+        {
+            return mask + 1;
+        }
+
+    private:
+        const size_t mask;
+        cell *const cells;
+
+        alignas(QUEUE_CACHE_LINE) std::atomic<size_t> enqueue_pos { 0 };
+        Wait not_empty {};
+
+        alignas(QUEUE_CACHE_LINE) std::atomic<size_t> dequeue_pos { 0 };
+        Wait not_full {};
+    };
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "executor.h"
+#include "function.h"
+
+namespace ytl
+{
+    /**
+     * @brief Serial executor on top of a pool.
+     * Functions posted to the same strand run one at a time in FIFO order,
+     * different strands run in parallel. Posting is lock-free: messages go
+     * into an intrusive MPSC mailbox and the strand is scheduled as a single
+     * job whenever its running flag flips from idle to busy.
+     */
+    class strand
+    {
+    public:
+        /**
+         * @brief Create a strand
+         * @param ex Pool the strand's work runs on
+         */
+        explicit strand(executor &ex = executor::global());
+
+        /**
+         * @brief Block until every posted function has run. Must not be called
+         * from the strand itself or race with further posts.
+         */
+        ~strand();
+
+        strand(const strand &) = delete;
+
+        strand &operator=(const strand &) = delete;
+
+        /**
+         * @brief Queue a function behind everything already posted to this strand
+         * @tparam Fn Function or lambda type
+         * @param fn Function to execute, must not throw
+         */
+        template<typename Fn>
+            requires std::is_invocable_v<std::decay_t<Fn> &>
+        void post(Fn &&fn)
+        {
+            enqueue(new message(std::forward<Fn>(fn)));
+        }
+
+        /**
+         * @brief Whether the calling thread is currently running this strand's work
+         */
+        [[nodiscard]] bool running_in_this_thread() const noexcept;
+
+        [[nodiscard]] executor &context() const noexcept
+        {
+            return ex;
+        }
+
+    private:
+        /**
+         * @brief Messages run per scheduling round before the strand yields its worker
+         */
+        static constexpr size_t BATCH = 64;
+
+        struct message
+        {
+            std::atomic<message *> next { nullptr };
+            unique_function<void()> fn;
+
+            message() = default;
+
+            template<typename Fn>
+            explicit message(Fn &&f) : fn(std::forward<Fn>(f)) {}
+        };
+
+        struct runner : detail::job
+        {
+            strand *owner;
+
+            explicit runner(strand *owner) : owner(owner)
+            {
+                invoke = &strand::drain;
+            }
+        };
+
+        static thread_local const strand *current;
+
+        executor &ex;
+        runner job { this };
+        message stub;
+
+        alignas(QUEUE_CACHE_LINE) std::atomic<message *> tail { &stub };
+        alignas(QUEUE_CACHE_LINE) message *head { &stub };
+        std::atomic<bool> running { false };
+        std::atomic<uint32_t> draining { 0 };
+
+        void enqueue(message *msg);
+
+        message *pop() noexcept;
+
+        static void drain(detail::job *job);
+    };
+}
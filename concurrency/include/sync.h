@@ -0,0 +1,483 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace ytl
+{
+    namespace detail
+    {
+        inline void cpu_relax() noexcept
+        {
+#if defined(__x86_64__) || defined(__i386__)
+            _mm_pause();
+#elif defined(__aarch64__)
+            asm volatile("yield");
+#endif
+        }
+
+        /**
+         * @brief Pause while the holder is likely running, yield once the wait
+         * suggests it was preempted so an oversubscribed machine still progresses
+         */
+        inline void spin_backoff(uint32_t &polls, const uint32_t pauses = 1) noexcept
+        {
+            static constexpr uint32_t YIELD_AFTER = 1024;
+            if (++polls < YIELD_AFTER)
+            {
+                for (uint32_t i = pauses; i; --i)
+                    cpu_relax();
+            }
+            else
+                std::this_thread::yield();
+        }
+
+        /**
+         * @brief Sleep while word still holds expected, spurious wake-ups are possible
+         */
+        void futex_wait(std::atomic<uint32_t> &word, uint32_t expected) noexcept;
+
+        void futex_wake_one(std::atomic<uint32_t> &word) noexcept;
+
+        void futex_wake_all(std::atomic<uint32_t> &word) noexcept;
+
+        /**
+         * @brief Counter only written by the current lock holder, readable from anywhere
+         */
+        inline void bump(std::atomic<uint64_t> &counter) noexcept
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Contention counters, read with stats() on any primitive
+     */
+    struct lock_stats
+    {
+        uint64_t acquisitions { 0 };
+        uint64_t contended { 0 };
+        uint64_t parked { 0 };
+    };
+
+    /**
+     * @brief FIFO spinlock, waiters back off proportionally to their distance from the head
+     */
+    class ticket_lock
+    {
+    public:
+        void lock() noexcept
+        {
+            const uint32_t ticket = next.fetch_add(1, std::memory_order_relaxed);
+            uint32_t current = serving.load(std::memory_order_acquire);
+            if (current != ticket)
+            {
+                contended.fetch_add(1, std::memory_order_relaxed);
+                uint32_t polls = 0;
+                do
+                {
+                    detail::spin_backoff(polls, (ticket - current) * BACKOFF);
+                    current = serving.load(std::memory_order_acquire);
+                }
+                while (current != ticket);
+            }
+            detail::bump(acquisitions);
+        }
+
+        bool try_lock() noexcept
+        {
+            uint32_t current = serving.load(std::memory_order_relaxed);
+            if (!next.compare_exchange_strong(current, current + 1, std::memory_order_acquire,
+                                              std::memory_order_relaxed))
+                return false;
+            detail::bump(acquisitions);
+            return true;
+        }
+
+        void unlock() noexcept
+        {
+            serving.store(serving.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        [[nodiscard]] lock_stats stats() const noexcept
+        {
+            return { acquisitions.load(std::memory_order_relaxed), contended.load(std::memory_order_relaxed), 0 };
+        }
+
+    private:
+        static constexpr uint32_t BACKOFF = 16;
+
+        std::atomic<uint32_t> next { 0 };
+        std::atomic<uint32_t> serving { 0 };
+        std::atomic<uint64_t> acquisitions { 0 };
+        std::atomic<uint64_t> contended { 0 };
+    };
+
+    /**
+     * @brief MCS queue lock, every waiter spins on its own cache line.
+     * Each acquisition needs a node that stays alive until unlock, the
+     * scoped guard keeps it on the stack.
+     */
+    class mcs_lock
+    {
+    public:
+        struct alignas(64) node
+        {
+            std::atomic<node *> next { nullptr };
+            std::atomic<bool> locked { false };
+        };
+
+        class scoped
+        {
+        public:
+            explicit scoped(mcs_lock &lock) noexcept : lock(lock)
+            {
+                lock.lock(self);
+            }
+
+            ~scoped()
+            {
+                lock.unlock(self);
+            }
+
+            scoped(const scoped &) = delete;
+
+            scoped &operator=(const scoped &) = delete;
+
+        private:
+            mcs_lock &lock;
+            node self;
+        };
+
+        void lock(node &self) noexcept
+        {
+            self.next.store(nullptr, std::memory_order_relaxed);
+            self.locked.store(true, std::memory_order_relaxed);
+
+            if (node *prev = tail.exchange(&self, std::memory_order_acq_rel))
+            {
+                contended.fetch_add(1, std::memory_order_relaxed);
+                prev->next.store(&self, std::memory_order_release);
+                uint32_t polls = 0;
+                while (self.locked.load(std::memory_order_acquire))
+                    detail::spin_backoff(polls);
+            }
+            detail::bump(acquisitions);
+        }
+
+        bool try_lock(node &self) noexcept
+        {
+            self.next.store(nullptr, std::memory_order_relaxed);
+            node *expected = nullptr;
+            if (!tail.compare_exchange_strong(expected, &self, std::memory_order_acquire, std::memory_order_relaxed))
+                return false;
+            detail::bump(acquisitions);
+            return true;
+        }
+
+        void unlock(node &self) noexcept
+        {
+            node *succ = self.next.load(std::memory_order_acquire);
+            if (!succ)
+            {
+                node *expected = &self;
+                if (tail.compare_exchange_strong(expected, nullptr, std::memory_order_release,
+                                                 std::memory_order_relaxed))
+                    return;
+
+                uint32_t polls = 0;
+                while (!(succ = self.next.load(std::memory_order_acquire)))
+                    detail::spin_backoff(polls);
+            }
+            succ->locked.store(false, std::memory_order_release);
+        }
+
+        [[nodiscard]] lock_stats stats() const noexcept
+        {
+            return { acquisitions.load(std::memory_order_relaxed), contended.load(std::memory_order_relaxed), 0 };
+        }
+
+    private:
+        std::atomic<node *> tail { nullptr };
+        std::atomic<uint64_t> acquisitions { 0 };
+        std::atomic<uint64_t> contended { 0 };
+    };
+
+    /**
+     * @brief Mutex that spins for a bounded number of rounds before parking on a futex.
+     * Uncontended lock and unlock are a single atomic each, the kernel is only
+     * entered when a waiter actually sleeps.
+     */
+    class adaptive_mutex
+    {
+    public:
+        void lock() noexcept
+        {
+            uint32_t expected = UNLOCKED;
+            if (!word.compare_exchange_strong(expected, LOCKED, std::memory_order_acquire, std::memory_order_relaxed))
+                lock_slow();
+            detail::bump(acquisitions);
+        }
+
+        bool try_lock() noexcept
+        {
+            uint32_t expected = UNLOCKED;
+            if (!word.compare_exchange_strong(expected, LOCKED, std::memory_order_acquire, std::memory_order_relaxed))
+                return false;
+            detail::bump(acquisitions);
+            return true;
+        }
+
+        void unlock() noexcept
+        {
+            if (word.exchange(UNLOCKED, std::memory_order_release) == PARKED)
+                detail::futex_wake_one(word);
+        }
+
+        [[nodiscard]] lock_stats stats() const noexcept
+        {
+            return {
+                acquisitions.load(std::memory_order_relaxed),
+                contended.load(std::memory_order_relaxed),
+                parked.load(std::memory_order_relaxed)
+            };
+        }
+
+    private:
+        static constexpr uint32_t UNLOCKED = 0;
+        static constexpr uint32_t LOCKED = 1;
+        static constexpr uint32_t PARKED = 2;
+        static constexpr uint32_t SPIN_ROUNDS = 100;
+
+        std::atomic<uint32_t> word { UNLOCKED };
+        std::atomic<uint64_t> acquisitions { 0 };
+        std::atomic<uint64_t> contended { 0 };
+        std::atomic<uint64_t> parked { 0 };
+
+        void lock_slow() noexcept;
+    };
+
+    /**
+     * @brief Manual-reset event, waiters park on a futex until it is set
+     */
+    class event
+    {
+    public:
+        void set() noexcept
+        {
+            if (state.exchange(1, std::memory_order_release) == 0)
+                detail::futex_wake_all(state);
+        }
+
+        void reset() noexcept
+        {
+            state.store(0, std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] bool is_set() const noexcept
+        {
+            return state.load(std::memory_order_acquire) != 0;
+        }
+
+        void wait() noexcept
+        {
+            while (!state.load(std::memory_order_acquire))
+            {
+                parked.fetch_add(1, std::memory_order_relaxed);
+                detail::futex_wait(state, 0);
+            }
+        }
+
+        [[nodiscard]] lock_stats stats() const noexcept
+        {
+            return { 0, 0, parked.load(std::memory_order_relaxed) };
+        }
+
+    private:
+        std::atomic<uint32_t> state { 0 };
+        std::atomic<uint64_t> parked { 0 };
+    };
+
+    /**
+     * @brief Single-use countdown, wait returns once the count reaches zero
+     */
+    class latch
+    {
+    public:
+        explicit latch(const uint32_t count) noexcept : count(count) {}
+
+        void count_down(const uint32_t n = 1) noexcept
+        {
+            if (count.fetch_sub(n, std::memory_order_acq_rel) == n)
+                detail::futex_wake_all(count);
+        }
+
+        [[nodiscard]] bool try_wait() const noexcept
+        {
+            return count.load(std::memory_order_acquire) == 0;
+        }
+
+        void wait() noexcept
+        {
+            for (uint32_t current; (current = count.load(std::memory_order_acquire)) != 0;)
+            {
+                parked.fetch_add(1, std::memory_order_relaxed);
+                detail::futex_wait(count, current);
+            }
+        }
+
+        void arrive_and_wait(const uint32_t n = 1) noexcept
+        {
+            count_down(n);
+            wait();
+        }
+
+        [[nodiscard]] lock_stats stats() const noexcept
+        {
+            return { 0, 0, parked.load(std::memory_order_relaxed) };
+        }
+
+    private:
+        std::atomic<uint32_t> count;
+        std::atomic<uint64_t> parked { 0 };
+    };
+
+    /**
+     * @brief Reusable barrier for a fixed number of participants
+     */
+    class barrier
+    {
+    public:
+        explicit barrier(const uint32_t participants) noexcept
+            : expected(participants), remaining(participants) {}
+
+        void arrive_and_wait() noexcept
+        {
+            const uint32_t gen = generation.load(std::memory_order_acquire);
+            if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                remaining.store(expected, std::memory_order_relaxed);
+                generation.store(gen + 1, std::memory_order_release);
+                detail::futex_wake_all(generation);
+                return;
+            }
+
+            while (generation.load(std::memory_order_acquire) == gen)
+            {
+                parked.fetch_add(1, std::memory_order_relaxed);
+                detail::futex_wait(generation, gen);
+            }
+        }
+
+        [[nodiscard]] lock_stats stats() const noexcept
+        {
+            return { 0, 0, parked.load(std::memory_order_relaxed) };
+        }
+
+    private:
+        const uint32_t expected;
+        std::atomic<uint32_t> remaining;
+        std::atomic<uint32_t> generation { 0 };
+        std::atomic<uint64_t> parked { 0 };
+    };
+
+    /**
+     * @brief Sequence lock for read-mostly data.
+     * Readers never write shared memory and retry if a write overlapped,
+     * writers are serialized by the sequence word itself. The payload is
+     * kept as relaxed atomic words so concurrent copies are well defined.
+     * @tparam T Trivially copyable payload
+     */
+    template<typename T>
+    class seqlock
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "seqlock payload must be trivially copyable");
+
+        static constexpr size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    public:
+        seqlock() noexcept
+        {
+            store(T {});
+        }
+
+        explicit seqlock(const T &value) noexcept
+        {
+            store(value);
+        }
+
+        [[nodiscard]] T load() const noexcept
+        {
+            uint64_t buf[WORDS];
+            uint32_t polls = 0;
+            while (true)
+            {
+                const uint32_t begin = sequence.load(std::memory_order_acquire);
+                if (!(begin & 1))
+                {
+                    for (size_t i = 0; i < WORDS; ++i)
+                        buf[i] = data[i].load(std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (sequence.load(std::memory_order_relaxed) == begin)
+                        break;
+                }
+                retries.fetch_add(1, std::memory_order_relaxed);
+                detail::spin_backoff(polls);
+            }
+
+            T out;
+            std::memcpy(&out, buf, sizeof(T));
+            return out;
+        }
+
+        void store(const T &value) noexcept
+        {
+            uint64_t buf[WORDS] {};
+            std::memcpy(buf, &value, sizeof(T));
+
+            uint32_t seq = sequence.load(std::memory_order_relaxed);
+            uint32_t polls = 0;
+            while (seq & 1 || !sequence.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire,
+                                                             std::memory_order_relaxed))
+            {
+                writers_contended.fetch_add(1, std::memory_order_relaxed);
+                detail::spin_backoff(polls);
+                seq = sequence.load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_release);
+
+            for (size_t i = 0; i < WORDS; ++i)
+                data[i].store(buf[i], std::memory_order_relaxed);
+
+            sequence.store(seq + 2, std::memory_order_release);
+            detail::bump(writes);
+        }
+
+        /**
+         * @brief acquisitions counts writes, contended counts reader retries plus blocked writers
+         */
+        [[nodiscard]] lock_stats stats() const noexcept
+        {
+            return {
+                writes.load(std::memory_order_relaxed),
+                retries.load(std::memory_order_relaxed) + writers_contended.load(std::memory_order_relaxed),
+                0
+            };
+        }
+
+    private:
+        std::atomic<uint32_t> sequence { 0 };
+        std::atomic<uint64_t> data[WORDS] {};
+        mutable std::atomic<uint64_t> retries { 0 };
+        std::atomic<uint64_t> writes { 0 };
+        std::atomic<uint64_t> writers_contended { 0 };
+    };
+}
@@ -1,9 +1,15 @@
 #pragma once
 
-#include <functional>
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <thread>
 #include <variant>
 
+#include "executor.h"
+#include "function.h"
+#include "sync.h"
+
 namespace ytl
 {
     class task
@@ -24,7 +30,7 @@ namespace ytl
             CANCELLED
         };
 
-        using executable = std::variant<std::function<void()>, std::shared_ptr<std::thread> >;
+        using executable = std::variant<unique_function<void()>, std::shared_ptr<std::thread> >;
 
         /**
          * @brief Spawn a new task immediately
@@ -48,6 +54,32 @@ namespace ytl
             return task;
         }
 
+        /**
+         * @brief Queue a task on a pool instead of running it on the caller.
+         * Posted tasks never take the serial lock, the pool decides what runs concurrently
+         * @tparam Fn Function or lambda type
+         * @tparam Args Argument types
+         * @param ex Pool to run on
+         * @param prio URGENT tasks are picked before any queued bulk work
+         * @param fn Function to execute
+         * @param args Arguments to the function
+         */
+        template<typename Fn, typename... Args>
+        static void post(executor &ex, const priority prio, Fn &&fn, Args &&... args)
+        {
+            ex.submit([fn = std::forward<Fn>(fn), ... args = std::forward<Args>(args)]() mutable
+            {
+                task task;
+                task.type = type::FUNCTION;
+                task.state.store(state::RUNNING, std::memory_order_relaxed);
+                task.execu = [&fn, &args...]() mutable
+                {
+                    fn(std::move(args)...);
+                };
+                task.execute(false);
+            }, prio);
+        }
+
         /**
          * @brief Spawn a new thread task
          * @param thread Thread to manage
@@ -66,7 +98,7 @@ namespace ytl
         * @param thread Thread to defer
         * @return Deferred Task
         */
-        static task defer(std::variant<std::function<void()>, std::shared_ptr<std::thread> > thread);
+        static task defer(executable thread);
 
         template<typename Fn, typename... Args>
         static task delay(float duration, Fn &&fn, Args &&... args)
@@ -113,13 +145,17 @@ namespace ytl
         static inline std::atomic<uint64_t> next_id = 0;
 
         std::atomic<state> state;
-        uint64_t id;
         type type;
+        uint64_t id;
         executable execu;
 
-        static std::mutex mutex;
-        static bool serial;
+        static adaptive_mutex mutex;
+        static std::atomic<bool> serial;
 
-        void execute() const;
+        /**
+         * @brief Run the payload unless cancelled
+         * @param serialize Hold the global task mutex while running
+         */
+        void execute(bool serialize = serial.load(std::memory_order_relaxed));
     };
 }
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "executor.h"
+#include "function.h"
+
+namespace ytl
+{
+    /**
+     * @brief Reusable dependency graph of jobs.
+     * Nodes and edges are declared once. Every run resets one counter per node
+     * and releases nodes onto the executor as their last predecessor finishes,
+     * nothing is allocated between runs.
+     */
+    class task_graph
+    {
+    public:
+        using node = uint32_t;
+
+        task_graph() = default;
+
+        task_graph(const task_graph &) = delete;
+
+        task_graph &operator=(const task_graph &) = delete;
+
+        /**
+         * @brief Add a node
+         * @tparam Fn Function or lambda type
+         * @param fn Function executed each time the graph runs, must not throw
+         * @return Handle of the new node
+         */
+        template<typename Fn>
+        node emplace(Fn &&fn)
+        {
+            const auto id = static_cast<node>(nodes.size());
+            nodes.emplace_back(this, id, std::forward<Fn>(fn));
+            prepared = false;
+            return id;
+        }
+
+        /**
+         * @brief Declare that from must complete before to starts
+         * @param from Predecessor node
+         * @param to Successor node
+         * @throws std::out_of_range if either is not a node of this graph, std::invalid_argument if they are the same
+         */
+        void precede(node from, node to);
+
+        /**
+         * @brief Execute every node once, respecting the declared edges
+         * @param ex Executor to run on
+         * @return False if the graph contains a cycle, in which case nothing runs
+         */
+        bool run(executor &ex = executor::global());
+
+        [[nodiscard]] size_t size() const noexcept
+        {
+            return nodes.size();
+        }
+
+    private:
+        struct node_data : detail::job
+        {
+            task_graph *graph;
+            node index;
+            unique_function<void()> fn;
+            std::vector<node_data *> successors;
+            uint32_t predecessors { 0 };
+            std::atomic<uint32_t> pending { 0 };
+
+            template<typename Fn>
+            node_data(task_graph *graph, const node index, Fn &&f)
+                : graph(graph), index(index), fn(std::forward<Fn>(f))
+            {
+                invoke = &task_graph::execute;
+            }
+        };
+
+        std::deque<node_data> nodes;
+        std::vector<node_data *> roots;
+        bool prepared { false };
+        bool acyclic { true };
+
+        executor *ex { nullptr };
+        std::atomic<size_t> remaining { 0 };
+        std::atomic<bool> done { false };
+
+        void prepare();
+
+        static void execute(detail::job *job);
+    };
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace ytl::trace
+{
+    enum class event : uint8_t
+    {
+        ENQUEUE,
+        STEAL,
+        START,
+        END,
+        CANCEL
+    };
+
+    enum class source : uint8_t
+    {
+        TASK,
+        JOB
+    };
+
+    struct record
+    {
+        uint64_t timestamp;
+        uint64_t id;
+        event type;
+        source origin;
+    };
+
+    /**
+     * @brief Enqueue to start latency, bucket i counts samples in [2^i, 2^(i+1)) ns
+     */
+    struct histogram
+    {
+        static constexpr size_t BUCKETS = 40;
+
+        uint64_t buckets[BUCKETS] {};
+        uint64_t count { 0 };
+        uint64_t sum { 0 };
+        uint64_t min { ~uint64_t { 0 } };
+        uint64_t max { 0 };
+
+        void add(uint64_t ns) noexcept;
+
+        void merge(const histogram &other) noexcept;
+
+        /**
+         * @brief Upper bound of the bucket holding the given quantile
+         * @param q Quantile in [0, 1]
+         * @return Latency in nanoseconds
+         */
+        [[nodiscard]] uint64_t percentile(double q) const noexcept;
+    };
+
+    /**
+     * @brief Events kept per thread before the oldest ones are overwritten.
+     * The ring of an exited thread keeps its events and is reused by the next
+     * thread that records, which then shares its tid in the export.
+     */
+    inline constexpr size_t RING_CAPACITY = 1 << 14;
+
+#ifdef YTL_TRACING
+    inline constexpr bool compiled = true;
+#else
+    inline constexpr bool compiled = false;
+#endif
+
+    namespace detail
+    {
+        inline std::atomic<bool> active { false };
+
+        void emit(event type, source origin, uint64_t id, uint64_t timestamp) noexcept;
+
+        void sample(uint64_t latency) noexcept;
+    }
+
+    /**
+     * @brief Start or stop recording, tracing is off until enabled
+     */
+    void enable(bool on = true) noexcept;
+
+    [[nodiscard]] inline bool enabled() noexcept
+    {
+        return compiled && detail::active.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Monotonic timestamp in nanoseconds
+     */
+    [[nodiscard]] uint64_t now() noexcept;
+
+    /**
+     * @brief Record a lifecycle event on the calling thread's ring
+     * @param type Lifecycle event
+     * @param origin Whether id names a task or an executor job
+     * @param id Task or job id
+     */
+    inline void emit(const event type, const source origin, const uint64_t id) noexcept
+    {
+        if (enabled())
+            detail::emit(type, origin, id, now());
+    }
+
+    /**
+     * @brief Aggregate queue latency over every thread that recorded events
+     */
+    [[nodiscard]] histogram queue_latency() noexcept;
+
+    /**
+     * @brief Drop every recorded event and latency sample. Call it at a
+     * quiescent point, e.g. with recording disabled and the pools idle: a
+     * thread recording meanwhile may keep some of its events or samples, or
+     * restore a ring's position from before the clear.
+     */
+    void clear() noexcept;
+
+    /**
+     * @brief Write recorded events in Chrome trace event format, loadable by
+     * chrome://tracing and Perfetto. Export while workers are quiescent, a ring
+     * that wraps during the export may yield a torn record.
+     * @param path Output file
+     * @return Whether the file was written
+     */
+    bool export_chrome(const char *path);
+}
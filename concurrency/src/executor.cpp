@@ -0,0 +1,413 @@
+#include "../include/executor.h"
+#include "work_deque.h"
+#include "../include/trace.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#endif
+
+namespace ytl
+{
+    struct executor::worker
+    {
+        detail::work_deque<> deque;
+        executor *owner { nullptr };
+        size_t index { 0 };
+        uint64_t rng { 0 };
+        std::thread thread;
+    };
+
+    thread_local executor::worker *executor::current = nullptr;
+
+    namespace
+    {
+        constexpr size_t SPIN_ROUNDS = 64;
+
+#ifdef YTL_TRACING
+        std::atomic<uint64_t> next_job_id { 1 };
+#endif
+
+        struct pool_registry
+        {
+            std::mutex mutex;
+            std::condition_variable released;
+            std::vector<executor *> pools;
+        };
+
+        pool_registry &registry()
+        {
+            static pool_registry instance;
+            return instance;
+        }
+
+        executor::options named(std::string name, const size_t threads)
+        {
+            executor::options opts;
+            opts.name = std::move(name);
+            opts.threads = threads;
+            return opts;
+        }
+
+        uint64_t next_random(uint64_t &state) noexcept
+        {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            return state;
+        }
+    }
+
+    executor::executor(const size_t threads) : executor(named({}, threads)) {}
+
+    executor::executor(options opts) : opts(std::move(opts))
+    {
+        size_t threads = this->opts.threads;
+        if (!threads)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+
+        workers.reserve(threads);
+        for (size_t i = 0; i < threads; ++i)
+        {
+            auto w = std::make_unique<worker>();
+            w->owner = this;
+            w->index = i;
+            w->rng = 0x9E3779B97F4A7C15ULL * (i + 1);
+            workers.push_back(std::move(w));
+        }
+
+        configuring.store(threads, std::memory_order_relaxed);
+        for (size_t i = 0; i < threads; ++i)
+            workers[i]->thread = std::thread(&executor::run, this, i);
+
+        // configured() is only meaningful once every worker tried to apply the options
+        for (size_t left; (left = configuring.load(std::memory_order_acquire));)
+            configuring.wait(left, std::memory_order_acquire);
+
+        if (!this->opts.name.empty())
+        {
+            auto &reg = registry();
+            std::lock_guard lock(reg.mutex);
+            reg.pools.push_back(this);
+        }
+    }
+
+    executor::~executor()
+    {
+        if (!opts.name.empty())
+        {
+            auto &reg = registry();
+            std::unique_lock lock(reg.mutex);
+            std::erase(reg.pools, this);
+            // No handle can appear once unregistered, wait out the ones find gave
+            reg.released.wait(lock, [this] { return !pins; });
+        }
+
+        stopping.store(true, std::memory_order_seq_cst);
+        signal.fetch_add(1, std::memory_order_seq_cst);
+        signal.notify_all();
+
+        for (const auto &w: workers)
+        {
+            if (w->thread.joinable())
+                w->thread.join();
+        }
+    }
+
+    executor &executor::global()
+    {
+        static executor instance(named("global", 0));
+        return instance;
+    }
+
+    std::shared_ptr<executor> executor::find(const std::string_view name)
+    {
+        auto &reg = registry();
+        std::lock_guard lock(reg.mutex);
+        for (executor *pool: reg.pools)
+        {
+            if (pool->opts.name == name)
+            {
+                pool->pins++;
+                return std::shared_ptr<executor>(pool, [](executor *pinned)
+                {
+                    auto &reg = registry();
+                    std::lock_guard lock(reg.mutex);
+                    if (!--pinned->pins)
+                        reg.released.notify_all();
+                });
+            }
+        }
+        return nullptr;
+    }
+
+    bool executor::is_worker() const noexcept
+    {
+        return current && current->owner == this;
+    }
+
+    bool executor::local_empty() const noexcept
+    {
+        return !is_worker() || current->deque.empty();
+    }
+
+    void executor::submit(detail::job *job, const priority prio)
+    {
+#ifdef YTL_TRACING
+        job->enqueued = 0;
+        if (trace::enabled())
+        {
+            job->trace_id = next_job_id.fetch_add(1, std::memory_order_relaxed);
+            job->enqueued = trace::now();
+            trace::detail::emit(trace::event::ENQUEUE, trace::source::JOB, job->trace_id, job->enqueued);
+        }
+#endif
+        if (prio == priority::URGENT)
+            enqueue(urgent, urgent_overflow, job);
+        else if (!is_worker() || !current->deque.push(job))
+            enqueue(injected, injected_overflow, job);
+        notify();
+    }
+
+    void executor::enqueue(mpmc_queue<detail::job *> &queue, overflow_list &overflow, detail::job *job)
+    {
+        if (!overflow.size.load(std::memory_order_acquire) && queue.try_push(job))
+            return;
+
+        std::lock_guard lock(overflow.mutex);
+        overflow.jobs.push_back(job);
+        overflow.size.fetch_add(1, std::memory_order_release);
+    }
+
+    detail::job *executor::dequeue(mpmc_queue<detail::job *> &queue, overflow_list &overflow)
+    {
+        if (detail::job *job; queue.try_pop(job))
+            return job;
+        if (!overflow.size.load(std::memory_order_acquire))
+            return nullptr;
+
+        std::lock_guard lock(overflow.mutex);
+        if (overflow.jobs.empty())
+            return nullptr;
+        detail::job *job = overflow.jobs.front();
+        overflow.jobs.pop_front();
+        overflow.size.fetch_sub(1, std::memory_order_release);
+        return job;
+    }
+
+    bool executor::try_run_one()
+    {
+        if (!is_worker())
+            return false;
+
+        if (detail::job *job = find_work(current))
+        {
+            run_job(job);
+            return true;
+        }
+        return false;
+    }
+
+    void executor::wait(const std::atomic<bool> &flag)
+    {
+        if (!is_worker())
+        {
+            // Parked on the executor's counter, the flag may be gone by the time its setter wakes anyone
+            blocked.fetch_add(1, std::memory_order_seq_cst);
+            while (true)
+            {
+                const uint32_t seen = completions.load(std::memory_order_seq_cst);
+                if (flag.load(std::memory_order_seq_cst))
+                    break;
+                completions.wait(seen, std::memory_order_seq_cst);
+            }
+            blocked.fetch_sub(1, std::memory_order_seq_cst);
+            return;
+        }
+
+        size_t idle = 0;
+        while (!flag.load(std::memory_order_acquire))
+        {
+            if (try_run_one())
+            {
+                idle = 0;
+                continue;
+            }
+
+            if (++idle > SPIN_ROUNDS)
+                std::this_thread::yield();
+        }
+    }
+
+    void executor::complete(std::atomic<bool> &flag) noexcept
+    {
+        flag.store(true, std::memory_order_seq_cst);
+        completions.fetch_add(1, std::memory_order_seq_cst);
+        if (blocked.load(std::memory_order_seq_cst))
+            completions.notify_all();
+    }
+
+    void executor::run(const size_t index)
+    {
+        worker *self = workers[index].get();
+        current = self;
+        configure(index);
+        if (configuring.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            configuring.notify_all();
+
+        while (true)
+        {
+            if (detail::job *job = find_work(self))
+            {
+                run_job(job);
+                continue;
+            }
+
+            bool found = false;
+            for (size_t i = 0; i < SPIN_ROUNDS && !found; ++i)
+            {
+                std::this_thread::yield();
+                found = has_work();
+            }
+            if (found)
+                continue;
+
+            const uint32_t seen = signal.load(std::memory_order_seq_cst);
+            sleepers.fetch_add(1, std::memory_order_seq_cst);
+            if (!has_work())
+            {
+                if (stopping.load(std::memory_order_seq_cst))
+                {
+                    sleepers.fetch_sub(1, std::memory_order_seq_cst);
+                    break;
+                }
+                signal.wait(seen, std::memory_order_seq_cst);
+            }
+            sleepers.fetch_sub(1, std::memory_order_seq_cst);
+        }
+
+        current = nullptr;
+    }
+
+    void executor::configure(const size_t index)
+    {
+        bool ok = true;
+#ifdef __linux__
+        if (!opts.name.empty())
+        {
+            char name[16];
+            std::snprintf(name, sizeof(name), "%.10s/%zu", opts.name.c_str(), index);
+            pthread_setname_np(pthread_self(), name);
+        }
+
+        if (!opts.cpus.empty())
+        {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            if (opts.pin_workers)
+            {
+                CPU_SET(opts.cpus[index % opts.cpus.size()], &set);
+            }
+            else
+            {
+                for (const int cpu: opts.cpus)
+                    CPU_SET(cpu, &set);
+            }
+            ok &= pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+        }
+
+        if (opts.nice)
+            ok &= setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), opts.nice) == 0;
+
+        if (opts.fifo_priority)
+        {
+            sched_param param {};
+            param.sched_priority = opts.fifo_priority;
+            ok &= pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+        }
+#else
+        ok = opts.cpus.empty() && !opts.nice && !opts.fifo_priority;
+#endif
+        if (!ok)
+            config_failed.store(true, std::memory_order_release);
+    }
+
+    void executor::notify()
+    {
+        signal.fetch_add(1, std::memory_order_seq_cst);
+        if (sleepers.load(std::memory_order_seq_cst))
+            signal.notify_one();
+    }
+
+    detail::job *executor::find_work(worker *self)
+    {
+        if (detail::job *job = dequeue(urgent, urgent_overflow))
+            return job;
+
+        if (detail::job *job = self->deque.pop())
+            return job;
+
+        if (detail::job *job = dequeue(injected, injected_overflow))
+            return job;
+
+        const size_t n = workers.size();
+        if (n <= 1)
+            return nullptr;
+
+        const size_t start = next_random(self->rng) % n;
+        for (size_t i = 0; i < n; ++i)
+        {
+            const size_t victim = (start + i) % n;
+            if (victim == self->index)
+                continue;
+            if (detail::job *job = workers[victim]->deque.steal())
+            {
+#ifdef YTL_TRACING
+                if (job->enqueued)
+                    trace::emit(trace::event::STEAL, trace::source::JOB, job->trace_id);
+#endif
+                return job;
+            }
+        }
+        return nullptr;
+    }
+
+    void executor::run_job(detail::job *job)
+    {
+#ifdef YTL_TRACING
+        if (job->enqueued && trace::enabled())
+        {
+            const uint64_t id = job->trace_id;
+            const uint64_t start = trace::now();
+            trace::detail::sample(start - job->enqueued);
+            trace::detail::emit(trace::event::START, trace::source::JOB, id, start);
+            job->invoke(job);
+            trace::emit(trace::event::END, trace::source::JOB, id);
+            return;
+        }
+#endif
+        job->invoke(job);
+    }
+
+    bool executor::has_work() const noexcept
+    {
+        if (!injected.empty() || !urgent.empty() || injected_overflow.size.load(std::memory_order_acquire) ||
+            urgent_overflow.size.load(std::memory_order_acquire))
+            return true;
+
+        for (const auto &w: workers)
+        {
+            if (!w->deque.empty())
+                return true;
+        }
+        return false;
+    }
+}
@@ -0,0 +1,109 @@
+#include "../include/strand.h"
+
+#include <thread>
+
+namespace ytl
+{
+    thread_local const strand *strand::current = nullptr;
+
+    strand::strand(executor &ex) : ex(ex) {}
+
+    strand::~strand()
+    {
+        while (running.load(std::memory_order_acquire) || draining.load(std::memory_order_acquire))
+        {
+            if (!ex.try_run_one())
+                std::this_thread::yield();
+        }
+    }
+
+    bool strand::running_in_this_thread() const noexcept
+    {
+        return current == this;
+    }
+
+    void strand::enqueue(message *msg)
+    {
+        msg->next.store(nullptr, std::memory_order_relaxed);
+        message *prev = tail.exchange(msg, std::memory_order_seq_cst);
+        prev->next.store(msg, std::memory_order_release);
+
+        if (!running.exchange(true, std::memory_order_seq_cst))
+            ex.submit(&job);
+    }
+
+    strand::message *strand::pop() noexcept
+    {
+        message *first = head;
+        message *next = first->next.load(std::memory_order_acquire);
+
+        if (first == &stub)
+        {
+            if (!next)
+            {
+                if (tail.load(std::memory_order_seq_cst) == &stub)
+                    return nullptr;
+
+                // A producer swapped the tail but has not linked its message yet
+                while (!(next = stub.next.load(std::memory_order_acquire)))
+                    detail::cpu_relax();
+            }
+            head = next;
+            first = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+
+        if (!next)
+        {
+            if (first == tail.load(std::memory_order_seq_cst))
+            {
+                // Last message, park the stub behind it so the queue never runs dry
+                stub.next.store(nullptr, std::memory_order_relaxed);
+                message *prev = tail.exchange(&stub, std::memory_order_seq_cst);
+                prev->next.store(&stub, std::memory_order_release);
+            }
+            while (!(next = first->next.load(std::memory_order_acquire)))
+                detail::cpu_relax();
+        }
+
+        head = next;
+        return first;
+    }
+
+    void strand::drain(detail::job *job)
+    {
+        strand *self = static_cast<runner *>(job)->owner;
+        self->draining.fetch_add(1, std::memory_order_relaxed);
+
+        const strand *outer = current;
+        current = self;
+
+        size_t ran = 0;
+        for (; ran < BATCH; ++ran)
+        {
+            message *msg = self->pop();
+            if (!msg)
+                break;
+            msg->fn();
+            delete msg;
+        }
+        current = outer;
+
+        // Keep the flag raised and go to the back of the pool so one busy strand
+        // cannot monopolize a worker
+        if (ran == BATCH)
+            self->ex.submit(&self->job);
+        else
+        {
+            // The mailbox was empty, only the tail is safe to read once the flag
+            // drops because a concurrent post may already have scheduled a drain
+            self->running.store(false, std::memory_order_seq_cst);
+            if (self->tail.load(std::memory_order_seq_cst) != &self->stub &&
+                !self->running.exchange(true, std::memory_order_seq_cst))
+                self->ex.submit(&self->job);
+        }
+
+        // Last touch, the destructor may free the strand as soon as this lands
+        self->draining.fetch_sub(1, std::memory_order_release);
+    }
+}
@@ -0,0 +1,80 @@
+#include "../include/sync.h"
+
+#ifdef __linux__
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace ytl
+{
+    namespace detail
+    {
+#ifdef __linux__
+        namespace
+        {
+            void futex(std::atomic<uint32_t> &word, const int op, const uint32_t value) noexcept
+            {
+                static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t));
+                syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), op | FUTEX_PRIVATE_FLAG, value,
+                        nullptr, nullptr, 0);
+            }
+        }
+
+        void futex_wait(std::atomic<uint32_t> &word, const uint32_t expected) noexcept
+        {
+            futex(word, FUTEX_WAIT, expected);
+        }
+
+        void futex_wake_one(std::atomic<uint32_t> &word) noexcept
+        {
+            futex(word, FUTEX_WAKE, 1);
+        }
+
+        void futex_wake_all(std::atomic<uint32_t> &word) noexcept
+        {
+            futex(word, FUTEX_WAKE, INT_MAX);
+        }
+#else
+        void futex_wait(std::atomic<uint32_t> &word, const uint32_t expected) noexcept
+        {
+            word.wait(expected, std::memory_order_relaxed);
+        }
+
+        void futex_wake_one(std::atomic<uint32_t> &word) noexcept
+        {
+            word.notify_one();
+        }
+
+        void futex_wake_all(std::atomic<uint32_t> &word) noexcept
+        {
+            word.notify_all();
+        }
+#endif
+    }
+
+    void adaptive_mutex::lock_slow() noexcept
+    {
+        contended.fetch_add(1, std::memory_order_relaxed);
+
+        for (uint32_t round = 0; round < SPIN_ROUNDS; ++round)
+        {
+            uint32_t current = word.load(std::memory_order_relaxed);
+            if (current == PARKED)
+                break;
+            if (current == UNLOCKED && word.compare_exchange_weak(current, LOCKED, std::memory_order_acquire,
+                                                                  std::memory_order_relaxed))
+                return;
+            detail::cpu_relax();
+        }
+
+        // Once anyone parked the word stays PARKED until its owner unlocks, so
+        // whoever takes it from here must assume there are sleepers to wake
+        while (word.exchange(PARKED, std::memory_order_acquire) != UNLOCKED)
+        {
+            parked.fetch_add(1, std::memory_order_relaxed);
+            detail::futex_wait(word, PARKED);
+        }
+    }
+}
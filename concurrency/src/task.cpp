@@ -1,14 +1,15 @@
 #include "../include/task.h"
+#include "../include/trace.h"
 
 namespace ytl
 {
-    std::mutex task::mutex;
-    bool task::serial = true;
+    adaptive_mutex task::mutex;
+    std::atomic<bool> task::serial { true };
 
-    task::task() : state(state::CREATED), id(next_id.fetch_add(1, std::memory_order_relaxed)), type(type::FUNCTION) {}
+    task::task() : state(state::CREATED), type(type::FUNCTION), id(next_id.fetch_add(1, std::memory_order_relaxed)) {}
 
-    task::task(task &&other) noexcept : id(other.id),
-                                        type(other.type),
+    task::task(task &&other) noexcept : type(other.type),
+                                        id(other.id),
                                         execu(std::move(other.execu))
     {
         state.store(other.state.load(std::memory_order_relaxed), std::memory_order_relaxed);
@@ -40,7 +41,7 @@ namespace ytl
         return task;
     }
 
-    task task::defer(std::variant<std::function<void()>, std::shared_ptr<std::thread>> thread)
+    task task::defer(executable thread)
     {
         task task;
         task.type = type::THREAD;
@@ -62,12 +63,12 @@ namespace ytl
 
     void task::desynchronize()
     {
-        serial = false;
+        serial.store(false, std::memory_order_relaxed);
     }
 
     void task::synchronize()
     {
-        serial = true;
+        serial.store(true, std::memory_order_relaxed);
     }
 
     float task::wait(float duration)
@@ -81,6 +82,7 @@ namespace ytl
         if (task.state.load(std::memory_order_relaxed) != state::CANCELLED)
         {
             task.state.store(state::CANCELLED, std::memory_order_relaxed);
+            trace::emit(trace::event::CANCEL, trace::source::TASK, task.id);
             if (std::holds_alternative<std::shared_ptr<std::thread>>(task.execu))
             {
                 if (const auto &thread = std::get<std::shared_ptr<std::thread>>(task.execu);
@@ -92,17 +94,19 @@ namespace ytl
         }
     }
 
-    void task::execute() const
+    void task::execute(const bool serialize)
     {
         if (state.load(std::memory_order_relaxed) == state::CANCELLED)
             return;
 
-        if (serial)
+        trace::emit(trace::event::START, trace::source::TASK, id);
+
+        if (serialize)
         {
             std::lock_guard lock(mutex);
-            if (std::holds_alternative<std::function<void()>>(execu))
+            if (std::holds_alternative<unique_function<void()>>(execu))
             {
-                std::get<std::function<void()>>(execu)();
+                std::get<unique_function<void()>>(execu)();
             }
             else if (std::holds_alternative<std::shared_ptr<std::thread>>(execu))
             {
@@ -115,9 +119,9 @@ namespace ytl
         }
         else
         {
-            if (std::holds_alternative<std::function<void()>>(execu))
+            if (std::holds_alternative<unique_function<void()>>(execu))
             {
-                std::get<std::function<void()>>(execu)();
+                std::get<unique_function<void()>>(execu)();
             }
             else if (std::holds_alternative<std::shared_ptr<std::thread>>(execu))
             {
@@ -128,6 +132,8 @@ namespace ytl
                 }
             }
         }
+
+        trace::emit(trace::event::END, trace::source::TASK, id);
     }
 }
 
@@ -0,0 +1,107 @@
+#include "../include/task_graph.h"
+
+#include <stdexcept>
+
+namespace ytl
+{
+    void task_graph::precede(const node from, const node to)
+    {
+        // A stale or foreign handle would index past the nodes and corrupt them
+        if (from >= nodes.size() || to >= nodes.size())
+            throw std::out_of_range("task_graph: unknown node");
+        if (from == to)
+            throw std::invalid_argument("task_graph: a node cannot precede itself");
+
+        nodes[from].successors.push_back(&nodes[to]);
+        nodes[to].predecessors++;
+        prepared = false;
+    }
+
+    bool task_graph::run(executor &ex)
+    {
+        if (!prepared)
+            prepare();
+
+        if (!acyclic)
+            return false;
+        if (nodes.empty())
+            return true;
+
+        this->ex = &ex;
+        for (auto &n: nodes)
+            n.pending.store(n.predecessors, std::memory_order_relaxed);
+        remaining.store(nodes.size(), std::memory_order_relaxed);
+        done.store(false, std::memory_order_relaxed);
+
+        for (node_data *root: roots)
+            ex.submit(root);
+
+        ex.wait(done);
+        return true;
+    }
+
+    void task_graph::prepare()
+    {
+        roots.clear();
+
+        std::vector<uint32_t> pending;
+        std::vector<node_data *> ready;
+        pending.reserve(nodes.size());
+        for (auto &n: nodes)
+        {
+            pending.push_back(n.predecessors);
+            if (!n.predecessors)
+            {
+                roots.push_back(&n);
+                ready.push_back(&n);
+            }
+        }
+
+        size_t visited = 0;
+        while (!ready.empty())
+        {
+            const node_data *n = ready.back();
+            ready.pop_back();
+            visited++;
+
+            for (node_data *succ: n->successors)
+            {
+                if (!--pending[succ->index])
+                    ready.push_back(succ);
+            }
+        }
+
+        acyclic = visited == nodes.size();
+        prepared = true;
+    }
+
+    void task_graph::execute(detail::job *job)
+    {
+        auto *n = static_cast<node_data *>(job);
+        task_graph *graph = n->graph;
+
+        while (n)
+        {
+            n->fn();
+
+            node_data *next = nullptr;
+            for (node_data *succ: n->successors)
+            {
+                if (succ->pending.fetch_sub(1, std::memory_order_acq_rel) != 1)
+                    continue;
+
+                if (next)
+                    graph->ex->submit(next);
+                next = succ;
+            }
+
+            if (graph->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                // run may return and the graph go away once done is set
+                graph->ex->complete(graph->done);
+                return;
+            }
+            n = next;
+        }
+    }
+}
@@ -0,0 +1,266 @@
+#include "../include/trace.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ytl::trace
+{
+    namespace
+    {
+        struct ring
+        {
+            uint32_t tid { 0 };
+            std::atomic<uint64_t> head { 0 };
+            record records[RING_CAPACITY] {};
+
+            std::atomic<uint64_t> buckets[histogram::BUCKETS] {};
+            std::atomic<uint64_t> count { 0 };
+            std::atomic<uint64_t> sum { 0 };
+            std::atomic<uint64_t> min { ~uint64_t { 0 } };
+            std::atomic<uint64_t> max { 0 };
+        };
+
+        /**
+         * @brief Every ring ever handed out, in export order. Rings of exited
+         * threads keep their events and wait in spare for the next new thread,
+         * so memory is bounded by the peak number of recording threads.
+         */
+        struct registry
+        {
+            std::mutex mutex;
+            std::vector<std::unique_ptr<ring> > rings;
+            std::vector<ring *> spare;
+        };
+
+        registry &rings() noexcept
+        {
+            static registry instance;
+            return instance;
+        }
+
+        /**
+         * @brief Gives the thread's ring back when the thread exits
+         */
+        struct ring_owner
+        {
+            ring *r { nullptr };
+
+            ~ring_owner()
+            {
+                if (r)
+                {
+                    auto &reg = rings();
+                    std::lock_guard lock(reg.mutex);
+                    reg.spare.push_back(r);
+                }
+            }
+        };
+
+        thread_local ring_owner local;
+
+        ring *local_ring() noexcept
+        {
+            if (!local.r)
+            {
+                auto &reg = rings();
+                std::lock_guard lock(reg.mutex);
+                if (!reg.spare.empty())
+                {
+                    local.r = reg.spare.back();
+                    reg.spare.pop_back();
+                }
+                else
+                {
+                    auto r = std::make_unique<ring>();
+                    r->tid = static_cast<uint32_t>(reg.rings.size());
+                    local.r = r.get();
+                    reg.rings.push_back(std::move(r));
+                }
+            }
+            return local.r;
+        }
+
+        size_t bucket_of(const uint64_t ns) noexcept
+        {
+            const size_t b = ns ? 63 - __builtin_clzll(ns) : 0;
+            return b < histogram::BUCKETS ? b : histogram::BUCKETS - 1;
+        }
+
+        const char *category(const source origin) noexcept
+        {
+            return origin == source::TASK ? "task" : "job";
+        }
+    }
+
+    void histogram::add(const uint64_t ns) noexcept
+    {
+        buckets[bucket_of(ns)]++;
+        count++;
+        sum += ns;
+        min = ns < min ? ns : min;
+        max = ns > max ? ns : max;
+    }
+
+    void histogram::merge(const histogram &other) noexcept
+    {
+        for (size_t i = 0; i < BUCKETS; ++i)
+            buckets[i] += other.buckets[i];
+        count += other.count;
+        sum += other.sum;
+        min = other.min < min ? other.min : min;
+        max = other.max > max ? other.max : max;
+    }
+
+    uint64_t histogram::percentile(const double q) const noexcept
+    {
+        if (!count)
+            return 0;
+
+        const auto target = static_cast<uint64_t>(q * static_cast<double>(count - 1)) + 1;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKETS; ++i)
+        {
+            seen += buckets[i];
+            if (seen >= target)
+            {
+                const uint64_t upper = (uint64_t { 2 } << i) - 1;
+                return upper < max ? upper : max;
+            }
+        }
+        return max;
+    }
+
+    void enable(const bool on) noexcept
+    {
+        detail::active.store(on && compiled, std::memory_order_relaxed);
+    }
+
+    uint64_t now() noexcept
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void detail::emit(const event type, const source origin, const uint64_t id, const uint64_t timestamp) noexcept
+    {
+        ring *r = local_ring();
+        const uint64_t h = r->head.load(std::memory_order_relaxed);
+        r->records[h & (RING_CAPACITY - 1)] = { timestamp, id, type, origin };
+        r->head.store(h + 1, std::memory_order_release);
+    }
+
+    void detail::sample(const uint64_t latency) noexcept
+    {
+        ring *r = local_ring();
+        auto bump = [](std::atomic<uint64_t> &v, const uint64_t by)
+        {
+            v.store(v.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+        };
+
+        bump(r->buckets[bucket_of(latency)], 1);
+        bump(r->count, 1);
+        bump(r->sum, latency);
+        if (latency < r->min.load(std::memory_order_relaxed))
+            r->min.store(latency, std::memory_order_relaxed);
+        if (latency > r->max.load(std::memory_order_relaxed))
+            r->max.store(latency, std::memory_order_relaxed);
+    }
+
+    histogram queue_latency() noexcept
+    {
+        histogram total;
+        auto &reg = rings();
+        std::lock_guard lock(reg.mutex);
+        for (const auto &r: reg.rings)
+        {
+            histogram h;
+            for (size_t i = 0; i < histogram::BUCKETS; ++i)
+                h.buckets[i] = r->buckets[i].load(std::memory_order_relaxed);
+            h.count = r->count.load(std::memory_order_relaxed);
+            h.sum = r->sum.load(std::memory_order_relaxed);
+            h.min = r->min.load(std::memory_order_relaxed);
+            h.max = r->max.load(std::memory_order_relaxed);
+            total.merge(h);
+        }
+        return total;
+    }
+
+    void clear() noexcept
+    {
+        auto &reg = rings();
+        std::lock_guard lock(reg.mutex);
+        for (const auto &r: reg.rings)
+        {
+            r->head.store(0, std::memory_order_relaxed);
+            for (auto &b: r->buckets)
+                b.store(0, std::memory_order_relaxed);
+            r->count.store(0, std::memory_order_relaxed);
+            r->sum.store(0, std::memory_order_relaxed);
+            r->min.store(~uint64_t { 0 }, std::memory_order_relaxed);
+            r->max.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    bool export_chrome(const char *path)
+    {
+        FILE *file = std::fopen(path, "w");
+        if (!file)
+            return false;
+
+        auto &reg = rings();
+        std::lock_guard lock(reg.mutex);
+
+        std::fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", file);
+        bool first = true;
+        auto write = [&](const record &rec, const uint32_t tid, const char *ph, const char *name, const char *extra)
+        {
+            std::fprintf(file, "%s\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"%s\",\"ts\":%.3f,\"pid\":1,\"tid\":%u%s",
+                         first ? "" : ",", name, category(rec.origin), ph,
+                         static_cast<double>(rec.timestamp) / 1000.0, tid, extra);
+            if (ph[0] == 's' || ph[0] == 'f')
+                std::fprintf(file, ",\"id\":%llu", static_cast<unsigned long long>(rec.id));
+            else
+                std::fprintf(file, ",\"args\":{\"id\":%llu}", static_cast<unsigned long long>(rec.id));
+            std::fputc('}', file);
+            first = false;
+        };
+
+        for (const auto &r: reg.rings)
+        {
+            const uint64_t head = r->head.load(std::memory_order_acquire);
+            const uint64_t begin = head > RING_CAPACITY ? head - RING_CAPACITY : 0;
+            for (uint64_t i = begin; i < head; ++i)
+            {
+                const record &rec = r->records[i & (RING_CAPACITY - 1)];
+                const char *name = category(rec.origin);
+                switch (rec.type)
+                {
+                    case event::ENQUEUE:
+                        write(rec, r->tid, "i", "enqueue", ",\"s\":\"t\"");
+                        write(rec, r->tid, "s", "queue", "");
+                        break;
+                    case event::STEAL:
+                        write(rec, r->tid, "i", "steal", ",\"s\":\"t\"");
+                        break;
+                    case event::START:
+                        if (rec.origin == source::JOB)
+                            write(rec, r->tid, "f", "queue", ",\"bp\":\"e\"");
+                        write(rec, r->tid, "B", name, "");
+                        break;
+                    case event::END:
+                        write(rec, r->tid, "E", name, "");
+                        break;
+                    case event::CANCEL:
+                        write(rec, r->tid, "i", "cancel", ",\"s\":\"t\"");
+                        break;
+                }
+            }
+        }
+
+        std::fputs("\n]}\n", file);
+        return std::fclose(file) == 0;
+    }
+}
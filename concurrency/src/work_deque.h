@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "../include/executor.h"
+
+namespace ytl::detail
+{
+    /**
+     * @brief Fixed capacity Chase-Lev deque.
+     * The owner pushes and pops at the bottom, thieves steal from the top.
+     * Memory ordering follows Le et al., "Correct and Efficient Work-Stealing
+     * for Weak Memory Models".
+     */
+    template<size_t Capacity = 4096>
+    class work_deque
+    {
+        static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+        static constexpr int64_t mask = Capacity - 1;
+
+    public:
+        bool push(job *j) noexcept
+        {
+            const int64_t b = bottom.load(std::memory_order_relaxed);
+            if (const int64_t t = top.load(std::memory_order_acquire);
+                b - t >= static_cast<int64_t>(Capacity))
+                return false;
+
+            buffer[b & mask].store(j, std::memory_order_release);
+            std::atomic_thread_fence(std::memory_order_release);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return true;
+        }
+
+        job *pop() noexcept
+        {
+            const int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+            bottom.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t t = top.load(std::memory_order_relaxed);
+
+            if (t > b)
+            {
+                bottom.store(b + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+
+            job *j = buffer[b & mask].load(std::memory_order_relaxed);
+            if (t == b)
+            {
+                if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                    j = nullptr;
+                bottom.store(b + 1, std::memory_order_relaxed);
+            }
+            return j;
+        }
+
+        job *steal() noexcept
+        {
+            int64_t t = top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (const int64_t b = bottom.load(std::memory_order_acquire);
+                t >= b)
+                return nullptr;
+
+            job *j = buffer[t & mask].load(std::memory_order_acquire);
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                return nullptr;
+            return j;
+        }
+
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed);
+        }
+
+    private:
+        alignas(64) std::atomic<int64_t> top { 0 };
+        alignas(64) std::atomic<int64_t> bottom { 0 };
+        alignas(64) std::atomic<job *> buffer[Capacity] {};
+    };
+}
@@ -0,0 +1,411 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <hash.h>
+#include <string.h>
+
+// string/include shadows the libc header, so the references are declared here
+extern "C"
+{
+    size_t strlen(const char *s);
+    size_t strnlen(const char *s, size_t maxlen);
+    char *strcpy(char *dest, const char *src);
+    char *strncpy(char *dest, const char *src, size_t count);
+    char *strcat(char *dest, const char *src);
+    char *strncat(char *dest, const char *src, size_t count);
+    int strcmp(const char *s1, const char *s2);
+    int strncmp(const char *s1, const char *s2, size_t count);
+    int strcasecmp(const char *s1, const char *s2);
+    int strncasecmp(const char *s1, const char *s2, size_t count);
+    char *strchr(const char *s, int ch);
+    char *strrchr(const char *s, int ch);
+    char *strstr(const char *haystack, const char *needle);
+    int memcmp(const void *s1, const void *s2, size_t count);
+    void *memcpy(void *dest, const void *src, size_t count);
+}
+
+namespace
+{
+    /**
+     * @brief Input layout: the byte searched for, a 16-bit count, a 16-bit
+     * split, then the bytes. The bytes before the split are the first string,
+     * the rest the second, each cut at its first zero by the functions reading it.
+     */
+    constexpr size_t HEADER = 5;
+    constexpr size_t MAX_INPUT = size_t { 1 } << 16;
+
+    /**
+     * @brief Pages with an inaccessible page on either side. Inputs are placed
+     * flush against one of the guards, so a kernel reading a byte outside its
+     * string faults instead of reading a neighbour's memory.
+     */
+    class guarded
+    {
+    public:
+        guarded()
+        {
+            const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+            room = (MAX_INPUT + 2 * page - 1) / page * page;
+            void *map = mmap(nullptr, room + 2 * page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (map == MAP_FAILED)
+                std::abort();
+            base = static_cast<char *>(map) + page;
+            if (mprotect(map, page, PROT_NONE) || mprotect(base + room, page, PROT_NONE))
+                std::abort();
+        }
+
+        guarded(const guarded &) = delete;
+
+        guarded &operator=(const guarded &) = delete;
+
+        /**
+         * @param at_end Place the bytes against the trailing guard, otherwise against the leading one
+         * @return Start of length writable bytes
+         */
+        char *slot(const size_t length, const bool at_end) const noexcept
+        {
+            return at_end ? base + room - length : base;
+        }
+
+        char *place(const char *bytes, const size_t length, const bool at_end) const noexcept
+        {
+            char *p = slot(length, at_end);
+            if (length)
+                ::memcpy(p, bytes, length);
+            return p;
+        }
+
+    private:
+        char *base;
+        size_t room;
+    };
+
+    const guarded &first_region()
+    {
+        static const guarded region;
+        return region;
+    }
+
+    const guarded &second_region()
+    {
+        static const guarded region;
+        return region;
+    }
+
+    const guarded &dest_region()
+    {
+        static const guarded region;
+        return region;
+    }
+
+    const char *current_level = "";
+    const uint8_t *current_input = nullptr;
+    size_t current_size = 0;
+
+    [[noreturn]] void fail(const char *function)
+    {
+        std::fprintf(stderr, "mismatch in %s at simd level %s\n", function, current_level);
+#ifndef YTL_LIBFUZZER
+        // libFuzzer saves the input of a crash itself
+        if (FILE *file = std::fopen("mismatch.bin", "wb"))
+        {
+            std::fwrite(current_input, 1, current_size, file);
+            std::fclose(file);
+            std::fprintf(stderr, "input written to mismatch.bin\n");
+        }
+#endif
+        std::abort();
+    }
+
+    void check(const bool ok, const char *function)
+    {
+        if (!ok)
+            fail(function);
+    }
+
+    int sign(const int x)
+    {
+        return (x > 0) - (x < 0);
+    }
+
+    // References for the functions libc lacks, written for obviousness
+    const char *reference_strnchr(const char *s, size_t count, const int ch)
+    {
+        for (; count; --count, ++s)
+        {
+            if (*s == static_cast<char>(ch))
+                return s;
+            if (!*s)
+                break;
+        }
+        return nullptr;
+    }
+
+    const char *reference_strnstr(const char *s, const char *needle, const size_t length)
+    {
+        const size_t n = ::strlen(needle);
+        const size_t limit = ::strnlen(s, length);
+        for (size_t i = 0; i + n <= limit; ++i)
+        {
+            if (!::memcmp(s + i, needle, n))
+                return s + i;
+        }
+        return nullptr;
+    }
+
+    size_t reference_strlcpy(char *dest, const char *src, const size_t size)
+    {
+        const size_t length = ::strlen(src);
+        if (size)
+        {
+            const size_t n = length < size - 1 ? length : size - 1;
+            ::memcpy(dest, src, n);
+            dest[n] = '\0';
+        }
+        return length;
+    }
+
+    size_t reference_strlcat(char *dest, const char *src, const size_t size)
+    {
+        const size_t used = ::strnlen(dest, size);
+        if (used == size)
+            return size + ::strlen(src);
+        return used + reference_strlcpy(dest + used, src, size - used);
+    }
+
+    int reference_memcasecmp(const char *s1, const char *s2, const size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            const auto c1 = static_cast<unsigned char>(ytl::to_lower(s1[i]));
+            const auto c2 = static_cast<unsigned char>(ytl::to_lower(s2[i]));
+            if (c1 != c2)
+                return c1 - c2;
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Compare every string.h function on one placement of the input
+     */
+    void run(const std::string_view a, const std::string_view b, const int ch, const size_t count, const bool at_end)
+    {
+        // Terminated copies against a guard, and the raw bytes for the length bounded functions
+        std::vector<char> terminated_a(a.begin(), a.end());
+        terminated_a.push_back('\0');
+        std::vector<char> terminated_b(b.begin(), b.end());
+        terminated_b.push_back('\0');
+        const char *s1 = first_region().place(terminated_a.data(), terminated_a.size(), at_end);
+        const char *s2 = second_region().place(terminated_b.data(), terminated_b.size(), at_end);
+        const size_t len1 = ::strlen(s1);
+        const size_t len2 = ::strlen(s2);
+
+        check(ytl::strlen(s1) == len1, "strlen");
+        check(ytl::strnlen(s1, count) == ::strnlen(s1, count), "strnlen");
+
+        check(ytl::strchr(s1, ch) == ::strchr(s1, ch), "strchr");
+        check(ytl::strrchr(s1, ch) == ::strrchr(s1, ch), "strrchr");
+        check(ytl::strnchr(s1, count, ch) == reference_strnchr(s1, count, ch), "strnchr");
+        check(ytl::strstr(s1, s2) == ::strstr(s1, s2), "strstr");
+        check(ytl::strnstr(s1, s2, count) == reference_strnstr(s1, s2, count), "strnstr");
+
+        check(sign(ytl::strcmp(s1, s2)) == sign(::strcmp(s1, s2)), "strcmp");
+        check(sign(ytl::strncmp(s1, s2, count)) == sign(::strncmp(s1, s2, count)), "strncmp");
+        check(sign(ytl::strcasecmp(s1, s2)) == sign(::strcasecmp(s1, s2)), "strcasecmp");
+        check(sign(ytl::strncasecmp(s1, s2, count)) == sign(::strncasecmp(s1, s2, count)), "strncasecmp");
+
+        std::vector<char> expected(a.size() + b.size() + 1 + count);
+        char *lowered = dest_region().slot(a.size(), at_end);
+        ytl::to_lower(lowered, a.data(), a.size());
+        for (size_t i = 0; i < a.size(); ++i)
+            check(lowered[i] == ytl::to_lower(a[i]), "to_lower");
+        check(ytl::casehash(a.data(), a.size()) == ytl::hash(lowered, a.size()), "casehash");
+        ytl::to_upper(lowered, a.size());
+        for (size_t i = 0; i < a.size(); ++i)
+            check(lowered[i] == ytl::to_upper(a[i]), "to_upper");
+
+        // Writers get exactly the room they may use, so a stray write faults too
+        char *dest = dest_region().slot(len1 + 1, at_end);
+        check(ytl::strcpy(dest, s1) == dest && !::memcmp(dest, s1, len1 + 1), "strcpy");
+
+        dest = dest_region().slot(count, at_end);
+        ::strncpy(expected.data(), s1, count);
+        check(ytl::strncpy(dest, s1, count) == dest && !::memcmp(dest, expected.data(), count), "strncpy");
+
+        dest = dest_region().slot(count, at_end);
+        const size_t copied = reference_strlcpy(expected.data(), s1, count);
+        const size_t written = count ? (copied < count ? copied : count - 1) + 1 : 0;
+        check(ytl::strlcpy(dest, s1, count) == copied && !::memcmp(dest, expected.data(), written), "strlcpy");
+
+        dest = dest_region().slot(len1 + len2 + 1, at_end);
+        ::memcpy(dest, s1, len1 + 1);
+        ::strcat(::strcpy(expected.data(), s1), s2);
+        check(ytl::strcat(dest, s2) == dest && !::memcmp(dest, expected.data(), len1 + len2 + 1), "strcat");
+
+        const size_t appended = len2 < count ? len2 : count;
+        dest = dest_region().slot(len1 + appended + 1, at_end);
+        ::memcpy(dest, s1, len1 + 1);
+        ::strncat(::strcpy(expected.data(), s1), s2, count);
+        check(ytl::strncat(dest, s2, count) == dest && !::memcmp(dest, expected.data(), len1 + appended + 1),
+              "strncat");
+
+        // strlcat reads at most size bytes of dest, which need not be terminated within them
+        const size_t size = count < a.size() ? count : a.size();
+        dest = first_region().place(a.data(), size, at_end);
+        ::memcpy(expected.data(), a.data(), size);
+        const size_t concatenated = reference_strlcat(expected.data(), s2, size);
+        check(ytl::strlcat(dest, s2, size) == concatenated && !::memcmp(dest, expected.data(), size), "strlcat");
+
+        // The byte range functions see exactly their bytes between the guards, the strings are overwritten now
+        const size_t common = a.size() < b.size() ? a.size() : b.size();
+        const char *r1 = first_region().place(a.data(), common, at_end);
+        const char *r2 = second_region().place(b.data(), common, at_end);
+        check(sign(ytl::memcasecmp(r1, r2, common)) == sign(reference_memcasecmp(r1, r2, common)), "memcasecmp");
+    }
+
+    struct level_name
+    {
+        ytl::simd_level level;
+        const char *name;
+    };
+
+    constexpr level_name LEVELS[] = {
+        { ytl::simd_level::SCALAR, "scalar" },
+        { ytl::simd_level::SSE2, "sse2" },
+        { ytl::simd_level::AVX2, "avx2" },
+        { ytl::simd_level::AVX512, "avx512" },
+        { ytl::simd_level::NEON, "neon" },
+    };
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, const size_t size)
+{
+    if (size < HEADER || size - HEADER > MAX_INPUT / 2)
+        return 0;
+
+    const int ch = static_cast<char>(data[0]);
+    const size_t count = data[1] | data[2] << 8;
+    const std::string_view bytes(reinterpret_cast<const char *>(data + HEADER), size - HEADER);
+    const size_t split = data[3] | data[4] << 8;
+    const std::string_view a = bytes.substr(0, split);
+    const std::string_view b = split < bytes.size() ? bytes.substr(split) : std::string_view();
+
+    current_input = data;
+    current_size = size;
+    const ytl::simd_level best = ytl::active_simd();
+    for (const level_name &level: LEVELS)
+    {
+        if (!ytl::select_simd(level.level))
+            continue;
+        current_level = level.name;
+        run(a, b, ch, count, true);
+        run(a, b, ch, count, false);
+    }
+    ytl::select_simd(best);
+    return 0;
+}
+
+#ifndef YTL_LIBFUZZER
+namespace
+{
+    /**
+     * @brief Inputs that hit the interesting paths often: small alphabets so
+     * searches match and compares run long, mixed case, zeros and high bytes,
+     * lengths around vector and page sizes.
+     */
+    std::vector<uint8_t> generate(std::mt19937_64 &rng, const size_t max_length)
+    {
+        using namespace std::string_view_literals;
+        constexpr std::string_view ALPHABETS[] = {
+            "ab"sv, "aAbB"sv, "abcxyzABCXYZ"sv, "a\0b\x80\xff"sv, "0123456789@[`{"sv
+        };
+        const std::string_view alphabet = ALPHABETS[rng() % std::size(ALPHABETS)];
+        const size_t length = rng() % 4 ? rng() % 80 : rng() % (max_length + 1);
+
+        std::vector<uint8_t> input(HEADER + length);
+        for (size_t i = HEADER; i < input.size(); ++i)
+            input[i] = static_cast<uint8_t>(rng() % 8 ? alphabet[rng() % alphabet.size()] : rng());
+
+        // Half the time the second string repeats part of the first
+        const size_t split = length ? rng() % (length + 1) : 0;
+        if (rng() % 2 && split)
+        {
+            const size_t from = rng() % split;
+            for (size_t i = split; i < length && from + i - split < split; ++i)
+                input[HEADER + i] = input[HEADER + from + i - split];
+        }
+        input[0] = static_cast<uint8_t>(rng() % 2 ? alphabet[rng() % alphabet.size()] : rng());
+        const size_t count = rng() % 4 ? rng() % (length + 2) : rng() % 0x10000;
+        input[1] = static_cast<uint8_t>(count);
+        input[2] = static_cast<uint8_t>(count >> 8);
+        input[3] = static_cast<uint8_t>(split);
+        input[4] = static_cast<uint8_t>(split >> 8);
+        return input;
+    }
+
+    bool replay(const char *path)
+    {
+        FILE *file = std::fopen(path, "rb");
+        if (!file)
+            return false;
+        std::vector<uint8_t> input;
+        uint8_t chunk[4096];
+        for (size_t n; (n = std::fread(chunk, 1, sizeof(chunk), file));)
+            input.insert(input.end(), chunk, chunk + n);
+        std::fclose(file);
+        LLVMFuzzerTestOneInput(input.data(), input.size());
+        return true;
+    }
+}
+
+/**
+ * Without libFuzzer the harness replays the files it is given, or runs
+ * generated inputs: string [--runs N] [--seed S] [--max-length L]
+ */
+int main(const int argc, char **argv)
+{
+    size_t runs = 100000;
+    uint64_t seed = 1;
+    size_t max_length = 4096;
+    size_t replayed = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string_view arg = argv[i];
+        if (arg == "--runs" && i + 1 < argc)
+            runs = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--seed" && i + 1 < argc)
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--max-length" && i + 1 < argc)
+            max_length = std::strtoull(argv[++i], nullptr, 10);
+        else if (replay(argv[i]))
+            replayed++;
+        else
+        {
+            std::fprintf(stderr, "cannot read %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (replayed)
+    {
+        std::printf("replayed %zu inputs\n", replayed);
+        return 0;
+    }
+
+    std::mt19937_64 rng(seed);
+    for (size_t i = 0; i < runs; ++i)
+    {
+        const std::vector<uint8_t> input = generate(rng, max_length);
+        LLVMFuzzerTestOneInput(input.data(), input.size());
+    }
+    std::printf("%zu inputs, no mismatch\n", runs);
+    return 0;
+}
+#endif
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace ytl
+{
+    /**
+     * @brief Secret words mixed into every hash. Tables facing untrusted keys should
+     * use a random key, so colliding inputs cannot be computed offline.
+     */
+    class hash_key
+    {
+    public:
+        static constexpr size_t WORDS = 24;
+
+        /**
+         * @brief Key expanded from a seed, the same seed always gives the same key
+         */
+        constexpr explicit hash_key(uint64_t seed) noexcept : secret {}
+        {
+            // wyrand steps, redrawn until the word has about as many ones as zeros,
+            // sparse words would leave the multiplies they feed weak
+            for (uint64_t &word: secret)
+            {
+                do
+                {
+                    seed += 0xA0761D6478BD642F;
+                    const auto m = static_cast<unsigned __int128>(seed) * (seed ^ 0xE7037ED1A0B428DB);
+                    word = static_cast<uint64_t>(m) ^ static_cast<uint64_t>(m >> 64);
+                }
+                while (std::popcount(word) < 28 || std::popcount(word) > 36);
+            }
+        }
+
+        /**
+         * @brief Key seeded from the system entropy source
+         */
+        [[nodiscard]] static hash_key random();
+
+        [[nodiscard]] constexpr const uint64_t *words() const noexcept
+        {
+            return secret;
+        }
+
+    private:
+        uint64_t secret[WORDS];
+    };
+
+    /**
+     * @brief Key behind the hash overloads that take none
+     */
+    inline constexpr hash_key DEFAULT_HASH_KEY { 0 };
+
+    /**
+     * @brief 64 bit hash of a byte range. Up to 256 bytes are folded with 128 bit
+     * multiplies, longer inputs run eight vector lanes over 64 byte stripes.
+     * Not cryptographic, and stable only within one build.
+     */
+    [[nodiscard]] uint64_t hash(const void *data, size_t length, uint64_t seed = 0) noexcept;
+
+    /**
+     * @brief Hash under a secret key, for tables an attacker may try to flood
+     */
+    [[nodiscard]] uint64_t hash(const void *data, size_t length, const hash_key &key, uint64_t seed = 0) noexcept;
+
+    [[nodiscard]] inline uint64_t hash(const std::span<const std::byte> bytes, const uint64_t seed = 0) noexcept
+    {
+        return hash(bytes.data(), bytes.size(), seed);
+    }
+
+    /**
+     * @brief Incremental form of hash, the digest equals the one-shot hash of all
+     * bytes passed to update, however they were split
+     */
+    class hasher
+    {
+    public:
+        explicit hasher(uint64_t seed = 0) noexcept;
+
+        /**
+         * @param key Must outlive the hasher
+         */
+        explicit hasher(const hash_key &key, uint64_t seed = 0) noexcept;
+
+        void update(const void *data, size_t length) noexcept;
+
+        void update(const std::span<const std::byte> bytes) noexcept
+        {
+            update(bytes.data(), bytes.size());
+        }
+
+        [[nodiscard]] uint64_t digest() const noexcept;
+
+        /**
+         * @brief Start over with the same key and seed
+         */
+        void reset() noexcept;
+
+    private:
+        static constexpr size_t STRIPE = 64;
+        static constexpr size_t BUFFER = 256;
+
+        const hash_key *key;
+        uint64_t seed;
+        uint64_t total { 0 };
+        uint64_t acc[8];
+        // Stripes accumulated since the last scramble
+        size_t block_stripes { 0 };
+        size_t buffered { 0 };
+        // The last consumed stripe sits right before the buffer, the final stripe
+        // of a short tail overlaps into it
+        alignas(STRIPE) unsigned char bytes[STRIPE + BUFFER];
+    };
+}
@@ -0,0 +1,295 @@
+#include "../include/hash.h"
+#include "stripes.h"
+
+#include <random>
+
+namespace ytl
+{
+    namespace detail
+    {
+        namespace
+        {
+            constexpr uint64_t PRIME32_1 = 0x9E3779B1;
+            constexpr uint64_t PRIME64_1 = 0x9E3779B185EBCA87;
+
+            // Byte offsets into the key. The final stripe and the merge read it unaligned,
+            // so their words never repeat those of an accumulated stripe.
+            constexpr size_t SCRAMBLE_KEY = 128;
+            constexpr size_t LAST_STRIPE_KEY = 121;
+            constexpr size_t MERGE_KEY = 11;
+
+            constexpr size_t SHORT_MAX = 256;
+
+            constexpr uint64_t INITIAL_ACC[8] = {
+                0x00000000C2B2AE3D, 0x9E3779B185EBCA87, 0xC2B2AE3D27D4EB4F, 0x165667B19E3779F9,
+                0x85EBCA77C2B2AE63, 0x0000000085EBCA77, 0x27D4EB2F165667C5, 0x000000009E3779B1
+            };
+
+            uint64_t read8(const unsigned char *p) noexcept
+            {
+                uint64_t v;
+                __builtin_memcpy(&v, p, sizeof(v));
+                return v;
+            }
+
+            uint64_t read4(const unsigned char *p) noexcept
+            {
+                uint32_t v;
+                __builtin_memcpy(&v, p, sizeof(v));
+                return v;
+            }
+
+            /**
+             * @brief Low and high half of the 128 bit product, in place
+             */
+            void mum(uint64_t &a, uint64_t &b) noexcept
+            {
+                const auto m = static_cast<unsigned __int128>(a) * b;
+                a = static_cast<uint64_t>(m);
+                b = static_cast<uint64_t>(m >> 64);
+            }
+
+            uint64_t mix(uint64_t a, uint64_t b) noexcept
+            {
+                mum(a, b);
+                return a ^ b;
+            }
+
+            /**
+             * @brief wyhash, every input byte passes through a full 64 by 64 multiply
+             */
+            inline uint64_t hash_short(const unsigned char *p, const size_t length, uint64_t seed,
+                                const uint64_t *secret) noexcept
+            {
+                seed ^= mix(seed ^ secret[0], secret[1]);
+                uint64_t a;
+                uint64_t b;
+                if (length <= 16)
+                {
+                    if (length >= 4)
+                    {
+                        // Two overlapping reads from each end cover 4 to 16 bytes
+                        const size_t step = length >> 3 << 2;
+                        a = read4(p) << 32 | read4(p + step);
+                        b = read4(p + length - 4) << 32 | read4(p + length - 4 - step);
+                    }
+                    else if (length)
+                    {
+                        a = uint64_t { p[0] } << 16 | uint64_t { p[length >> 1] } << 8 | p[length - 1];
+                        b = 0;
+                    }
+                    else
+                        a = b = 0;
+                }
+                else
+                {
+                    size_t i = length;
+                    if (i > 48)
+                    {
+                        uint64_t see1 = seed;
+                        uint64_t see2 = seed;
+                        do
+                        {
+                            seed = mix(read8(p) ^ secret[1], read8(p + 8) ^ seed);
+                            see1 = mix(read8(p + 16) ^ secret[2], read8(p + 24) ^ see1);
+                            see2 = mix(read8(p + 32) ^ secret[3], read8(p + 40) ^ see2);
+                            p += 48;
+                            i -= 48;
+                        }
+                        while (i > 48);
+                        seed ^= see1 ^ see2;
+                    }
+                    for (; i > 16; i -= 16, p += 16)
+                        seed = mix(read8(p) ^ secret[1], read8(p + 8) ^ seed);
+                    // The last 16 bytes, overlapping the ones already mixed
+                    a = read8(p + i - 16);
+                    b = read8(p + i - 8);
+                }
+                a ^= secret[1];
+                b ^= seed;
+                mum(a, b);
+                return mix(a ^ secret[0] ^ length, b ^ secret[1]);
+            }
+
+            accumulate_fn pick() noexcept
+            {
+#ifdef YTL_HASH_X86
+                __builtin_cpu_init();
+                return __builtin_cpu_supports("avx2") ? accumulate_avx2 : accumulate_sse2;
+#elif defined(YTL_HASH_NEON)
+                return accumulate_neon;
+#else
+                return accumulate_scalar;
+#endif
+            }
+
+            void accumulate(uint64_t *acc, const unsigned char *p, const unsigned char *key, const size_t count) noexcept
+            {
+                static const accumulate_fn fn = pick();
+                fn(acc, p, key, count);
+            }
+
+            void init(uint64_t *acc, const uint64_t seed) noexcept
+            {
+                for (size_t i = 0; i < 8; ++i)
+                    acc[i] = INITIAL_ACC[i] ^ seed;
+            }
+
+            /**
+             * @brief Accumulate count stripes, scrambling the lanes after every full block
+             * @param block_stripes Stripes of the current block so far
+             */
+            void consume(uint64_t *acc, size_t &block_stripes, const unsigned char *p, size_t count,
+                         const unsigned char *key) noexcept
+            {
+                while (count)
+                {
+                    const size_t n = count < BLOCK_STRIPES - block_stripes ? count : BLOCK_STRIPES - block_stripes;
+                    accumulate(acc, p, key + block_stripes * 8, n);
+                    p += n * STRIPE_BYTES;
+                    count -= n;
+                    block_stripes += n;
+                    if (block_stripes == BLOCK_STRIPES)
+                    {
+                        // Spreads the high bits down before the sums could lose them
+                        for (size_t i = 0; i < 8; ++i)
+                            acc[i] = (acc[i] ^ acc[i] >> 47 ^ read8(key + SCRAMBLE_KEY + i * 8)) * PRIME32_1;
+                        block_stripes = 0;
+                    }
+                }
+            }
+
+            /**
+             * @brief Fold in the final 64 bytes and reduce the lanes to one word
+             */
+            uint64_t finish(uint64_t *acc, const unsigned char *last, const uint64_t length, const unsigned char *key) noexcept
+            {
+                accumulate(acc, last, key + LAST_STRIPE_KEY, 1);
+                uint64_t h = length * PRIME64_1;
+                for (size_t i = 0; i < 4; ++i)
+                {
+                    h += mix(acc[2 * i] ^ read8(key + MERGE_KEY + i * 16),
+                             acc[2 * i + 1] ^ read8(key + MERGE_KEY + i * 16 + 8));
+                }
+                h ^= h >> 37;
+                h *= 0x165667919E3779F9;
+                return h ^ h >> 32;
+            }
+
+            uint64_t hash_long(const unsigned char *p, const size_t length, const uint64_t seed,
+                               const unsigned char *key) noexcept
+            {
+                uint64_t acc[8];
+                init(acc, seed);
+                size_t block_stripes = 0;
+                consume(acc, block_stripes, p, (length - 1) / STRIPE_BYTES, key);
+                return finish(acc, p + length - STRIPE_BYTES, length, key);
+            }
+
+            const unsigned char *key_bytes(const hash_key &key) noexcept
+            {
+                return reinterpret_cast<const unsigned char *>(key.words());
+            }
+        }
+
+        void accumulate_scalar(uint64_t *acc, const unsigned char *p, const unsigned char *key, size_t count) noexcept
+        {
+            for (; count; --count, p += STRIPE_BYTES, key += 8)
+            {
+                for (size_t i = 0; i < 8; ++i)
+                {
+                    const uint64_t data = read8(p + i * 8);
+                    const uint64_t x = data ^ read8(key + i * 8);
+                    acc[i ^ 1] += data;
+                    acc[i] += (x & 0xFFFFFFFF) * (x >> 32);
+                }
+            }
+        }
+    }
+
+    hash_key hash_key::random()
+    {
+        std::random_device device;
+        return hash_key(uint64_t { device() } << 32 | device());
+    }
+
+    uint64_t hash(const void *data, const size_t length, const hash_key &key, const uint64_t seed) noexcept
+    {
+        const auto *p = static_cast<const unsigned char *>(data);
+        return length <= detail::SHORT_MAX ? detail::hash_short(p, length, seed, key.words())
+                                           : detail::hash_long(p, length, seed, detail::key_bytes(key));
+    }
+
+    uint64_t hash(const void *data, const size_t length, const uint64_t seed) noexcept
+    {
+        // Spelled out so the default key folds into the short path
+        const auto *p = static_cast<const unsigned char *>(data);
+        return length <= detail::SHORT_MAX ? detail::hash_short(p, length, seed, DEFAULT_HASH_KEY.words())
+                                           : detail::hash_long(p, length, seed, detail::key_bytes(DEFAULT_HASH_KEY));
+    }
+
+    hasher::hasher(const uint64_t seed) noexcept : hasher(DEFAULT_HASH_KEY, seed) {}
+
+    hasher::hasher(const hash_key &key, const uint64_t seed) noexcept : key(&key), seed(seed)
+    {
+        detail::init(acc, seed);
+    }
+
+    void hasher::reset() noexcept
+    {
+        total = 0;
+        block_stripes = 0;
+        buffered = 0;
+        detail::init(acc, seed);
+    }
+
+    void hasher::update(const void *data, size_t length) noexcept
+    {
+        const auto *p = static_cast<const unsigned char *>(data);
+        total += length;
+        if (length <= BUFFER - buffered)
+        {
+            if (length)
+                __builtin_memcpy(bytes + STRIPE + buffered, p, length);
+            buffered += length;
+            return;
+        }
+
+        // More input follows a full buffer, so none of it is the final stripe
+        const unsigned char *k = detail::key_bytes(*key);
+        const size_t fill = BUFFER - buffered;
+        __builtin_memcpy(bytes + STRIPE + buffered, p, fill);
+        p += fill;
+        length -= fill;
+        detail::consume(acc, block_stripes, bytes + STRIPE, BUFFER / STRIPE, k);
+        const unsigned char *last = bytes + BUFFER;
+
+        if (length > BUFFER)
+        {
+            // Stream large inputs straight through, leaving 1 to 64 bytes behind
+            const size_t stripes = (length - 1) / STRIPE;
+            detail::consume(acc, block_stripes, p, stripes, k);
+            last = p + (stripes - 1) * STRIPE;
+            p += stripes * STRIPE;
+            length -= stripes * STRIPE;
+        }
+        __builtin_memcpy(bytes, last, STRIPE);
+        __builtin_memcpy(bytes + STRIPE, p, length);
+        buffered = length;
+    }
+
+    uint64_t hasher::digest() const noexcept
+    {
+        static_assert(BUFFER == detail::SHORT_MAX, "a buffered input must still hash as a short one");
+        if (total <= detail::SHORT_MAX)
+            return detail::hash_short(bytes + STRIPE, total, seed, key->words());
+
+        const unsigned char *k = detail::key_bytes(*key);
+        uint64_t lanes[8];
+        __builtin_memcpy(lanes, acc, sizeof(lanes));
+        size_t stripes = block_stripes;
+        detail::consume(lanes, stripes, bytes + STRIPE, (buffered - 1) / STRIPE, k);
+        // Reaches back into the previous stripe when fewer than 64 bytes are buffered
+        return detail::finish(lanes, bytes + buffered, total, k);
+    }
+}
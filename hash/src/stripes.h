@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__)
+#define YTL_HASH_X86 1
+#elif defined(__aarch64__)
+#define YTL_HASH_NEON 1
+#endif
+
+namespace ytl::detail
+{
+    inline constexpr size_t STRIPE_BYTES = 64;
+
+    /**
+     * @brief Stripes between two scrambles, the key slides one word per stripe
+     */
+    inline constexpr size_t BLOCK_STRIPES = 16;
+
+    /**
+     * @brief Fold count stripes into the eight lanes of acc. Each lane adds the product
+     * of the low and high half of its keyed word, and the unkeyed word of its neighbour.
+     * @param key Key of the first stripe, stripe i uses the 64 bytes 8 * i further on
+     */
+    using accumulate_fn = void (*)(uint64_t *acc, const unsigned char *p, const unsigned char *key,
+                                   size_t count) noexcept;
+
+    void accumulate_scalar(uint64_t *acc, const unsigned char *p, const unsigned char *key, size_t count) noexcept;
+#ifdef YTL_HASH_X86
+    void accumulate_sse2(uint64_t *acc, const unsigned char *p, const unsigned char *key, size_t count) noexcept;
+    void accumulate_avx2(uint64_t *acc, const unsigned char *p, const unsigned char *key, size_t count) noexcept;
+#endif
+#ifdef YTL_HASH_NEON
+    void accumulate_neon(uint64_t *acc, const unsigned char *p, const unsigned char *key, size_t count) noexcept;
+#endif
+}
@@ -0,0 +1,32 @@
+#include "stripes.h"
+
+#ifdef YTL_HASH_X86
+#include <immintrin.h>
+
+namespace ytl::detail
+{
+    void accumulate_avx2(uint64_t *acc, const unsigned char *p, const unsigned char *key, size_t count) noexcept
+    {
+        __m256i lanes[2];
+        for (size_t i = 0; i < 2; ++i)
+            lanes[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(acc + i * 4));
+
+        for (; count; --count, p += STRIPE_BYTES, key += 8)
+        {
+            for (size_t i = 0; i < 2; ++i)
+            {
+                const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i * 32));
+                const __m256i x =
+                        _mm256_xor_si256(data, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(key + i * 32)));
+                const __m256i product = _mm256_mul_epu32(x, _mm256_srli_epi64(x, 32));
+                // Swaps the words within each 128 bit half, neighbours never cross halves
+                const __m256i swapped = _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+                lanes[i] = _mm256_add_epi64(lanes[i], _mm256_add_epi64(product, swapped));
+            }
+        }
+
+        for (size_t i = 0; i < 2; ++i)
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(acc + i * 4), lanes[i]);
+    }
+}
+#endif
@@ -0,0 +1,29 @@
+#include "stripes.h"
+
+#ifdef YTL_HASH_NEON
+#include <arm_neon.h>
+
+namespace ytl::detail
+{
+    void accumulate_neon(uint64_t *acc, const unsigned char *p, const unsigned char *key, size_t count) noexcept
+    {
+        uint64x2_t lanes[4];
+        for (size_t i = 0; i < 4; ++i)
+            lanes[i] = vld1q_u64(acc + i * 2);
+
+        for (; count; --count, p += STRIPE_BYTES, key += 8)
+        {
+            for (size_t i = 0; i < 4; ++i)
+            {
+                const uint64x2_t data = vreinterpretq_u64_u8(vld1q_u8(p + i * 16));
+                const uint64x2_t x = veorq_u64(data, vreinterpretq_u64_u8(vld1q_u8(key + i * 16)));
+                const uint64x2_t product = vmull_u32(vmovn_u64(x), vshrn_n_u64(x, 32));
+                lanes[i] = vaddq_u64(lanes[i], vaddq_u64(product, vextq_u64(data, data, 1)));
+            }
+        }
+
+        for (size_t i = 0; i < 4; ++i)
+            vst1q_u64(acc + i * 2, lanes[i]);
+    }
+}
+#endif
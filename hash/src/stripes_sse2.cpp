@@ -0,0 +1,30 @@
+#include "stripes.h"
+
+#ifdef YTL_HASH_X86
+#include <immintrin.h>
+
+namespace ytl::detail
+{
+    void accumulate_sse2(uint64_t *acc, const unsigned char *p, const unsigned char *key, size_t count) noexcept
+    {
+        __m128i lanes[4];
+        for (size_t i = 0; i < 4; ++i)
+            lanes[i] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(acc + i * 2));
+
+        for (; count; --count, p += STRIPE_BYTES, key += 8)
+        {
+            for (size_t i = 0; i < 4; ++i)
+            {
+                const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i * 16));
+                const __m128i x = _mm_xor_si128(data, _mm_loadu_si128(reinterpret_cast<const __m128i *>(key + i * 16)));
+                const __m128i product = _mm_mul_epu32(x, _mm_srli_epi64(x, 32));
+                const __m128i swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+                lanes[i] = _mm_add_epi64(lanes[i], _mm_add_epi64(product, swapped));
+            }
+        }
+
+        for (size_t i = 0; i < 4; ++i)
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(acc + i * 2), lanes[i]);
+    }
+}
+#endif
@@ -50,6 +50,8 @@ namespace ytl
         uint32_t generation;
     };
 
+    class RequestPool;
+
     struct alignas(32) RequestData
     {
         HTTPS_STATE state;
@@ -60,7 +62,7 @@ namespace ytl
         uint32_t data_offset;
         uint32_t data_length;
         CURL *curl;
-        char padding[4];
+        RequestPool *pool;
     };
 
     class RequestPool
@@ -119,7 +121,7 @@ namespace ytl
 
         [[nodiscard]] bool valid_handle(RequestHandle handle) const;
 
-        size_t write_cb(char *ptr, size_t size, size_t nmemb, void *userdata);
+        static size_t write_cb(char *ptr, size_t size, size_t nmemb, void *userdata);
 
         void init_curl_handle(CURL *curl, RequestData &req);
     };
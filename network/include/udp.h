@@ -7,6 +7,8 @@
 #include <vector>
 #include <netinet/in.h>
 
+#include <hash.h>
+
 namespace ytl
 {
     inline constexpr size_t MAX_BUFFERED_PACKETS = 8;
@@ -68,6 +70,14 @@ namespace ytl
         }
 
         [[nodiscard]] bool operator==(const Address &other) const noexcept;
+
+        /**
+         * @brief Hash of the first addr_len bytes, the ones operator== compares
+         */
+        [[nodiscard]] uint64_t hash(uint64_t seed = 0) const noexcept
+        {
+            return ytl::hash(storage, static_cast<size_t>(addr_len), seed);
+        }
     };
 
     struct alignas(32) PacketData
@@ -180,3 +190,12 @@ namespace ytl
         }
     }
 }
+
+template<>
+struct std::hash<ytl::Address>
+{
+    size_t operator()(const ytl::Address &address) const noexcept
+    {
+        return address.hash();
+    }
+};
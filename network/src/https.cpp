@@ -46,6 +46,7 @@ namespace ytl
         req.data_offset = 0;
         req.data_length = 0;
 
+        req.pool = this;
         req.curl = curl_handles[next_curl_handle++];
         if (next_curl_handle >= MAX_CONCURRENT_REQUESTS)
             next_curl_handle = 0;
@@ -137,7 +138,7 @@ namespace ytl
     {
         if (!valid_handle(handle))
             return {};
-        const auto &[state, error, status_code, url_offset, url_length, data_offset, data_length, curl, padding] =
+        const auto &[state, error, status_code, url_offset, url_length, data_offset, data_length, curl, pool] =
                 requests[handle.index];
         return std::span(
             responses.data() + data_offset,
@@ -201,6 +202,7 @@ namespace ytl
         size_t real_size = size * nmemb;
 
         auto *response_ptr = reinterpret_cast<std::byte *>(ptr);
+        auto &responses = req->pool->responses;
         responses.insert(
             responses.begin() + req->data_offset + req->data_length,
             response_ptr,
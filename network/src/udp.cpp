@@ -1,4 +1,6 @@
 #include "../include/udp.h"
+#include <cerrno>
+#include <cstdlib>
 #include <cstring>
 #include <fcntl.h>
 #include <netdb.h>
@@ -476,10 +478,10 @@ namespace ytl
     Address UDPPool::resolve_host(const std::string_view hostname, const std::string_view port, const bool ipv4)
     {
         const addrinfo hints {
+            .ai_flags = AI_PASSIVE,
             .ai_family = ipv4 ? AF_INET : AF_INET6,
             .ai_socktype = SOCK_DGRAM,
-            .ai_protocol = IPPROTO_UDP,
-            .ai_flags = AI_PASSIVE
+            .ai_protocol = IPPROTO_UDP
         };
 
         addrinfo *result = nullptr;
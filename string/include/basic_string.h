@@ -0,0 +1,333 @@
+#pragma once
+
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <new>
+
+#include <raw_allocator.h>
+
+#include "string_view.h"
+
+namespace ytl
+{
+    /**
+     * @brief Owning, zero terminated string that tracks its length.
+     * Up to 23 characters live inside the 24 byte object. The last inline byte
+     * holds the spare inline capacity, so it doubles as the terminator of a full
+     * inline string. Heap strings flag their capacity word with the top bit,
+     * which lands in that same byte.
+     * @tparam Allocator Heap storage, allocation failure throws std::bad_alloc
+     */
+    template<raw_allocator Allocator = heap_allocator>
+    class basic_string
+    {
+        static_assert(std::endian::native == std::endian::little, "inline layout assumes a little endian target");
+
+    public:
+        using value_type = char;
+        using size_type = size_t;
+        using iterator = char *;
+        using const_iterator = const char *;
+
+        static constexpr size_t npos = string_view::npos;
+
+        /**
+         * @brief Longest string stored without allocating
+         */
+        static constexpr size_t SSO_CAPACITY = 23;
+
+        basic_string() noexcept;
+
+        basic_string(const char *s) : basic_string(string_view(s)) {}
+
+        basic_string(const char *s, size_t length);
+
+        explicit basic_string(string_view s) : basic_string(s.data(), s.size()) {}
+
+        basic_string(size_t count, char c);
+
+        basic_string(const basic_string &other);
+
+        basic_string(basic_string &&other) noexcept;
+
+        ~basic_string();
+
+        basic_string &operator=(const basic_string &other);
+
+        basic_string &operator=(basic_string &&other) noexcept;
+
+        basic_string &operator=(const string_view s)
+        {
+            return assign(s.data(), s.size());
+        }
+
+        basic_string &operator=(const char *s)
+        {
+            return *this = string_view(s);
+        }
+
+        basic_string &assign(const char *s, size_t length);
+
+        [[nodiscard]] const char *data() const noexcept
+        {
+            return small() ? rep.inline_chars : rep.heap.ptr;
+        }
+
+        [[nodiscard]] char *data() noexcept
+        {
+            return small() ? rep.inline_chars : rep.heap.ptr;
+        }
+
+        [[nodiscard]] const char *c_str() const noexcept
+        {
+            return data();
+        }
+
+        [[nodiscard]] size_t size() const noexcept
+        {
+            return small() ? SSO_CAPACITY - static_cast<size_t>(rep.inline_chars[SSO_CAPACITY]) : rep.heap.size;
+        }
+
+        [[nodiscard]] size_t length() const noexcept
+        {
+            return size();
+        }
+
+        [[nodiscard]] size_t capacity() const noexcept
+        {
+            return small() ? SSO_CAPACITY : rep.heap.capacity & ~HEAP_FLAG;
+        }
+
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return !size();
+        }
+
+        char &operator[](const size_t i) noexcept
+        {
+            return data()[i];
+        }
+
+        const char &operator[](const size_t i) const noexcept
+        {
+            return data()[i];
+        }
+
+        [[nodiscard]] char &front() noexcept
+        {
+            return data()[0];
+        }
+
+        [[nodiscard]] char &back() noexcept
+        {
+            return data()[size() - 1];
+        }
+
+        [[nodiscard]] char *begin() noexcept
+        {
+            return data();
+        }
+
+        [[nodiscard]] char *end() noexcept
+        {
+            return data() + size();
+        }
+
+        [[nodiscard]] const char *begin() const noexcept
+        {
+            return data();
+        }
+
+        [[nodiscard]] const char *end() const noexcept
+        {
+            return data() + size();
+        }
+
+        [[nodiscard]] string_view view() const noexcept
+        {
+            return { data(), size() };
+        }
+
+        operator string_view() const noexcept
+        {
+            return view();
+        }
+
+        operator std::string_view() const noexcept
+        {
+            return { data(), size() };
+        }
+
+        /**
+         * @brief Make room for capacity characters without changing the content
+         */
+        void reserve(size_t capacity);
+
+        void resize(size_t count, char c = '\0');
+
+        void clear() noexcept
+        {
+            set_size(0);
+        }
+
+        /**
+         * @brief Move back inline or drop spare heap capacity
+         */
+        void shrink_to_fit();
+
+        void push_back(char c);
+
+        void pop_back() noexcept
+        {
+            set_size(size() - 1);
+        }
+
+        basic_string &append(const char *s, size_t length);
+
+        basic_string &append(const string_view s)
+        {
+            return append(s.data(), s.size());
+        }
+
+        basic_string &append(size_t count, char c);
+
+        basic_string &operator+=(const string_view s)
+        {
+            return append(s.data(), s.size());
+        }
+
+        basic_string &operator+=(const char *s)
+        {
+            return append(string_view(s));
+        }
+
+        basic_string &operator+=(const char c)
+        {
+            push_back(c);
+            return *this;
+        }
+
+        [[nodiscard]] basic_string substr(const size_t pos = 0, const size_t count = npos) const
+        {
+            return basic_string(view().substr(pos, count));
+        }
+
+        [[nodiscard]] int compare(const string_view s) const noexcept
+        {
+            return view().compare(s);
+        }
+
+        [[nodiscard]] bool starts_with(const string_view s) const noexcept
+        {
+            return view().starts_with(s);
+        }
+
+        [[nodiscard]] bool ends_with(const string_view s) const noexcept
+        {
+            return view().ends_with(s);
+        }
+
+        [[nodiscard]] size_t find(const char c, const size_t pos = 0) const noexcept
+        {
+            return view().find(c, pos);
+        }
+
+        [[nodiscard]] size_t find(const string_view s, const size_t pos = 0) const noexcept
+        {
+            return view().find(s, pos);
+        }
+
+        [[nodiscard]] size_t rfind(const char c, const size_t pos = npos) const noexcept
+        {
+            return view().rfind(c, pos);
+        }
+
+        [[nodiscard]] bool contains(const char c) const noexcept
+        {
+            return view().contains(c);
+        }
+
+        [[nodiscard]] bool contains(const string_view s) const noexcept
+        {
+            return view().contains(s);
+        }
+
+        friend bool operator==(const basic_string &a, const basic_string &b) noexcept
+        {
+            return a.view() == b.view();
+        }
+
+        friend bool operator==(const basic_string &a, const string_view b) noexcept
+        {
+            return a.view() == b;
+        }
+
+        friend bool operator==(const basic_string &a, const char *b) noexcept
+        {
+            return a.view() == string_view(b);
+        }
+
+        friend std::strong_ordering operator<=>(const basic_string &a, const basic_string &b) noexcept
+        {
+            return a.view() <=> b.view();
+        }
+
+        friend std::strong_ordering operator<=>(const basic_string &a, const string_view b) noexcept
+        {
+            return a.view() <=> b;
+        }
+
+        friend basic_string operator+(const basic_string &a, const string_view b)
+        {
+            basic_string result;
+            result.reserve(a.size() + b.size());
+            result.append(a.view()).append(b);
+            return result;
+        }
+
+    private:
+        static constexpr size_t HEAP_FLAG = size_t { 1 } << (sizeof(size_t) * 8 - 1);
+
+        struct heap_rep
+        {
+            char *ptr;
+            size_t size;
+            // Capacity without the terminator, top bit set
+            size_t capacity;
+        };
+
+        union
+        {
+            heap_rep heap;
+            char inline_chars[SSO_CAPACITY + 1];
+        } rep;
+
+        [[nodiscard]] bool small() const noexcept
+        {
+            return !(static_cast<unsigned char>(rep.inline_chars[SSO_CAPACITY]) & 0x80);
+        }
+
+        void set_size(size_t size) noexcept;
+
+        /**
+         * @brief Move to a heap buffer of at least capacity characters, keeping the content
+         */
+        void grow(size_t capacity);
+
+        static char *allocate(size_t capacity);
+    };
+
+    using string = basic_string<>;
+}
+
+template<ytl::raw_allocator Allocator>
+struct std::hash<ytl::basic_string<Allocator>>
+{
+    size_t operator()(const ytl::basic_string<Allocator> &s) const noexcept
+    {
+        return ytl::hash(s.view());
+    }
+};
+
+#include "basic_string.inl"
@@ -0,0 +1,211 @@
+#pragma once
+
+namespace ytl
+{
+    template<raw_allocator Allocator>
+    basic_string<Allocator>::basic_string() noexcept
+    {
+        rep.inline_chars[0] = '\0';
+        rep.inline_chars[SSO_CAPACITY] = static_cast<char>(SSO_CAPACITY);
+    }
+
+    template<raw_allocator Allocator>
+    basic_string<Allocator>::basic_string(const char *s, const size_t length) : basic_string()
+    {
+        append(s, length);
+    }
+
+    template<raw_allocator Allocator>
+    basic_string<Allocator>::basic_string(const size_t count, const char c) : basic_string()
+    {
+        append(count, c);
+    }
+
+    template<raw_allocator Allocator>
+    basic_string<Allocator>::basic_string(const basic_string &other) : basic_string()
+    {
+        if (other.small())
+            rep = other.rep;
+        else
+            append(other.data(), other.size());
+    }
+
+    template<raw_allocator Allocator>
+    basic_string<Allocator>::basic_string(basic_string &&other) noexcept : rep(other.rep)
+    {
+        other.rep.inline_chars[0] = '\0';
+        other.rep.inline_chars[SSO_CAPACITY] = static_cast<char>(SSO_CAPACITY);
+    }
+
+    template<raw_allocator Allocator>
+    basic_string<Allocator>::~basic_string()
+    {
+        if (!small())
+            Allocator::deallocate(rep.heap.ptr);
+    }
+
+    template<raw_allocator Allocator>
+    basic_string<Allocator> &basic_string<Allocator>::operator=(const basic_string &other)
+    {
+        if (this != &other)
+            assign(other.data(), other.size());
+        return *this;
+    }
+
+    template<raw_allocator Allocator>
+    basic_string<Allocator> &basic_string<Allocator>::operator=(basic_string &&other) noexcept
+    {
+        if (this != &other)
+        {
+            if (!small())
+                Allocator::deallocate(rep.heap.ptr);
+            rep = other.rep;
+            other.rep.inline_chars[0] = '\0';
+            other.rep.inline_chars[SSO_CAPACITY] = static_cast<char>(SSO_CAPACITY);
+        }
+        return *this;
+    }
+
+    template<raw_allocator Allocator>
+    basic_string<Allocator> &basic_string<Allocator>::assign(const char *s, const size_t length)
+    {
+        if (length > capacity())
+        {
+            // The source may live in the old buffer, which survives until the copy is done
+            char *fresh = allocate(length);
+            __builtin_memcpy(fresh, s, length);
+            if (!small())
+                Allocator::deallocate(rep.heap.ptr);
+            rep.heap = { fresh, length, length | HEAP_FLAG };
+        }
+        else if (length)
+            __builtin_memmove(data(), s, length);
+        set_size(length);
+        return *this;
+    }
+
+    template<raw_allocator Allocator>
+    void basic_string<Allocator>::reserve(const size_t capacity)
+    {
+        if (capacity > this->capacity())
+            grow(capacity);
+    }
+
+    template<raw_allocator Allocator>
+    void basic_string<Allocator>::resize(const size_t count, const char c)
+    {
+        const size_t current = size();
+        if (count > current)
+            append(count - current, c);
+        else
+            set_size(count);
+    }
+
+    template<raw_allocator Allocator>
+    void basic_string<Allocator>::shrink_to_fit()
+    {
+        if (small())
+            return;
+
+        const size_t length = rep.heap.size;
+        if (length == capacity())
+            return;
+
+        char *old = rep.heap.ptr;
+        if (length <= SSO_CAPACITY)
+        {
+            __builtin_memcpy(rep.inline_chars, old, length);
+            rep.inline_chars[length] = '\0';
+            rep.inline_chars[SSO_CAPACITY] = static_cast<char>(SSO_CAPACITY - length);
+        }
+        else
+        {
+            char *fresh = allocate(length);
+            __builtin_memcpy(fresh, old, length + 1);
+            rep.heap = { fresh, length, length | HEAP_FLAG };
+        }
+        Allocator::deallocate(old);
+    }
+
+    template<raw_allocator Allocator>
+    void basic_string<Allocator>::push_back(const char c)
+    {
+        const size_t length = size();
+        if (length == capacity())
+            grow(length + 1);
+        data()[length] = c;
+        set_size(length + 1);
+    }
+
+    template<raw_allocator Allocator>
+    basic_string<Allocator> &basic_string<Allocator>::append(const char *s, const size_t length)
+    {
+        if (!length)
+            return *this;
+
+        const size_t current = size();
+        if (length > capacity() - current)
+        {
+            // Appending a piece of this string, keep its offset across the move
+            const char *base = data();
+            const bool inside = s >= base && s < base + current;
+            const size_t offset = static_cast<size_t>(s - base);
+            grow(current + length);
+            if (inside)
+                s = data() + offset;
+        }
+        __builtin_memcpy(data() + current, s, length);
+        set_size(current + length);
+        return *this;
+    }
+
+    template<raw_allocator Allocator>
+    basic_string<Allocator> &basic_string<Allocator>::append(const size_t count, const char c)
+    {
+        const size_t current = size();
+        if (count > capacity() - current)
+            grow(current + count);
+        __builtin_memset(data() + current, c, count);
+        set_size(current + count);
+        return *this;
+    }
+
+    template<raw_allocator Allocator>
+    void basic_string<Allocator>::set_size(const size_t size) noexcept
+    {
+        if (small())
+        {
+            rep.inline_chars[size] = '\0';
+            rep.inline_chars[SSO_CAPACITY] = static_cast<char>(SSO_CAPACITY - size);
+        }
+        else
+        {
+            rep.heap.size = size;
+            rep.heap.ptr[size] = '\0';
+        }
+    }
+
+    template<raw_allocator Allocator>
+    void basic_string<Allocator>::grow(const size_t capacity)
+    {
+        // Geometric growth keeps repeated appends amortized constant
+        const size_t current = this->capacity();
+        const size_t target = capacity > 2 * current ? capacity : 2 * current;
+        const size_t length = size();
+
+        char *fresh = allocate(target);
+        __builtin_memcpy(fresh, data(), length + 1);
+        if (!small())
+            Allocator::deallocate(rep.heap.ptr);
+        rep.heap = { fresh, length, target | HEAP_FLAG };
+    }
+
+    template<raw_allocator Allocator>
+    char *basic_string<Allocator>::allocate(const size_t capacity)
+    {
+        void *ptr = Allocator::allocate(capacity + 1);
+        if (!ptr)
+            throw std::bad_alloc();
+        return static_cast<char *>(ptr);
+    }
+}
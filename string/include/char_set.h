@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "string_view.h"
+
+namespace ytl
+{
+    namespace detail
+    {
+        /**
+         * @brief Nibble tables tested with byte shuffles, one bit per bucket.
+         * A start matches a bucket when every fingerprint byte k has the bucket
+         * bit in both lo[k][byte & 15] and hi[k][byte >> 4]. Teddy buckets
+         * patterns, a char_set buckets the high nibbles of its members.
+         */
+        struct nibble_masks
+        {
+            static constexpr size_t MAX_FINGERPRINT = 3;
+            static constexpr size_t BUCKETS = 8;
+
+            size_t fingerprint { 0 };
+            uint8_t lo[MAX_FINGERPRINT][16] {};
+            uint8_t hi[MAX_FINGERPRINT][16] {};
+        };
+    }
+
+    /**
+     * @brief Set of bytes searched with one vector lookup per block.
+     * Each high nibble used by the set gets a bucket, the low nibble table
+     * lists the buckets a low nibble belongs to. Sets spanning more than 8 high
+     * nibbles share buckets and confirm each hit against a bitmap.
+     */
+    class char_set
+    {
+    public:
+        constexpr char_set() noexcept = default;
+
+        /**
+         * @param chars Members of the set
+         */
+        explicit char_set(string_view chars) noexcept;
+
+        [[nodiscard]] bool contains(const char c) const noexcept
+        {
+            const auto b = static_cast<unsigned char>(c);
+            return bits[b >> 6] >> (b & 63) & 1;
+        }
+
+        /**
+         * @brief First member in a byte range
+         * @return Pointer to it, nullptr if the range holds none
+         */
+        [[nodiscard]] const char *find(const char *s, size_t count) const noexcept;
+
+        /**
+         * @brief First byte in a range that is not a member
+         */
+        [[nodiscard]] const char *skip(const char *s, size_t count) const noexcept;
+
+    private:
+        uint64_t bits[4] {};
+        detail::nibble_masks masks;
+        // The nibble tables report members only, no bitmap check needed
+        bool exact { true };
+    };
+}
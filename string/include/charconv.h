@@ -0,0 +1,107 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <system_error>
+
+namespace ytl
+{
+    /**
+     * @brief Same layout and meaning as std::to_chars_result, the output is not terminated
+     */
+    struct to_chars_result
+    {
+        char* ptr;
+        std::errc ec;
+    };
+
+    /**
+     * @brief Same layout and meaning as std::from_chars_result
+     */
+    struct from_chars_result
+    {
+        const char* ptr;
+        std::errc ec;
+    };
+
+    namespace detail
+    {
+        template<typename T>
+        concept char_integer = std::integral<T> && !std::same_as<T, bool>;
+
+        to_chars_result to_chars(char* first, char* last, uint64_t magnitude, bool negative) noexcept;
+        from_chars_result from_chars(const char* first, const char* last, uint64_t& magnitude, bool& negative) noexcept;
+    }
+
+    /**
+     * @brief Decimal form of an integer, with a leading '-' when negative
+     * @return Past the last character written, or last with errc::value_too_large
+     */
+    template<detail::char_integer T>
+    to_chars_result to_chars(char* first, char* last, const T value) noexcept
+    {
+        if constexpr (std::is_signed_v<T>)
+        {
+            const auto magnitude = static_cast<uint64_t>(value);
+            return value < 0 ? detail::to_chars(first, last, 0 - magnitude, true)
+                             : detail::to_chars(first, last, magnitude, false);
+        }
+        else
+            return detail::to_chars(first, last, value, false);
+    }
+
+    /**
+     * @brief Shortest form that parses back to the same value, in fixed or
+     * scientific notation, whichever is shorter. Matches the plain std::to_chars overload.
+     */
+    to_chars_result to_chars(char* first, char* last, double value) noexcept;
+    to_chars_result to_chars(char* first, char* last, float value) noexcept;
+
+    /**
+     * @brief Parse a decimal integer, with a leading '-' for signed types only
+     * @return errc::invalid_argument without digits, errc::result_out_of_range when the
+     * value does not fit, value is left alone in both cases
+     */
+    template<detail::char_integer T>
+    from_chars_result from_chars(const char* first, const char* last, T& value) noexcept
+    {
+        if constexpr (std::is_unsigned_v<T>)
+        {
+            if (first != last && *first == '-')
+                return { first, std::errc::invalid_argument };
+        }
+
+        uint64_t magnitude;
+        bool negative;
+        const auto result = detail::from_chars(first, last, magnitude, negative);
+        if (result.ec != std::errc {})
+            return result;
+
+        if constexpr (std::is_signed_v<T>)
+        {
+            using U = std::make_unsigned_t<T>;
+            const uint64_t limit = static_cast<U>(std::numeric_limits<T>::max()) + uint64_t { negative };
+            if (magnitude > limit)
+                return { result.ptr, std::errc::result_out_of_range };
+            value = static_cast<T>(negative ? 0 - static_cast<U>(magnitude) : static_cast<U>(magnitude));
+        }
+        else
+        {
+            if (magnitude > std::numeric_limits<T>::max())
+                return { result.ptr, std::errc::result_out_of_range };
+            value = static_cast<T>(magnitude);
+        }
+        return result;
+    }
+
+    /**
+     * @brief Parse a number in the general format of std::from_chars: optional '-', digits
+     * with an optional point and exponent, or inf, infinity and nan. Correctly rounded.
+     * @return errc::result_out_of_range when the value overflows or a nonzero value
+     * underflows to zero, value is left alone then
+     */
+    from_chars_result from_chars(const char* first, const char* last, double& value) noexcept;
+    from_chars_result from_chars(const char* first, const char* last, float& value) noexcept;
+}
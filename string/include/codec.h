@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <system_error>
+
+#include "char_set.h"
+
+namespace ytl
+{
+    enum class base64_alphabet
+    {
+        /**
+         * @brief RFC 4648 section 4, ends in + and /
+         */
+        STANDARD,
+        /**
+         * @brief RFC 4648 section 5, ends in - and _
+         */
+        URL
+    };
+
+    /**
+     * @brief Outcome of a decoding. On errc::illegal_byte_sequence read is the
+     * offset of the first character that cannot be decoded, everything before
+     * the group holding it is written.
+     */
+    struct decode_result
+    {
+        size_t read;
+        size_t written;
+        std::errc ec;
+    };
+
+    [[nodiscard]] constexpr size_t base64_encoded_length(const size_t length, const bool padding = true) noexcept
+    {
+        return padding ? (length + 2) / 3 * 4 : length / 3 * 4 + (length % 3 ? length % 3 + 1 : 0);
+    }
+
+    /**
+     * @brief Most bytes length characters decode to
+     */
+    [[nodiscard]] constexpr size_t base64_decoded_length(const size_t length) noexcept
+    {
+        return length / 4 * 3 + length % 4 * 3 / 4;
+    }
+
+    /**
+     * @param dest Room for base64_encoded_length(length, padding) characters
+     * @return Characters written
+     */
+    size_t base64_encode(const char* src, size_t length, char* dest,
+                         base64_alphabet alphabet = base64_alphabet::STANDARD, bool padding = true) noexcept;
+
+    /**
+     * @brief Decode and validate. Padding is optional but must be complete when
+     * present, and the bits a final partial group leaves over must be zero.
+     * @param dest Room for base64_decoded_length(length) bytes
+     */
+    decode_result base64_decode(const char* src, size_t length, char* dest,
+                                base64_alphabet alphabet = base64_alphabet::STANDARD) noexcept;
+
+    /**
+     * @param dest Room for 2 * length digits
+     * @return Digits written
+     */
+    size_t hex_encode(const char* src, size_t length, char* dest, bool upper = false) noexcept;
+
+    /**
+     * @brief Decode digit pairs of either case. An odd length fails at the last digit.
+     * @param dest Room for length / 2 bytes
+     */
+    decode_result hex_decode(const char* src, size_t length, char* dest) noexcept;
+
+    /**
+     * @brief Bytes percent_encode escapes by default, all but the RFC 3986
+     * unreserved letters, digits, -, ., _ and ~
+     */
+    [[nodiscard]] const char_set& percent_escapes() noexcept;
+
+    /**
+     * @brief Characters percent_encode writes
+     */
+    [[nodiscard]] size_t percent_encoded_length(const char* src, size_t length,
+                                                const char_set& escaped = percent_escapes()) noexcept;
+
+    /**
+     * @brief Replace the escaped bytes by % and two upper case hex digits
+     * @param dest Room for percent_encoded_length characters, 3 * length at most
+     * @return Characters written
+     */
+    size_t percent_encode(const char* src, size_t length, char* dest,
+                          const char_set& escaped = percent_escapes()) noexcept;
+
+    /**
+     * @brief Decode %XX escapes of either case, other bytes pass through
+     * @param dest Room for length bytes, may be src to decode in place
+     * @param plus_as_space Decode + as a space, as form bodies and queries do
+     */
+    decode_result percent_decode(const char* src, size_t length, char* dest, bool plus_as_space = false) noexcept;
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "char_set.h"
+
+namespace ytl
+{
+    /**
+     * @brief Set of patterns searched in a single pass over the text.
+     * Patterns compile into an Aho-Corasick automaton over byte classes, so the
+     * scan costs one table lookup per text byte whatever the number of patterns.
+     * Small sets are first filtered with Teddy, a vector fingerprint test on the
+     * leading pattern bytes, and fall back to the automaton when the fingerprint
+     * matches too often. Empty patterns never match.
+     */
+    class multi_searcher
+    {
+    public:
+        struct match
+        {
+            /**
+             * @brief Index of the pattern in construction order
+             */
+            uint32_t pattern;
+            size_t offset;
+            size_t length;
+        };
+
+        explicit multi_searcher(std::span<const std::string_view> patterns);
+
+        multi_searcher(const std::initializer_list<std::string_view> patterns)
+            : multi_searcher(std::span(patterns.begin(), patterns.size()))
+        {
+        }
+
+        /**
+         * @brief Report every occurrence of every pattern, overlapping ones included
+         * @param text Text start, may contain zeros
+         * @param length Text length
+         * @param fn Called with each match, a callback returning false stops the scan.
+         * Matches are reported in no particular order.
+         */
+        template<typename Fn>
+            requires std::is_invocable_v<Fn &, const match &>
+        void find_all(const char *text, size_t length, Fn &&fn) const
+        {
+            using callback = std::remove_reference_t<Fn>;
+            scan(text, length, [](void *context, const match &m) -> bool
+            {
+                callback &f = *static_cast<callback *>(context);
+                if constexpr (std::is_void_v<std::invoke_result_t<callback &, const match &>>)
+                {
+                    f(m);
+                    return true;
+                }
+                else
+                    return static_cast<bool>(f(m));
+            }, const_cast<void *>(static_cast<const void *>(std::addressof(fn))));
+        }
+
+        /**
+         * @brief Whether any pattern occurs in the text
+         */
+        [[nodiscard]] bool contains(const char *text, size_t length) const;
+
+        [[nodiscard]] size_t size() const noexcept
+        {
+            return lengths.size();
+        }
+
+    private:
+        using emitter = bool (*)(void *context, const match &m);
+
+        /**
+         * @brief Largest set filtered with Teddy before the automaton runs
+         */
+        static constexpr size_t TEDDY_PATTERNS = 16;
+
+        static constexpr uint32_t NONE = ~uint32_t { 0 };
+
+        static constexpr size_t FINISHED = ~size_t { 0 };
+
+        struct output
+        {
+            // Patterns ending in this state, a range of ids
+            uint32_t begin;
+            uint32_t end;
+            // Next reporting state on the suffix chain plus one, 0 ends the chain
+            uint32_t next;
+        };
+
+        // Pattern bytes back to back
+        std::vector<char> bytes;
+        std::vector<uint32_t> offsets;
+        std::vector<uint32_t> lengths;
+
+        // Automaton, state ids are premultiplied by the class count and the
+        // reporting states are numbered last
+        uint8_t classes_of[256] {};
+        uint32_t classes { 1 };
+        uint32_t first_match { NONE };
+        std::vector<uint32_t> transitions;
+        std::vector<output> outputs;
+        std::vector<uint32_t> ids;
+
+        detail::nibble_masks teddy;
+        std::vector<uint32_t> buckets[detail::nibble_masks::BUCKETS];
+        size_t shortest { 0 };
+
+        void compile();
+
+        void compile_teddy();
+
+        void scan(const char *text, size_t length, emitter emit, void *context) const;
+
+        /**
+         * @brief Teddy pass over the text
+         * @return Offset the automaton continues from, FINISHED when the scan is over
+         */
+        size_t filter(const char *text, size_t length, emitter emit, void *context) const;
+    };
+}
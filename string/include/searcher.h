@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+
+#include "string.h"
+
+namespace ytl
+{
+    /**
+     * @brief Precompiled substring search for a needle used repeatedly.
+     * Short needles go through a vector filter on their first and last byte,
+     * long needles through Two-Way, which is linear in the haystack and needs
+     * no allocation. A short needle that produces too many false candidates
+     * falls back to Two-Way, so adversarial input cannot make a search quadratic.
+     * The searcher does not copy the needle, it must outlive the searcher.
+     */
+    class searcher
+    {
+    public:
+        /**
+         * @param needle Bytes to look for, may contain zeros
+         * @param length Needle length
+         */
+        searcher(const char *needle, size_t length) noexcept;
+
+        /**
+         * @param needle Zero terminated needle
+         */
+        explicit searcher(const char *needle) noexcept : searcher(needle, strlen(needle)) {}
+
+        /**
+         * @brief Find the first occurrence in a byte range
+         * @param haystack Range start
+         * @param length Range length, the range may contain zeros
+         * @return First match, haystack for an empty needle, nullptr if absent
+         */
+        [[nodiscard]] const char *find(const char *haystack, size_t length) const noexcept;
+
+        /**
+         * @brief Find the first occurrence in a zero terminated string.
+         * The terminator is located lazily, a match near the start does not
+         * scan the rest of the string.
+         */
+        [[nodiscard]] const char *find(const char *haystack) const noexcept;
+
+        [[nodiscard]] size_t size() const noexcept
+        {
+            return length;
+        }
+
+    private:
+        /**
+         * @brief Longest needle handled by the first/last byte filter
+         */
+        static constexpr size_t SHORT_NEEDLE = 32;
+
+        const unsigned char *needle;
+        size_t length;
+
+        // Critical factorization for Two-Way
+        size_t split { 0 };
+        size_t period { 0 };
+        size_t memory { 0 };
+
+        /**
+         * @brief Last position plus one of each byte in the needle, 0 if absent.
+         * Only filled for long needles.
+         */
+        size_t shift[256];
+
+        const char *filtered(const char *haystack, size_t length) const noexcept;
+
+        const char *two_way(const char *haystack, size_t length) const noexcept;
+    };
+}
@@ -1,24 +1,132 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
+#include <type_traits>
 
 namespace ytl
 {
+    /**
+     * @brief Instruction set used by the scanning functions, picked at first use
+     */
+    enum class simd_level : uint8_t
+    {
+        SCALAR,
+        SSE2,
+        AVX2,
+        AVX512,
+        NEON
+    };
+
+    [[nodiscard]] simd_level active_simd() noexcept;
+
+    /**
+     * @brief Force an instruction set, meant for benchmarks and differential tests
+     * @param level Instruction set to use from now on
+     * @return False if the CPU or build does not support it, nothing changes then
+     */
+    bool select_simd(simd_level level) noexcept;
+
+    namespace detail
+    {
+        int strncasecmp(const char* s1, const char* s2, size_t count) noexcept;
+    }
+
+    /**
+     * @brief ASCII case conversion, other bytes are left alone
+     */
+    constexpr char to_lower(const char c) noexcept
+    {
+        return c >= 'A' && c <= 'Z' ? static_cast<char>(c | 0x20) : c;
+    }
+
+    constexpr char to_upper(const char c) noexcept
+    {
+        return c >= 'a' && c <= 'z' ? static_cast<char>(c & ~0x20) : c;
+    }
+
+    void to_lower(char* s, size_t length) noexcept;
+    void to_upper(char* s, size_t length) noexcept;
+
+    /**
+     * @brief Converting copy, dest may equal src but not overlap it otherwise
+     */
+    void to_lower(char* dest, const char* src, size_t length) noexcept;
+    void to_upper(char* dest, const char* src, size_t length) noexcept;
+
     size_t strlen(const char* s) noexcept;
-    constexpr size_t strnlen(const char* s, size_t maxlen) noexcept;
+
+    constexpr size_t strnlen(const char* s, size_t maxlen) noexcept
+    {
+        const char* es = s;
+        while (maxlen && *es)
+        {
+            es++;
+            maxlen--;
+        }
+        return es - s;
+    }
 
     char* strcpy(char* dest, const char* src) noexcept;
     char* strncpy(char* dest, const char* src, size_t count) noexcept;
     size_t strlcpy(char* dest, const char* src, size_t size) noexcept;
 
+    /**
+     * @brief Each call measures dest again, build long strings with string_builder
+     */
     char* strcat(char* dest, const char* src) noexcept;
     char* strncat(char* dest, const char* src, size_t count) noexcept;
     size_t strlcat(char* dest, const char* src, size_t size) noexcept;
 
     int strcmp(const char* s1, const char* s2) noexcept;
-    constexpr int strncmp(const char* s1, const char* s2, size_t count) noexcept;
-    constexpr int strcasecmp(const char* s1, const char* s2) noexcept;
-    constexpr int strncasecmp(const char* s1, const char* s2, size_t count) noexcept;
+
+    constexpr int strncmp(const char* s1, const char* s2, size_t count) noexcept
+    {
+        while (count--)
+        {
+            const auto c1 = static_cast<unsigned char>(*s1++);
+            if (const auto c2 = static_cast<unsigned char>(*s2++);
+                c1 != c2)
+                return c1 - c2;
+            if (!c1)
+                break;
+        }
+        return 0;
+    }
+
+    /**
+     * @brief ASCII case-insensitive compare, the result is the difference of the lowered bytes
+     */
+    constexpr int strncasecmp(const char* s1, const char* s2, size_t count) noexcept
+    {
+        if (!std::is_constant_evaluated())
+            return detail::strncasecmp(s1, s2, count);
+
+        while (count--)
+        {
+            const auto c1 = static_cast<unsigned char>(to_lower(*s1++));
+            if (const auto c2 = static_cast<unsigned char>(to_lower(*s2++));
+                c1 != c2 || !c1)
+                return c1 - c2;
+        }
+        return 0;
+    }
+
+    constexpr int strcasecmp(const char* s1, const char* s2) noexcept
+    {
+        return strncasecmp(s1, s2, ~size_t { 0 });
+    }
+
+    /**
+     * @brief ASCII case-insensitive compare of two byte ranges, zeros included
+     */
+    int memcasecmp(const char* s1, const char* s2, size_t count) noexcept;
+
+    /**
+     * @brief Hash that is equal for strings differing only in ASCII case,
+     * the ytl::hash of the lowered bytes
+     */
+    [[nodiscard]] uint64_t casehash(const char* s, size_t length, uint64_t seed = 0) noexcept;
 
     const char* strchr(const char* s, int ch) noexcept;
     const char* strrchr(const char* s, int ch) noexcept;
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/uio.h>
+#endif
+
+#include "basic_string.h"
+
+namespace ytl
+{
+    /**
+     * @brief Text assembled in a chain of chunks. Appends copy into the last
+     * chunk and start a new, larger one when it fills, so nothing written is
+     * ever moved again. The chain goes out through scatter I/O as is, contiguous
+     * storage is only built by flatten and str.
+     * @tparam Allocator Chunk storage, allocation failure throws std::bad_alloc
+     */
+    template<raw_allocator Allocator = heap_allocator>
+    class basic_string_builder
+    {
+    public:
+        /**
+         * @brief Chunk allocations double from the first size up to the largest,
+         * longer appends get a chunk of their own length
+         */
+        static constexpr size_t FIRST_CHUNK = 256;
+        static constexpr size_t MAX_CHUNK = size_t { 64 } << 10;
+
+        /**
+         * @brief Referenced ranges shorter than this are copied, a chunk of their own costs more
+         */
+        static constexpr size_t MIN_REFERENCE = 128;
+
+        basic_string_builder() noexcept = default;
+
+        basic_string_builder(const basic_string_builder &) = delete;
+
+        basic_string_builder(basic_string_builder &&other) noexcept;
+
+        ~basic_string_builder();
+
+        basic_string_builder &operator=(const basic_string_builder &) = delete;
+
+        basic_string_builder &operator=(basic_string_builder &&other) noexcept;
+
+        basic_string_builder &append(const char *s, const size_t length)
+        {
+            if (length && length <= static_cast<size_t>(limit - cursor))
+            {
+                __builtin_memcpy(cursor, s, length);
+                commit(length);
+                return *this;
+            }
+            return append_slow(s, length);
+        }
+
+        basic_string_builder &append(const string_view s)
+        {
+            return append(s.data(), s.size());
+        }
+
+        basic_string_builder &append(size_t count, char c);
+
+        /**
+         * @brief Link caller owned bytes into the chain instead of copying them
+         * @param s Must stay unchanged until the builder is done with it, short ranges are copied
+         */
+        basic_string_builder &append_reference(string_view s);
+
+        void push_back(const char c)
+        {
+            if (cursor == limit)
+                add_chunk(1);
+            *cursor = c;
+            commit(1);
+        }
+
+        basic_string_builder &operator+=(const string_view s)
+        {
+            return append(s.data(), s.size());
+        }
+
+        basic_string_builder &operator+=(const char *s)
+        {
+            return append(string_view(s));
+        }
+
+        basic_string_builder &operator+=(const char c)
+        {
+            push_back(c);
+            return *this;
+        }
+
+        /**
+         * @brief Room to format in place, e.g. with to_chars
+         * @return Start of at least n writable bytes, commit takes the ones used
+         */
+        [[nodiscard]] char *prepare(size_t n);
+
+        /**
+         * @param n Bytes written at the last prepare, at most the ones asked for
+         */
+        void commit(const size_t n) noexcept
+        {
+            cursor += n;
+            tail->size += n;
+            total += n;
+        }
+
+        [[nodiscard]] size_t size() const noexcept
+        {
+            return total;
+        }
+
+        [[nodiscard]] size_t length() const noexcept
+        {
+            return total;
+        }
+
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return !total;
+        }
+
+        /**
+         * @brief Call fn with each non empty chunk in order
+         */
+        template<typename Fn>
+            requires std::is_invocable_v<Fn &, string_view>
+        void for_each(Fn &&fn) const
+        {
+            for (const chunk *c = head; c; c = c->next)
+            {
+                if (c->size)
+                    fn(string_view(c->data, c->size));
+            }
+        }
+
+        /**
+         * @brief Describe the content from offset on as a scatter list
+         * @param count Entries available at out
+         * @return Entries filled, fewer than count once the content runs out
+         */
+        size_t gather(string_view *out, size_t count, size_t offset = 0) const noexcept;
+
+#if defined(__unix__) || defined(__APPLE__)
+        /**
+         * @brief gather for writev, pair with consume after a partial write
+         */
+        size_t gather(iovec *out, size_t count, size_t offset = 0) const noexcept;
+#endif
+
+        /**
+         * @brief Drop the first n bytes, releasing the chunks they empty
+         */
+        void consume(size_t n) noexcept;
+
+        /**
+         * @param dest Room for size() bytes
+         * @return End of the copy
+         */
+        char *copy_to(char *dest) const noexcept;
+
+        /**
+         * @brief Move the content into one chunk
+         * @return The whole content, valid until the builder next changes
+         */
+        string_view flatten();
+
+        [[nodiscard]] basic_string<Allocator> str() const;
+
+        /**
+         * @brief Drop the content, keeping the last chunk for reuse
+         */
+        void clear() noexcept;
+
+    private:
+        /**
+         * @brief Chunk header, followed by its bytes unless it refers to the caller's
+         */
+        struct chunk
+        {
+            chunk *next;
+            const char *data;
+            size_t size;
+        };
+
+        // Writes go to the last chunk between cursor and limit, both null when it is a reference
+        chunk *head { nullptr };
+        chunk *tail { nullptr };
+        char *cursor { nullptr };
+        char *limit { nullptr };
+        size_t total { 0 };
+        size_t next_chunk { FIRST_CHUNK };
+
+        basic_string_builder &append_slow(const char *s, size_t length);
+
+        /**
+         * @brief Start a chunk with room for at least length bytes
+         */
+        void add_chunk(size_t length);
+
+        void link(chunk *c) noexcept;
+
+        void release() noexcept;
+
+        static void *allocate(size_t bytes);
+
+        static char *bytes_of(chunk *c) noexcept
+        {
+            return reinterpret_cast<char *>(c + 1);
+        }
+    };
+
+    using string_builder = basic_string_builder<>;
+}
+
+#include "string_builder.inl"
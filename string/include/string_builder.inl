@@ -0,0 +1,277 @@
+#pragma once
+
+namespace ytl
+{
+    template<raw_allocator Allocator>
+    basic_string_builder<Allocator>::basic_string_builder(basic_string_builder &&other) noexcept
+        : head(other.head), tail(other.tail), cursor(other.cursor), limit(other.limit), total(other.total),
+          next_chunk(other.next_chunk)
+    {
+        other.head = other.tail = nullptr;
+        other.cursor = other.limit = nullptr;
+        other.total = 0;
+        other.next_chunk = FIRST_CHUNK;
+    }
+
+    template<raw_allocator Allocator>
+    basic_string_builder<Allocator>::~basic_string_builder()
+    {
+        release();
+    }
+
+    template<raw_allocator Allocator>
+    basic_string_builder<Allocator> &basic_string_builder<Allocator>::operator=(basic_string_builder &&other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            head = other.head;
+            tail = other.tail;
+            cursor = other.cursor;
+            limit = other.limit;
+            total = other.total;
+            next_chunk = other.next_chunk;
+            other.head = other.tail = nullptr;
+            other.cursor = other.limit = nullptr;
+            other.total = 0;
+            other.next_chunk = FIRST_CHUNK;
+        }
+        return *this;
+    }
+
+    template<raw_allocator Allocator>
+    basic_string_builder<Allocator> &basic_string_builder<Allocator>::append(size_t count, const char c)
+    {
+        while (count)
+        {
+            if (cursor == limit)
+                add_chunk(count);
+            const size_t room = static_cast<size_t>(limit - cursor);
+            const size_t n = count < room ? count : room;
+            __builtin_memset(cursor, c, n);
+            commit(n);
+            count -= n;
+        }
+        return *this;
+    }
+
+    template<raw_allocator Allocator>
+    basic_string_builder<Allocator> &basic_string_builder<Allocator>::append_reference(const string_view s)
+    {
+        if (s.size() < MIN_REFERENCE)
+            return append(s);
+        link(new (allocate(sizeof(chunk))) chunk { nullptr, s.data(), s.size() });
+        // Later appends must follow the reference, so they start a new chunk
+        cursor = limit = nullptr;
+        total += s.size();
+        return *this;
+    }
+
+    template<raw_allocator Allocator>
+    char *basic_string_builder<Allocator>::prepare(const size_t n)
+    {
+        if (!cursor || n > static_cast<size_t>(limit - cursor))
+            add_chunk(n);
+        return cursor;
+    }
+
+    template<raw_allocator Allocator>
+    size_t basic_string_builder<Allocator>::gather(string_view *out, const size_t count, size_t offset) const noexcept
+    {
+        size_t filled = 0;
+        for (const chunk *c = head; c && filled < count; c = c->next)
+        {
+            if (offset >= c->size)
+            {
+                offset -= c->size;
+                continue;
+            }
+            out[filled++] = { c->data + offset, c->size - offset };
+            offset = 0;
+        }
+        return filled;
+    }
+
+#if defined(__unix__) || defined(__APPLE__)
+    template<raw_allocator Allocator>
+    size_t basic_string_builder<Allocator>::gather(iovec *out, const size_t count, size_t offset) const noexcept
+    {
+        size_t filled = 0;
+        for (const chunk *c = head; c && filled < count; c = c->next)
+        {
+            if (offset >= c->size)
+            {
+                offset -= c->size;
+                continue;
+            }
+            // writev only reads through iov_base
+            out[filled++] = { const_cast<char *>(c->data + offset), c->size - offset };
+            offset = 0;
+        }
+        return filled;
+    }
+#endif
+
+    template<raw_allocator Allocator>
+    void basic_string_builder<Allocator>::consume(size_t n) noexcept
+    {
+        total -= n;
+        while (n)
+        {
+            chunk *c = head;
+            if (n < c->size)
+            {
+                c->data += n;
+                c->size -= n;
+                return;
+            }
+            n -= c->size;
+            if (c == tail)
+            {
+                // Everything is gone, a writable last chunk starts over
+                if (cursor)
+                {
+                    cursor = bytes_of(c);
+                    c->data = cursor;
+                    c->size = 0;
+                    return;
+                }
+                head = tail = nullptr;
+            }
+            else
+                head = c->next;
+            Allocator::deallocate(c);
+        }
+    }
+
+    template<raw_allocator Allocator>
+    char *basic_string_builder<Allocator>::copy_to(char *dest) const noexcept
+    {
+        for (const chunk *c = head; c; c = c->next)
+        {
+            if (c->size)
+                __builtin_memcpy(dest, c->data, c->size);
+            dest += c->size;
+        }
+        return dest;
+    }
+
+    template<raw_allocator Allocator>
+    string_view basic_string_builder<Allocator>::flatten()
+    {
+        if (head == tail)
+            return head ? string_view(head->data, head->size) : string_view();
+
+        const size_t room = next_chunk - sizeof(chunk);
+        const size_t capacity = total > room ? total : room;
+        chunk *c = new (allocate(sizeof(chunk) + capacity)) chunk { nullptr, nullptr, 0 };
+        char *bytes = bytes_of(c);
+        const size_t length = static_cast<size_t>(copy_to(bytes) - bytes);
+        release();
+
+        c->data = bytes;
+        c->size = length;
+        link(c);
+        cursor = bytes + length;
+        limit = bytes + capacity;
+        total = length;
+        return { bytes, length };
+    }
+
+    template<raw_allocator Allocator>
+    basic_string<Allocator> basic_string_builder<Allocator>::str() const
+    {
+        basic_string<Allocator> result;
+        result.reserve(total);
+        for_each([&](const string_view s) { result.append(s); });
+        return result;
+    }
+
+    template<raw_allocator Allocator>
+    void basic_string_builder<Allocator>::clear() noexcept
+    {
+        if (!cursor)
+        {
+            release();
+            return;
+        }
+        for (chunk *c = head; c != tail;)
+        {
+            chunk *next = c->next;
+            Allocator::deallocate(c);
+            c = next;
+        }
+        head = tail;
+        cursor = bytes_of(tail);
+        tail->data = cursor;
+        tail->size = 0;
+        total = 0;
+    }
+
+    template<raw_allocator Allocator>
+    basic_string_builder<Allocator> &basic_string_builder<Allocator>::append_slow(const char *s, size_t length)
+    {
+        if (!length)
+            return *this;
+        // Top up the last chunk, the rest goes to one new chunk
+        if (const size_t room = static_cast<size_t>(limit - cursor))
+        {
+            __builtin_memcpy(cursor, s, room);
+            commit(room);
+            s += room;
+            length -= room;
+        }
+        add_chunk(length);
+        __builtin_memcpy(cursor, s, length);
+        commit(length);
+        return *this;
+    }
+
+    template<raw_allocator Allocator>
+    void basic_string_builder<Allocator>::add_chunk(const size_t length)
+    {
+        // Geometric chunk sizes keep the chain logarithmic until they reach the cap
+        const size_t room = next_chunk - sizeof(chunk);
+        const size_t capacity = length > room ? length : room;
+        chunk *c = new (allocate(sizeof(chunk) + capacity)) chunk { nullptr, nullptr, 0 };
+        next_chunk = next_chunk < MAX_CHUNK / 2 ? next_chunk * 2 : MAX_CHUNK;
+
+        cursor = bytes_of(c);
+        limit = cursor + capacity;
+        c->data = cursor;
+        link(c);
+    }
+
+    template<raw_allocator Allocator>
+    void basic_string_builder<Allocator>::link(chunk *c) noexcept
+    {
+        if (tail)
+            tail->next = c;
+        else
+            head = c;
+        tail = c;
+    }
+
+    template<raw_allocator Allocator>
+    void basic_string_builder<Allocator>::release() noexcept
+    {
+        for (chunk *c = head; c;)
+        {
+            chunk *next = c->next;
+            Allocator::deallocate(c);
+            c = next;
+        }
+        head = tail = nullptr;
+        cursor = limit = nullptr;
+        total = 0;
+    }
+
+    template<raw_allocator Allocator>
+    void *basic_string_builder<Allocator>::allocate(const size_t bytes)
+    {
+        void *ptr = Allocator::allocate(bytes);
+        if (!ptr)
+            throw std::bad_alloc();
+        return ptr;
+    }
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <atomic>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+#include "string_view.h"
+
+namespace ytl
+{
+    /**
+     * @brief Set of strings stored once each, named by dense 32-bit symbols.
+     * Bytes live in an arena and stay put for the interner's lifetime, so views
+     * of them never dangle. Finding a string that is already interned takes no
+     * lock, storing a new one is serialized. Symbols of one interner are equal
+     * exactly when their strings are.
+     */
+    class string_interner
+    {
+    public:
+        struct symbol
+        {
+            uint32_t id;
+
+            friend constexpr bool operator==(symbol, symbol) noexcept = default;
+            friend constexpr std::strong_ordering operator<=>(symbol, symbol) noexcept = default;
+        };
+
+        /**
+         * @brief Id of the symbol find returns for strings never interned
+         */
+        static constexpr uint32_t NONE = ~uint32_t { 0 };
+
+        string_interner();
+        ~string_interner();
+
+        string_interner(const string_interner &) = delete;
+        string_interner &operator=(const string_interner &) = delete;
+
+        /**
+         * @brief Symbol of s, storing a copy the first time it is seen
+         * @throws std::bad_alloc, std::length_error past 2^32 - 1 strings or a string of 4 GiB
+         */
+        symbol intern(string_view s);
+
+        /**
+         * @return Symbol of s, id NONE if it was never interned
+         */
+        [[nodiscard]] symbol find(string_view s) const noexcept;
+
+        [[nodiscard]] bool contains(const string_view s) const noexcept
+        {
+            return find(s).id != NONE;
+        }
+
+        /**
+         * @param s Symbol returned by this interner
+         */
+        [[nodiscard]] string_view view(symbol s) const noexcept;
+
+        /**
+         * @brief Interned bytes, followed by a zero
+         */
+        [[nodiscard]] const char *c_str(const symbol s) const noexcept
+        {
+            return entry(s.id);
+        }
+
+        /**
+         * @brief Strings interned so far, every id below it is valid
+         */
+        [[nodiscard]] size_t size() const noexcept
+        {
+            return count.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @brief Bytes held for the strings, their index and the lookup tables
+         */
+        [[nodiscard]] size_t memory_usage() const noexcept
+        {
+            return footprint.load(std::memory_order_relaxed);
+        }
+
+    private:
+        struct table;
+        struct block;
+
+        // Segment k holds FIRST_SEGMENT << k ids, enough for every id below NONE
+        static constexpr size_t FIRST_SEGMENT = 1024;
+        static constexpr size_t SEGMENTS = 23;
+
+        [[nodiscard]] const char *entry(uint32_t id) const noexcept;
+        [[nodiscard]] uint32_t lookup(const table *t, string_view s, uint64_t h) const noexcept;
+        const char *store(string_view s);
+        void grow();
+
+        std::atomic<table *> current;
+        std::atomic<uint32_t> count { 0 };
+        std::atomic<size_t> footprint { 0 };
+        const char **segments[SEGMENTS] {};
+
+        // Writer side, only touched under the lock
+        std::mutex writer;
+        block *blocks { nullptr };
+        char *cursor { nullptr };
+        char *limit { nullptr };
+    };
+}
+
+template<>
+struct std::hash<ytl::string_interner::symbol>
+{
+    size_t operator()(const ytl::string_interner::symbol s) const noexcept
+    {
+        return s.id;
+    }
+};
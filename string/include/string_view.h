@@ -0,0 +1,211 @@
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <string_view>
+
+#include <hash.h>
+
+#include "string.h"
+
+namespace ytl
+{
+    /**
+     * @brief Non-owning character range with the interface of std::string_view.
+     * Converts implicitly from and to std::string_view. Searches run on the
+     * length bounded vector kernels and never look for a terminator, so views
+     * may hold zeros.
+     */
+    class string_view
+    {
+    public:
+        using value_type = char;
+        using size_type = size_t;
+        using iterator = const char *;
+        using const_iterator = const char *;
+
+        static constexpr size_t npos = ~size_t { 0 };
+
+        constexpr string_view() noexcept = default;
+
+        constexpr string_view(const char *s, const size_t length) noexcept : ptr(s), len(length) {}
+
+        /**
+         * @param s Zero terminated string, measured once
+         */
+        string_view(const char *s) noexcept : ptr(s), len(strlen(s)) {}
+
+        constexpr string_view(const std::string_view s) noexcept : ptr(s.data()), len(s.size()) {}
+
+        constexpr operator std::string_view() const noexcept
+        {
+            return { ptr, len };
+        }
+
+        [[nodiscard]] constexpr const char *data() const noexcept
+        {
+            return ptr;
+        }
+
+        [[nodiscard]] constexpr size_t size() const noexcept
+        {
+            return len;
+        }
+
+        [[nodiscard]] constexpr size_t length() const noexcept
+        {
+            return len;
+        }
+
+        [[nodiscard]] constexpr bool empty() const noexcept
+        {
+            return !len;
+        }
+
+        constexpr const char &operator[](const size_t i) const noexcept
+        {
+            return ptr[i];
+        }
+
+        [[nodiscard]] constexpr const char &front() const noexcept
+        {
+            return ptr[0];
+        }
+
+        [[nodiscard]] constexpr const char &back() const noexcept
+        {
+            return ptr[len - 1];
+        }
+
+        [[nodiscard]] constexpr const char *begin() const noexcept
+        {
+            return ptr;
+        }
+
+        [[nodiscard]] constexpr const char *end() const noexcept
+        {
+            return ptr + len;
+        }
+
+        constexpr void remove_prefix(const size_t n) noexcept
+        {
+            ptr += n;
+            len -= n;
+        }
+
+        constexpr void remove_suffix(const size_t n) noexcept
+        {
+            len -= n;
+        }
+
+        /**
+         * @brief Part of the view, pos and count are clamped to its end
+         */
+        [[nodiscard]] constexpr string_view substr(size_t pos = 0, const size_t count = npos) const noexcept
+        {
+            pos = pos < len ? pos : len;
+            return { ptr + pos, count < len - pos ? count : len - pos };
+        }
+
+        [[nodiscard]] int compare(string_view other) const noexcept;
+
+        [[nodiscard]] bool starts_with(const string_view prefix) const noexcept
+        {
+            return len >= prefix.len && (!prefix.len || !__builtin_memcmp(ptr, prefix.ptr, prefix.len));
+        }
+
+        [[nodiscard]] bool ends_with(const string_view suffix) const noexcept
+        {
+            return len >= suffix.len && (!suffix.len || !__builtin_memcmp(ptr + len - suffix.len, suffix.ptr, suffix.len));
+        }
+
+        /**
+         * @return Position of the first c at or after pos, npos if absent
+         */
+        [[nodiscard]] size_t find(char c, size_t pos = 0) const noexcept;
+
+        /**
+         * @return Position of the first occurrence of s at or after pos, npos if absent
+         */
+        [[nodiscard]] size_t find(string_view s, size_t pos = 0) const noexcept;
+
+        /**
+         * @return Position of the last c at or before pos, npos if absent
+         */
+        [[nodiscard]] size_t rfind(char c, size_t pos = npos) const noexcept;
+
+        [[nodiscard]] bool contains(const char c) const noexcept
+        {
+            return find(c) != npos;
+        }
+
+        [[nodiscard]] bool contains(const string_view s) const noexcept
+        {
+            return find(s) != npos;
+        }
+
+        friend bool operator==(const string_view a, const string_view b) noexcept
+        {
+            return a.len == b.len && (!a.len || !__builtin_memcmp(a.ptr, b.ptr, a.len));
+        }
+
+        friend bool operator==(const string_view a, const std::string_view b) noexcept
+        {
+            return a == string_view(b);
+        }
+
+        /**
+         * @brief Literals convert to both view types, this picks one
+         */
+        friend bool operator==(const string_view a, const char *b) noexcept
+        {
+            return a == string_view(b);
+        }
+
+        friend std::strong_ordering operator<=>(const string_view a, const string_view b) noexcept
+        {
+            return a.compare(b) <=> 0;
+        }
+
+        friend std::strong_ordering operator<=>(const string_view a, const std::string_view b) noexcept
+        {
+            return a.compare(b) <=> 0;
+        }
+
+        friend std::strong_ordering operator<=>(const string_view a, const char *b) noexcept
+        {
+            return a.compare(b) <=> 0;
+        }
+
+    private:
+        const char *ptr { nullptr };
+        size_t len { 0 };
+    };
+
+    [[nodiscard]] inline uint64_t hash(const string_view s, const uint64_t seed = 0) noexcept
+    {
+        return hash(s.data(), s.size(), seed);
+    }
+
+    /**
+     * @brief Transparent hash for tables keyed by strings, looked up by any view of one
+     */
+    struct string_hash
+    {
+        using is_transparent = void;
+
+        size_t operator()(const string_view s) const noexcept
+        {
+            return hash(s);
+        }
+    };
+}
+
+template<>
+struct std::hash<ytl::string_view>
+{
+    size_t operator()(const ytl::string_view s) const noexcept
+    {
+        return ytl::hash(s);
+    }
+};
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+
+#include "char_set.h"
+#include "string_view.h"
+
+namespace ytl
+{
+    /**
+     * @brief Input range over the pieces of a text, yielding views into it
+     * @tparam Splitter Provides bool next(string_view &piece) and holds the cursor
+     */
+    template<typename Splitter>
+    class piece_range
+    {
+    public:
+        class iterator
+        {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = string_view;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() noexcept = default;
+
+            explicit iterator(Splitter *owner) noexcept : owner(owner)
+            {
+                ++*this;
+            }
+
+            const string_view &operator*() const noexcept
+            {
+                return piece;
+            }
+
+            const string_view *operator->() const noexcept
+            {
+                return &piece;
+            }
+
+            iterator &operator++() noexcept
+            {
+                if (!owner->next(piece))
+                    owner = nullptr;
+                return *this;
+            }
+
+            void operator++(int) noexcept
+            {
+                ++*this;
+            }
+
+            friend bool operator==(const iterator &a, const iterator &b) noexcept
+            {
+                return a.owner == b.owner;
+            }
+
+        private:
+            Splitter *owner { nullptr };
+            string_view piece;
+        };
+
+        iterator begin() noexcept
+        {
+            return iterator(static_cast<Splitter *>(this));
+        }
+
+        iterator end() noexcept
+        {
+            return {};
+        }
+    };
+
+    /**
+     * @brief Splits a text on any byte of a delimiter set without copying.
+     * Delimiters are found with the vector byte class lookup of char_set.
+     * The set is referenced, it must outlive the tokenizer.
+     */
+    class tokenizer : public piece_range<tokenizer>
+    {
+    public:
+        /**
+         * @param text Text to split
+         * @param delimiters Bytes separating tokens
+         * @param skip_empty Treat a run of delimiters as one, like strtok
+         */
+        tokenizer(const string_view text, const char_set &delimiters, const bool skip_empty = true) noexcept
+            : text(text), delimiters(delimiters), skip_empty(skip_empty)
+        {
+        }
+
+        /**
+         * @brief Advance to the next token
+         * @return False once the text is exhausted
+         */
+        bool next(string_view &token) noexcept;
+
+        /**
+         * @brief Text not consumed yet
+         */
+        [[nodiscard]] string_view rest() const noexcept
+        {
+            return text;
+        }
+
+    private:
+        string_view text;
+        const char_set &delimiters;
+        bool skip_empty;
+        // A delimiter ended the last token, so an empty one may follow
+        bool pending { false };
+    };
+
+    /**
+     * @brief Splits a text into lines ending in \n or \r\n, terminators excluded.
+     * A final line without terminator is yielded when not empty.
+     */
+    class split_lines : public piece_range<split_lines>
+    {
+    public:
+        explicit split_lines(const string_view text) noexcept : text(text) {}
+
+        bool next(string_view &line) noexcept;
+
+        [[nodiscard]] string_view rest() const noexcept
+        {
+            return text;
+        }
+
+    private:
+        string_view text;
+    };
+}
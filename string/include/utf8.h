@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <system_error>
+
+namespace ytl
+{
+    /**
+     * @brief Outcome of a transcoding. On errc::illegal_byte_sequence read is the
+     * offset of the bad sequence, on errc::value_too_large that of the first code
+     * point that did not fit. Everything before it is converted either way.
+     */
+    struct utf_result
+    {
+        size_t read;
+        size_t written;
+        std::errc ec;
+    };
+
+    /**
+     * @brief Whether the bytes are well formed UTF-8: shortest forms only, no
+     * surrogates, nothing above U+10FFFF, no sequence cut off at the end
+     */
+    [[nodiscard]] bool validate_utf8(const char* s, size_t length) noexcept;
+
+    /**
+     * @brief Start of the first ill formed sequence, or s + length
+     */
+    [[nodiscard]] const char* find_invalid_utf8(const char* s, size_t length) noexcept;
+
+    /**
+     * @brief Code points in valid UTF-8, every byte that is not a continuation byte
+     */
+    [[nodiscard]] size_t count_utf8(const char* s, size_t length) noexcept;
+
+    /**
+     * @brief UTF-16 units needed for valid UTF-8
+     */
+    [[nodiscard]] size_t utf16_length(const char* s, size_t length) noexcept;
+
+    /**
+     * @brief UTF-8 bytes needed for valid UTF-16
+     */
+    [[nodiscard]] size_t utf8_length(const char16_t* s, size_t length) noexcept;
+
+    /**
+     * @brief UTF-8 bytes needed for valid UTF-32
+     */
+    [[nodiscard]] size_t utf8_length(const char32_t* s, size_t length) noexcept;
+
+    /**
+     * @brief Transcode and validate in one pass. Output is never split inside a code point.
+     * @param capacity Units available at dest
+     */
+    utf_result utf8_to_utf16(const char* src, size_t length, char16_t* dest, size_t capacity) noexcept;
+    utf_result utf8_to_utf32(const char* src, size_t length, char32_t* dest, size_t capacity) noexcept;
+    utf_result utf16_to_utf8(const char16_t* src, size_t length, char* dest, size_t capacity) noexcept;
+    utf_result utf32_to_utf8(const char32_t* src, size_t length, char* dest, size_t capacity) noexcept;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ytl::detail
+{
+    using uint128 = unsigned __int128;
+
+    /**
+     * @brief Fixed width unsigned integer, only used to build power tables at compile time
+     * @tparam WORDS Number of 64 bit words, little endian
+     */
+    template<size_t WORDS>
+    struct bigint
+    {
+        uint64_t w[WORDS] {};
+
+        constexpr explicit bigint(const uint64_t v = 0) noexcept
+        {
+            w[0] = v;
+        }
+
+        static constexpr bigint power_of_two(const size_t exponent) noexcept
+        {
+            bigint r;
+            r.w[exponent / 64] = uint64_t { 1 } << (exponent % 64);
+            return r;
+        }
+
+        constexpr void multiply(const uint64_t m) noexcept
+        {
+            uint64_t carry = 0;
+            for (size_t i = 0; i < WORDS; ++i)
+            {
+                const uint128 p = static_cast<uint128>(w[i]) * m + carry;
+                w[i] = static_cast<uint64_t>(p);
+                carry = static_cast<uint64_t>(p >> 64);
+            }
+        }
+
+        /**
+         * @brief Floor division, repeating it divides by the product of the divisors
+         */
+        constexpr void divide(const uint64_t d) noexcept
+        {
+            uint128 rest = 0;
+            for (size_t i = WORDS; i--;)
+            {
+                rest = rest << 64 | w[i];
+                w[i] = static_cast<uint64_t>(rest / d);
+                rest %= d;
+            }
+        }
+
+        [[nodiscard]] constexpr size_t bit_width() const noexcept
+        {
+            for (size_t i = WORDS; i--;)
+            {
+                if (w[i])
+                    return i * 64 + 64 - __builtin_clzll(w[i]);
+            }
+            return 0;
+        }
+
+        /**
+         * @brief The 128 bits starting at bit from, bits past the top read as zero
+         */
+        [[nodiscard]] constexpr uint128 extract(const size_t from) const noexcept
+        {
+            const size_t word = from / 64;
+            const size_t bit = from % 64;
+            const auto at = [this](const size_t i) { return i < WORDS ? w[i] : 0; };
+            const auto piece = [&](const size_t i)
+            {
+                return bit ? at(i) >> bit | at(i + 1) << (64 - bit) : at(i);
+            };
+            return static_cast<uint128>(piece(word + 1)) << 64 | piece(word);
+        }
+
+        /**
+         * @brief The value shifted so its top bit lands on bit bits - 1, truncated
+         */
+        [[nodiscard]] constexpr uint128 normalized(const size_t bits) const noexcept
+        {
+            const size_t width = bit_width();
+            if (width > bits)
+                return extract(width - bits);
+            return extract(0) << (bits - width);
+        }
+    };
+}
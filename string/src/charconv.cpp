@@ -0,0 +1,60 @@
+#include "../include/charconv.h"
+#include "digits.h"
+
+namespace ytl::detail
+{
+    to_chars_result to_chars(char *first, char *last, const uint64_t magnitude, const bool negative) noexcept
+    {
+        const size_t length = count_digits(magnitude) + negative;
+        if (static_cast<size_t>(last - first) < length)
+            return { last, std::errc::value_too_large };
+
+        *first = '-';
+        write_digits(first + length, magnitude);
+        return { first + length, std::errc {} };
+    }
+
+    from_chars_result from_chars(const char *first, const char *last, uint64_t &magnitude, bool &negative) noexcept
+    {
+        const char *p = first;
+        negative = p != last && *p == '-';
+        p += negative;
+
+        const char *digits = p;
+        uint64_t v = 0;
+        // Eight digits at a time, a shorter run ends the number. Up to 19 digits always fit,
+        // the 20th of a 64 bit value needs an overflow check.
+        bool open = true;
+        while (open && last - p >= 8 && p - digits < 16)
+        {
+            const uint64_t word = load_eight(p);
+            const unsigned run = digit_run(word);
+            if (run == 8)
+                v = v * 100000000 + parse_eight(word);
+            else
+            {
+                if (run)
+                    v = v * POW10[run] + parse_leading(word, run);
+                open = false;
+            }
+            p += run;
+        }
+        while (open && p != last && is_digit(*p) && p - digits < 19)
+            v = v * 10 + static_cast<uint64_t>(*p++ - '0');
+
+        if (p == digits)
+            return { first, std::errc::invalid_argument };
+
+        bool overflow = false;
+        while (open && p != last && is_digit(*p))
+        {
+            overflow |= __builtin_mul_overflow(v, 10, &v);
+            overflow |= __builtin_add_overflow(v, static_cast<uint64_t>(*p++ - '0'), &v);
+        }
+        if (overflow)
+            return { p, std::errc::result_out_of_range };
+
+        magnitude = v;
+        return { p, std::errc {} };
+    }
+}
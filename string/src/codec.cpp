@@ -0,0 +1,279 @@
+#include "../include/codec.h"
+#include "codec_tables.h"
+#include "simd.h"
+
+namespace ytl::detail
+{
+    namespace
+    {
+        const uint8_t *base64_values(const bool url) noexcept
+        {
+            return url ? base64::URL_VALUES.of : base64::STANDARD_VALUES.of;
+        }
+
+        /**
+         * @brief Decode the group after the whole ones, which is short, padded or bad
+         * @param i Offset of the group
+         */
+        decode_result base64_tail(const char *src, const size_t length, size_t i, char *dest, size_t written,
+                                  const uint8_t *values) noexcept
+        {
+            const auto *p = reinterpret_cast<const unsigned char *>(src);
+            size_t n = 0;
+            while (n < 4 && i + n < length && values[p[i + n]] != base64::INVALID)
+                n++;
+
+            if (i + n < length)
+            {
+                // Only padding may follow the data, and only enough of it to fill the group
+                if (p[i + n] != '=' || n < 2)
+                    return { i + n, written, std::errc::illegal_byte_sequence };
+                for (size_t k = n; k < 4; ++k)
+                {
+                    if (i + k == length || p[i + k] != '=')
+                        return { i + k, written, std::errc::illegal_byte_sequence };
+                }
+                if (i + 4 < length)
+                    return { i + 4, written, std::errc::illegal_byte_sequence };
+            }
+            if (n == 1)
+                return { i, written, std::errc::illegal_byte_sequence };
+
+            if (n)
+            {
+                uint32_t v = 0;
+                for (size_t k = 0; k < n; ++k)
+                    v = v << 6 | values[p[i + k]];
+                // Two characters carry a byte and four spare bits, three carry two bytes and two
+                const unsigned spare = n == 2 ? 4 : 2;
+                if (v & ((1u << spare) - 1))
+                    return { i + n - 1, written, std::errc::illegal_byte_sequence };
+                v >>= spare;
+                if (n == 3)
+                    dest[written++] = static_cast<char>(v >> 8);
+                dest[written++] = static_cast<char>(v);
+            }
+            return { length, written, std::errc {} };
+        }
+    }
+
+    namespace scalar
+    {
+        size_t base64_encode(const char *src, const size_t length, char *dest, const bool url) noexcept
+        {
+            const char *alphabet = url ? base64::URL : base64::STANDARD;
+            const auto *p = reinterpret_cast<const unsigned char *>(src);
+            size_t i = 0;
+            for (; i + 3 <= length; i += 3, dest += 4)
+            {
+                const uint32_t v = uint32_t { p[i] } << 16 | uint32_t { p[i + 1] } << 8 | p[i + 2];
+                dest[0] = alphabet[v >> 18];
+                dest[1] = alphabet[v >> 12 & 63];
+                dest[2] = alphabet[v >> 6 & 63];
+                dest[3] = alphabet[v & 63];
+            }
+            return i;
+        }
+
+        size_t base64_decode(const char *src, const size_t length, char *dest, const bool url) noexcept
+        {
+            const uint8_t *values = base64_values(url);
+            const auto *p = reinterpret_cast<const unsigned char *>(src);
+            size_t i = 0;
+            for (; i + 4 <= length; i += 4, dest += 3)
+            {
+                const uint32_t a = values[p[i]];
+                const uint32_t b = values[p[i + 1]];
+                const uint32_t c = values[p[i + 2]];
+                const uint32_t d = values[p[i + 3]];
+                // Values fit in six bits, INVALID has the top one set
+                if ((a | b | c | d) & 0x80)
+                    break;
+                const uint32_t v = a << 18 | b << 12 | c << 6 | d;
+                dest[0] = static_cast<char>(v >> 16);
+                dest[1] = static_cast<char>(v >> 8);
+                dest[2] = static_cast<char>(v);
+            }
+            return i;
+        }
+
+        size_t hex_encode(const char *src, const size_t length, char *dest, const bool upper) noexcept
+        {
+            const char *digits = upper ? hex::UPPER : hex::LOWER;
+            const auto *p = reinterpret_cast<const unsigned char *>(src);
+            for (size_t i = 0; i < length; ++i)
+            {
+                dest[2 * i] = digits[p[i] >> 4];
+                dest[2 * i + 1] = digits[p[i] & 15];
+            }
+            return length;
+        }
+
+        size_t hex_decode(const char *src, const size_t length, char *dest) noexcept
+        {
+            const auto *p = reinterpret_cast<const unsigned char *>(src);
+            size_t i = 0;
+            for (; i + 2 <= length; i += 2)
+            {
+                const unsigned high = hex::VALUES.of[p[i]];
+                const unsigned low = hex::VALUES.of[p[i + 1]];
+                if ((high | low) & 0x80)
+                    break;
+                *dest++ = static_cast<char>(high << 4 | low);
+            }
+            return i;
+        }
+    }
+}
+
+namespace ytl
+{
+    size_t base64_encode(const char *src, const size_t length, char *dest, const base64_alphabet alphabet,
+                         const bool padding) noexcept
+    {
+        const bool url = alphabet == base64_alphabet::URL;
+        size_t done = detail::active().base64_encode(src, length, dest, url);
+        done += detail::scalar::base64_encode(src + done, length - done, dest + done / 3 * 4, url);
+        char *out = dest + done / 3 * 4;
+
+        if (const size_t rest = length - done)
+        {
+            const char *digits = url ? detail::base64::URL : detail::base64::STANDARD;
+            const auto *p = reinterpret_cast<const unsigned char *>(src + done);
+            const uint32_t v = uint32_t { p[0] } << 16 | (rest == 2 ? uint32_t { p[1] } << 8 : 0);
+            *out++ = digits[v >> 18];
+            *out++ = digits[v >> 12 & 63];
+            if (rest == 2)
+                *out++ = digits[v >> 6 & 63];
+            if (padding)
+            {
+                for (size_t k = rest; k < 3; ++k)
+                    *out++ = '=';
+            }
+        }
+        return static_cast<size_t>(out - dest);
+    }
+
+    decode_result base64_decode(const char *src, const size_t length, char *dest,
+                                const base64_alphabet alphabet) noexcept
+    {
+        const bool url = alphabet == base64_alphabet::URL;
+        size_t i = detail::active().base64_decode(src, length, dest, url);
+        // The vector kernel stops at a bad block, the scalar loop narrows it down to the group
+        i += detail::scalar::base64_decode(src + i, length - i, dest + i / 4 * 3, url);
+        return detail::base64_tail(src, length, i, dest, i / 4 * 3, detail::base64_values(url));
+    }
+
+    size_t hex_encode(const char *src, const size_t length, char *dest, const bool upper) noexcept
+    {
+        const size_t done = detail::active().hex_encode(src, length, dest, upper);
+        detail::scalar::hex_encode(src + done, length - done, dest + 2 * done, upper);
+        return 2 * length;
+    }
+
+    decode_result hex_decode(const char *src, const size_t length, char *dest) noexcept
+    {
+        size_t i = detail::active().hex_decode(src, length, dest);
+        i += detail::scalar::hex_decode(src + i, length - i, dest + i / 2);
+        if (i == length)
+            return { length, length / 2, std::errc {} };
+        const bool high_bad = detail::hex::VALUES.of[static_cast<unsigned char>(src[i])] == detail::hex::INVALID;
+        return { high_bad || i + 1 == length ? i : i + 1, i / 2, std::errc::illegal_byte_sequence };
+    }
+
+    const char_set &percent_escapes() noexcept
+    {
+        static const char_set escapes = []
+        {
+            char bytes[256];
+            size_t count = 0;
+            for (unsigned b = 0; b < 256; ++b)
+            {
+                const bool unreserved = (b >= 'A' && b <= 'Z') || (b >= 'a' && b <= 'z') || (b >= '0' && b <= '9') ||
+                                        b == '-' || b == '.' || b == '_' || b == '~';
+                if (!unreserved)
+                    bytes[count++] = static_cast<char>(b);
+            }
+            return char_set(string_view(bytes, count));
+        }();
+        return escapes;
+    }
+
+    size_t percent_encoded_length(const char *src, const size_t length, const char_set &escaped) noexcept
+    {
+        size_t count = length;
+        for (size_t i = 0; i < length; ++i)
+            count += escaped.contains(src[i]) ? 2 : 0;
+        return count;
+    }
+
+    size_t percent_encode(const char *src, const size_t length, char *dest, const char_set &escaped) noexcept
+    {
+        // The default set spans every high nibble, a vector scan would confirm
+        // nearly each byte against the bitmap. Escapes are too frequent to
+        // branch on, so every byte writes three and advances by one or three.
+        // Output after the byte is at least two long until the last two bytes.
+        char *out = dest;
+        size_t i = 0;
+        for (; i + 2 < length; ++i)
+        {
+            const auto b = static_cast<unsigned char>(src[i]);
+            const unsigned escape = escaped.contains(src[i]);
+            const char first[2] = { src[i], '%' };
+            out[0] = first[escape];
+            out[1] = detail::hex::UPPER[b >> 4];
+            out[2] = detail::hex::UPPER[b & 15];
+            out += 1 + 2 * escape;
+        }
+        for (; i < length; ++i)
+        {
+            const auto b = static_cast<unsigned char>(src[i]);
+            if (!escaped.contains(src[i]))
+            {
+                *out++ = src[i];
+                continue;
+            }
+            out[0] = '%';
+            out[1] = detail::hex::UPPER[b >> 4];
+            out[2] = detail::hex::UPPER[b & 15];
+            out += 3;
+        }
+        return static_cast<size_t>(out - dest);
+    }
+
+    decode_result percent_decode(const char *src, const size_t length, char *dest, const bool plus_as_space) noexcept
+    {
+        static const char_set specials(string_view("%+"));
+        size_t i = 0;
+        size_t written = 0;
+        while (i < length)
+        {
+            // Runs without escapes move a vector scan and a copy at a time
+            const char *hit = plus_as_space ? specials.find(src + i, length - i)
+                                            : detail::active().memchr(src + i, length - i, '%');
+            const size_t run = hit ? static_cast<size_t>(hit - src) - i : length - i;
+            if (run && dest + written != src + i)
+                __builtin_memmove(dest + written, src + i, run);
+            i += run;
+            written += run;
+            if (!hit)
+                break;
+
+            if (*hit == '+')
+            {
+                dest[written++] = ' ';
+                i++;
+                continue;
+            }
+            const uint8_t high = i + 1 < length ? detail::hex::VALUES.of[static_cast<unsigned char>(src[i + 1])]
+                                                : detail::hex::INVALID;
+            const uint8_t low = i + 2 < length ? detail::hex::VALUES.of[static_cast<unsigned char>(src[i + 2])]
+                                               : detail::hex::INVALID;
+            if ((high | low) & 0x80)
+                return { i, written, std::errc::illegal_byte_sequence };
+            dest[written++] = static_cast<char>(high << 4 | low);
+            i += 3;
+        }
+        return { length, written, std::errc {} };
+    }
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ytl::detail
+{
+    namespace base64
+    {
+        inline constexpr char STANDARD[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        inline constexpr char URL[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+        constexpr uint8_t INVALID = 0xFF;
+
+        struct values
+        {
+            uint8_t of[256];
+        };
+
+        /**
+         * @brief Nibble tables for vector decoding. A byte is outside the alphabet
+         * when lo[byte & 15] & hi[byte >> 4] is not zero, and adding roll[byte >> 4]
+         * gives its value. The one byte whose value breaks the pattern of its high
+         * nibble is special, it looks up roll[8] instead.
+         */
+        struct nibbles
+        {
+            uint8_t lo[16];
+            uint8_t hi[16];
+            uint8_t roll[16];
+            char special;
+        };
+
+        constexpr values make_values(const char *alphabet) noexcept
+        {
+            values v {};
+            for (uint8_t &value: v.of)
+                value = INVALID;
+            for (uint8_t i = 0; i < 64; ++i)
+                v.of[static_cast<unsigned char>(alphabet[i])] = i;
+            return v;
+        }
+
+        constexpr nibbles make_nibbles(const char *alphabet) noexcept
+        {
+            const values v = make_values(alphabet);
+            nibbles n {};
+
+            // High nibbles with the same valid low nibbles share a class bit
+            uint16_t rows[16] {};
+            for (unsigned b = 0; b < 256; ++b)
+            {
+                if (v.of[b] != INVALID)
+                    rows[b >> 4] |= static_cast<uint16_t>(1u << (b & 15));
+            }
+            unsigned classes = 0;
+            for (unsigned h = 0; h < 16; ++h)
+            {
+                for (unsigned k = 0; k < h && !n.hi[h]; ++k)
+                {
+                    if (rows[k] == rows[h])
+                        n.hi[h] = n.hi[k];
+                }
+                if (!n.hi[h])
+                    n.hi[h] = static_cast<uint8_t>(1u << classes++);
+                for (unsigned l = 0; l < 16; ++l)
+                {
+                    if (!(rows[h] >> l & 1))
+                        n.lo[l] |= n.hi[h];
+                }
+            }
+
+            bool seen[16] {};
+            for (unsigned b = 0; b < 256; ++b)
+            {
+                if (v.of[b] == INVALID)
+                    continue;
+                const auto offset = static_cast<uint8_t>(v.of[b] - b);
+                if (!seen[b >> 4])
+                {
+                    seen[b >> 4] = true;
+                    n.roll[b >> 4] = offset;
+                }
+                else if (offset != n.roll[b >> 4])
+                {
+                    n.special = static_cast<char>(b);
+                    n.roll[8] = offset;
+                }
+            }
+            return n;
+        }
+
+        inline constexpr values STANDARD_VALUES = make_values(STANDARD);
+        inline constexpr values URL_VALUES = make_values(URL);
+        inline constexpr nibbles STANDARD_NIBBLES = make_nibbles(STANDARD);
+        inline constexpr nibbles URL_NIBBLES = make_nibbles(URL);
+    }
+
+    namespace hex
+    {
+        inline constexpr char LOWER[] = "0123456789abcdef";
+        inline constexpr char UPPER[] = "0123456789ABCDEF";
+
+        constexpr uint8_t INVALID = 0xFF;
+
+        struct values
+        {
+            uint8_t of[256];
+        };
+
+        constexpr values make_values() noexcept
+        {
+            values v {};
+            for (uint8_t &value: v.of)
+                value = INVALID;
+            for (uint8_t i = 0; i < 16; ++i)
+            {
+                v.of[static_cast<unsigned char>(LOWER[i])] = i;
+                v.of[static_cast<unsigned char>(UPPER[i])] = i;
+            }
+            return v;
+        }
+
+        inline constexpr values VALUES = make_values();
+    }
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ytl::detail
+{
+    inline constexpr char DIGIT_PAIRS[] =
+        "00010203040506070809"
+        "10111213141516171819"
+        "20212223242526272829"
+        "30313233343536373839"
+        "40414243444546474849"
+        "50515253545556575859"
+        "60616263646566676869"
+        "70717273747576777879"
+        "80818283848586878889"
+        "90919293949596979899";
+
+    inline constexpr uint64_t POW10[] = {
+        1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull,
+        1000000000ull, 10000000000ull, 100000000000ull, 1000000000000ull, 10000000000000ull,
+        100000000000000ull, 1000000000000000ull, 10000000000000000ull, 100000000000000000ull,
+        1000000000000000000ull, 10000000000000000000ull
+    };
+
+    /**
+     * @brief Number of decimal digits, at least one. The bit width gives
+     * floor(log10) up to one, a single compare fixes it.
+     */
+    constexpr unsigned count_digits(uint64_t v) noexcept
+    {
+        // Setting the low bit never changes the count and keeps zero at one digit
+        v |= 1;
+        const unsigned t = (64 - __builtin_clzll(v)) * 1233 >> 12;
+        return t + (v >= POW10[t]);
+    }
+
+    /**
+     * @brief Eight ASCII digits of v < 10^8 in one word, first digit in the lowest byte.
+     * The halves, quarters and single digits are split off in all lanes at once.
+     */
+    constexpr uint64_t encode_eight(const uint64_t v) noexcept
+    {
+        uint64_t y = v / 10000 | v % 10000 << 32;
+        // x * 10486 >> 20 is x / 100 below 10^4, x * 103 >> 10 is x / 10 below 100
+        uint64_t z = (y * 10486 >> 20) & 0x0000007F0000007F;
+        y = z | (y - z * 100) << 16;
+        z = (y * 103 >> 10) & 0x000F000F000F000F;
+        y = z | (y - z * 10) << 8;
+        return y + 0x3030303030303030;
+    }
+
+    /**
+     * @brief Write the count_digits(v) digits of v so they end at end, eight at a time, then in pairs
+     */
+    inline void write_digits(char *end, uint64_t v) noexcept
+    {
+        while (v >= 100000000)
+        {
+            const uint64_t high = v / 100000000;
+            uint64_t eight = encode_eight(v - high * 100000000);
+            if constexpr (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+                eight = __builtin_bswap64(eight);
+            end -= 8;
+            __builtin_memcpy(end, &eight, 8);
+            v = high;
+        }
+        while (v >= 100)
+        {
+            const uint64_t pair = v % 100;
+            v /= 100;
+            end -= 2;
+            __builtin_memcpy(end, DIGIT_PAIRS + pair * 2, 2);
+        }
+        if (v >= 10)
+            __builtin_memcpy(end - 2, DIGIT_PAIRS + v * 2, 2);
+        else
+            end[-1] = static_cast<char>('0' + v);
+    }
+
+    constexpr bool is_digit(const char c) noexcept
+    {
+        return static_cast<unsigned char>(c - '0') < 10;
+    }
+
+    inline uint64_t load_eight(const char *s) noexcept
+    {
+        uint64_t v;
+        __builtin_memcpy(&v, s, sizeof(v));
+        if constexpr (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+            v = __builtin_bswap64(v);
+        return v;
+    }
+
+    /**
+     * @brief Number of digit bytes a little endian word starts with
+     */
+    constexpr unsigned digit_run(const uint64_t v) noexcept
+    {
+        // A digit is 0x3X and stays so when 6 is added. Carries out of a non digit
+        // byte only disturb the bytes after it.
+        constexpr uint64_t HIGH = 0xF0F0F0F0F0F0F0F0;
+        constexpr uint64_t ZEROS = 0x3030303030303030;
+        const uint64_t bad = ((v & HIGH) ^ ZEROS) | (((v + 0x0606060606060606) & HIGH) ^ ZEROS);
+        return bad ? __builtin_ctzll(bad) >> 3 : 8;
+    }
+
+    /**
+     * @brief Value of eight digit bytes, first byte most significant. Three multiplies
+     * combine adjacent digits, then pairs, then quads, across all lanes at once.
+     */
+    constexpr uint32_t parse_eight(uint64_t v) noexcept
+    {
+        v -= 0x3030303030303030;
+        v = v * 10 + (v >> 8);
+        v = ((v & 0x000000FF000000FF) * (100 + (1000000ull << 32))
+                + ((v >> 16) & 0x000000FF000000FF) * (1 + (10000ull << 32))) >> 32;
+        return static_cast<uint32_t>(v);
+    }
+
+    /**
+     * @brief Value of the first count digits of a word, 0 < count < 8. The digits move to
+     * the top and '0' bytes fill in below, as leading zeros.
+     */
+    constexpr uint32_t parse_leading(const uint64_t v, const unsigned count) noexcept
+    {
+        return parse_eight(v << (64 - 8 * count) | 0x3030303030303030 >> 8 * count);
+    }
+}
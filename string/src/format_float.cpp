@@ -0,0 +1,374 @@
+#include <array>
+#include <bit>
+
+#include "../include/charconv.h"
+#include "bigint.h"
+#include "digits.h"
+
+/**
+ * Shortest round trip formatting with Schubfach (R. Giulietti, "The Schubfach way to
+ * render doubles"). The value is scaled by a 126 bit power of ten and the interval of
+ * decimals rounding back to it is probed for a member with one digit less, then for
+ * the two closest candidates, so no digit loop and no bignum work happens per call.
+ */
+namespace ytl::detail
+{
+    namespace
+    {
+        constexpr int K_MIN = -324;
+        constexpr int K_MAX = 292;
+
+        /**
+         * @brief g = floor(10^-k / 2^r) + 1 split in two 63 bit halves, with r picked
+         * so that 2^125 <= g < 2^126
+         */
+        struct power
+        {
+            uint64_t hi;
+            uint64_t lo;
+        };
+
+        constexpr power split(const uint128 g) noexcept
+        {
+            return { static_cast<uint64_t>(g >> 63), static_cast<uint64_t>(g) & ~uint64_t { 0 } >> 1 };
+        }
+
+        constexpr auto POWERS = []
+        {
+            std::array<power, K_MAX - K_MIN + 1> table {};
+            using big = bigint<18>;
+
+            big p(1);
+            for (int e = 0; e <= -K_MIN; ++e, p.multiply(10))
+                table[-e - K_MIN] = split(p.normalized(126) + 1);
+
+            // floor(2^(width(10^k) + 125) / 10^k) cut from floor(2^M / 10^k)
+            constexpr size_t M = 1100;
+            auto x = big::power_of_two(M);
+            big d(1);
+            for (int k = 1; k <= K_MAX; ++k)
+            {
+                d.multiply(10);
+                x.divide(10);
+                table[k - K_MIN] = split(x.extract(M - d.bit_width() - 125) + 1);
+            }
+            return table;
+        }();
+
+        /**
+         * @brief floor(q log10(2)), floor(q log10(3/4 2)) and floor(e log2(10)) over the exponent ranges used
+         */
+        constexpr int flog10_pow2(const int q) noexcept
+        {
+            return static_cast<int>(q * 661971961083ll >> 41);
+        }
+
+        constexpr int flog10_three_quarters_pow2(const int q) noexcept
+        {
+            return static_cast<int>((q * 661971961083ll - 274743187321ll) >> 41);
+        }
+
+        constexpr int flog2_pow10(const int e) noexcept
+        {
+            return static_cast<int>(e * 913124641741ll >> 38);
+        }
+
+        inline uint64_t multiply_high(const uint64_t a, const uint64_t b) noexcept
+        {
+            return static_cast<uint64_t>(static_cast<uint128>(a) * b >> 64);
+        }
+
+        /**
+         * @brief Decimal significand and exponent, value = digits * 10^exponent
+         */
+        struct decimal
+        {
+            uint64_t digits;
+            int exponent;
+        };
+
+        /**
+         * @brief Parameters of an IEEE binary format and the scaled product of Schubfach
+         */
+        template<typename T>
+        struct binary;
+
+        template<>
+        struct binary<double>
+        {
+            using bits_type = uint64_t;
+            static constexpr int PRECISION = 53;
+            static constexpr int Q_MIN = -1074;
+            static constexpr uint64_t C_MIN = uint64_t { 1 } << 52;
+            static constexpr int H_BIAS = 2;
+
+            static uint64_t round_to_odd(const power g, const uint64_t cp) noexcept
+            {
+                const uint64_t x1 = multiply_high(g.lo, cp);
+                const uint128 y = static_cast<uint128>(g.hi) * cp;
+                const uint64_t z = (static_cast<uint64_t>(y) >> 1) + x1;
+                const uint64_t vbp = static_cast<uint64_t>(y >> 64) + (z >> 63);
+                constexpr uint64_t MASK = ~uint64_t { 0 } >> 1;
+                return vbp | ((z & MASK) + MASK) >> 63;
+            }
+
+            static uint64_t tens(const uint64_t s) noexcept
+            {
+                return 10 * multiply_high(s, 1844674407370955168ull);
+            }
+        };
+
+        template<>
+        struct binary<float>
+        {
+            using bits_type = uint32_t;
+            static constexpr int PRECISION = 24;
+            static constexpr int Q_MIN = -149;
+            static constexpr uint64_t C_MIN = uint64_t { 1 } << 23;
+            static constexpr int H_BIAS = 33;
+
+            static uint64_t round_to_odd(const power g, const uint64_t cp) noexcept
+            {
+                const uint64_t x1 = multiply_high(g.hi + 1, cp);
+                constexpr uint64_t MASK = 0xFFFFFFFF;
+                return (x1 >> 31 | ((x1 & MASK) + MASK) >> 32) & MASK;
+            }
+
+            static uint64_t tens(const uint64_t s) noexcept
+            {
+                return 10 * (s * 1717986919ull >> 34);
+            }
+        };
+
+        template<typename T>
+        decimal shortest(const int q, const uint64_t c) noexcept
+        {
+            using format = binary<T>;
+
+            const uint64_t out = c & 1;
+            const uint64_t cb = c << 2;
+            const uint64_t cbr = cb + 2;
+            uint64_t cbl;
+            int k;
+            // At a power of two the gap below is half the gap above
+            if (c != format::C_MIN || q == format::Q_MIN)
+            {
+                cbl = cb - 2;
+                k = flog10_pow2(q);
+            }
+            else
+            {
+                cbl = cb - 1;
+                k = flog10_three_quarters_pow2(q);
+            }
+            const int h = q + flog2_pow10(-k) + format::H_BIAS;
+
+            const power g = POWERS[k - K_MIN];
+            const uint64_t vb = format::round_to_odd(g, cb << h);
+            const uint64_t vbl = format::round_to_odd(g, cbl << h);
+            const uint64_t vbr = format::round_to_odd(g, cbr << h);
+
+            // One digit less when a multiple of ten lies in the rounding interval. Java's
+            // version skips this below three digits only to print at least two.
+            const uint64_t s = vb >> 2;
+            const uint64_t sp10 = format::tens(s);
+            const uint64_t tp10 = sp10 + 10;
+            const bool upin = vbl + out <= sp10 << 2;
+            const bool wpin = (tp10 << 2) + out <= vbr;
+            if (upin != wpin)
+                return { upin ? sp10 : tp10, k };
+
+            // Otherwise the closer of the two neighbours, ties to even
+            const uint64_t t = s + 1;
+            const bool uin = vbl + out <= s << 2;
+            const bool win = (t << 2) + out <= vbr;
+            if (uin != win)
+                return { uin ? s : t, k };
+
+            const auto cmp = static_cast<int64_t>(vb - ((s + t) << 1));
+            return { cmp < 0 || (cmp == 0 && !(s & 1)) ? s : t, k };
+        }
+
+        template<typename T>
+        decimal to_decimal(const typename binary<T>::bits_type bits) noexcept
+        {
+            using format = binary<T>;
+            constexpr int FRACTION = format::PRECISION - 1;
+            constexpr int EXPONENT_BITS = sizeof(T) * 8 - format::PRECISION;
+
+            const uint64_t t = bits & (format::C_MIN - 1);
+            const int bq = static_cast<int>(bits >> FRACTION & ((1u << EXPONENT_BITS) - 1));
+            if (bq)
+            {
+                const int mq = -format::Q_MIN + 1 - bq;
+                const uint64_t c = format::C_MIN | t;
+                // Integers below 2^PRECISION are their own shortest form
+                if (mq > 0 && mq < format::PRECISION)
+                {
+                    if (const uint64_t f = c >> mq; f << mq == c)
+                        return { f, 0 };
+                }
+                return shortest<T>(-mq, c);
+            }
+            // Java scales the smallest subnormals by ten to print two digits, not wanted here
+            return shortest<T>(format::Q_MIN, t);
+        }
+
+        /**
+         * @brief Value of a binary number that is an integer above the exact range of its
+         * significand, zero for smaller numbers and for ones too large to print in fixed notation
+         */
+        template<typename T>
+        uint128 large_integer(const typename binary<T>::bits_type bits) noexcept
+        {
+            using format = binary<T>;
+            constexpr int FRACTION = format::PRECISION - 1;
+
+            const int shift = static_cast<int>(bits >> FRACTION) + format::Q_MIN - 1;
+            if (shift <= 0 || shift > 64)
+                return 0;
+            return static_cast<uint128>(format::C_MIN | (bits & (format::C_MIN - 1))) << shift;
+        }
+
+        /**
+         * @brief Lay out the digits in fixed or scientific notation, whichever is shorter,
+         * fixed on ties. Fixed notation pads a large integer with its exact digits instead of
+         * zeros, the closest of the equally short forms.
+         */
+        char *write_decimal(char *p, decimal d, const uint128 integer) noexcept
+        {
+            // Strip trailing zeros in halving steps, integers can carry up to 22 of them
+            while (d.digits % 100000000 == 0)
+            {
+                d.digits /= 100000000;
+                d.exponent += 8;
+            }
+            if (d.digits % 10000 == 0)
+            {
+                d.digits /= 10000;
+                d.exponent += 4;
+            }
+            if (d.digits % 100 == 0)
+            {
+                d.digits /= 100;
+                d.exponent += 2;
+            }
+            if (d.digits % 10 == 0)
+            {
+                d.digits /= 10;
+                d.exponent++;
+            }
+
+            const int n = static_cast<int>(count_digits(d.digits));
+            const int point = n + d.exponent;
+            const int x = point - 1;
+
+            const int scientific = n + (n > 1) + 2 + (x >= 100 || x <= -100 ? 3 : 2);
+            const int fixed = d.exponent >= 0 ? point : point > 0 ? n + 1 : 2 - d.exponent;
+
+            if (fixed <= scientific)
+            {
+                if (d.exponent > 0 && integer)
+                {
+                    // At most 22 digits fit the fixed form here, split off the low 19
+                    constexpr uint64_t LOW = POW10[19];
+                    if (integer < LOW)
+                    {
+                        const int length = static_cast<int>(count_digits(static_cast<uint64_t>(integer)));
+                        write_digits(p + length, static_cast<uint64_t>(integer));
+                        return p + length;
+                    }
+                    const auto high = static_cast<uint64_t>(integer / LOW);
+                    const int h = static_cast<int>(count_digits(high));
+                    write_digits(p + h, high);
+                    __builtin_memset(p + h, '0', 19);
+                    write_digits(p + h + 19, static_cast<uint64_t>(integer % LOW));
+                    return p + h + 19;
+                }
+                if (d.exponent >= 0)
+                {
+                    write_digits(p + n, d.digits);
+                    __builtin_memset(p + n, '0', d.exponent);
+                }
+                else if (point > 0)
+                {
+                    // Shift the integer part left over the point
+                    write_digits(p + n + 1, d.digits);
+                    __builtin_memmove(p, p + 1, point);
+                    p[point] = '.';
+                }
+                else
+                {
+                    p[0] = '0';
+                    p[1] = '.';
+                    __builtin_memset(p + 2, '0', -point);
+                    write_digits(p + fixed, d.digits);
+                }
+                return p + fixed;
+            }
+
+            write_digits(p + n + 1, d.digits);
+            p[0] = p[1];
+            p[1] = '.';
+            p += n + (n > 1);
+            *p++ = 'e';
+            *p++ = x < 0 ? '-' : '+';
+            const unsigned magnitude = x < 0 ? -x : x;
+            if (magnitude >= 100)
+            {
+                *p++ = static_cast<char>('0' + magnitude / 100);
+                __builtin_memcpy(p, DIGIT_PAIRS + magnitude % 100 * 2, 2);
+            }
+            else
+                __builtin_memcpy(p, DIGIT_PAIRS + magnitude * 2, 2);
+            return p + 2;
+        }
+
+        template<typename T>
+        to_chars_result format_float(char *first, char *last, const T value) noexcept
+        {
+            using format = binary<T>;
+            constexpr int FRACTION = format::PRECISION - 1;
+            using bits_type = typename format::bits_type;
+
+            const auto bits = std::bit_cast<bits_type>(value);
+            const bits_type magnitude = bits & ~bits_type { 0 } >> 1;
+            constexpr bits_type INFINITY_BITS = ~bits_type { 0 } >> 1 >> FRACTION << FRACTION;
+
+            // Longest layouts: -1.2345678901234567e-308 and the fixed forms that tie with them
+            char buffer[32];
+            char *p = buffer;
+            if (bits != magnitude)
+                *p++ = '-';
+
+            if (magnitude >= INFINITY_BITS)
+            {
+                __builtin_memcpy(p, magnitude == INFINITY_BITS ? "inf" : "nan", 3);
+                p += 3;
+            }
+            else if (!magnitude)
+                *p++ = '0';
+            else
+                p = write_decimal(p, to_decimal<T>(magnitude), large_integer<T>(magnitude));
+
+            const auto length = static_cast<size_t>(p - buffer);
+            if (static_cast<size_t>(last - first) < length)
+                return { last, std::errc::value_too_large };
+            __builtin_memcpy(first, buffer, length);
+            return { first + length, std::errc {} };
+        }
+    }
+}
+
+namespace ytl
+{
+    to_chars_result to_chars(char *first, char *last, const double value) noexcept
+    {
+        return detail::format_float(first, last, value);
+    }
+
+    to_chars_result to_chars(char *first, char *last, const float value) noexcept
+    {
+        return detail::format_float(first, last, value);
+    }
+}
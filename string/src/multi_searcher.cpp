@@ -0,0 +1,228 @@
+#include "../include/multi_searcher.h"
+#include "simd.h"
+
+namespace ytl
+{
+    multi_searcher::multi_searcher(const std::span<const std::string_view> patterns)
+    {
+        offsets.reserve(patterns.size());
+        lengths.reserve(patterns.size());
+        for (const std::string_view pattern : patterns)
+        {
+            offsets.push_back(static_cast<uint32_t>(bytes.size()));
+            lengths.push_back(static_cast<uint32_t>(pattern.size()));
+            bytes.insert(bytes.end(), pattern.begin(), pattern.end());
+        }
+        compile();
+        compile_teddy();
+    }
+
+    bool multi_searcher::contains(const char *text, const size_t length) const
+    {
+        bool found = false;
+        find_all(text, length, [&found](const match &)
+        {
+            found = true;
+            return false;
+        });
+        return found;
+    }
+
+    void multi_searcher::compile()
+    {
+        // One class per byte some pattern uses, the rest share class 0
+        for (const char c : bytes)
+            classes_of[static_cast<unsigned char>(c)] = 1;
+        for (uint8_t &cls : classes_of)
+            cls = cls ? static_cast<uint8_t>(classes++) : 0;
+        if (classes > 256)
+        {
+            // Every byte is used, class 0 is never referenced and takes byte 0
+            classes = 256;
+            for (size_t c = 0; c < 256; ++c)
+                classes_of[c] = static_cast<uint8_t>(c);
+        }
+
+        // Trie, NONE marks a missing edge
+        std::vector<uint32_t> trie(classes, NONE);
+        std::vector<std::vector<uint32_t>> ends(1);
+        for (uint32_t id = 0; id < lengths.size(); ++id)
+        {
+            if (!lengths[id])
+                continue;
+
+            uint32_t state = 0;
+            for (uint32_t i = 0; i < lengths[id]; ++i)
+            {
+                const size_t edge = state * classes + classes_of[static_cast<unsigned char>(bytes[offsets[id] + i])];
+                if (trie[edge] == NONE)
+                {
+                    trie[edge] = static_cast<uint32_t>(ends.size());
+                    ends.emplace_back();
+                    trie.resize(trie.size() + classes, NONE);
+                }
+                state = trie[edge];
+            }
+            ends[state].push_back(id);
+        }
+
+        // Breadth first, every missing edge takes the edge of the failure state
+        const size_t states = ends.size();
+        std::vector<uint32_t> fail(states, 0);
+        std::vector<uint32_t> dict(states, 0);
+        std::vector<uint32_t> order;
+        order.reserve(states);
+        order.push_back(0);
+        for (size_t head = 0; head < order.size(); ++head)
+        {
+            const uint32_t state = order[head];
+            for (uint32_t c = 0; c < classes; ++c)
+            {
+                uint32_t &edge = trie[state * classes + c];
+                const uint32_t fallback = state ? trie[fail[state] * classes + c] : 0;
+                if (edge == NONE)
+                    edge = fallback;
+                else
+                {
+                    fail[edge] = fallback;
+                    dict[edge] = ends[fallback].empty() ? dict[fallback] : fallback;
+                    order.push_back(edge);
+                }
+            }
+        }
+
+        // Renumber so the reporting states come last and one compare spots them
+        std::vector<uint32_t> renamed(states);
+        uint32_t next = 0;
+        for (uint32_t state = 0; state < states; ++state)
+        {
+            if (ends[state].empty() && !dict[state])
+                renamed[state] = next++;
+        }
+        first_match = next * classes;
+        for (uint32_t state = 0; state < states; ++state)
+        {
+            if (!ends[state].empty() || dict[state])
+                renamed[state] = next++;
+        }
+
+        transitions.assign(states * classes, 0);
+        for (uint32_t state = 0; state < states; ++state)
+        {
+            for (uint32_t c = 0; c < classes; ++c)
+                transitions[renamed[state] * classes + c] = renamed[trie[state * classes + c]] * classes;
+        }
+
+        const uint32_t reporting = static_cast<uint32_t>(states) - first_match / classes;
+        outputs.resize(reporting);
+        for (uint32_t state = 0; state < states; ++state)
+        {
+            if (renamed[state] * classes < first_match)
+                continue;
+
+            output &out = outputs[renamed[state] - first_match / classes];
+            out.begin = static_cast<uint32_t>(ids.size());
+            ids.insert(ids.end(), ends[state].begin(), ends[state].end());
+            out.end = static_cast<uint32_t>(ids.size());
+            out.next = dict[state] ? renamed[dict[state]] - first_match / classes + 1 : 0;
+        }
+    }
+
+    void multi_searcher::compile_teddy()
+    {
+        size_t used = 0;
+        shortest = ~size_t { 0 };
+        for (const uint32_t length : lengths)
+        {
+            if (length)
+            {
+                used++;
+                shortest = length < shortest ? length : shortest;
+            }
+        }
+        if (!used || used > TEDDY_PATTERNS)
+            return;
+
+        teddy.fingerprint = shortest < detail::nibble_masks::MAX_FINGERPRINT ? shortest : detail::nibble_masks::MAX_FINGERPRINT;
+        uint32_t slot = 0;
+        for (uint32_t id = 0; id < lengths.size(); ++id)
+        {
+            if (!lengths[id])
+                continue;
+
+            const size_t bucket = slot++ % detail::nibble_masks::BUCKETS;
+            buckets[bucket].push_back(id);
+            for (size_t k = 0; k < teddy.fingerprint; ++k)
+            {
+                const auto c = static_cast<unsigned char>(bytes[offsets[id] + k]);
+                teddy.lo[k][c & 0x0F] |= static_cast<uint8_t>(1u << bucket);
+                teddy.hi[k][c >> 4] |= static_cast<uint8_t>(1u << bucket);
+            }
+        }
+    }
+
+    void multi_searcher::scan(const char *text, const size_t length, const emitter emit, void *context) const
+    {
+        size_t from = 0;
+        if (teddy.fingerprint && detail::active().nibble_find)
+        {
+            from = filter(text, length, emit, context);
+            if (from == FINISHED)
+                return;
+        }
+
+        uint32_t state = 0;
+        for (size_t i = from; i < length; ++i)
+        {
+            state = transitions[state + classes_of[static_cast<unsigned char>(text[i])]];
+            if (state < first_match)
+                continue;
+
+            for (uint32_t out = (state - first_match) / classes + 1; out; out = outputs[out - 1].next)
+            {
+                for (uint32_t k = outputs[out - 1].begin; k < outputs[out - 1].end; ++k)
+                {
+                    const uint32_t id = ids[k];
+                    if (!emit(context, { id, i + 1 - lengths[id], lengths[id] }))
+                        return;
+                }
+            }
+        }
+    }
+
+    size_t multi_searcher::filter(const char *text, const size_t length, const emitter emit, void *context) const
+    {
+        if (length < shortest)
+            return FINISHED;
+
+        const auto scan = detail::active().nibble_find;
+        const size_t count = length - shortest + 1;
+        size_t candidates = 0;
+        size_t at = 0;
+        uint8_t hit;
+        while (const char *candidate = scan(teddy, text + at, count - at, hit))
+        {
+            at = static_cast<size_t>(candidate - text);
+
+            // Fingerprints matching more than one position in 8 make verification
+            // dearer than the automaton, which resumes here
+            if (++candidates > at / 8 + 64)
+                return at;
+
+            for (; hit; hit &= hit - 1)
+            {
+                for (const uint32_t id : buckets[__builtin_ctz(hit)])
+                {
+                    if (lengths[id] <= length - at &&
+                        !__builtin_memcmp(text + at, bytes.data() + offsets[id], lengths[id]) &&
+                        !emit(context, { id, at, lengths[id] }))
+                        return FINISHED;
+                }
+            }
+
+            if (++at == count)
+                break;
+        }
+        return FINISHED;
+    }
+}
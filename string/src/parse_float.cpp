@@ -0,0 +1,392 @@
+#include <array>
+#include <bit>
+#include <charconv>
+#include <limits>
+
+#include "../include/charconv.h"
+#include "bigint.h"
+#include "digits.h"
+
+/**
+ * Correctly rounded decimal to binary conversion. Short inputs with small exponents are
+ * exact in floating point arithmetic (Clinger's fast path), everything else goes through
+ * Eisel-Lemire: one or two 64x64 multiplies by a truncated 128 bit power of five decide
+ * the rounding for any significand of up to 19 digits. Longer inputs are settled when the
+ * truncated significand and its successor round alike, the rest is left to std::from_chars.
+ */
+namespace ytl::detail
+{
+    namespace
+    {
+        constexpr int Q_SMALLEST = -342;
+        constexpr int Q_LARGEST = 308;
+
+        struct power
+        {
+            uint64_t hi;
+            uint64_t lo;
+        };
+
+        /**
+         * @brief 5^q normalized to 128 bits: truncated for q >= 0, a truncated reciprocal below,
+         * rounded up while 5^-q still fits a word so exact halfway cases stay detectable
+         */
+        constexpr auto POWERS_OF_FIVE = []
+        {
+            std::array<power, Q_LARGEST - Q_SMALLEST + 1> table {};
+            using big = bigint<16>;
+
+            big p(1);
+            for (int q = 0; q <= Q_LARGEST; ++q, p.multiply(5))
+            {
+                const uint128 v = p.normalized(128);
+                table[q - Q_SMALLEST] = { static_cast<uint64_t>(v >> 64), static_cast<uint64_t>(v) };
+            }
+
+            // floor(2^(width(5^-q) + 127) / 5^-q) cut from floor(2^M / 5^-q)
+            constexpr size_t M = 960;
+            auto x = big::power_of_two(M);
+            big d(1);
+            for (int q = -1; q >= Q_SMALLEST; --q)
+            {
+                d.multiply(5);
+                x.divide(5);
+                const uint128 v = x.extract(M - d.bit_width() - 127) + (q >= -27);
+                table[q - Q_SMALLEST] = { static_cast<uint64_t>(v >> 64), static_cast<uint64_t>(v) };
+            }
+            return table;
+        }();
+
+        template<typename T>
+        struct binary;
+
+        template<>
+        struct binary<double>
+        {
+            using bits_type = uint64_t;
+            static constexpr int MANTISSA_BITS = 52;
+            static constexpr int MIN_EXPONENT = -1023;
+            static constexpr int INFINITE_POWER = 0x7FF;
+            static constexpr int SMALLEST_POWER = -342;
+            static constexpr int LARGEST_POWER = 308;
+            // Halfway cases can only be exact while 5^|q| times the significand fits the product
+            static constexpr int MIN_ROUND_TO_EVEN = -4;
+            static constexpr int MAX_ROUND_TO_EVEN = 23;
+            static constexpr int MAX_EXACT_POWER = 22;
+
+            static constexpr double EXACT_POWERS[] = {
+                1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+            };
+        };
+
+        template<>
+        struct binary<float>
+        {
+            using bits_type = uint32_t;
+            static constexpr int MANTISSA_BITS = 23;
+            static constexpr int MIN_EXPONENT = -127;
+            static constexpr int INFINITE_POWER = 0xFF;
+            static constexpr int SMALLEST_POWER = -65;
+            static constexpr int LARGEST_POWER = 38;
+            static constexpr int MIN_ROUND_TO_EVEN = -17;
+            static constexpr int MAX_ROUND_TO_EVEN = 10;
+            static constexpr int MAX_EXACT_POWER = 10;
+
+            static constexpr float EXACT_POWERS[] = {
+                1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+            };
+        };
+
+        /**
+         * @brief Biased binary exponent and significand with the implicit bit cleared
+         */
+        struct adjusted
+        {
+            uint64_t mantissa;
+            int power2;
+        };
+
+        template<typename T>
+        adjusted eisel_lemire(const int64_t q, uint64_t w) noexcept
+        {
+            using format = binary<T>;
+
+            if (q < format::SMALLEST_POWER)
+                return { 0, 0 };
+            if (q > format::LARGEST_POWER)
+                return { 0, format::INFINITE_POWER };
+
+            const int lz = __builtin_clzll(w);
+            w <<= lz;
+
+            // The high word alone decides unless the bits below the rounding position are all ones
+            const power &five = POWERS_OF_FIVE[q - Q_SMALLEST];
+            uint128 product = static_cast<uint128>(w) * five.hi;
+            constexpr uint64_t PRECISION_MASK = ~uint64_t { 0 } >> (format::MANTISSA_BITS + 3);
+            if ((static_cast<uint64_t>(product >> 64) & PRECISION_MASK) == PRECISION_MASK)
+                product += static_cast<uint128>(w) * five.lo >> 64;
+            const auto high = static_cast<uint64_t>(product >> 64);
+            const auto low = static_cast<uint64_t>(product);
+
+            const int upper = static_cast<int>(high >> 63);
+            const int shift = upper + 64 - format::MANTISSA_BITS - 3;
+            adjusted answer {
+                high >> shift,
+                static_cast<int>(((152170 + 65536) * q >> 16) + 63) + upper - lz - format::MIN_EXPONENT
+            };
+
+            if (answer.power2 <= 0)
+            {
+                if (-answer.power2 + 1 >= 64)
+                    return { 0, 0 };
+                answer.mantissa >>= -answer.power2 + 1;
+                answer.mantissa += answer.mantissa & 1;
+                answer.mantissa >>= 1;
+                // Rounding up the largest subnormal yields the smallest normal
+                answer.power2 = answer.mantissa < uint64_t { 1 } << format::MANTISSA_BITS ? 0 : 1;
+                return answer;
+            }
+
+            // Exactly halfway: nothing but zeros was shifted out, round to even
+            if (low <= 1 && q >= format::MIN_ROUND_TO_EVEN && q <= format::MAX_ROUND_TO_EVEN
+                && (answer.mantissa & 3) == 1 && answer.mantissa << shift == high)
+                answer.mantissa &= ~uint64_t { 1 };
+
+            answer.mantissa += answer.mantissa & 1;
+            answer.mantissa >>= 1;
+            if (answer.mantissa >= uint64_t { 2 } << format::MANTISSA_BITS)
+            {
+                answer.mantissa = uint64_t { 1 } << format::MANTISSA_BITS;
+                answer.power2++;
+            }
+
+            answer.mantissa &= ~(uint64_t { 1 } << format::MANTISSA_BITS);
+            if (answer.power2 >= format::INFINITE_POWER)
+                return { 0, format::INFINITE_POWER };
+            return answer;
+        }
+
+        /**
+         * @brief Decimal significand of up to 19 digits and exponent, value = mantissa * 10^exponent
+         */
+        struct parsed
+        {
+            uint64_t mantissa;
+            int64_t exponent;
+            const char *end;
+            bool negative;
+            // Significant digits past the 19th were dropped
+            bool truncated;
+        };
+
+        /**
+         * @brief Accumulate a run of digits eight at a time, v wraps on runs past 19 digits
+         */
+        inline const char *scan_digits(const char *p, const char *last, uint64_t &v) noexcept
+        {
+            while (last - p >= 8)
+            {
+                const uint64_t word = load_eight(p);
+                const unsigned run = digit_run(word);
+                if (run < 8)
+                {
+                    if (run)
+                        v = v * POW10[run] + parse_leading(word, run);
+                    return p + run;
+                }
+                v = v * 100000000 + parse_eight(word);
+                p += 8;
+            }
+            while (p != last && is_digit(*p))
+                v = v * 10 + static_cast<uint64_t>(*p++ - '0');
+            return p;
+        }
+
+        bool parse_decimal(const char *first, const char *last, parsed &out) noexcept
+        {
+            const char *p = first;
+            out.negative = p != last && *p == '-';
+            p += out.negative;
+
+            const char *start = p;
+            uint64_t m = 0;
+            p = scan_digits(p, last, m);
+            int64_t digits = p - start;
+
+            int64_t exponent = 0;
+            if (p != last && *p == '.')
+            {
+                const char *fraction = ++p;
+                p = scan_digits(p, last, m);
+                exponent = fraction - p;
+                digits -= exponent;
+            }
+            if (!digits)
+                return false;
+            const char *end = p;
+
+            if (p != last && (*p | 0x20) == 'e')
+            {
+                const char *e = p + 1;
+                const bool negative = e != last && *e == '-';
+                e += e != last && (*e == '-' || *e == '+');
+                if (e != last && is_digit(*e))
+                {
+                    int64_t value = 0;
+                    // Anything this large overflows or underflows either way
+                    for (; e != last && is_digit(*e); ++e)
+                    {
+                        if (value < 0x10000)
+                            value = value * 10 + (*e - '0');
+                    }
+                    exponent += negative ? -value : value;
+                    p = e;
+                }
+            }
+
+            out.end = p;
+            out.truncated = false;
+            if (digits > 19)
+            {
+                // Leading zeros are not significant, the significand wrapped only if 20 others remain
+                const char *s = start;
+                while (s != end && (*s == '0' || *s == '.'))
+                    digits -= *s++ == '0';
+
+                if (digits > 19)
+                {
+                    out.truncated = true;
+                    m = 0;
+                    for (int kept = 0; kept < 19; ++s)
+                    {
+                        if (*s != '.')
+                        {
+                            m = m * 10 + static_cast<uint64_t>(*s - '0');
+                            kept++;
+                        }
+                    }
+                    exponent += digits - 19;
+                }
+            }
+
+            out.mantissa = m;
+            out.exponent = exponent;
+            return true;
+        }
+
+        /**
+         * @brief inf, infinity, nan and nan(chars), any case
+         */
+        template<typename T>
+        bool parse_special(const char *first, const char *last, T &value, const char *&end) noexcept
+        {
+            const bool negative = first != last && *first == '-';
+            const char *p = first + negative;
+            const auto starts = [&](const char *word, const size_t length)
+            {
+                if (static_cast<size_t>(last - p) < length)
+                    return false;
+                for (size_t i = 0; i < length; ++i)
+                {
+                    if ((p[i] | 0x20) != word[i])
+                        return false;
+                }
+                return true;
+            };
+
+            if (starts("nan", 3))
+            {
+                p += 3;
+                if (p != last && *p == '(')
+                {
+                    const char *q = p + 1;
+                    while (q != last && (is_digit(*q) || ((*q | 0x20) >= 'a' && (*q | 0x20) <= 'z') || *q == '_'))
+                        ++q;
+                    if (q != last && *q == ')')
+                        p = q + 1;
+                }
+                value = negative ? -std::numeric_limits<T>::quiet_NaN() : std::numeric_limits<T>::quiet_NaN();
+            }
+            else if (starts("inf", 3))
+            {
+                p += starts("infinity", 8) ? 8 : 3;
+                value = negative ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::infinity();
+            }
+            else
+                return false;
+
+            end = p;
+            return true;
+        }
+
+        template<typename T>
+        from_chars_result parse_float(const char *first, const char *last, T &value) noexcept
+        {
+            using format = binary<T>;
+            using bits_type = typename format::bits_type;
+
+            parsed number;
+            if (!parse_decimal(first, last, number))
+            {
+                if (const char *end; parse_special(first, last, value, end))
+                    return { end, std::errc {} };
+                return { first, std::errc::invalid_argument };
+            }
+
+            if (!number.mantissa)
+            {
+                value = number.negative ? -T { 0 } : T { 0 };
+                return { number.end, std::errc {} };
+            }
+
+            // Both the significand and the power of ten are exact, one rounding happens
+            constexpr uint64_t EXACT_MANTISSA = uint64_t { 1 } << (format::MANTISSA_BITS + 1);
+            if (!number.truncated && number.mantissa <= EXACT_MANTISSA
+                && number.exponent >= -format::MAX_EXACT_POWER && number.exponent <= format::MAX_EXACT_POWER)
+            {
+                auto v = static_cast<T>(number.mantissa);
+                if (number.exponent < 0)
+                    v /= format::EXACT_POWERS[-number.exponent];
+                else
+                    v *= format::EXACT_POWERS[number.exponent];
+                value = number.negative ? -v : v;
+                return { number.end, std::errc {} };
+            }
+
+            adjusted answer = eisel_lemire<T>(number.exponent, number.mantissa);
+            if (number.truncated)
+            {
+                // The dropped digits lie between mantissa and mantissa + 1
+                const adjusted upper = eisel_lemire<T>(number.exponent, number.mantissa + 1);
+                if (upper.mantissa != answer.mantissa || upper.power2 != answer.power2)
+                {
+                    const auto [ptr, ec] = std::from_chars(first, last, value);
+                    return { ptr, ec };
+                }
+            }
+
+            if (answer.power2 == format::INFINITE_POWER || (!answer.power2 && !answer.mantissa))
+                return { number.end, std::errc::result_out_of_range };
+
+            const auto bits = static_cast<bits_type>(answer.mantissa
+                | static_cast<uint64_t>(answer.power2) << format::MANTISSA_BITS
+                | static_cast<uint64_t>(number.negative) << (sizeof(T) * 8 - 1));
+            value = std::bit_cast<T>(bits);
+            return { number.end, std::errc {} };
+        }
+    }
+}
+
+namespace ytl
+{
+    from_chars_result from_chars(const char *first, const char *last, double &value) noexcept
+    {
+        return detail::parse_float(first, last, value);
+    }
+
+    from_chars_result from_chars(const char *first, const char *last, float &value) noexcept
+    {
+        return detail::parse_float(first, last, value);
+    }
+}
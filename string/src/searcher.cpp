@@ -0,0 +1,206 @@
+#include "../include/searcher.h"
+#include "simd.h"
+
+namespace ytl
+{
+    namespace
+    {
+        /**
+         * @brief Haystack bytes searched per filter call before the false candidate rate is checked
+         */
+        constexpr size_t STRIDE = 16384;
+
+        /**
+         * @brief Window of a zero terminated haystack delimited before it is searched,
+         * small enough that the search reads it back from cache
+         */
+        constexpr size_t WINDOW = 16384;
+
+        /**
+         * @brief Start of the maximal suffix of needle under the byte order given by less
+         * @param period Receives the period of that suffix
+         * @return Position before the suffix, SIZE_MAX for the whole needle
+         */
+        template<typename Less>
+        size_t maximal_suffix(const unsigned char *needle, const size_t length, size_t &period, const Less &less)
+        {
+            size_t ip = static_cast<size_t>(-1);
+            size_t jp = 0;
+            size_t k = 1;
+            period = 1;
+            while (jp + k < length)
+            {
+                const unsigned char a = needle[ip + k];
+                const unsigned char b = needle[jp + k];
+                if (a == b)
+                {
+                    if (k == period)
+                    {
+                        jp += period;
+                        k = 1;
+                    }
+                    else
+                        k++;
+                }
+                else if (less(b, a))
+                {
+                    jp += k;
+                    k = 1;
+                    period = jp - ip;
+                }
+                else
+                {
+                    ip = jp++;
+                    k = period = 1;
+                }
+            }
+            return ip;
+        }
+    }
+
+    searcher::searcher(const char *needle, const size_t length) noexcept
+        : needle(reinterpret_cast<const unsigned char *>(needle)), length(length)
+    {
+        if (length < 2)
+            return;
+
+        // Critical factorization, the longer of the two maximal suffixes
+        size_t forward_period;
+        const size_t forward = maximal_suffix(this->needle, length, forward_period, [](auto a, auto b) { return a < b; });
+        const size_t reverse = maximal_suffix(this->needle, length, period, [](auto a, auto b) { return a > b; });
+        if (reverse + 1 > forward + 1)
+            split = reverse;
+        else
+        {
+            split = forward;
+            period = forward_period;
+        }
+
+        // A periodic needle remembers how much of the previous window already matched
+        if (!__builtin_memcmp(this->needle, this->needle + period, split + 1))
+            memory = length - period;
+        else
+            period = (split > length - split - 1 ? split : length - split - 1) + 1;
+
+        if (length > SHORT_NEEDLE)
+        {
+            for (size_t &entry : shift)
+                entry = 0;
+            for (size_t i = 0; i < length; ++i)
+                shift[this->needle[i]] = i + 1;
+        }
+    }
+
+    const char *searcher::find(const char *haystack, const size_t length) const noexcept
+    {
+        if (!this->length)
+            return haystack;
+        if (this->length > length)
+            return nullptr;
+        if (this->length == 1)
+            return static_cast<const char *>(__builtin_memchr(haystack, *needle, length));
+        if (this->length <= SHORT_NEEDLE)
+            return filtered(haystack, length);
+        return two_way(haystack, length);
+    }
+
+    const char *searcher::find(const char *haystack) const noexcept
+    {
+        if (!length)
+            return haystack;
+
+        // Search window by window while the terminator is located, a window
+        // overlaps its predecessor by one byte less than the needle
+        const char *from = haystack;
+        const char *scanned = haystack;
+        const size_t chunk = length > WINDOW ? length : WINDOW;
+        while (true)
+        {
+            const char *terminator = strnchr(scanned, chunk, '\0');
+            const char *end = terminator ? terminator : scanned + chunk;
+            if (const char *hit = find(from, static_cast<size_t>(end - from)))
+                return hit;
+            if (terminator)
+                return nullptr;
+
+            from = end - (length - 1);
+            scanned = end;
+        }
+    }
+
+    const char *searcher::filtered(const char *haystack, const size_t length) const noexcept
+    {
+        const detail::kernels &kernels = detail::active();
+        const auto *bytes = reinterpret_cast<const char *>(needle);
+        const char *end = haystack + length;
+        const char *from = haystack;
+        size_t candidates = 0;
+
+        while (static_cast<size_t>(end - from) >= this->length)
+        {
+            const size_t window = static_cast<size_t>(end - from) < STRIDE + this->length - 1
+                                      ? static_cast<size_t>(end - from)
+                                      : STRIDE + this->length - 1;
+            if (const char *hit = kernels.find(from, window, bytes, this->length, candidates))
+                return hit;
+            from += window - this->length + 1;
+
+            // More than one verification per 16 bytes means the input is built
+            // against the filter, finish in guaranteed linear time
+            if (candidates > static_cast<size_t>(from - haystack) / 16)
+                return two_way(from, static_cast<size_t>(end - from));
+        }
+        return nullptr;
+    }
+
+    const char *searcher::two_way(const char *haystack, const size_t length) const noexcept
+    {
+        const auto *h = reinterpret_cast<const unsigned char *>(haystack);
+        const unsigned char *end = h + length;
+        const bool skips = this->length > SHORT_NEEDLE;
+        size_t mem = 0;
+
+        while (static_cast<size_t>(end - h) >= this->length)
+        {
+            // The last window byte decides a bad character skip
+            if (skips)
+            {
+                if (const size_t last = shift[h[this->length - 1]])
+                {
+                    if (size_t k = this->length - last)
+                    {
+                        h += k < mem ? mem : k;
+                        mem = 0;
+                        continue;
+                    }
+                }
+                else
+                {
+                    h += this->length;
+                    mem = 0;
+                    continue;
+                }
+            }
+
+            // Right half first, a mismatch there moves past it
+            size_t k = split + 1 > mem ? split + 1 : mem;
+            while (k < this->length && needle[k] == h[k])
+                k++;
+            if (k < this->length)
+            {
+                h += k - split;
+                mem = 0;
+                continue;
+            }
+
+            // Then the left half down to what the previous window already matched
+            for (k = split + 1; k > mem && needle[k - 1] == h[k - 1]; k--)
+                ;
+            if (k <= mem)
+                return reinterpret_cast<const char *>(h);
+            h += period;
+            mem = memory;
+        }
+        return nullptr;
+    }
+}
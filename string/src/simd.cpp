@@ -0,0 +1,82 @@
+#include "simd.h"
+
+#include <atomic>
+#include <initializer_list>
+
+namespace ytl::detail
+{
+    namespace
+    {
+        std::atomic<const kernels *> selected { nullptr };
+
+        const kernels *supported(const simd_level level) noexcept
+        {
+            switch (level)
+            {
+                case simd_level::SCALAR:
+                    return &scalar_kernels;
+#ifdef YTL_STRING_X86
+                case simd_level::SSE2:
+                    return &sse2_kernels;
+                case simd_level::AVX2:
+                    __builtin_cpu_init();
+                    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi") &&
+                           __builtin_cpu_supports("bmi2") && __builtin_cpu_supports("popcnt")
+                               ? &avx2_kernels
+                               : nullptr;
+                case simd_level::AVX512:
+                    __builtin_cpu_init();
+                    return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+                           __builtin_cpu_supports("bmi") && __builtin_cpu_supports("bmi2") &&
+                           __builtin_cpu_supports("popcnt")
+                               ? &avx512_kernels
+                               : nullptr;
+#endif
+#ifdef YTL_STRING_NEON
+                case simd_level::NEON:
+                    return &neon_kernels;
+#endif
+                default:
+                    return nullptr;
+            }
+        }
+
+        const kernels *best() noexcept
+        {
+            for (const simd_level level: { simd_level::AVX512, simd_level::AVX2, simd_level::SSE2, simd_level::NEON })
+            {
+                if (const kernels *k = supported(level))
+                    return k;
+            }
+            return &scalar_kernels;
+        }
+    }
+
+    const kernels &active() noexcept
+    {
+        const kernels *k = selected.load(std::memory_order_acquire);
+        if (!k)
+        {
+            k = best();
+            selected.store(k, std::memory_order_release);
+        }
+        return *k;
+    }
+}
+
+namespace ytl
+{
+    simd_level active_simd() noexcept
+    {
+        return detail::active().level;
+    }
+
+    bool select_simd(const simd_level level) noexcept
+    {
+        const detail::kernels *k = detail::supported(level);
+        if (!k)
+            return false;
+        detail::selected.store(k, std::memory_order_release);
+        return true;
+    }
+}
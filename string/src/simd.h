@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "../include/char_set.h"
+#include "../include/string.h"
+
+#if defined(__x86_64__)
+#define YTL_STRING_X86 1
+#elif defined(__aarch64__)
+#define YTL_STRING_NEON 1
+#endif
+
+// Kernels read whole aligned vectors around the string, which never crosses a
+// page but does touch bytes outside the object, invisible to the caller
+#if defined(__clang__) || defined(__GNUC__)
+#define YTL_STRING_KERNEL __attribute__((no_sanitize("address", "thread")))
+#else
+#define YTL_STRING_KERNEL
+#endif
+
+namespace ytl::detail
+{
+    /**
+     * @brief Smallest page size of supported targets, loads inside one page never fault
+     */
+    inline constexpr uintptr_t PAGE_BYTES = 4096;
+
+    /**
+     * @brief Scanning routines of one instruction set
+     */
+    struct kernels
+    {
+        simd_level level;
+        size_t (*strlen)(const char *s) noexcept;
+        int (*strcmp)(const char *s1, const char *s2) noexcept;
+        const char *(*strchr)(const char *s, int ch) noexcept;
+        const char *(*strrchr)(const char *s, int ch) noexcept;
+        const char *(*strnchr)(const char *s, size_t count, int ch) noexcept;
+        const char *(*memchr)(const char *s, size_t count, int ch) noexcept;
+        const char *(*memrchr)(const char *s, size_t count, int ch) noexcept;
+        int (*strncasecmp)(const char *s1, const char *s2, size_t count) noexcept;
+        int (*memcasecmp)(const char *s1, const char *s2, size_t count) noexcept;
+        void (*to_lower)(char *dest, const char *src, size_t count) noexcept;
+        void (*to_upper)(char *dest, const char *src, size_t count) noexcept;
+        /**
+         * @brief First occurrence of a needle of at least two bytes in a bounded range.
+         * Positions matching the first and last needle byte are verified in full,
+         * each verification is counted into candidates.
+         */
+        const char *(*find)(const char *haystack, size_t length, const char *needle, size_t count,
+                            size_t &candidates) noexcept;
+        /**
+         * @brief First start before count matching the nibble tables, null on targets without byte shuffles.
+         * Finds Teddy candidates and char_set members. The fingerprint bytes of
+         * every start before count must be readable.
+         * @param buckets Receives the common bits of the match
+         */
+        const char *(*nibble_find)(const nibble_masks &masks, const char *text, size_t count,
+                                   uint8_t &buckets) noexcept;
+        bool (*validate_utf8)(const char *s, size_t length) noexcept;
+        /**
+         * @brief Bytes that are not UTF-8 continuation bytes, the code points of valid text
+         */
+        size_t (*count_utf8)(const char *s, size_t length) noexcept;
+        /**
+         * @brief Encode whole 3 byte groups while blocks last
+         * @return Bytes consumed, a multiple of 3, dest receives 4 characters for each 3
+         */
+        size_t (*base64_encode)(const char *src, size_t length, char *dest, bool url) noexcept;
+        /**
+         * @brief Decode whole 4 character groups up to the first block holding a
+         * character outside the alphabet, padding included
+         * @return Characters consumed, a multiple of 4
+         */
+        size_t (*base64_decode)(const char *src, size_t length, char *dest, bool url) noexcept;
+        /**
+         * @return Bytes consumed, dest receives two digits for each
+         */
+        size_t (*hex_encode)(const char *src, size_t length, char *dest, bool upper) noexcept;
+        /**
+         * @brief Decode digit pairs up to the first block holding a non digit
+         * @return Digits consumed, an even number
+         */
+        size_t (*hex_decode)(const char *src, size_t length, char *dest) noexcept;
+    };
+
+    namespace scalar
+    {
+        /**
+         * @brief Portable UTF-8 routines, also taken by targets without byte shuffles
+         */
+        bool validate_utf8(const char *s, size_t length) noexcept;
+        size_t count_utf8(const char *s, size_t length) noexcept;
+
+        /**
+         * @brief Portable codecs, consuming every whole group
+         */
+        size_t base64_encode(const char *src, size_t length, char *dest, bool url) noexcept;
+        size_t base64_decode(const char *src, size_t length, char *dest, bool url) noexcept;
+        size_t hex_encode(const char *src, size_t length, char *dest, bool upper) noexcept;
+        size_t hex_decode(const char *src, size_t length, char *dest) noexcept;
+    }
+
+#ifdef YTL_STRING_X86
+    namespace avx2_codec
+    {
+        /**
+         * @brief Codecs on 256-bit shuffles, the AVX-512 kernels take them too
+         */
+        size_t base64_encode(const char *src, size_t length, char *dest, bool url) noexcept;
+        size_t base64_decode(const char *src, size_t length, char *dest, bool url) noexcept;
+        size_t hex_encode(const char *src, size_t length, char *dest, bool upper) noexcept;
+        size_t hex_decode(const char *src, size_t length, char *dest) noexcept;
+    }
+#endif
+
+    extern const kernels scalar_kernels;
+#ifdef YTL_STRING_X86
+    extern const kernels sse2_kernels;
+    extern const kernels avx2_kernels;
+    extern const kernels avx512_kernels;
+#endif
+#ifdef YTL_STRING_NEON
+    extern const kernels neon_kernels;
+#endif
+
+    /**
+     * @brief Kernels picked for this CPU, or the ones forced by select_simd
+     */
+    const kernels &active() noexcept;
+}
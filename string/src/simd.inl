@@ -0,0 +1,615 @@
+#pragma once
+
+#include "simd.h"
+
+/**
+ * Kernels shared by every vector instruction set. Each one is written against
+ * a traits type V providing:
+ *   vec               native vector type
+ *   WIDTH             bytes per vector, a power of two dividing the page size
+ *   BITS              mask bits per byte, 1 for movemask style, 4 for NEON
+ *   load(p)           aligned load
+ *   loadu(p)          unaligned load
+ *   splat(c)          vector of c
+ *   eq(a, b)          mask of equal bytes
+ *   zero(a)           mask of zero bytes
+ *   flip_case(a, f)   toggle bit 5 of the bytes in [f, f + 26)
+ *   store(p, a)       unaligned store
+ * and optionally, for Teddy:
+ *   table(t)          16 byte table repeated in every 128-bit lane
+ *   classify(lo, hi, a) lo[a & 15] & hi[a >> 4] for each byte
+ *   both(a, b)        bitwise and
+ * for counting UTF-8 code points:
+ *   signs(a)          mask of bytes with the top bit set
+ *   subs(a, b)        unsigned saturating subtract
+ * and for UTF-8 validation, on top of the Teddy and counting operations:
+ *   prev<N>(a, b)     a moved up N bytes, the last N bytes of b shifted in
+ *   either(a, b)      bitwise or
+ *   differ(a, b)      bitwise xor
+ * Scans start with an aligned load of the block holding the first byte and
+ * shift away the bytes before it, so no load ever crosses into another page.
+ */
+namespace ytl::detail::simd
+{
+    template<typename V>
+    constexpr uint64_t ALL = V::WIDTH * V::BITS == 64 ? ~uint64_t { 0 } : (uint64_t { 1 } << V::WIDTH * V::BITS) - 1;
+
+    template<typename V>
+    size_t first(const uint64_t mask) noexcept
+    {
+        return static_cast<size_t>(__builtin_ctzll(mask)) / V::BITS;
+    }
+
+    template<typename V>
+    size_t last(const uint64_t mask) noexcept
+    {
+        return static_cast<size_t>(63 - __builtin_clzll(mask)) / V::BITS;
+    }
+
+    template<typename V>
+    size_t misalignment(const char *s) noexcept
+    {
+        return reinterpret_cast<uintptr_t>(s) & (V::WIDTH - 1);
+    }
+
+    template<typename V>
+    bool page_safe(const char *s) noexcept
+    {
+        return (reinterpret_cast<uintptr_t>(s) & (PAGE_BYTES - 1)) <= PAGE_BYTES - V::WIDTH;
+    }
+
+    /**
+     * @brief First byte flagged by mask_of, which maps a loaded vector to a byte mask.
+     * Some byte at or after s must be flagged, the terminator usually is.
+     */
+    template<typename V, typename Mask>
+    YTL_STRING_KERNEL const char *scan(const char *s, const Mask &mask_of) noexcept
+    {
+        const size_t offset = misalignment<V>(s);
+        const char *p = s - offset;
+        if (const uint64_t mask = mask_of(V::load(p)) >> offset * V::BITS)
+            return s + first<V>(mask);
+
+        // Single blocks up to a four block boundary, so an unrolled round never
+        // leaves the page of its first block
+        for (p += V::WIDTH; reinterpret_cast<uintptr_t>(p) & (4 * V::WIDTH - 1); p += V::WIDTH)
+        {
+            if (const uint64_t mask = mask_of(V::load(p)))
+                return p + first<V>(mask);
+        }
+
+        // Four independent compares per round keep several loads in flight
+        for (;; p += 4 * V::WIDTH)
+        {
+            const uint64_t m0 = mask_of(V::load(p));
+            const uint64_t m1 = mask_of(V::load(p + V::WIDTH));
+            const uint64_t m2 = mask_of(V::load(p + 2 * V::WIDTH));
+            const uint64_t m3 = mask_of(V::load(p + 3 * V::WIDTH));
+            if (m0 | m1 | m2 | m3)
+            {
+                const uint64_t masks[] = { m0, m1, m2, m3 };
+                size_t i = 0;
+                while (!masks[i])
+                    i++;
+                return p + i * V::WIDTH + first<V>(masks[i]);
+            }
+        }
+    }
+
+    template<typename V>
+    YTL_STRING_KERNEL size_t strlen(const char *s) noexcept
+    {
+        return static_cast<size_t>(scan<V>(s, [](const typename V::vec block) { return V::zero(block); }) - s);
+    }
+
+    template<typename V>
+    YTL_STRING_KERNEL int strcmp(const char *s1, const char *s2) noexcept
+    {
+        size_t i = 0;
+        while (true)
+        {
+            if (page_safe<V>(s1 + i) && page_safe<V>(s2 + i))
+            {
+                const typename V::vec a = V::loadu(s1 + i);
+                if (const uint64_t stop = (V::eq(a, V::loadu(s2 + i)) ^ ALL<V>) | V::zero(a))
+                {
+                    i += first<V>(stop);
+                    break;
+                }
+                i += V::WIDTH;
+                continue;
+            }
+
+            // One of the strings is near a page end, step bytewise past it
+            const size_t end = i + V::WIDTH;
+            for (; i < end; ++i)
+            {
+                if (s1[i] != s2[i] || !s1[i])
+                    return static_cast<unsigned char>(s1[i]) - static_cast<unsigned char>(s2[i]);
+            }
+        }
+        return static_cast<unsigned char>(s1[i]) - static_cast<unsigned char>(s2[i]);
+    }
+
+    template<typename V>
+    YTL_STRING_KERNEL const char *strchr(const char *s, const int ch) noexcept
+    {
+        const char c = static_cast<char>(ch);
+        const typename V::vec needle = V::splat(c);
+        const char *hit = scan<V>(s, [needle](const typename V::vec block)
+        {
+            return V::eq(block, needle) | V::zero(block);
+        });
+        return *hit == c ? hit : nullptr;
+    }
+
+    template<typename V>
+    YTL_STRING_KERNEL const char *strrchr(const char *s, const int ch) noexcept
+    {
+        const char c = static_cast<char>(ch);
+        if (!c)
+            return s + strlen<V>(s);
+
+        const typename V::vec needle = V::splat(c);
+        const size_t offset = misalignment<V>(s);
+        const char *p = s - offset;
+        const char *base = s;
+        const char *found = nullptr;
+
+        typename V::vec block = V::load(p);
+        uint64_t zeros = V::zero(block) >> offset * V::BITS;
+        uint64_t matches = V::eq(block, needle) >> offset * V::BITS;
+        while (true)
+        {
+            if (zeros)
+            {
+                // Only matches before the terminator count
+                matches &= zeros ^ (zeros - 1);
+                return matches ? base + last<V>(matches) : found;
+            }
+            if (matches)
+                found = base + last<V>(matches);
+
+            p += V::WIDTH;
+            base = p;
+            block = V::load(p);
+            zeros = V::zero(block);
+            matches = V::eq(block, needle);
+        }
+    }
+
+    template<typename V>
+    YTL_STRING_KERNEL const char *strnchr(const char *s, size_t count, const int ch) noexcept
+    {
+        if (!count)
+            return nullptr;
+
+        const char c = static_cast<char>(ch);
+        const typename V::vec needle = V::splat(c);
+        const size_t offset = misalignment<V>(s);
+        const char *p = s - offset;
+        const char *base = s;
+        size_t avail = V::WIDTH - offset;
+
+        typename V::vec block = V::load(p);
+        uint64_t mask = (V::eq(block, needle) | V::zero(block)) >> offset * V::BITS;
+        while (true)
+        {
+            if (mask)
+            {
+                const size_t i = first<V>(mask);
+                if (i >= count)
+                    return nullptr;
+                return base[i] == c ? base + i : nullptr;
+            }
+            if (avail >= count)
+                return nullptr;
+
+            count -= avail;
+            p += V::WIDTH;
+            base = p;
+            avail = V::WIDTH;
+            block = V::load(p);
+            mask = V::eq(block, needle) | V::zero(block);
+        }
+    }
+
+    /**
+     * @brief Case-insensitive compare of at most count bytes
+     * @tparam TERMINATED Stop at a zero byte as well
+     */
+    template<typename V, bool TERMINATED>
+    YTL_STRING_KERNEL int casecmp(const char *s1, const char *s2, const size_t count) noexcept
+    {
+        size_t i = 0;
+        while (i < count)
+        {
+            if (page_safe<V>(s1 + i) && page_safe<V>(s2 + i))
+            {
+                const typename V::vec a = V::flip_case(V::loadu(s1 + i), 'A');
+                uint64_t stop = V::eq(a, V::flip_case(V::loadu(s2 + i), 'A')) ^ ALL<V>;
+                if constexpr (TERMINATED)
+                    stop |= V::zero(a);
+                if (stop)
+                {
+                    const size_t j = i + first<V>(stop);
+                    if (j >= count)
+                        return 0;
+                    return static_cast<unsigned char>(to_lower(s1[j])) - static_cast<unsigned char>(to_lower(s2[j]));
+                }
+                i += V::WIDTH;
+                continue;
+            }
+
+            // One of the strings is near a page end, step bytewise past it
+            const size_t end = count - i > V::WIDTH ? i + V::WIDTH : count;
+            for (; i < end; ++i)
+            {
+                const auto c1 = static_cast<unsigned char>(to_lower(s1[i]));
+                const auto c2 = static_cast<unsigned char>(to_lower(s2[i]));
+                if (c1 != c2 || (TERMINATED && !c1))
+                    return c1 - c2;
+            }
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Copy count bytes with the letters in [FIRST, FIRST + 26) switched case.
+     * The last vector overlaps the previous one, converting twice changes nothing.
+     */
+    template<typename V, char FIRST>
+    YTL_STRING_KERNEL void convert(char *dest, const char *src, const size_t count) noexcept
+    {
+        if (count < V::WIDTH)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                const char c = src[i];
+                dest[i] = c >= FIRST && c < FIRST + 26 ? static_cast<char>(c ^ 0x20) : c;
+            }
+            return;
+        }
+
+        size_t i = 0;
+        for (; i + V::WIDTH <= count; i += V::WIDTH)
+            V::store(dest + i, V::flip_case(V::loadu(src + i), FIRST));
+        if (i < count)
+            V::store(dest + count - V::WIDTH, V::flip_case(V::loadu(src + count - V::WIDTH), FIRST));
+    }
+
+    /**
+     * @brief Mask of the bytes equal to c in the count bytes from s, count below one vector.
+     * Reads a whole vector when it stays in the page, bytewise otherwise.
+     */
+    template<typename V>
+    YTL_STRING_KERNEL uint64_t partial(const char *s, const size_t count, const char c) noexcept
+    {
+        uint64_t mask = 0;
+        if (page_safe<V>(s))
+            mask = V::eq(V::loadu(s), V::splat(c));
+        else
+        {
+            for (size_t i = 0; i < count; ++i)
+                mask |= static_cast<uint64_t>(s[i] == c) << i * V::BITS;
+        }
+        return mask & ((uint64_t { 1 } << count * V::BITS) - 1);
+    }
+
+    template<typename V>
+    YTL_STRING_KERNEL const char *memchr(const char *s, const size_t count, const int ch) noexcept
+    {
+        const char c = static_cast<char>(ch);
+        const typename V::vec needle = V::splat(c);
+        size_t i = 0;
+        for (; i + V::WIDTH <= count; i += V::WIDTH)
+        {
+            if (const uint64_t mask = V::eq(V::loadu(s + i), needle))
+                return s + i + first<V>(mask);
+        }
+        if (i < count)
+        {
+            if (const uint64_t mask = partial<V>(s + i, count - i, c))
+                return s + i + first<V>(mask);
+        }
+        return nullptr;
+    }
+
+    template<typename V>
+    YTL_STRING_KERNEL const char *memrchr(const char *s, size_t count, const int ch) noexcept
+    {
+        const char c = static_cast<char>(ch);
+        const typename V::vec needle = V::splat(c);
+        for (; count >= V::WIDTH; count -= V::WIDTH)
+        {
+            if (const uint64_t mask = V::eq(V::loadu(s + count - V::WIDTH), needle))
+                return s + count - V::WIDTH + last<V>(mask);
+        }
+        if (count)
+        {
+            if (const uint64_t mask = partial<V>(s, count, c))
+                return s + last<V>(mask);
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Filter on the needle's first and last byte, reads stay inside the range.
+     */
+    template<typename V>
+    YTL_STRING_KERNEL const char *find(const char *haystack, const size_t length, const char *needle,
+                                       const size_t count, size_t &candidates) noexcept
+    {
+        const typename V::vec head = V::splat(needle[0]);
+        const typename V::vec tail = V::splat(needle[count - 1]);
+
+        size_t i = 0;
+        for (; i + count - 1 + V::WIDTH <= length; i += V::WIDTH)
+        {
+            uint64_t mask = V::eq(V::loadu(haystack + i), head) & V::eq(V::loadu(haystack + i + count - 1), tail);
+            while (mask)
+            {
+                const unsigned bit = __builtin_ctzll(mask);
+                const char *at = haystack + i + bit / V::BITS;
+                candidates++;
+                if (!__builtin_memcmp(at + 1, needle + 1, count - 2))
+                    return at;
+                mask &= ~(((uint64_t { 1 } << V::BITS) - 1) << bit);
+            }
+        }
+
+        for (; i + count <= length; ++i)
+        {
+            if (haystack[i] == needle[0] && haystack[i + count - 1] == needle[count - 1])
+            {
+                candidates++;
+                if (!__builtin_memcmp(haystack + i + 1, needle + 1, count - 2))
+                    return haystack + i;
+            }
+        }
+        return nullptr;
+    }
+
+    template<typename V>
+    concept nibble_lookup = requires(const uint8_t *t, typename V::vec a)
+    {
+        V::table(t);
+        V::classify(a, a, a);
+        V::both(a, a);
+    };
+
+    /**
+     * @brief First start whose FINGERPRINT bytes all hit the nibble tables with a common bit
+     */
+    template<typename V, size_t FINGERPRINT>
+    YTL_STRING_KERNEL const char *nibble_scan(const nibble_masks &masks, const char *text, const size_t count,
+                                              uint8_t &buckets) noexcept
+    {
+        typename V::vec lo[FINGERPRINT];
+        typename V::vec hi[FINGERPRINT];
+        for (size_t k = 0; k < FINGERPRINT; ++k)
+        {
+            lo[k] = V::table(masks.lo[k]);
+            hi[k] = V::table(masks.hi[k]);
+        }
+
+        size_t i = 0;
+        for (; i + V::WIDTH <= count; i += V::WIDTH)
+        {
+            typename V::vec hits = V::classify(lo[0], hi[0], V::loadu(text + i));
+            for (size_t k = 1; k < FINGERPRINT; ++k)
+                hits = V::both(hits, V::classify(lo[k], hi[k], V::loadu(text + i + k)));
+
+            if (const uint64_t mask = V::zero(hits) ^ ALL<V>)
+            {
+                uint8_t lanes[V::WIDTH];
+                V::store(lanes, hits);
+                const size_t j = first<V>(mask);
+                buckets = lanes[j];
+                return text + i + j;
+            }
+        }
+
+        for (; i < count; ++i)
+        {
+            uint8_t hit = 0xFF;
+            for (size_t k = 0; k < FINGERPRINT; ++k)
+            {
+                const auto c = static_cast<unsigned char>(text[i + k]);
+                hit &= masks.lo[k][c & 0x0F] & masks.hi[k][c >> 4];
+            }
+            if (hit)
+            {
+                buckets = hit;
+                return text + i;
+            }
+        }
+        return nullptr;
+    }
+
+    template<typename V>
+    YTL_STRING_KERNEL const char *nibble_find(const nibble_masks &masks, const char *text, const size_t count,
+                                              uint8_t &buckets) noexcept
+    {
+        switch (masks.fingerprint)
+        {
+            case 1:
+                return nibble_scan<V, 1>(masks, text, count, buckets);
+            case 2:
+                return nibble_scan<V, 2>(masks, text, count, buckets);
+            default:
+                return nibble_scan<V, 3>(masks, text, count, buckets);
+        }
+    }
+
+    template<typename V>
+    concept utf8_count = requires(typename V::vec a)
+    {
+        V::signs(a);
+        V::subs(a, a);
+    };
+
+    template<typename V>
+    concept utf8_lookup = nibble_lookup<V> && utf8_count<V> && requires(typename V::vec a)
+    {
+        V::template prev<1>(a, a);
+        V::either(a, a);
+        V::differ(a, a);
+    };
+
+    template<typename V>
+    YTL_STRING_KERNEL size_t count_utf8(const char *s, const size_t length) noexcept
+    {
+        // Continuation bytes are the ones at least 0x80 and at most 0xBF
+        const typename V::vec last_continuation = V::splat(static_cast<char>(0xBF));
+        size_t continuations = 0;
+        size_t i = 0;
+        for (; i + V::WIDTH <= length; i += V::WIDTH)
+        {
+            const typename V::vec block = V::loadu(s + i);
+            continuations += __builtin_popcountll(V::signs(block) & V::zero(V::subs(block, last_continuation)));
+        }
+        return i - continuations / V::BITS + scalar::count_utf8(s + i, length - i);
+    }
+
+    namespace utf8
+    {
+        // Error classes of a byte and the one before it, after Keiser and Lemire,
+        // "Validating UTF-8 In Less Than One Instruction Per Byte". A pair is bad when
+        // the classes of its first byte's nibbles and its second byte's high nibble
+        // share a bit, except that continuations owed to a three or four byte lead
+        // must show up as TWO_CONTS, which the lengths check flips.
+        constexpr uint8_t TOO_SHORT = 1 << 0;
+        constexpr uint8_t TOO_LONG = 1 << 1;
+        constexpr uint8_t OVERLONG_3 = 1 << 2;
+        constexpr uint8_t TOO_LARGE = 1 << 3;
+        constexpr uint8_t SURROGATE = 1 << 4;
+        constexpr uint8_t OVERLONG_2 = 1 << 5;
+        constexpr uint8_t TOO_LARGE_1000 = 1 << 6;
+        constexpr uint8_t OVERLONG_4 = 1 << 6;
+        constexpr uint8_t TWO_CONTS = 1 << 7;
+        constexpr uint8_t CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS;
+
+        inline constexpr uint8_t FIRST_HIGH[16] = {
+            TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+            TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+            TOO_SHORT | OVERLONG_2,
+            TOO_SHORT,
+            TOO_SHORT | OVERLONG_3 | SURROGATE,
+            TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4
+        };
+
+        inline constexpr uint8_t FIRST_LOW[16] = {
+            CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+            CARRY | OVERLONG_2,
+            CARRY,
+            CARRY,
+            CARRY | TOO_LARGE,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000
+        };
+
+        inline constexpr uint8_t SECOND_HIGH[16] = {
+            TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+            TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+            TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+            TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+            TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+            TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT
+        };
+
+        inline constexpr uint8_t ANY[16] = {
+            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+        };
+
+        /**
+         * @brief Largest bytes that finish a vector without an open sequence, in its last WIDTH bytes
+         */
+        inline constexpr char TAIL_MAX[64] = {
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            static_cast<char>(0xEF), static_cast<char>(0xDF), static_cast<char>(0xBF)
+        };
+    }
+
+    /**
+     * @brief Lookup validation over whole vectors. Errors accumulate in one vector,
+     * checked once at the end, and blocks of plain ASCII skip the tables.
+     */
+    template<typename V>
+    YTL_STRING_KERNEL bool validate_utf8(const char *s, const size_t length) noexcept
+    {
+        using vec = typename V::vec;
+        const vec first_low = V::table(utf8::FIRST_LOW);
+        const vec first_high = V::table(utf8::FIRST_HIGH);
+        const vec second_high = V::table(utf8::SECOND_HIGH);
+        const vec any = V::table(utf8::ANY);
+        const vec tail_max = V::loadu(utf8::TAIL_MAX + sizeof(utf8::TAIL_MAX) - V::WIDTH);
+        const vec third_lead = V::splat(static_cast<char>(0xE0 - 0x80));
+        const vec fourth_lead = V::splat(static_cast<char>(0xF0 - 0x80));
+        const vec top = V::splat(static_cast<char>(0x80));
+
+        vec previous = V::splat(0);
+        vec error = previous;
+        vec incomplete = previous;
+        const auto check = [&](const vec input)
+        {
+            const vec prev1 = V::template prev<1>(input, previous);
+            const vec special = V::both(V::classify(first_low, first_high, prev1), V::classify(any, second_high, input));
+            // Top bit set where the byte two or three back leads a longer sequence
+            const vec owed = V::either(V::subs(V::template prev<2>(input, previous), third_lead),
+                                       V::subs(V::template prev<3>(input, previous), fourth_lead));
+            error = V::either(error, V::differ(V::both(owed, top), special));
+        };
+
+        size_t i = 0;
+        for (; i + V::WIDTH <= length; i += V::WIDTH)
+        {
+            const vec input = V::loadu(s + i);
+            if (V::signs(input))
+            {
+                check(input);
+                incomplete = V::subs(input, tail_max);
+            }
+            else
+                error = V::either(error, incomplete);
+            previous = input;
+        }
+
+        // Zero padding reads as ASCII, so a sequence cut off by the end fails the check
+        alignas(64) char tail[V::WIDTH] = {};
+        if (i < length)
+            __builtin_memcpy(tail, s + i, length - i);
+        check(V::loadu(tail));
+        return V::zero(error) == ALL<V>;
+    }
+
+    template<typename V>
+    constexpr kernels table(const simd_level level) noexcept
+    {
+        kernels k = {
+            level, &strlen<V>, &strcmp<V>, &strchr<V>, &strrchr<V>, &strnchr<V>, &memchr<V>, &memrchr<V>,
+            &casecmp<V, true>, &casecmp<V, false>, &convert<V, 'A'>, &convert<V, 'a'>, &find<V>, nullptr,
+            &scalar::validate_utf8, &scalar::count_utf8, &scalar::base64_encode, &scalar::base64_decode,
+            &scalar::hex_encode, &scalar::hex_decode
+        };
+        if constexpr (nibble_lookup<V>)
+            k.nibble_find = &nibble_find<V>;
+        if constexpr (utf8_count<V>)
+            k.count_utf8 = &count_utf8<V>;
+        if constexpr (utf8_lookup<V>)
+            k.validate_utf8 = &validate_utf8<V>;
+        return k;
+    }
+}
@@ -0,0 +1,258 @@
+#include "simd.inl"
+#include "codec_tables.h"
+
+#ifdef YTL_STRING_X86
+#include <immintrin.h>
+
+namespace ytl::detail
+{
+    namespace
+    {
+        struct avx2
+        {
+            using vec = __m256i;
+
+            static constexpr size_t WIDTH = 32;
+            static constexpr size_t BITS = 1;
+
+            YTL_STRING_KERNEL static vec load(const char *p) noexcept
+            {
+                return _mm256_load_si256(reinterpret_cast<const __m256i *>(p));
+            }
+
+            YTL_STRING_KERNEL static vec loadu(const char *p) noexcept
+            {
+                return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            }
+
+            static vec splat(const char c) noexcept
+            {
+                return _mm256_set1_epi8(c);
+            }
+
+            static uint64_t eq(const vec a, const vec b) noexcept
+            {
+                return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)));
+            }
+
+            static uint64_t zero(const vec a) noexcept
+            {
+                return eq(a, _mm256_setzero_si256());
+            }
+
+            static vec table(const uint8_t *t) noexcept
+            {
+                return _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(t)));
+            }
+
+            static vec classify(const vec lo, const vec hi, const vec a) noexcept
+            {
+                const vec low = _mm256_set1_epi8(0x0F);
+                return _mm256_and_si256(_mm256_shuffle_epi8(lo, _mm256_and_si256(a, low)),
+                                        _mm256_shuffle_epi8(hi, _mm256_and_si256(_mm256_srli_epi16(a, 4), low)));
+            }
+
+            static vec both(const vec a, const vec b) noexcept
+            {
+                return _mm256_and_si256(a, b);
+            }
+
+            static vec flip_case(const vec a, const char first) noexcept
+            {
+                const vec shifted = _mm256_add_epi8(a, _mm256_set1_epi8(static_cast<char>(0x80 - first)));
+                const vec letters = _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(0x80 + 26)), shifted);
+                return _mm256_xor_si256(a, _mm256_and_si256(letters, _mm256_set1_epi8(0x20)));
+            }
+
+            static uint64_t signs(const vec a) noexcept
+            {
+                return static_cast<uint32_t>(_mm256_movemask_epi8(a));
+            }
+
+            static vec subs(const vec a, const vec b) noexcept
+            {
+                return _mm256_subs_epu8(a, b);
+            }
+
+            template<int N>
+            static vec prev(const vec a, const vec before) noexcept
+            {
+                // alignr works within 128-bit lanes, the lane below each one of a comes first
+                return _mm256_alignr_epi8(a, _mm256_permute2x128_si256(before, a, 0x21), 16 - N);
+            }
+
+            static vec either(const vec a, const vec b) noexcept
+            {
+                return _mm256_or_si256(a, b);
+            }
+
+            static vec differ(const vec a, const vec b) noexcept
+            {
+                return _mm256_xor_si256(a, b);
+            }
+
+            static void store(void *p, const vec a) noexcept
+            {
+                _mm256_storeu_si256(static_cast<__m256i *>(p), a);
+            }
+        };
+    }
+
+    namespace avx2_codec
+    {
+        namespace
+        {
+            /**
+             * @brief The same 16 byte table in both lanes
+             */
+            __m256i lanes(const uint8_t *t) noexcept
+            {
+                return _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(t)));
+            }
+
+            /**
+             * @brief Bytes that are decimal digits or hex letters of either case, and their values
+             */
+            __m256i hex_values(const __m256i c, uint32_t &valid) noexcept
+            {
+                const __m256i digit = _mm256_sub_epi8(c, _mm256_set1_epi8('0'));
+                const __m256i letter = _mm256_sub_epi8(_mm256_or_si256(c, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+                const __m256i is_digit = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+                const __m256i is_letter = _mm256_cmpeq_epi8(_mm256_min_epu8(letter, _mm256_set1_epi8(5)), letter);
+                valid = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(is_digit, is_letter)));
+                return _mm256_blendv_epi8(_mm256_add_epi8(letter, _mm256_set1_epi8(10)), digit, is_digit);
+            }
+        }
+
+        // Base64 after Mula and Lemire, "Faster Base64 Encoding and Decoding using AVX2 Instructions"
+        size_t base64_encode(const char *src, const size_t length, char *dest, const bool url) noexcept
+        {
+            // Offsets from six bit value to character, by value range
+            const __m256i offsets = url ? _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                                           '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '-' - 62,
+                                                           '_' - 63, 'A', 0, 0, 'a' - 26, '0' - 52, '0' - 52, '0' - 52,
+                                                           '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                                           '0' - 52, '-' - 62, '_' - 63, 'A', 0, 0)
+                                        : _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                                           '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                                                           '/' - 63, 'A', 0, 0, 'a' - 26, '0' - 52, '0' - 52, '0' - 52,
+                                                           '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                                           '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+            // Each 32-bit word gets the bytes of one group as b1 b0 b2 b1
+            const __m256i spread = _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+                                                    1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+            size_t i = 0;
+            // Each round reads 28 bytes and encodes 24 of them
+            for (; i + 28 <= length; i += 24, dest += 32)
+            {
+                const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+                const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i + 12));
+                const __m256i in = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1),
+                                                       spread);
+
+                // Move the four six bit fields of each word into their own bytes
+                const __m256i ac = _mm256_mulhi_epu16(_mm256_and_si256(in, _mm256_set1_epi32(0x0FC0FC00)),
+                                                      _mm256_set1_epi32(0x04000040));
+                const __m256i bd = _mm256_mullo_epi16(_mm256_and_si256(in, _mm256_set1_epi32(0x003F03F0)),
+                                                      _mm256_set1_epi32(0x01000010));
+                const __m256i values = _mm256_or_si256(ac, bd);
+
+                // 13 for upper case, 0 for lower case, 1 to 10 for digits, 11 and 12 for the last two
+                const __m256i upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), values);
+                const __m256i range = _mm256_or_si256(_mm256_subs_epu8(values, _mm256_set1_epi8(51)),
+                                                      _mm256_and_si256(upper, _mm256_set1_epi8(13)));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(dest),
+                                    _mm256_add_epi8(values, _mm256_shuffle_epi8(offsets, range)));
+            }
+            return i;
+        }
+
+        size_t base64_decode(const char *src, const size_t length, char *dest, const bool url) noexcept
+        {
+            const base64::nibbles &n = url ? base64::URL_NIBBLES : base64::STANDARD_NIBBLES;
+            const __m256i lo = lanes(n.lo);
+            const __m256i hi = lanes(n.hi);
+            const __m256i roll = lanes(n.roll);
+            const __m256i special = _mm256_set1_epi8(n.special);
+            const __m256i special_shift = _mm256_set1_epi8(static_cast<char>(8 - (n.special >> 4)));
+            const __m256i low_nibble = _mm256_set1_epi8(0x0F);
+            const __m256i pack = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                                  2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+            size_t i = 0;
+            for (; i + 32 <= length; i += 32, dest += 24)
+            {
+                const __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+                const __m256i high_nibbles = _mm256_and_si256(_mm256_srli_epi16(in, 4), low_nibble);
+                const __m256i bad = _mm256_and_si256(_mm256_shuffle_epi8(lo, _mm256_and_si256(in, low_nibble)),
+                                                     _mm256_shuffle_epi8(hi, high_nibbles));
+                if (!_mm256_testz_si256(bad, bad))
+                    break;
+
+                const __m256i index = _mm256_add_epi8(high_nibbles,
+                                                      _mm256_and_si256(_mm256_cmpeq_epi8(in, special), special_shift));
+                const __m256i values = _mm256_add_epi8(in, _mm256_shuffle_epi8(roll, index));
+
+                // Pairs of six bit values into 12 bits, pairs of those into 24
+                const __m256i pairs = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+                const __m256i words = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+                // Twelve bytes per lane, joined into the low 24 and stored without touching more
+                const __m256i bytes = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(words, pack),
+                                                                  _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dest), _mm256_castsi256_si128(bytes));
+                _mm_storel_epi64(reinterpret_cast<__m128i *>(dest + 16), _mm256_extracti128_si256(bytes, 1));
+            }
+            return i;
+        }
+
+        size_t hex_encode(const char *src, const size_t length, char *dest, const bool upper) noexcept
+        {
+            const __m256i digits = lanes(reinterpret_cast<const uint8_t *>(upper ? hex::UPPER : hex::LOWER));
+            const __m256i low_nibble = _mm256_set1_epi8(0x0F);
+            size_t i = 0;
+            for (; i + 32 <= length; i += 32, dest += 64)
+            {
+                const __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+                const __m256i high = _mm256_shuffle_epi8(digits, _mm256_and_si256(_mm256_srli_epi16(in, 4), low_nibble));
+                const __m256i low = _mm256_shuffle_epi8(digits, _mm256_and_si256(in, low_nibble));
+                // Interleaving works per lane, the lane swap puts the halves back in order
+                const __m256i first = _mm256_unpacklo_epi8(high, low);
+                const __m256i second = _mm256_unpackhi_epi8(high, low);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(dest), _mm256_permute2x128_si256(first, second, 0x20));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(dest + 32),
+                                    _mm256_permute2x128_si256(first, second, 0x31));
+            }
+            return i;
+        }
+
+        size_t hex_decode(const char *src, const size_t length, char *dest) noexcept
+        {
+            size_t i = 0;
+            for (; i + 64 <= length; i += 64, dest += 32)
+            {
+                uint32_t valid0;
+                uint32_t valid1;
+                const __m256i v0 = hex_values(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i)), valid0);
+                const __m256i v1 = hex_values(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i + 32)), valid1);
+                if ((valid0 & valid1) != ~uint32_t { 0 })
+                    break;
+                // High digit times 16 plus low digit, packed back to bytes in order
+                const __m256i weights = _mm256_set1_epi16(0x0110);
+                const __m256i bytes = _mm256_packus_epi16(_mm256_maddubs_epi16(v0, weights),
+                                                          _mm256_maddubs_epi16(v1, weights));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(dest), _mm256_permute4x64_epi64(bytes, 0xD8));
+            }
+            return i;
+        }
+    }
+
+    const kernels avx2_kernels = []
+    {
+        kernels k = simd::table<avx2>(simd_level::AVX2);
+        k.base64_encode = &avx2_codec::base64_encode;
+        k.base64_decode = &avx2_codec::base64_decode;
+        k.hex_encode = &avx2_codec::hex_encode;
+        k.hex_decode = &avx2_codec::hex_decode;
+        return k;
+    }();
+}
+#endif
@@ -0,0 +1,112 @@
+#include "simd.inl"
+
+#ifdef YTL_STRING_X86
+#include <immintrin.h>
+
+namespace ytl::detail
+{
+    namespace
+    {
+        struct avx512
+        {
+            using vec = __m512i;
+
+            static constexpr size_t WIDTH = 64;
+            static constexpr size_t BITS = 1;
+
+            YTL_STRING_KERNEL static vec load(const char *p) noexcept
+            {
+                return _mm512_load_si512(p);
+            }
+
+            YTL_STRING_KERNEL static vec loadu(const char *p) noexcept
+            {
+                return _mm512_loadu_si512(p);
+            }
+
+            static vec splat(const char c) noexcept
+            {
+                return _mm512_set1_epi8(c);
+            }
+
+            static uint64_t eq(const vec a, const vec b) noexcept
+            {
+                return _mm512_cmpeq_epi8_mask(a, b);
+            }
+
+            static uint64_t zero(const vec a) noexcept
+            {
+                return _mm512_testn_epi8_mask(a, a);
+            }
+
+            static vec table(const uint8_t *t) noexcept
+            {
+                return _mm512_maskz_broadcast_i32x4(0xFFFF, _mm_loadu_si128(reinterpret_cast<const __m128i *>(t)));
+            }
+
+            static vec classify(const vec lo, const vec hi, const vec a) noexcept
+            {
+                const vec low = _mm512_set1_epi8(0x0F);
+                return _mm512_and_si512(_mm512_shuffle_epi8(lo, _mm512_and_si512(a, low)),
+                                        _mm512_shuffle_epi8(hi, _mm512_and_si512(_mm512_srli_epi16(a, 4), low)));
+            }
+
+            static vec both(const vec a, const vec b) noexcept
+            {
+                return _mm512_and_si512(a, b);
+            }
+
+            static vec flip_case(const vec a, const char first) noexcept
+            {
+                const __mmask64 letters = _mm512_cmplt_epu8_mask(_mm512_sub_epi8(a, _mm512_set1_epi8(first)),
+                                                                 _mm512_set1_epi8(26));
+                return _mm512_xor_si512(a, _mm512_maskz_mov_epi8(letters, _mm512_set1_epi8(0x20)));
+            }
+
+            static uint64_t signs(const vec a) noexcept
+            {
+                return _mm512_movepi8_mask(a);
+            }
+
+            static vec subs(const vec a, const vec b) noexcept
+            {
+                return _mm512_subs_epu8(a, b);
+            }
+
+            template<int N>
+            static vec prev(const vec a, const vec before) noexcept
+            {
+                // alignr works within 128-bit lanes, the lane below each one of a comes first
+                const vec below = _mm512_permutex2var_epi64(a, _mm512_set_epi64(5, 4, 3, 2, 1, 0, 15, 14), before);
+                return _mm512_alignr_epi8(a, below, 16 - N);
+            }
+
+            static vec either(const vec a, const vec b) noexcept
+            {
+                return _mm512_or_si512(a, b);
+            }
+
+            static vec differ(const vec a, const vec b) noexcept
+            {
+                return _mm512_xor_si512(a, b);
+            }
+
+            static void store(void *p, const vec a) noexcept
+            {
+                _mm512_storeu_si512(p, a);
+            }
+        };
+    }
+
+    // The codecs gain little from wider shuffles without VBMI, they stay on AVX2
+    const kernels avx512_kernels = []
+    {
+        kernels k = simd::table<avx512>(simd_level::AVX512);
+        k.base64_encode = &avx2_codec::base64_encode;
+        k.base64_decode = &avx2_codec::base64_decode;
+        k.hex_encode = &avx2_codec::hex_encode;
+        k.hex_decode = &avx2_codec::hex_decode;
+        return k;
+    }();
+}
+#endif
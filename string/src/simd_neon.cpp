@@ -0,0 +1,223 @@
+#include "simd.inl"
+#include "codec_tables.h"
+
+#ifdef YTL_STRING_NEON
+#include <arm_neon.h>
+
+namespace ytl::detail
+{
+    namespace
+    {
+        struct neon
+        {
+            using vec = uint8x16_t;
+
+            static constexpr size_t WIDTH = 16;
+            static constexpr size_t BITS = 4;
+
+            YTL_STRING_KERNEL static vec load(const char *p) noexcept
+            {
+                return vld1q_u8(reinterpret_cast<const uint8_t *>(p));
+            }
+
+            YTL_STRING_KERNEL static vec loadu(const char *p) noexcept
+            {
+                return load(p);
+            }
+
+            static vec splat(const char c) noexcept
+            {
+                return vdupq_n_u8(static_cast<uint8_t>(c));
+            }
+
+            // NEON has no movemask, narrowing each 16-bit lane by 4 leaves one
+            // nibble per byte in a 64-bit scalar
+            static uint64_t mask(const uint8x16_t cmp) noexcept
+            {
+                return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(cmp), 4)), 0);
+            }
+
+            static uint64_t eq(const vec a, const vec b) noexcept
+            {
+                return mask(vceqq_u8(a, b));
+            }
+
+            static uint64_t zero(const vec a) noexcept
+            {
+                return mask(vceqzq_u8(a));
+            }
+
+            static vec table(const uint8_t *t) noexcept
+            {
+                return vld1q_u8(t);
+            }
+
+            static vec classify(const vec lo, const vec hi, const vec a) noexcept
+            {
+                return vandq_u8(vqtbl1q_u8(lo, vandq_u8(a, vdupq_n_u8(0x0F))), vqtbl1q_u8(hi, vshrq_n_u8(a, 4)));
+            }
+
+            static vec both(const vec a, const vec b) noexcept
+            {
+                return vandq_u8(a, b);
+            }
+
+            static vec flip_case(const vec a, const char first) noexcept
+            {
+                const vec letters = vcltq_u8(vsubq_u8(a, vdupq_n_u8(static_cast<uint8_t>(first))), vdupq_n_u8(26));
+                return veorq_u8(a, vandq_u8(letters, vdupq_n_u8(0x20)));
+            }
+
+            static uint64_t signs(const vec a) noexcept
+            {
+                return mask(vcltzq_s8(vreinterpretq_s8_u8(a)));
+            }
+
+            static vec subs(const vec a, const vec b) noexcept
+            {
+                return vqsubq_u8(a, b);
+            }
+
+            template<int N>
+            static vec prev(const vec a, const vec before) noexcept
+            {
+                return vextq_u8(before, a, 16 - N);
+            }
+
+            static vec either(const vec a, const vec b) noexcept
+            {
+                return vorrq_u8(a, b);
+            }
+
+            static vec differ(const vec a, const vec b) noexcept
+            {
+                return veorq_u8(a, b);
+            }
+
+            static void store(void *p, const vec a) noexcept
+            {
+                vst1q_u8(static_cast<uint8_t *>(p), a);
+            }
+        };
+    }
+
+    namespace neon_codec
+    {
+        namespace
+        {
+            uint8x16x4_t table64(const uint8_t *t) noexcept
+            {
+                return { { vld1q_u8(t), vld1q_u8(t + 16), vld1q_u8(t + 32), vld1q_u8(t + 48) } };
+            }
+
+            /**
+             * @brief Values of hex digits of either case, valid flags the bytes that are digits
+             */
+            uint8x16_t hex_values(const uint8x16_t c, uint8x16_t &valid) noexcept
+            {
+                const uint8x16_t digit = vsubq_u8(c, vdupq_n_u8('0'));
+                const uint8x16_t letter = vsubq_u8(vorrq_u8(c, vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+                const uint8x16_t is_digit = vcltq_u8(digit, vdupq_n_u8(10));
+                valid = vorrq_u8(is_digit, vcltq_u8(letter, vdupq_n_u8(6)));
+                return vbslq_u8(is_digit, digit, vaddq_u8(letter, vdupq_n_u8(10)));
+            }
+
+            // Structured loads and stores split and join the groups, so every step is lane wise
+            size_t base64_encode(const char *src, const size_t length, char *dest, const bool url) noexcept
+            {
+                const uint8x16x4_t alphabet = table64(reinterpret_cast<const uint8_t *>(url ? base64::URL : base64::STANDARD));
+                const uint8x16_t six = vdupq_n_u8(63);
+                const auto *p = reinterpret_cast<const uint8_t *>(src);
+                size_t i = 0;
+                for (; i + 48 <= length; i += 48, dest += 64)
+                {
+                    const uint8x16x3_t in = vld3q_u8(p + i);
+                    uint8x16x4_t out;
+                    out.val[0] = vshrq_n_u8(in.val[0], 2);
+                    out.val[1] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[0], 4), vshrq_n_u8(in.val[1], 4)), six);
+                    out.val[2] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[1], 2), vshrq_n_u8(in.val[2], 6)), six);
+                    out.val[3] = vandq_u8(in.val[2], six);
+                    for (uint8x16_t &v: out.val)
+                        v = vqtbl4q_u8(alphabet, v);
+                    vst4q_u8(reinterpret_cast<uint8_t *>(dest), out);
+                }
+                return i;
+            }
+
+            size_t base64_decode(const char *src, const size_t length, char *dest, const bool url) noexcept
+            {
+                const uint8_t *values = url ? base64::URL_VALUES.of : base64::STANDARD_VALUES.of;
+                const uint8x16x4_t low = table64(values);
+                const uint8x16x4_t high = table64(values + 64);
+                const auto *p = reinterpret_cast<const uint8_t *>(src);
+                size_t i = 0;
+                for (; i + 64 <= length; i += 64, dest += 48)
+                {
+                    uint8x16x4_t in = vld4q_u8(p + i);
+                    uint8x16_t bad = vdupq_n_u8(0);
+                    for (uint8x16_t &c: in.val)
+                    {
+                        // Out of range indices look up zero, so each byte hits at most one of the tables.
+                        // Bytes from 0x80 hit none, their own top bit marks them.
+                        const uint8x16_t v = vorrq_u8(vqtbl4q_u8(low, c), vqtbl4q_u8(high, vsubq_u8(c, vdupq_n_u8(64))));
+                        bad = vorrq_u8(bad, vorrq_u8(v, c));
+                        c = v;
+                    }
+                    if (vmaxvq_u8(bad) & 0x80)
+                        break;
+
+                    uint8x16x3_t out;
+                    out.val[0] = vorrq_u8(vshlq_n_u8(in.val[0], 2), vshrq_n_u8(in.val[1], 4));
+                    out.val[1] = vorrq_u8(vshlq_n_u8(in.val[1], 4), vshrq_n_u8(in.val[2], 2));
+                    out.val[2] = vorrq_u8(vshlq_n_u8(in.val[2], 6), in.val[3]);
+                    vst3q_u8(reinterpret_cast<uint8_t *>(dest), out);
+                }
+                return i;
+            }
+
+            size_t hex_encode(const char *src, const size_t length, char *dest, const bool upper) noexcept
+            {
+                const uint8x16_t digits = vld1q_u8(reinterpret_cast<const uint8_t *>(upper ? hex::UPPER : hex::LOWER));
+                const auto *p = reinterpret_cast<const uint8_t *>(src);
+                size_t i = 0;
+                for (; i + 16 <= length; i += 16, dest += 32)
+                {
+                    const uint8x16_t in = vld1q_u8(p + i);
+                    const uint8x16x2_t out = { { vqtbl1q_u8(digits, vshrq_n_u8(in, 4)),
+                                                 vqtbl1q_u8(digits, vandq_u8(in, vdupq_n_u8(15))) } };
+                    vst2q_u8(reinterpret_cast<uint8_t *>(dest), out);
+                }
+                return i;
+            }
+
+            size_t hex_decode(const char *src, const size_t length, char *dest) noexcept
+            {
+                const auto *p = reinterpret_cast<const uint8_t *>(src);
+                size_t i = 0;
+                for (; i + 32 <= length; i += 32, dest += 16)
+                {
+                    const uint8x16x2_t in = vld2q_u8(p + i);
+                    uint8x16_t valid_high;
+                    uint8x16_t valid_low;
+                    const uint8x16_t high = hex_values(in.val[0], valid_high);
+                    const uint8x16_t low = hex_values(in.val[1], valid_low);
+                    if (vminvq_u8(vandq_u8(valid_high, valid_low)) != 0xFF)
+                        break;
+                    vst1q_u8(reinterpret_cast<uint8_t *>(dest), vorrq_u8(vshlq_n_u8(high, 4), low));
+                }
+                return i;
+            }
+        }
+    }
+
+    const kernels neon_kernels = []
+    {
+        kernels k = simd::table<neon>(simd_level::NEON);
+        k.base64_encode = &neon_codec::base64_encode;
+        k.base64_decode = &neon_codec::base64_decode;
+        k.hex_encode = &neon_codec::hex_encode;
+        k.hex_decode = &neon_codec::hex_decode;
+        return k;
+    }();
+}
+#endif
@@ -0,0 +1,68 @@
+#include "simd.inl"
+
+#ifdef YTL_STRING_X86
+#include <emmintrin.h>
+
+namespace ytl::detail
+{
+    namespace
+    {
+        struct sse2
+        {
+            using vec = __m128i;
+
+            static constexpr size_t WIDTH = 16;
+            static constexpr size_t BITS = 1;
+
+            YTL_STRING_KERNEL static vec load(const char *p) noexcept
+            {
+                return _mm_load_si128(reinterpret_cast<const __m128i *>(p));
+            }
+
+            YTL_STRING_KERNEL static vec loadu(const char *p) noexcept
+            {
+                return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+            }
+
+            static vec splat(const char c) noexcept
+            {
+                return _mm_set1_epi8(c);
+            }
+
+            static uint64_t eq(const vec a, const vec b) noexcept
+            {
+                return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)));
+            }
+
+            static uint64_t zero(const vec a) noexcept
+            {
+                return eq(a, _mm_setzero_si128());
+            }
+
+            static vec flip_case(const vec a, const char first) noexcept
+            {
+                const vec shifted = _mm_add_epi8(a, _mm_set1_epi8(static_cast<char>(0x80 - first)));
+                const vec letters = _mm_cmplt_epi8(shifted, _mm_set1_epi8(static_cast<char>(0x80 + 26)));
+                return _mm_xor_si128(a, _mm_and_si128(letters, _mm_set1_epi8(0x20)));
+            }
+
+            static uint64_t signs(const vec a) noexcept
+            {
+                return static_cast<uint32_t>(_mm_movemask_epi8(a));
+            }
+
+            static vec subs(const vec a, const vec b) noexcept
+            {
+                return _mm_subs_epu8(a, b);
+            }
+
+            static void store(void *p, const vec a) noexcept
+            {
+                _mm_storeu_si128(static_cast<__m128i *>(p), a);
+            }
+        };
+    }
+
+    const kernels sse2_kernels = simd::table<sse2>(simd_level::SSE2);
+}
+#endif
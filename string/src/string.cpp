@@ -1,4 +1,8 @@
 #include "../include/string.h"
+#include "../include/searcher.h"
+#include "simd.h"
+
+#include <hash.h>
 
 namespace ytl::detail
 {
@@ -9,67 +13,236 @@ namespace ytl::detail
     {
         return ((x - ones) & ~x & highs) != 0;
     }
-}
 
-namespace ytl
-{
-    size_t strlen(const char *s) noexcept
+    namespace scalar
     {
-        const char *str = s;
-        if (reinterpret_cast<size_t>(str) & (sizeof(size_t) - 1))
+        YTL_STRING_KERNEL size_t strlen(const char *s) noexcept
         {
-            while (reinterpret_cast<size_t>(str) & (sizeof(size_t) - 1))
+            const char *str = s;
+            if (reinterpret_cast<size_t>(str) & (sizeof(size_t) - 1))
             {
-                if (!*str)
-                    return str - s;
+                while (reinterpret_cast<size_t>(str) & (sizeof(size_t) - 1))
+                {
+                    if (!*str)
+                        return str - s;
+                    str++;
+                }
+            }
+
+            const auto *ls = reinterpret_cast<const size_t *>(str);
+            while (!has_zero(*ls))
+                ls++;
+
+            str = reinterpret_cast<const char *>(ls);
+            while (*str)
                 str++;
+
+            return str - s;
+        }
+
+        YTL_STRING_KERNEL int strcmp(const char *s1, const char *s2) noexcept
+        {
+            while (reinterpret_cast<size_t>(s1) & (sizeof(size_t) - 1))
+            {
+                if (*s1 != *s2)
+                    return static_cast<unsigned char>(*s1) - static_cast<unsigned char>(*s2);
+                if (!*s1)
+                    return 0;
+                s1++;
+                s2++;
             }
+
+            while (true)
+            {
+                // s1 is aligned, s2 is only read a word at a time while the word stays in its page
+                if ((reinterpret_cast<uintptr_t>(s2) & (PAGE_BYTES - 1)) <= PAGE_BYTES - sizeof(size_t))
+                {
+                    const size_t w1 = *reinterpret_cast<const size_t *>(s1);
+                    size_t w2;
+                    __builtin_memcpy(&w2, s2, sizeof(w2));
+                    if (!has_zero(w1) && w1 == w2)
+                    {
+                        s1 += sizeof(size_t);
+                        s2 += sizeof(size_t);
+                        continue;
+                    }
+                }
+
+                for (size_t i = 0; i < sizeof(size_t); ++i, ++s1, ++s2)
+                {
+                    if (*s1 != *s2 || !*s1)
+                        return static_cast<unsigned char>(*s1) - static_cast<unsigned char>(*s2);
+                }
+            }
+        }
+
+        const char *strchr(const char *s, const int c) noexcept
+        {
+            const auto ch = static_cast<char>(c);
+            while (*s && *s != ch)
+                s++;
+            return *s == ch ? s : nullptr;
+        }
+
+        const char *strrchr(const char *s, const int c) noexcept
+        {
+            const char *last = nullptr;
+            do
+            {
+                if (*s == static_cast<char>(c))
+                    last = s;
+            }
+            while (*s++);
+            return last;
         }
 
-        const auto *ls = reinterpret_cast<const size_t *>(str);
-        while (!detail::has_zero(*ls))
-            ls++;
+        const char *strnchr(const char *s, size_t count, const int c) noexcept
+        {
+            while (count--)
+            {
+                if (*s == static_cast<char>(c))
+                    return s;
+                if (*s++ == '\0')
+                    break;
+            }
+            return nullptr;
+        }
 
-        str = reinterpret_cast<const char *>(ls);
-        while (*str)
-            str++;
+        const char *memchr(const char *s, const size_t count, const int c) noexcept
+        {
+            return static_cast<const char *>(__builtin_memchr(s, c, count));
+        }
 
-        return str - s;
+        const char *memrchr(const char *s, size_t count, const int c) noexcept
+        {
+            while (count--)
+            {
+                if (s[count] == static_cast<char>(c))
+                    return s + count;
+            }
+            return nullptr;
+        }
+
+        template<bool TERMINATED>
+        int casecmp(const char *s1, const char *s2, size_t count) noexcept
+        {
+            while (count--)
+            {
+                const auto c1 = static_cast<unsigned char>(to_lower(*s1++));
+                if (const auto c2 = static_cast<unsigned char>(to_lower(*s2++));
+                    c1 != c2 || (TERMINATED && !c1))
+                    return c1 - c2;
+            }
+            return 0;
+        }
+
+        void lower(char *dest, const char *src, const size_t count) noexcept
+        {
+            for (size_t i = 0; i < count; ++i)
+                dest[i] = to_lower(src[i]);
+        }
+
+        void upper(char *dest, const char *src, const size_t count) noexcept
+        {
+            for (size_t i = 0; i < count; ++i)
+                dest[i] = to_upper(src[i]);
+        }
+
+        const char *find(const char *haystack, const size_t length, const char *needle, const size_t count,
+                         size_t &candidates) noexcept
+        {
+            const char *end = haystack + length - count + 1;
+            while (haystack < end)
+            {
+                const auto *at = static_cast<const char *>(__builtin_memchr(haystack, needle[0], end - haystack));
+                if (!at)
+                    break;
+                if (at[count - 1] == needle[count - 1])
+                {
+                    candidates++;
+                    if (!__builtin_memcmp(at + 1, needle + 1, count - 2))
+                        return at;
+                }
+                haystack = at + 1;
+            }
+            return nullptr;
+        }
     }
 
-    constexpr size_t strnlen(const char *s, size_t maxlen) noexcept
+    const kernels scalar_kernels = {
+        simd_level::SCALAR, &scalar::strlen, &scalar::strcmp, &scalar::strchr, &scalar::strrchr, &scalar::strnchr,
+        &scalar::memchr, &scalar::memrchr, &scalar::casecmp<true>, &scalar::casecmp<false>, &scalar::lower,
+        &scalar::upper, &scalar::find, nullptr, &scalar::validate_utf8, &scalar::count_utf8, &scalar::base64_encode,
+        &scalar::base64_decode, &scalar::hex_encode, &scalar::hex_decode
+    };
+}
+
+namespace ytl
+{
+    namespace detail
     {
-        const char *es = s;
-        while (*es && maxlen)
+        int strncasecmp(const char *s1, const char *s2, const size_t count) noexcept
         {
-            es++;
-            maxlen--;
+            return active().strncasecmp(s1, s2, count);
         }
-        return es - s;
     }
 
-    char *strcpy(char *dest, const char *src) noexcept
+    void to_lower(char *s, const size_t length) noexcept
+    {
+        detail::active().to_lower(s, s, length);
+    }
+
+    void to_upper(char *s, const size_t length) noexcept
+    {
+        detail::active().to_upper(s, s, length);
+    }
+
+    void to_lower(char *dest, const char *src, const size_t length) noexcept
+    {
+        detail::active().to_lower(dest, src, length);
+    }
+
+    void to_upper(char *dest, const char *src, const size_t length) noexcept
+    {
+        detail::active().to_upper(dest, src, length);
+    }
+
+    int memcasecmp(const char *s1, const char *s2, const size_t count) noexcept
     {
-        char *ret = dest;
+        return detail::active().memcasecmp(s1, s2, count);
+    }
 
-        while (reinterpret_cast<size_t>(src) & (sizeof(size_t) - 1))
+    uint64_t casehash(const char *s, size_t length, const uint64_t seed) noexcept
+    {
+        // Lowered copies go through the byte hash, so this equals hash of the lowered string
+        char lowered[256];
+        if (length <= sizeof(lowered))
         {
-            if ((*dest = *src) == '\0')
-                return ret;
-            dest++;
-            src++;
+            detail::active().to_lower(lowered, s, length);
+            return hash(lowered, length, seed);
         }
 
-        auto *ldest = reinterpret_cast<size_t *>(dest);
-        const auto *lsrc = reinterpret_cast<const size_t *>(src);
-        while (!detail::has_zero(*lsrc))
-            *ldest++ = *lsrc++;
+        hasher h(seed);
+        while (length)
+        {
+            const size_t n = length < sizeof(lowered) ? length : sizeof(lowered);
+            detail::active().to_lower(lowered, s, n);
+            h.update(lowered, n);
+            s += n;
+            length -= n;
+        }
+        return h.digest();
+    }
 
-        dest = reinterpret_cast<char *>(ldest);
-        src = reinterpret_cast<const char *>(lsrc);
-        while ((*dest++ = *src++) != '\0') {}
+    size_t strlen(const char *s) noexcept
+    {
+        return detail::active().strlen(s);
+    }
 
-        return ret;
+    char *strcpy(char *dest, const char *src) noexcept
+    {
+        __builtin_memcpy(dest, src, strlen(src) + 1);
+        return dest;
     }
 
     char *strncpy(char *dest, const char *src, size_t count) noexcept
@@ -88,44 +261,25 @@ namespace ytl
 
     size_t strlcpy(char *dest, const char *src, const size_t size) noexcept
     {
-        const char *s = src;
-        size_t n = size;
-        if (n != 0 && --n != 0)
-        {
-            do
-            {
-                if ((*dest++ = *s++) == 0)
-                    break;
-            }
-            while (--n != 0);
-        }
-
-        if (n == 0)
+        const size_t len = strlen(src);
+        if (size)
         {
-            if (size != 0)
-                *dest = '\0';
-            while (*s++);
+            const size_t n = len < size - 1 ? len : size - 1;
+            __builtin_memcpy(dest, src, n);
+            dest[n] = '\0';
         }
-
-        return s - src - 1;
+        return len;
     }
 
     char *strcat(char *dest, const char *src) noexcept
     {
-        char *tmp = dest;
-        while (*tmp)
-            tmp++;
-
-        while ((*tmp++ = *src++) != '\0') {}
+        strcpy(dest + strlen(dest), src);
         return dest;
     }
 
     char *strncat(char *dest, const char *src, size_t n) noexcept
     {
-        char *tmp = dest;
-        while (*tmp)
-            tmp++;
-
+        char *tmp = dest + strlen(dest);
         while (n-- > 0 && (*tmp = *src) != '\0')
         {
             tmp++;
@@ -138,114 +292,27 @@ namespace ytl
 
     size_t strlcat(char *dest, const char *src, const size_t size) noexcept
     {
-        const char *s = src;
-        char *d = dest;
-        size_t n = size;
-        while (n-- != 0 && *d != '\0')
-            d++;
-        const size_t dlen = d - dest;
-        n = size - dlen;
-
-        if (n == 0)
-            return dlen + strlen(s);
+        const char *end = strnchr(dest, size, '\0');
+        if (!end)
+            return size + strlen(src);
 
-        while (*s != '\0')
-        {
-            if (n != 1)
-            {
-                *d++ = *s;
-                n--;
-            }
-            s++;
-        }
-        *d = '\0';
+        const size_t dlen = end - dest;
+        const size_t slen = strlen(src);
+        const size_t n = slen < size - dlen - 1 ? slen : size - dlen - 1;
+        __builtin_memcpy(dest + dlen, src, n);
+        dest[dlen + n] = '\0';
 
-        return dlen + (s - src);
+        return dlen + slen;
     }
 
     int strcmp(const char *s1, const char *s2) noexcept
     {
-        while (reinterpret_cast<size_t>(s1) & (sizeof(size_t) - 1))
-        {
-            if (*s1 != *s2)
-                return static_cast<unsigned char>(*s1) - static_cast<unsigned char>(*s2);
-            if (!*s1)
-                return 0;
-            s1++;
-            s2++;
-        }
-
-        const auto *ls1 = reinterpret_cast<const size_t *>(s1);
-        const auto *ls2 = reinterpret_cast<const size_t *>(s2);
-        while (!detail::has_zero(*ls1) && *ls1 == *ls2)
-        {
-            ls1++;
-            ls2++;
-        }
-
-        s1 = reinterpret_cast<const char *>(ls1);
-        s2 = reinterpret_cast<const char *>(ls2);
-        while (*s1 && *s1 == *s2)
-        {
-            s1++;
-            s2++;
-        }
-        return static_cast<unsigned char>(*s1) - static_cast<unsigned char>(*s2);
+        return detail::active().strcmp(s1, s2);
     }
 
-    constexpr int strncmp(const char *s1, const char *s2, size_t count) noexcept
+    const char *strchr(const char *s, const int c) noexcept
     {
-        while (count--)
-        {
-            const auto c1 = static_cast<unsigned char>(*s1++);
-            if (auto c2 = static_cast<unsigned char>(*s2++);
-                c1 != c2)
-                return c1 - c2;
-            if (!c1)
-                break;
-        }
-        return 0;
-    }
-
-    constexpr int strcasecmp(const char *s1, const char *s2) noexcept
-    {
-        while (true)
-        {
-            const auto c1 = static_cast<unsigned char>(*s1++ | 0x20);
-            if (auto c2 = static_cast<unsigned char>(*s2++ | 0x20);
-                c1 != c2 || !c1)
-                return c1 - c2;
-        }
-    }
-
-    constexpr int strncasecmp(const char *s1, const char *s2, size_t len) noexcept
-    {
-        if (!len)
-            return 0;
-
-        do
-        {
-            const auto c1 = static_cast<unsigned char>(*s1++ | 0x20);
-            if (const auto c2 = static_cast<unsigned char>(*s2++ | 0x20);
-                !--len || c1 != c2)
-                return c1 - c2;
-        }
-        while (true);
-    }
-
-    const char *strchr(const char *s, int c) noexcept
-    {
-        const auto ch = static_cast<unsigned char>(c);
-        if (!ch)
-        {
-            while (*s)
-                s++;
-            return s;
-        }
-
-        while (*s && *s != ch)
-            s++;
-        return *s == ch ? s : nullptr;
+        return detail::active().strchr(s, c);
     }
 
     char *strchr(char *s, int c) noexcept
@@ -253,16 +320,9 @@ namespace ytl
         return const_cast<char *>(strchr(static_cast<const char *>(s), c));
     }
 
-    const char *strrchr(const char *s, int c) noexcept
+    const char *strrchr(const char *s, const int c) noexcept
     {
-        const char *last = nullptr;
-        do
-        {
-            if (*s == static_cast<char>(c))
-                last = s;
-        }
-        while (*s++);
-        return last;
+        return detail::active().strrchr(s, c);
     }
 
     char *strrchr(char *s, int c) noexcept
@@ -270,16 +330,9 @@ namespace ytl
         return const_cast<char *>(strrchr(static_cast<const char *>(s), c));
     }
 
-    const char *strnchr(const char *s, size_t count, int c) noexcept
+    const char *strnchr(const char *s, const size_t count, const int c) noexcept
     {
-        while (count--)
-        {
-            if (*s == static_cast<char>(c))
-                return s;
-            if (*s++ == '\0')
-                break;
-        }
-        return nullptr;
+        return detail::active().strnchr(s, count, c);
     }
 
     char *strnchr(char *s, size_t count, int c) noexcept
@@ -287,20 +340,10 @@ namespace ytl
         return const_cast<char *>(strnchr(static_cast<const char *>(s), count, c));
     }
 
-    const char *strnstr(const char *s1, const char *s2, size_t len) noexcept
+    const char *strnstr(const char *s1, const char *s2, const size_t len) noexcept
     {
-        const size_t l2 = strlen(s2);
-        if (!l2)
-            return s1;
-
-        while (len >= l2)
-        {
-            if (!strncmp(s1, s2, l2))
-                return s1;
-            s1++;
-            len--;
-        }
-        return nullptr;
+        const char *end = strnchr(s1, len, '\0');
+        return searcher(s2).find(s1, end ? static_cast<size_t>(end - s1) : len);
     }
 
     char *strnstr(char *s1, const char *s2, size_t len) noexcept
@@ -310,30 +353,7 @@ namespace ytl
 
     const char *strstr(const char *haystack, const char *needle) noexcept
     {
-        const char first = *needle;
-        if (!first)
-            return haystack;
-
-        while (*haystack)
-        {
-            if (*haystack == first)
-            {
-                const char *h = haystack + 1;
-                const char *n = needle + 1;
-
-                while (*n && *h == *n)
-                {
-                    h++;
-                    n++;
-                }
-
-                if (!*n)
-                    return haystack;
-            }
-            haystack++;
-        }
-
-        return nullptr;
+        return searcher(needle).find(haystack);
     }
 
     char *strstr(char *haystack, const char *needle) noexcept
@@ -0,0 +1,219 @@
+#include "../include/string_interner.h"
+
+#include <bit>
+#include <memory>
+#include <new>
+#include <stdexcept>
+
+namespace ytl
+{
+    /**
+     * @brief Open addressed slots, each the high half of a string's hash above its id + 1.
+     * Zero marks a free slot. Slots are only ever filled, so a probe ends at the
+     * first free one. Outgrown tables stay linked until the interner dies, readers
+     * may still be probing them.
+     */
+    struct string_interner::table
+    {
+        size_t mask;
+        std::atomic<uint64_t> *slots;
+        table *previous;
+    };
+
+    /**
+     * @brief Arena block, its bytes follow the header
+     */
+    struct string_interner::block
+    {
+        block *next;
+    };
+
+    namespace detail
+    {
+        namespace
+        {
+            constexpr size_t INITIAL_SLOTS = 64;
+            constexpr size_t BLOCK_BYTES = size_t { 64 } << 10;
+            // Strings larger than this get a block of their own instead of wasting the rest of one
+            constexpr size_t OWN_BLOCK = BLOCK_BYTES / 4;
+            constexpr size_t LENGTH_BYTES = sizeof(uint32_t);
+
+            uint64_t make_slot(const uint64_t h, const uint32_t id) noexcept
+            {
+                return (h >> 32) << 32 | (uint64_t { id } + 1);
+            }
+
+            /**
+             * @brief Segment of an id and its offset within it
+             */
+            size_t locate(const uint32_t id, size_t &offset, const size_t first) noexcept
+            {
+                const uint64_t k = std::bit_width(uint64_t { id } / first + 1) - 1;
+                offset = id - first * ((uint64_t { 1 } << k) - 1);
+                return k;
+            }
+
+            void place(std::atomic<uint64_t> *slots, const size_t mask, const uint64_t slot, const uint64_t h,
+                       const std::memory_order order) noexcept
+            {
+                size_t i = h & mask;
+                while (slots[i].load(std::memory_order_relaxed))
+                    i = (i + 1) & mask;
+                slots[i].store(slot, order);
+            }
+        }
+    }
+
+    string_interner::string_interner()
+    {
+        current.store(new table { detail::INITIAL_SLOTS - 1, new std::atomic<uint64_t>[detail::INITIAL_SLOTS](), nullptr },
+                      std::memory_order_relaxed);
+        footprint.store(sizeof(table) + detail::INITIAL_SLOTS * sizeof(uint64_t), std::memory_order_relaxed);
+    }
+
+    string_interner::~string_interner()
+    {
+        for (table *t = current.load(std::memory_order_relaxed); t;)
+        {
+            table *previous = t->previous;
+            delete[] t->slots;
+            delete t;
+            t = previous;
+        }
+        for (const char **segment: segments)
+            delete[] segment;
+        for (block *b = blocks; b;)
+        {
+            block *next = b->next;
+            ::operator delete(b);
+            b = next;
+        }
+    }
+
+    const char *string_interner::entry(const uint32_t id) const noexcept
+    {
+        size_t offset;
+        const size_t k = detail::locate(id, offset, FIRST_SEGMENT);
+        return segments[k][offset];
+    }
+
+    string_view string_interner::view(const symbol s) const noexcept
+    {
+        const char *bytes = entry(s.id);
+        uint32_t length;
+        __builtin_memcpy(&length, bytes - detail::LENGTH_BYTES, sizeof(length));
+        return { bytes, length };
+    }
+
+    uint32_t string_interner::lookup(const table *t, const string_view s, const uint64_t h) const noexcept
+    {
+        const uint64_t tag = h >> 32;
+        for (size_t i = h & t->mask;; i = (i + 1) & t->mask)
+        {
+            // Pairs with the release store of the slot, the entry and its bytes are visible
+            const uint64_t slot = t->slots[i].load(std::memory_order_acquire);
+            if (!slot)
+                return NONE;
+            const auto id = static_cast<uint32_t>(slot - 1);
+            if (slot >> 32 == tag && view({ id }) == s)
+                return id;
+        }
+    }
+
+    string_interner::symbol string_interner::find(const string_view s) const noexcept
+    {
+        return { lookup(current.load(std::memory_order_acquire), s, hash(s)) };
+    }
+
+    string_interner::symbol string_interner::intern(const string_view s)
+    {
+        const uint64_t h = hash(s);
+        if (const uint32_t id = lookup(current.load(std::memory_order_acquire), s, h); id != NONE)
+            return { id };
+
+        std::lock_guard lock(writer);
+        // Another writer may have stored it since
+        if (const uint32_t id = lookup(current.load(std::memory_order_relaxed), s, h); id != NONE)
+            return { id };
+
+        const uint32_t id = count.load(std::memory_order_relaxed);
+        if (id == NONE)
+            throw std::length_error("string_interner: symbol ids exhausted");
+        const char *bytes = store(s);
+
+        size_t offset;
+        const size_t k = detail::locate(id, offset, FIRST_SEGMENT);
+        if (!segments[k])
+        {
+            segments[k] = new const char *[FIRST_SEGMENT << k];
+            footprint.fetch_add((FIRST_SEGMENT << k) * sizeof(const char *), std::memory_order_relaxed);
+        }
+        segments[k][offset] = bytes;
+
+        // Keeps tables at most half full so probes stay short
+        if ((uint64_t { id } + 1) * 2 > current.load(std::memory_order_relaxed)->mask + 1)
+            grow();
+        const table *t = current.load(std::memory_order_relaxed);
+        detail::place(t->slots, t->mask, detail::make_slot(h, id), h, std::memory_order_release);
+        count.store(id + 1, std::memory_order_release);
+        return { id };
+    }
+
+    const char *string_interner::store(const string_view s)
+    {
+        if (s.size() > ~uint32_t { 0 })
+            throw std::length_error("string_interner: string too long");
+        const size_t need = detail::LENGTH_BYTES + s.size() + 1;
+
+        char *out;
+        if (need > detail::OWN_BLOCK)
+        {
+            auto *b = static_cast<block *>(::operator new(sizeof(block) + need));
+            b->next = blocks;
+            blocks = b;
+            out = reinterpret_cast<char *>(b + 1);
+            footprint.fetch_add(sizeof(block) + need, std::memory_order_relaxed);
+        }
+        else
+        {
+            if (need > static_cast<size_t>(limit - cursor))
+            {
+                auto *b = static_cast<block *>(::operator new(sizeof(block) + detail::BLOCK_BYTES));
+                b->next = blocks;
+                blocks = b;
+                cursor = reinterpret_cast<char *>(b + 1);
+                limit = cursor + detail::BLOCK_BYTES;
+                footprint.fetch_add(sizeof(block) + detail::BLOCK_BYTES, std::memory_order_relaxed);
+            }
+            out = cursor;
+            cursor += need;
+        }
+
+        const auto length = static_cast<uint32_t>(s.size());
+        __builtin_memcpy(out, &length, sizeof(length));
+        out += detail::LENGTH_BYTES;
+        if (!s.empty())
+            __builtin_memcpy(out, s.data(), s.size());
+        out[s.size()] = 0;
+        return out;
+    }
+
+    void string_interner::grow()
+    {
+        table *old = current.load(std::memory_order_relaxed);
+        const size_t slots = (old->mask + 1) * 2;
+        std::unique_ptr<std::atomic<uint64_t>[]> fresh(new std::atomic<uint64_t>[slots]());
+        auto *t = new table { slots - 1, fresh.get(), old };
+        fresh.release();
+
+        // Nobody sees the table before it is published, the release store below orders these
+        const uint32_t n = count.load(std::memory_order_relaxed);
+        for (uint32_t id = 0; id < n; ++id)
+        {
+            const uint64_t h = hash(view({ id }));
+            detail::place(t->slots, t->mask, detail::make_slot(h, id), h, std::memory_order_relaxed);
+        }
+        current.store(t, std::memory_order_release);
+        footprint.fetch_add(sizeof(table) + slots * sizeof(uint64_t), std::memory_order_relaxed);
+    }
+}
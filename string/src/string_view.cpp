@@ -0,0 +1,42 @@
+#include "../include/string_view.h"
+#include "../include/searcher.h"
+#include "simd.h"
+
+namespace ytl
+{
+    int string_view::compare(const string_view other) const noexcept
+    {
+        const size_t common = len < other.len ? len : other.len;
+        if (common)
+        {
+            if (const int diff = __builtin_memcmp(ptr, other.ptr, common))
+                return diff;
+        }
+        return len < other.len ? -1 : len > other.len;
+    }
+
+    size_t string_view::find(const char c, const size_t pos) const noexcept
+    {
+        if (pos >= len)
+            return npos;
+        const char *hit = detail::active().memchr(ptr + pos, len - pos, c);
+        return hit ? static_cast<size_t>(hit - ptr) : npos;
+    }
+
+    size_t string_view::find(const string_view s, const size_t pos) const noexcept
+    {
+        if (pos > len)
+            return npos;
+        if (!s.len)
+            return pos;
+        const char *hit = searcher(s.ptr, s.len).find(ptr + pos, len - pos);
+        return hit ? static_cast<size_t>(hit - ptr) : npos;
+    }
+
+    size_t string_view::rfind(const char c, const size_t pos) const noexcept
+    {
+        const size_t count = pos < len ? pos + 1 : len;
+        const char *hit = detail::active().memrchr(ptr, count, c);
+        return hit ? static_cast<size_t>(hit - ptr) : npos;
+    }
+}
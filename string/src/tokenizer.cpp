@@ -0,0 +1,110 @@
+#include "../include/tokenizer.h"
+#include "simd.h"
+
+namespace ytl
+{
+    char_set::char_set(const string_view chars) noexcept
+    {
+        for (const char c : chars)
+        {
+            const auto b = static_cast<unsigned char>(c);
+            bits[b >> 6] |= uint64_t { 1 } << (b & 63);
+        }
+
+        // One bucket per high nibble in use, beyond 8 they start sharing
+        uint8_t bucket_of[16] {};
+        size_t used = 0;
+        for (unsigned high = 0; high < 16; ++high)
+        {
+            if ((bits[high >> 2] >> (high & 3) * 16) & 0xFFFF)
+                bucket_of[high] = static_cast<uint8_t>(1u << used++ % detail::nibble_masks::BUCKETS);
+        }
+        exact = used <= detail::nibble_masks::BUCKETS;
+
+        masks.fingerprint = 1;
+        for (unsigned b = 0; b < 256; ++b)
+        {
+            if (contains(static_cast<char>(b)))
+            {
+                masks.lo[0][b & 0x0F] |= bucket_of[b >> 4];
+                masks.hi[0][b >> 4] = bucket_of[b >> 4];
+            }
+        }
+    }
+
+    const char *char_set::find(const char *s, size_t count) const noexcept
+    {
+        const auto scan = detail::active().nibble_find;
+        if (!scan)
+        {
+            for (const char *end = s + count; s < end; ++s)
+            {
+                if (contains(*s))
+                    return s;
+            }
+            return nullptr;
+        }
+
+        uint8_t hit;
+        while (const char *at = scan(masks, s, count, hit))
+        {
+            if (exact || contains(*at))
+                return at;
+            count -= static_cast<size_t>(at + 1 - s);
+            s = at + 1;
+        }
+        return nullptr;
+    }
+
+    const char *char_set::skip(const char *s, const size_t count) const noexcept
+    {
+        const char *end = s + count;
+        while (s < end && contains(*s))
+            s++;
+        return s;
+    }
+
+    bool tokenizer::next(string_view &token) noexcept
+    {
+        if (skip_empty)
+        {
+            text.remove_prefix(static_cast<size_t>(delimiters.skip(text.data(), text.size()) - text.data()));
+            if (text.empty())
+                return false;
+        }
+        else if (text.empty() && !pending)
+            return false;
+
+        const char *end = delimiters.find(text.data(), text.size());
+        if (!end)
+        {
+            token = text;
+            text.remove_prefix(text.size());
+            pending = false;
+            return true;
+        }
+
+        token = { text.data(), static_cast<size_t>(end - text.data()) };
+        text.remove_prefix(token.size() + 1);
+        pending = true;
+        return true;
+    }
+
+    bool split_lines::next(string_view &line) noexcept
+    {
+        if (text.empty())
+            return false;
+
+        const size_t newline = text.find('\n');
+        if (newline == string_view::npos)
+        {
+            line = text;
+            text.remove_prefix(text.size());
+            return true;
+        }
+
+        line = { text.data(), newline && text[newline - 1] == '\r' ? newline - 1 : newline };
+        text.remove_prefix(newline + 1);
+        return true;
+    }
+}
@@ -0,0 +1,351 @@
+#include "../include/utf8.h"
+#include "simd.h"
+
+#include <bit>
+#include <type_traits>
+
+namespace ytl::detail
+{
+    namespace
+    {
+        constexpr uint64_t LOW_BITS = ~uint64_t { 0 } / 0xFF;
+        constexpr uint64_t HIGH_BITS = LOW_BITS * 0x80;
+
+        uint64_t load_word(const char *s) noexcept
+        {
+            uint64_t v;
+            __builtin_memcpy(&v, s, sizeof(v));
+            return v;
+        }
+
+        /**
+         * @brief Bytes for which flag sets the top bit, eight at a time. Byte lanes
+         * count up to 255 words before they are summed.
+         */
+        template<typename Flag>
+        size_t count_bytes(const char *s, const size_t length, const Flag &flag) noexcept
+        {
+            size_t count = 0;
+            size_t i = 0;
+            while (i + 8 <= length)
+            {
+                uint64_t lanes = 0;
+                for (size_t round = 0; round < 255 && i + 8 <= length; ++round, i += 8)
+                    lanes += flag(load_word(s + i)) >> 7 & LOW_BITS;
+                lanes = (lanes & 0x00FF00FF00FF00FF) + (lanes >> 8 & 0x00FF00FF00FF00FF);
+                count += lanes * 0x0001000100010001 >> 48;
+            }
+            if (i < length)
+            {
+                // Zero padding is ASCII, which no flag counts
+                uint64_t w = 0;
+                __builtin_memcpy(&w, s + i, length - i);
+                count += (flag(w) >> 7 & LOW_BITS) * LOW_BITS >> 56;
+            }
+            return count;
+        }
+
+        constexpr uint64_t continuations(const uint64_t w) noexcept
+        {
+            return w & ~(w << 1);
+        }
+
+        constexpr uint64_t four_byte_leads(const uint64_t w) noexcept
+        {
+            return w & w << 1 & w << 2 & w << 3;
+        }
+
+        /**
+         * @brief Decode one code point of at most avail bytes
+         * @return Length of the sequence, 0 when it is ill formed
+         */
+        size_t decode(const unsigned char *p, const size_t avail, char32_t &cp) noexcept
+        {
+            const unsigned c = p[0];
+            if (c < 0x80)
+            {
+                cp = c;
+                return 1;
+            }
+            if (c < 0xC2)
+                return 0;
+            if (c < 0xE0)
+            {
+                if (avail < 2 || (p[1] & 0xC0) != 0x80)
+                    return 0;
+                cp = (c & 0x1F) << 6 | (p[1] & 0x3F);
+                return 2;
+            }
+
+            // The second byte range excludes overlong forms, surrogates and values past U+10FFFF
+            if (c < 0xF0)
+            {
+                const unsigned char low = c == 0xE0 ? 0xA0 : 0x80;
+                const unsigned char high = c == 0xED ? 0x9F : 0xBF;
+                if (avail < 3 || p[1] < low || p[1] > high || (p[2] & 0xC0) != 0x80)
+                    return 0;
+                cp = (c & 0x0F) << 12 | (p[1] & 0x3F) << 6 | (p[2] & 0x3F);
+                return 3;
+            }
+            if (c < 0xF5)
+            {
+                const unsigned char low = c == 0xF0 ? 0x90 : 0x80;
+                const unsigned char high = c == 0xF4 ? 0x8F : 0xBF;
+                if (avail < 4 || p[1] < low || p[1] > high || (p[2] & 0xC0) != 0x80 || (p[3] & 0xC0) != 0x80)
+                    return 0;
+                cp = (c & 0x07) << 18 | (p[1] & 0x3F) << 12 | (p[2] & 0x3F) << 6 | (p[3] & 0x3F);
+                return 4;
+            }
+            return 0;
+        }
+
+        /**
+         * @brief Offset of the first ill formed sequence, or length
+         */
+        size_t invalid_at(const char *s, const size_t length) noexcept
+        {
+            const auto *p = reinterpret_cast<const unsigned char *>(s);
+            size_t i = 0;
+            while (i < length)
+            {
+                if (i + 8 <= length && !(load_word(s + i) & HIGH_BITS))
+                {
+                    i += 8;
+                    continue;
+                }
+                char32_t cp;
+                const size_t n = decode(p + i, length - i, cp);
+                if (!n)
+                    return i;
+                i += n;
+            }
+            return length;
+        }
+
+        constexpr size_t BLOCK_UNITS = 16;
+
+        /**
+         * @brief Leading ASCII units of the 16 from p, read a word at a time
+         */
+        template<typename Unit>
+        size_t ascii_prefix(const Unit *p) noexcept
+        {
+            constexpr size_t UNIT_BITS = sizeof(Unit) * 8;
+            // All bits of each unit but its low seven
+            constexpr uint64_t NON_ASCII = ~uint64_t { 0 } / ((uint64_t { 1 } << (UNIT_BITS - 1) << 1) - 1) *
+                                           ((uint64_t { 1 } << (UNIT_BITS - 1) << 1) - 0x80);
+            constexpr size_t PER_WORD = 8 / sizeof(Unit);
+            for (size_t k = 0; k < BLOCK_UNITS; k += PER_WORD)
+            {
+                uint64_t w;
+                __builtin_memcpy(&w, p + k, sizeof(w));
+                if (const uint64_t bad = w & NON_ASCII)
+                {
+                    const unsigned bit = std::endian::native == std::endian::little ? __builtin_ctzll(bad)
+                                                                                    : __builtin_clzll(bad);
+                    return k + bit / UNIT_BITS;
+                }
+            }
+            return BLOCK_UNITS;
+        }
+
+        /**
+         * @brief Copy a block of units, the caller keeps only its ASCII prefix
+         */
+        template<typename To, typename From>
+        void copy_block(To *dest, const From *src) noexcept
+        {
+            // Local copies rule out overlap, so the conversion compiles to vector code
+            std::make_unsigned_t<From> in[BLOCK_UNITS];
+            To out[BLOCK_UNITS];
+            __builtin_memcpy(in, src, sizeof(in));
+            for (size_t k = 0; k < BLOCK_UNITS; ++k)
+                out[k] = static_cast<To>(in[k]);
+            __builtin_memcpy(dest, out, sizeof(out));
+        }
+
+        template<typename Unit>
+        utf_result from_utf8(const char *src, const size_t length, Unit *dest, const size_t capacity) noexcept
+        {
+            const auto *p = reinterpret_cast<const unsigned char *>(src);
+            size_t i = 0;
+            size_t written = 0;
+            while (i < length)
+            {
+                // Runs of ASCII are copied a block at a time
+                if (p[i] < 0x80 && length - i >= BLOCK_UNITS && capacity - written >= BLOCK_UNITS)
+                {
+                    copy_block(dest + written, p + i);
+                    const size_t ascii = ascii_prefix(src + i);
+                    i += ascii;
+                    written += ascii;
+                    if (ascii == BLOCK_UNITS)
+                        continue;
+                }
+
+                char32_t cp;
+                const size_t n = decode(p + i, length - i, cp);
+                if (!n)
+                    return { i, written, std::errc::illegal_byte_sequence };
+
+                const size_t units = sizeof(Unit) == 2 && cp >= 0x10000 ? 2 : 1;
+                if (capacity - written < units)
+                    return { i, written, std::errc::value_too_large };
+                if (units == 2)
+                {
+                    dest[written++] = static_cast<Unit>(0xD800 + ((cp - 0x10000) >> 10));
+                    dest[written++] = static_cast<Unit>(0xDC00 + (cp & 0x3FF));
+                }
+                else
+                    dest[written++] = static_cast<Unit>(cp);
+                i += n;
+            }
+            return { i, written, std::errc {} };
+        }
+
+        template<typename Unit>
+        utf_result to_utf8(const Unit *src, const size_t length, char *dest, const size_t capacity) noexcept
+        {
+            size_t i = 0;
+            size_t written = 0;
+            while (i < length)
+            {
+                if (src[i] < 0x80 && length - i >= BLOCK_UNITS && capacity - written >= BLOCK_UNITS)
+                {
+                    copy_block(dest + written, src + i);
+                    const size_t ascii = ascii_prefix(src + i);
+                    i += ascii;
+                    written += ascii;
+                    if (ascii == BLOCK_UNITS)
+                        continue;
+                }
+
+                char32_t cp = src[i];
+                size_t n = 1;
+                if (cp - 0xD800 < 0x800)
+                {
+                    // A high surrogate followed by a low one, only in UTF-16
+                    if (sizeof(Unit) != 2 || cp >= 0xDC00 || i + 1 == length ||
+                        static_cast<char32_t>(src[i + 1]) - 0xDC00 >= 0x400)
+                        return { i, written, std::errc::illegal_byte_sequence };
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (src[i + 1] - 0xDC00);
+                    n = 2;
+                }
+                else if (cp > 0x10FFFF)
+                    return { i, written, std::errc::illegal_byte_sequence };
+
+                const size_t bytes = 1 + (cp >= 0x80) + (cp >= 0x800) + (cp >= 0x10000);
+                if (capacity - written < bytes)
+                    return { i, written, std::errc::value_too_large };
+                char *out = dest + written;
+                switch (bytes)
+                {
+                    case 1:
+                        out[0] = static_cast<char>(cp);
+                        break;
+                    case 2:
+                        out[0] = static_cast<char>(0xC0 | cp >> 6);
+                        out[1] = static_cast<char>(0x80 | (cp & 0x3F));
+                        break;
+                    case 3:
+                        out[0] = static_cast<char>(0xE0 | cp >> 12);
+                        out[1] = static_cast<char>(0x80 | (cp >> 6 & 0x3F));
+                        out[2] = static_cast<char>(0x80 | (cp & 0x3F));
+                        break;
+                    default:
+                        out[0] = static_cast<char>(0xF0 | cp >> 18);
+                        out[1] = static_cast<char>(0x80 | (cp >> 12 & 0x3F));
+                        out[2] = static_cast<char>(0x80 | (cp >> 6 & 0x3F));
+                        out[3] = static_cast<char>(0x80 | (cp & 0x3F));
+                        break;
+                }
+                i += n;
+                written += bytes;
+            }
+            return { i, written, std::errc {} };
+        }
+    }
+
+    namespace scalar
+    {
+        bool validate_utf8(const char *s, const size_t length) noexcept
+        {
+            return invalid_at(s, length) == length;
+        }
+
+        size_t count_utf8(const char *s, const size_t length) noexcept
+        {
+            return length - count_bytes(s, length, continuations);
+        }
+    }
+}
+
+namespace ytl
+{
+    bool validate_utf8(const char *s, const size_t length) noexcept
+    {
+        return detail::active().validate_utf8(s, length);
+    }
+
+    const char *find_invalid_utf8(const char *s, const size_t length) noexcept
+    {
+        // Valid text is the common case, the bytewise search only runs on bad input
+        if (detail::active().validate_utf8(s, length))
+            return s + length;
+        return s + detail::invalid_at(s, length);
+    }
+
+    size_t count_utf8(const char *s, const size_t length) noexcept
+    {
+        return detail::active().count_utf8(s, length);
+    }
+
+    size_t utf16_length(const char *s, const size_t length) noexcept
+    {
+        // Code points past the basic plane take a surrogate pair
+        return count_utf8(s, length) + detail::count_bytes(s, length, detail::four_byte_leads);
+    }
+
+    size_t utf8_length(const char16_t *s, const size_t length) noexcept
+    {
+        // Each half of a surrogate pair stands for two of the four bytes
+        size_t bytes = 0;
+        for (size_t i = 0; i < length; ++i)
+        {
+            const char16_t u = s[i];
+            bytes += 1 + (u >= 0x80) + (u >= 0x800) - (u - 0xD800u < 0x800);
+        }
+        return bytes;
+    }
+
+    size_t utf8_length(const char32_t *s, const size_t length) noexcept
+    {
+        size_t bytes = 0;
+        for (size_t i = 0; i < length; ++i)
+        {
+            const char32_t c = s[i];
+            bytes += 1 + (c >= 0x80) + (c >= 0x800) + (c >= 0x10000);
+        }
+        return bytes;
+    }
+
+    utf_result utf8_to_utf16(const char *src, const size_t length, char16_t *dest, const size_t capacity) noexcept
+    {
+        return detail::from_utf8(src, length, dest, capacity);
+    }
+
+    utf_result utf8_to_utf32(const char *src, const size_t length, char32_t *dest, const size_t capacity) noexcept
+    {
+        return detail::from_utf8(src, length, dest, capacity);
+    }
+
+    utf_result utf16_to_utf8(const char16_t *src, const size_t length, char *dest, const size_t capacity) noexcept
+    {
+        return detail::to_utf8(src, length, dest, capacity);
+    }
+
+    utf_result utf32_to_utf8(const char32_t *src, const size_t length, char *dest, const size_t capacity) noexcept
+    {
+        return detail::to_utf8(src, length, dest, capacity);
+    }
+}
@@ -0,0 +1,227 @@
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <catch2.hpp>
+
+#include <basic_string.h>
+
+namespace
+{
+    /**
+     * @brief heap_allocator that counts the live allocations
+     */
+    struct counting_allocator
+    {
+        static inline size_t live = 0;
+
+        static void *allocate(const size_t size) noexcept
+        {
+            live++;
+            return ::operator new(size, std::nothrow);
+        }
+
+        static void deallocate(void *ptr) noexcept
+        {
+            live--;
+            ::operator delete(ptr);
+        }
+    };
+
+    using counted_string = ytl::basic_string<counting_allocator>;
+
+    int sign_of(const int x)
+    {
+        return (x > 0) - (x < 0);
+    }
+
+    /**
+     * @brief Same contents, a terminator behind them, and a capacity that holds them
+     */
+    void check_same(const counted_string &s, const std::string &expected)
+    {
+        REQUIRE(std::string_view(s) == expected);
+        REQUIRE(s.size() == expected.size());
+        REQUIRE(s.c_str()[s.size()] == '\0');
+        REQUIRE(s.capacity() >= s.size());
+        REQUIRE(s.empty() == expected.empty());
+    }
+
+    std::string random_text(std::mt19937_64 &rng, const size_t max_length)
+    {
+        std::string s(rng() % (max_length + 1), 'a');
+        for (char &c: s)
+            c = static_cast<char>('a' + rng() % 4);
+        return s;
+    }
+}
+
+TEST_CASE("basic_string behaves like std::string", "[basic_string]")
+{
+    std::mt19937_64 rng(5);
+    for (size_t round = 0; round < 200; ++round)
+    {
+        counted_string s;
+        std::string expected;
+        for (size_t step = 0; step < 60; ++step)
+        {
+            switch (rng() % 12)
+            {
+                case 0:
+                {
+                    const std::string text = random_text(rng, 40);
+                    s.append(text.data(), text.size());
+                    expected.append(text);
+                    break;
+                }
+                case 1:
+                {
+                    // Appending a piece of itself, which may move the buffer first
+                    const size_t from = expected.empty() ? 0 : rng() % expected.size();
+                    const size_t count = rng() % (expected.size() - from + 1);
+                    s.append(s.data() + from, count);
+                    expected.append(expected, from, count);
+                    break;
+                }
+                case 2:
+                {
+                    // Assigning a piece of itself moves the bytes inside the buffer
+                    const size_t from = expected.empty() ? 0 : rng() % expected.size();
+                    const size_t count = rng() % (expected.size() - from + 1);
+                    s.assign(s.data() + from, count);
+                    expected = expected.substr(from, count);
+                    break;
+                }
+                case 3:
+                {
+                    const char c = static_cast<char>('a' + rng() % 26);
+                    s.push_back(c);
+                    expected.push_back(c);
+                    break;
+                }
+                case 4:
+                    if (!expected.empty())
+                    {
+                        s.pop_back();
+                        expected.pop_back();
+                    }
+                    break;
+                case 5:
+                {
+                    const size_t count = rng() % 80;
+                    s.resize(count, 'r');
+                    expected.resize(count, 'r');
+                    break;
+                }
+                case 6:
+                    s.reserve(rng() % 200);
+                    break;
+                case 7:
+                    s.shrink_to_fit();
+                    break;
+                case 8:
+                {
+                    const size_t count = rng() % 30;
+                    s.append(count, 'n');
+                    expected.append(count, 'n');
+                    break;
+                }
+                case 9:
+                {
+                    counted_string copy = s;
+                    check_same(copy, expected);
+                    s = std::move(copy);
+                    check_same(copy, "");
+                    break;
+                }
+                case 10:
+                {
+                    const std::string text = random_text(rng, 30);
+                    s = text.c_str();
+                    expected = text;
+                    break;
+                }
+                default:
+                    if (rng() % 8 == 0)
+                    {
+                        s.clear();
+                        expected.clear();
+                    }
+                    break;
+            }
+            check_same(s, expected);
+        }
+
+        // Queries and comparisons against a second string
+        const std::string other = random_text(rng, 20);
+        const counted_string ytl_other(other.data(), other.size());
+        CHECK(sign_of(s.compare(ytl_other)) == sign_of(expected.compare(other)));
+        CHECK((s == ytl_other) == (expected == other));
+        CHECK(((s <=> ytl_other) < 0) == (expected < other));
+        CHECK(s.find(ytl_other) == expected.find(other));
+        CHECK(s.find('c') == expected.find('c'));
+        CHECK(s.rfind('c') == expected.rfind('c'));
+        CHECK(s.starts_with(ytl_other) == expected.starts_with(other));
+        CHECK(s.ends_with(ytl_other) == expected.ends_with(other));
+        CHECK(std::string_view(s + ytl_other) == expected + other);
+        const size_t from = rng() % (expected.size() + 1);
+        CHECK(std::string_view(s.substr(from, 5)) == expected.substr(from, 5));
+    }
+    CHECK(counting_allocator::live == 0);
+}
+
+TEST_CASE("basic_string keeps short strings inline", "[basic_string]")
+{
+    counting_allocator::live = 0;
+    {
+        counted_string s(counted_string::SSO_CAPACITY, 'x');
+        CHECK(s.capacity() == counted_string::SSO_CAPACITY);
+        CHECK(counting_allocator::live == 0);
+
+        counted_string copy = s;
+        CHECK(copy == s);
+        CHECK(counting_allocator::live == 0);
+
+        s.push_back('y');
+        CHECK(counting_allocator::live == 1);
+        CHECK(s.capacity() > counted_string::SSO_CAPACITY);
+
+        // Shrinking a short heap string brings it back inline
+        s.resize(4);
+        s.shrink_to_fit();
+        CHECK(counting_allocator::live == 0);
+        CHECK(s == "xxxx");
+        CHECK(s.capacity() == counted_string::SSO_CAPACITY);
+
+        counted_string moved = std::move(copy);
+        CHECK(copy.empty());
+        CHECK(moved.size() == counted_string::SSO_CAPACITY);
+    }
+    CHECK(counting_allocator::live == 0);
+}
+
+TEST_CASE("string_view agrees with std::string_view", "[basic_string]")
+{
+    std::mt19937_64 rng(6);
+    for (size_t round = 0; round < 2000; ++round)
+    {
+        const std::string a = random_text(rng, 40);
+        const std::string b = random_text(rng, 4);
+        const ytl::string_view va(a.data(), a.size());
+        const ytl::string_view vb(b.data(), b.size());
+        const std::string_view sa = a;
+        const std::string_view sb = b;
+
+        const size_t pos = rng() % (a.size() + 2);
+        REQUIRE(va.find(vb, pos) == sa.find(sb, pos));
+        REQUIRE(va.find('b', pos) == sa.find('b', pos));
+        REQUIRE(va.rfind('b', pos) == sa.rfind('b', pos));
+        REQUIRE(sign_of(va.compare(vb)) == sign_of(sa.compare(sb)));
+        REQUIRE(std::string_view(va.substr(pos, 3)) == sa.substr(std::min(pos, a.size()), 3));
+        REQUIRE(ytl::hash(va) == ytl::hash(a.data(), a.size()));
+    }
+}
@@ -0,0 +1,161 @@
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <string>
+#include <string_view>
+
+#include <catch2.hpp>
+
+#include <charconv.h>
+
+namespace
+{
+    /**
+     * @brief Numbers written the ways parsers get wrong: signs, leading zeros,
+     * long digit runs, exponents, special values and trailing junk
+     */
+    std::string random_number(std::mt19937_64 &rng)
+    {
+        constexpr std::string_view PIECES[] = {
+            "-", "+", "0", "00", "1", "9", "12345678901234567890", "18446744073709551615",
+            "18446744073709551616", "9223372036854775808", ".", "5", "e", "E", "e-", "e+",
+            "308", "309", "324", "400", "inf", "infinity", "nan", "x", " "
+        };
+        std::string s;
+        for (size_t pieces = 1 + rng() % 5; pieces; --pieces)
+            s += PIECES[rng() % std::size(PIECES)];
+        return s;
+    }
+
+    template<typename T>
+    T random_value(std::mt19937_64 &rng)
+    {
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            using bits = std::conditional_t<sizeof(T) == 8, uint64_t, uint32_t>;
+            T value;
+            do
+                value = std::bit_cast<T>(static_cast<bits>(rng()));
+            while (std::isnan(value));
+            return value;
+        }
+        else
+        {
+            // Short and long values alike, extremes included
+            const uint64_t raw = rng() >> (rng() % 64);
+            return static_cast<T>(raw);
+        }
+    }
+
+    template<typename T>
+    void check_to_chars(const T value)
+    {
+        char expected[64];
+        char actual[64];
+        const auto e = std::to_chars(expected, expected + sizeof(expected), value);
+        const auto a = ytl::to_chars(actual, actual + sizeof(actual), value);
+        REQUIRE(a.ec == std::errc {});
+        REQUIRE(std::string_view(actual, a.ptr) == std::string_view(expected, e.ptr));
+
+        // One byte short of the output
+        const size_t length = static_cast<size_t>(e.ptr - expected);
+        const auto short_of = ytl::to_chars(actual, actual + length - 1, value);
+        REQUIRE(short_of.ec == std::errc::value_too_large);
+        REQUIRE(short_of.ptr == actual + length - 1);
+    }
+
+    template<typename T>
+    void check_from_chars(const std::string &text)
+    {
+        T expected {};
+        T actual {};
+        const auto e = std::from_chars(text.data(), text.data() + text.size(), expected);
+        const auto a = ytl::from_chars(text.data(), text.data() + text.size(), actual);
+        CAPTURE(text);
+        REQUIRE(a.ec == e.ec);
+        REQUIRE(a.ptr == e.ptr);
+        if (e.ec == std::errc {})
+            REQUIRE(std::memcmp(&actual, &expected, sizeof(T)) == 0);
+        else
+            REQUIRE(actual == T {});
+    }
+}
+
+TEMPLATE_TEST_CASE("integer to_chars and from_chars agree with std", "[charconv]",
+                   int8_t, uint8_t, int16_t, uint16_t, int32_t, uint32_t, int64_t, uint64_t)
+{
+    std::mt19937_64 rng(10);
+    check_to_chars(std::numeric_limits<TestType>::min());
+    check_to_chars(std::numeric_limits<TestType>::max());
+    check_to_chars(TestType { 0 });
+    for (size_t round = 0; round < 5000; ++round)
+    {
+        const TestType value = random_value<TestType>(rng);
+        check_to_chars(value);
+
+        char text[32];
+        const auto written = std::to_chars(text, text + sizeof(text), value);
+        check_from_chars<TestType>(std::string(text, written.ptr));
+        check_from_chars<TestType>(random_number(rng));
+    }
+}
+
+TEMPLATE_TEST_CASE("float to_chars and from_chars agree with std", "[charconv]", double, float)
+{
+    using limits = std::numeric_limits<TestType>;
+    std::mt19937_64 rng(11);
+    for (const TestType value: { TestType { 0 }, -TestType { 0 }, limits::min(), limits::max(), limits::lowest(),
+                                 limits::denorm_min(), limits::epsilon(), limits::infinity(), -limits::infinity(),
+                                 TestType { 1 }, TestType { 0.1 }, TestType { 1e21 }, TestType { 123456789.0 } })
+        check_to_chars(value);
+
+    for (size_t round = 0; round < 20000; ++round)
+    {
+        const auto value = random_value<TestType>(rng);
+        check_to_chars(value);
+
+        // Shortest output parses back to the same bits
+        char text[64];
+        const auto written = std::to_chars(text, text + sizeof(text), value);
+        check_from_chars<TestType>(std::string(text, written.ptr));
+        check_from_chars<TestType>(random_number(rng));
+    }
+
+    // Halfway cases and digit runs longer than the significand
+    for (const char *text: { "9007199254740993", "2.2250738585072011e-308", "4.9406564584124654e-324",
+                             "1.7976931348623158e308", "1.7976931348623159e308", "3.4028235e38", "1e-46",
+                             "0.000000000000000000000000000000000000000000001", "1e400", "-0", "nan", "-inf" })
+        check_from_chars<TestType>(text);
+}
+
+TEST_CASE("from_chars reports errors like std", "[charconv]")
+{
+    int value = 7;
+    const std::string_view empty;
+    auto r = ytl::from_chars(empty.data(), empty.data(), value);
+    CHECK(r.ec == std::errc::invalid_argument);
+    CHECK(value == 7);
+
+    const std::string_view minus = "-";
+    r = ytl::from_chars(minus.data(), minus.data() + minus.size(), value);
+    CHECK(r.ec == std::errc::invalid_argument);
+    CHECK(r.ptr == minus.data());
+
+    unsigned u = 7;
+    const std::string_view negative = "-1";
+    r = ytl::from_chars(negative.data(), negative.data() + negative.size(), u);
+    CHECK(r.ec == std::errc::invalid_argument);
+    CHECK(u == 7);
+
+    // Out of range consumes every digit and leaves the value alone
+    const std::string_view big = "99999999999x";
+    r = ytl::from_chars(big.data(), big.data() + big.size(), value);
+    CHECK(r.ec == std::errc::result_out_of_range);
+    CHECK(r.ptr == big.data() + 11);
+    CHECK(value == 7);
+}
@@ -0,0 +1,301 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+#include <catch2.hpp>
+
+#include <codec.h>
+
+#include "simd_level.h"
+
+namespace
+{
+    std::string random_bytes(std::mt19937_64 &rng, const size_t max_length)
+    {
+        std::string s(rng() % (max_length + 1), '\0');
+        for (char &c: s)
+            c = static_cast<char>(rng());
+        return s;
+    }
+
+    /**
+     * @brief RFC 4648 encoding a group at a time
+     */
+    std::string reference_base64(const std::string &bytes, const bool url, const bool padding)
+    {
+        const char *digits = url ? "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_"
+                                 : "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        std::string out;
+        for (size_t i = 0; i < bytes.size(); i += 3)
+        {
+            const size_t n = std::min<size_t>(3, bytes.size() - i);
+            uint32_t v = 0;
+            for (size_t k = 0; k < 3; ++k)
+                v = v << 8 | (k < n ? static_cast<unsigned char>(bytes[i + k]) : 0);
+            for (size_t k = 0; k <= n; ++k)
+                out += digits[v >> (18 - 6 * k) & 63];
+            if (padding)
+                out.append(3 - n, '=');
+        }
+        return out;
+    }
+
+    std::string reference_hex(const std::string &bytes, const bool upper)
+    {
+        std::string out;
+        char pair[3];
+        for (const char c: bytes)
+        {
+            std::snprintf(pair, sizeof(pair), upper ? "%02X" : "%02x", static_cast<unsigned char>(c));
+            out += pair;
+        }
+        return out;
+    }
+
+    bool unreserved(const char c)
+    {
+        return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '-' || c == '.' ||
+               c == '_' || c == '~';
+    }
+
+    std::string reference_percent(const std::string &bytes)
+    {
+        std::string out;
+        char escape[4];
+        for (const char c: bytes)
+        {
+            if (unreserved(c))
+                out += c;
+            else
+            {
+                std::snprintf(escape, sizeof(escape), "%%%02X", static_cast<unsigned char>(c));
+                out += escape;
+            }
+        }
+        return out;
+    }
+
+    /**
+     * @brief Decode into a buffer with spare room, failing the test on errors
+     */
+    std::string base64_decoded(const std::string &text, const ytl::base64_alphabet alphabet)
+    {
+        std::string out(ytl::base64_decoded_length(text.size()), '\0');
+        const auto r = ytl::base64_decode(text.data(), text.size(), out.data(), alphabet);
+        REQUIRE(r.ec == std::errc {});
+        REQUIRE(r.read == text.size());
+        out.resize(r.written);
+        return out;
+    }
+
+    ytl::decode_result base64_failure(const std::string_view text)
+    {
+        char out[64];
+        return ytl::base64_decode(text.data(), text.size(), out);
+    }
+}
+
+TEST_CASE("base64 round trips and matches RFC 4648", "[codec]")
+{
+    const ytl::simd_level level = GENERATE(from_range(simd_levels()));
+    CAPTURE(level);
+    const simd_scope scope(level);
+
+    std::mt19937_64 rng(18);
+    for (size_t round = 0; round < 3000; ++round)
+    {
+        // Lengths around the vector blocks and well past them
+        const std::string bytes = random_bytes(rng, round % 2 ? 100 : 1000);
+        const bool url = rng() % 2;
+        const bool padding = rng() % 2;
+        const auto alphabet = url ? ytl::base64_alphabet::URL : ytl::base64_alphabet::STANDARD;
+        const std::string expected = reference_base64(bytes, url, padding);
+
+        std::string text(ytl::base64_encoded_length(bytes.size(), padding), '\0');
+        CAPTURE(bytes.size(), url, padding);
+        REQUIRE(text.size() == expected.size());
+        REQUIRE(ytl::base64_encode(bytes.data(), bytes.size(), text.data(), alphabet, padding) == text.size());
+        REQUIRE(text == expected);
+        REQUIRE(base64_decoded(text, alphabet) == bytes);
+    }
+}
+
+TEST_CASE("base64 decoding reports the first bad character", "[codec]")
+{
+    const ytl::simd_level level = GENERATE(from_range(simd_levels()));
+    CAPTURE(level);
+    const simd_scope scope(level);
+
+    std::mt19937_64 rng(19);
+    for (size_t round = 0; round < 3000; ++round)
+    {
+        const std::string bytes = random_bytes(rng, 300);
+        std::string text = reference_base64(bytes, false, rng() % 2);
+        if (text.empty())
+            continue;
+
+        // A character outside the alphabet, or one from the other alphabet
+        const size_t bad = rng() % text.size();
+        constexpr std::string_view STRANGERS("*-_ \n\0\x80\xff", 8);
+        text[bad] = STRANGERS[rng() % STRANGERS.size()];
+
+        std::string out(ytl::base64_decoded_length(text.size()), '\0');
+        const auto r = ytl::base64_decode(text.data(), text.size(), out.data());
+        CAPTURE(text, bad);
+        REQUIRE(r.ec == std::errc::illegal_byte_sequence);
+        REQUIRE(r.read == bad);
+        // Whole groups before the bad one are decoded
+        REQUIRE(r.written == bad / 4 * 3);
+        REQUIRE(out.compare(0, r.written, bytes, 0, r.written) == 0);
+    }
+
+    // Padding and leftover bits
+    CHECK(base64_decoded("QQ", ytl::base64_alphabet::STANDARD) == "A");
+    CHECK(base64_decoded("QUI", ytl::base64_alphabet::STANDARD) == "AB");
+    CHECK(base64_decoded("-_-_", ytl::base64_alphabet::URL) == "\xfb\xff\xbf");
+    CHECK(base64_failure("Q").read == 0);
+    CHECK(base64_failure("QUJDQ").read == 4);
+    CHECK(base64_failure("QR==").read == 1);
+    CHECK(base64_failure("QUJ=").read == 2);
+    CHECK(base64_failure("QQ=").read == 3);
+    CHECK(base64_failure("QQ=A").read == 3);
+    CHECK(base64_failure("Q===").read == 1);
+    CHECK(base64_failure("QQ==QQ==").read == 4);
+    CHECK(base64_failure("QUJD\nQUJD").read == 4);
+    CHECK(base64_failure("QUJD\nQUJD").written == 3);
+}
+
+TEST_CASE("hex round trips and reports the first bad digit", "[codec]")
+{
+    const ytl::simd_level level = GENERATE(from_range(simd_levels()));
+    CAPTURE(level);
+    const simd_scope scope(level);
+
+    std::mt19937_64 rng(20);
+    for (size_t round = 0; round < 3000; ++round)
+    {
+        const std::string bytes = random_bytes(rng, round % 2 ? 70 : 600);
+        const bool upper = rng() % 2;
+        std::string text(2 * bytes.size(), '\0');
+        CAPTURE(bytes.size(), upper);
+        REQUIRE(ytl::hex_encode(bytes.data(), bytes.size(), text.data(), upper) == text.size());
+        REQUIRE(text == reference_hex(bytes, upper));
+
+        // Either case decodes
+        for (char &c: text)
+        {
+            if (rng() % 2)
+                c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        }
+        std::string out(bytes.size(), '\0');
+        auto r = ytl::hex_decode(text.data(), text.size(), out.data());
+        REQUIRE(r.ec == std::errc {});
+        REQUIRE(r.read == text.size());
+        REQUIRE(r.written == bytes.size());
+        REQUIRE(out == bytes);
+        if (text.empty())
+            continue;
+
+        // An odd length fails at the last digit
+        r = ytl::hex_decode(text.data(), text.size() - 1, out.data());
+        REQUIRE(r.ec == std::errc::illegal_byte_sequence);
+        REQUIRE(r.read == text.size() - 2);
+        REQUIRE(r.written == bytes.size() - 1);
+
+        const size_t bad = rng() % text.size();
+        constexpr std::string_view STRANGERS("gG/:@`\0\xff", 8);
+        text[bad] = STRANGERS[rng() % STRANGERS.size()];
+        r = ytl::hex_decode(text.data(), text.size(), out.data());
+        CAPTURE(text, bad);
+        REQUIRE(r.ec == std::errc::illegal_byte_sequence);
+        REQUIRE(r.read == bad);
+        REQUIRE(r.written == bad / 2);
+        REQUIRE(out.compare(0, r.written, bytes, 0, r.written) == 0);
+    }
+}
+
+TEST_CASE("percent encoding escapes all but the unreserved bytes", "[codec]")
+{
+    const ytl::simd_level level = GENERATE(from_range(simd_levels()));
+    CAPTURE(level);
+    const simd_scope scope(level);
+
+    std::mt19937_64 rng(21);
+    for (size_t round = 0; round < 3000; ++round)
+    {
+        // Mostly plain text, so the decoder's runs between escapes get long
+        std::string bytes = random_bytes(rng, 200);
+        for (char &c: bytes)
+        {
+            if (rng() % 4)
+                c = static_cast<char>('a' + rng() % 26);
+        }
+        const std::string expected = reference_percent(bytes);
+
+        std::string text(3 * bytes.size(), '\0');
+        CAPTURE(bytes);
+        REQUIRE(ytl::percent_encoded_length(bytes.data(), bytes.size()) == expected.size());
+        REQUIRE(ytl::percent_encode(bytes.data(), bytes.size(), text.data()) == expected.size());
+        text.resize(expected.size());
+        REQUIRE(text == expected);
+
+        // In place, with lower case escapes
+        for (size_t i = 0; i < text.size(); ++i)
+        {
+            if (text[i] == '%' && rng() % 2)
+            {
+                text[i + 1] = static_cast<char>(std::tolower(static_cast<unsigned char>(text[i + 1])));
+                text[i + 2] = static_cast<char>(std::tolower(static_cast<unsigned char>(text[i + 2])));
+            }
+        }
+        const auto r = ytl::percent_decode(text.data(), text.size(), text.data());
+        REQUIRE(r.ec == std::errc {});
+        REQUIRE(r.read == text.size());
+        REQUIRE(text.substr(0, r.written) == bytes);
+    }
+
+    // A custom set
+    const ytl::char_set spaces(" ");
+    const std::string_view phrase = "a b/c";
+    char out[16];
+    CHECK(ytl::percent_encoded_length(phrase.data(), phrase.size(), spaces) == 7);
+    CHECK(std::string_view(out, ytl::percent_encode(phrase.data(), phrase.size(), out, spaces)) == "a%20b/c");
+}
+
+TEST_CASE("percent decoding stops at a broken escape", "[codec]")
+{
+    const ytl::simd_level level = GENERATE(from_range(simd_levels()));
+    CAPTURE(level);
+    const simd_scope scope(level);
+
+    const auto decode = [](const std::string_view text, const bool plus_as_space = false)
+    {
+        std::string out(text.size(), '\0');
+        const auto r = ytl::percent_decode(text.data(), text.size(), out.data(), plus_as_space);
+        out.resize(r.written);
+        return std::pair(r, out);
+    };
+
+    auto [r, out] = decode("a+b%2Bc", true);
+    CHECK(r.ec == std::errc {});
+    CHECK(out == "a b+c");
+    std::tie(r, out) = decode("a+b");
+    CHECK(out == "a+b");
+
+    // Long plain runs ahead of the failure
+    const std::string run(100, 'x');
+    for (const std::string_view tail: { "%", "%4", "%G1", "%4g", "%%41" })
+    {
+        std::tie(r, out) = decode(run + "%41" + std::string(tail) + "zz", true);
+        CAPTURE(tail);
+        CHECK(r.ec == std::errc::illegal_byte_sequence);
+        CHECK(r.read == run.size() + 3);
+        CHECK(out == run + "A");
+    }
+}
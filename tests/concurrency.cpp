@@ -0,0 +1,724 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <catch2.hpp>
+
+#include <executor.h>
+#include <queue.h>
+#include <strand.h>
+#include <sync.h>
+#include <task.h>
+#include <task_graph.h>
+
+namespace
+{
+    constexpr size_t THREADS = 4;
+
+    /**
+     * @brief Run fn on a worker of ex and block until it returned
+     */
+    template<typename Fn>
+    void run_on(ytl::executor &ex, Fn &&fn)
+    {
+        std::atomic<bool> done { false };
+        ex.submit([&]
+        {
+            fn();
+            ex.complete(done);
+        });
+        ex.wait(done);
+    }
+
+    uint64_t fib(ytl::executor &ex, const unsigned n)
+    {
+        if (n < 2)
+            return n;
+
+        uint64_t left = 0;
+        std::atomic<bool> done { false };
+        ex.submit([&]
+        {
+            left = fib(ex, n - 1);
+            ex.complete(done);
+        });
+        const uint64_t right = fib(ex, n - 2);
+        ex.wait(done);
+        return left + right;
+    }
+
+    /**
+     * @brief Have threads bump a plain counter under lock, lost updates show up in the total
+     */
+    template<typename Lock>
+    uint64_t contend(Lock &lock, const size_t rounds)
+    {
+        uint64_t counter = 0;
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < THREADS; ++t)
+        {
+            threads.emplace_back([&]
+            {
+                for (size_t i = 0; i < rounds; ++i)
+                {
+                    lock.lock();
+                    counter++;
+                    lock.unlock();
+                }
+            });
+        }
+        for (auto &t: threads)
+            t.join();
+        return counter;
+    }
+}
+
+TEST_CASE("executor runs every submitted job", "[executor]")
+{
+    ytl::executor ex(THREADS);
+    REQUIRE(ex.size() == THREADS);
+
+    constexpr size_t JOBS = 10000;
+    std::atomic<size_t> left { JOBS };
+    std::atomic<bool> done { false };
+    for (size_t i = 0; i < JOBS; ++i)
+    {
+        ex.submit([&]
+        {
+            if (left.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                ex.complete(done);
+        });
+    }
+    ex.wait(done);
+    CHECK(left.load() == 0);
+}
+
+TEST_CASE("executor spills jobs the bounded queues have no room for", "[executor]")
+{
+    // One worker, held until everything is queued, so nothing drains the queues meanwhile
+    ytl::executor ex(1);
+    constexpr size_t JOBS = 20000;
+    constexpr size_t URGENT_JOBS = 3000;
+
+    std::vector<int> order;
+    std::atomic<size_t> left { JOBS + URGENT_JOBS };
+    std::atomic<bool> done { false };
+    auto bulk = [&]
+    {
+        order.push_back(0);
+        if (left.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            ex.complete(done);
+    };
+
+    ytl::event release;
+    std::atomic<bool> held { false };
+    bool ran_inline = false;
+    SECTION("from outside the pool")
+    {
+        ex.submit([&]
+        {
+            held = true;
+            release.wait();
+        });
+        for (size_t i = 0; i < JOBS; ++i)
+            ex.submit(bulk);
+    }
+    SECTION("from a worker, without running them inline")
+    {
+        ex.submit([&]
+        {
+            for (size_t i = 0; i < JOBS; ++i)
+                ex.submit(bulk);
+            ran_inline = !order.empty();
+            held = true;
+            release.wait();
+        });
+    }
+    while (!held)
+        std::this_thread::yield();
+
+    // Urgent work submitted last still runs ahead of every queued bulk job
+    for (size_t i = 0; i < URGENT_JOBS; ++i)
+    {
+        ex.submit([&]
+        {
+            order.push_back(1);
+            if (left.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                ex.complete(done);
+        }, ytl::priority::URGENT);
+    }
+    release.set();
+    ex.wait(done);
+
+    CHECK_FALSE(ran_inline);
+    REQUIRE(order.size() == JOBS + URGENT_JOBS);
+    CHECK(std::all_of(order.begin(), order.begin() + URGENT_JOBS, [](const int x) { return x == 1; }));
+    CHECK(std::all_of(order.begin() + URGENT_JOBS, order.end(), [](const int x) { return x == 0; }));
+}
+
+TEST_CASE("executor forks and joins from workers", "[executor]")
+{
+    ytl::executor ex(THREADS);
+    uint64_t value = 0;
+    run_on(ex, [&] { value = fib(ex, 20); });
+    CHECK(value == 6765);
+}
+
+TEST_CASE("executor worker queries", "[executor]")
+{
+    ytl::executor ex(2);
+    CHECK_FALSE(ex.is_worker());
+    CHECK(ex.local_empty());
+    CHECK_FALSE(ex.try_run_one());
+
+    bool worker = false;
+    run_on(ex, [&] { worker = ex.is_worker(); });
+    CHECK(worker);
+    CHECK(ytl::executor::global().size() > 0);
+}
+
+TEST_CASE("named executors are found while alive", "[executor]")
+{
+    CHECK(ytl::executor::find("tests") == nullptr);
+    {
+        ytl::executor::options opts;
+        opts.name = "tests";
+        opts.threads = 1;
+        ytl::executor ex(opts);
+        CHECK(ytl::executor::find("tests").get() == &ex);
+        CHECK(ex.name() == "tests");
+        CHECK(ex.configured());
+    }
+    CHECK(ytl::executor::find("tests") == nullptr);
+}
+
+TEST_CASE("executor waits for the handles find gave out", "[executor]")
+{
+    ytl::executor::options opts;
+    opts.name = "pinned";
+    opts.threads = 1;
+    auto ex = std::make_unique<ytl::executor>(opts);
+    auto handle = ytl::executor::find("pinned");
+    REQUIRE(handle.get() == ex.get());
+
+    std::atomic<bool> destroyed { false };
+    std::thread destroyer([&]
+    {
+        ex.reset();
+        destroyed.store(true);
+    });
+
+    // The pool leaves the registry at once, but stays alive for the handle
+    while (ytl::executor::find("pinned"))
+        std::this_thread::yield();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    CHECK_FALSE(destroyed.load());
+    CHECK(handle->name() == "pinned");
+
+    handle.reset();
+    destroyer.join();
+    CHECK(destroyed.load());
+}
+
+TEST_CASE("executor reports configuration failures from construction on", "[executor]")
+{
+    // No machine running the tests has a cpu 1023, so every worker fails to apply the affinity
+    ytl::executor::options opts;
+    opts.threads = 2;
+    opts.cpus = { 1023 };
+    ytl::executor ex(opts);
+    CHECK_FALSE(ex.configured());
+}
+
+TEST_CASE("posted tasks run concurrently across pools and priorities", "[task]")
+{
+    // Posting skips the serial task lock, so every task below must be running at once
+    ytl::executor bulk(2);
+    ytl::executor urgent(2);
+    constexpr int TASKS = 4;
+    std::atomic<int> running { 0 };
+    std::atomic<int> met { 0 };
+    std::atomic<int> finished { 0 };
+
+    const auto rendezvous = [&]
+    {
+        ++running;
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (running.load() < TASKS && std::chrono::steady_clock::now() < deadline)
+            std::this_thread::yield();
+        met += running.load() == TASKS;
+        ++finished;
+    };
+
+    ytl::task::post(bulk, ytl::priority::NORMAL, rendezvous);
+    ytl::task::post(bulk, ytl::priority::NORMAL, rendezvous);
+    ytl::task::post(urgent, ytl::priority::URGENT, rendezvous);
+    ytl::task::post(urgent, ytl::priority::URGENT, rendezvous);
+    while (finished.load() < TASKS)
+        std::this_thread::yield();
+    CHECK(met.load() == TASKS);
+}
+
+TEST_CASE("task_graph respects edges", "[task_graph]")
+{
+    ytl::executor ex(THREADS);
+    ytl::task_graph graph;
+    std::atomic<int> step { 0 };
+    int a = -1, b = -1, c = -1, d = -1;
+
+    const auto na = graph.emplace([&] { a = step++; });
+    const auto nb = graph.emplace([&] { b = step++; });
+    const auto nc = graph.emplace([&] { c = step++; });
+    const auto nd = graph.emplace([&] { d = step++; });
+    graph.precede(na, nb);
+    graph.precede(na, nc);
+    graph.precede(nb, nd);
+    graph.precede(nc, nd);
+    REQUIRE(graph.size() == 4);
+
+    REQUIRE(graph.run(ex));
+    CHECK(a == 0);
+    CHECK(b > a);
+    CHECK(c > a);
+    CHECK(d == 3);
+}
+
+TEST_CASE("task_graph is reusable across runs", "[task_graph]")
+{
+    ytl::executor ex(THREADS);
+    ytl::task_graph graph;
+    std::atomic<size_t> runs { 0 };
+    std::vector<size_t> order;
+
+    // A chain with a wide fan-out in the middle
+    const auto first = graph.emplace([&] { order.push_back(0); });
+    const auto last = graph.emplace([&] { order.push_back(1); });
+    for (size_t i = 0; i < 32; ++i)
+    {
+        const auto mid = graph.emplace([&] { runs.fetch_add(1, std::memory_order_relaxed); });
+        graph.precede(first, mid);
+        graph.precede(mid, last);
+    }
+
+    for (size_t r = 0; r < 200; ++r)
+        REQUIRE(graph.run(ex));
+    CHECK(runs.load() == 200 * 32);
+    REQUIRE(order.size() == 400);
+    for (size_t i = 0; i < order.size(); ++i)
+        CHECK(order[i] == i % 2);
+
+    SECTION("nodes added between runs are picked up")
+    {
+        size_t extra = 0;
+        graph.precede(last, graph.emplace([&] { extra++; }));
+        REQUIRE(graph.run(ex));
+        REQUIRE(graph.run(ex));
+        CHECK(extra == 2);
+    }
+}
+
+TEST_CASE("task_graph can be destroyed as soon as run returns", "[task_graph]")
+{
+    // The last node finishes on a worker, which must not touch the graph after run may return
+    ytl::executor ex(THREADS);
+    std::atomic<size_t> ran { 0 };
+    const auto build_and_run = [&]
+    {
+        auto graph = std::make_unique<ytl::task_graph>();
+        const auto root = graph->emplace([&] { ran++; });
+        for (size_t i = 0; i < 4; ++i)
+            graph->precede(root, graph->emplace([&] { ran++; }));
+        const bool ok = graph->run(ex);
+        graph.reset();
+        return ok;
+    };
+
+    constexpr size_t ROUNDS = 2000;
+    SECTION("from outside the pool")
+    {
+        for (size_t r = 0; r < ROUNDS; ++r)
+            REQUIRE(build_and_run());
+    }
+    SECTION("from a worker")
+    {
+        bool ok = true;
+        run_on(ex, [&]
+        {
+            for (size_t r = 0; r < ROUNDS; ++r)
+                ok = build_and_run() && ok;
+        });
+        CHECK(ok);
+    }
+    CHECK(ran.load() == ROUNDS * 5);
+}
+
+TEST_CASE("task_graph edge cases", "[task_graph]")
+{
+    ytl::executor ex(2);
+
+    SECTION("empty graph")
+    {
+        ytl::task_graph graph;
+        CHECK(graph.run(ex));
+    }
+
+    SECTION("cycles are rejected without running anything")
+    {
+        ytl::task_graph graph;
+        bool ran = false;
+        const auto a = graph.emplace([&] { ran = true; });
+        const auto b = graph.emplace([&] { ran = true; });
+        graph.precede(a, b);
+        graph.precede(b, a);
+        CHECK_FALSE(graph.run(ex));
+        CHECK_FALSE(ran);
+    }
+
+    SECTION("edges to unknown nodes or back to the same node are refused")
+    {
+        ytl::task_graph graph;
+        bool ran = false;
+        const auto a = graph.emplace([&] { ran = true; });
+        CHECK_THROWS_AS(graph.precede(a, a + 1), std::out_of_range);
+        CHECK_THROWS_AS(graph.precede(7, a), std::out_of_range);
+        CHECK_THROWS_AS(graph.precede(a, a), std::invalid_argument);
+        CHECK(graph.run(ex));
+        CHECK(ran);
+    }
+
+    SECTION("graphs run from a worker")
+    {
+        ytl::task_graph graph;
+        size_t count = 0;
+        graph.emplace([&] { count++; });
+        run_on(ex, [&] { graph.run(ex); });
+        CHECK(count == 1);
+    }
+}
+
+TEST_CASE("locks exclude each other", "[sync]")
+{
+    constexpr size_t ROUNDS = 20000;
+
+    SECTION("ticket_lock")
+    {
+        ytl::ticket_lock lock;
+        CHECK(contend(lock, ROUNDS) == THREADS * ROUNDS);
+        CHECK(lock.stats().acquisitions == THREADS * ROUNDS);
+        CHECK(lock.try_lock());
+        CHECK_FALSE(lock.try_lock());
+        lock.unlock();
+    }
+
+    SECTION("adaptive_mutex")
+    {
+        ytl::adaptive_mutex lock;
+        CHECK(contend(lock, ROUNDS) == THREADS * ROUNDS);
+        CHECK(lock.stats().acquisitions == THREADS * ROUNDS);
+        CHECK(lock.try_lock());
+        CHECK_FALSE(lock.try_lock());
+        lock.unlock();
+    }
+
+    SECTION("mcs_lock")
+    {
+        ytl::mcs_lock lock;
+        uint64_t counter = 0;
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < THREADS; ++t)
+        {
+            threads.emplace_back([&]
+            {
+                for (size_t i = 0; i < ROUNDS; ++i)
+                {
+                    ytl::mcs_lock::scoped guard(lock);
+                    counter++;
+                }
+            });
+        }
+        for (auto &t: threads)
+            t.join();
+        CHECK(counter == THREADS * ROUNDS);
+
+        ytl::mcs_lock::node a, b;
+        CHECK(lock.try_lock(a));
+        CHECK_FALSE(lock.try_lock(b));
+        lock.unlock(a);
+    }
+}
+
+TEST_CASE("event wakes every waiter", "[sync]")
+{
+    ytl::event ev;
+    CHECK_FALSE(ev.is_set());
+
+    std::atomic<size_t> woken { 0 };
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < THREADS; ++t)
+    {
+        threads.emplace_back([&]
+        {
+            ev.wait();
+            woken++;
+        });
+    }
+    ev.set();
+    for (auto &t: threads)
+        t.join();
+    CHECK(woken.load() == THREADS);
+    CHECK(ev.is_set());
+
+    ev.wait();
+    ev.reset();
+    CHECK_FALSE(ev.is_set());
+}
+
+TEST_CASE("latch releases once the count reaches zero", "[sync]")
+{
+    ytl::latch done(THREADS);
+    CHECK_FALSE(done.try_wait());
+
+    std::atomic<size_t> arrived { 0 };
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < THREADS; ++t)
+    {
+        threads.emplace_back([&]
+        {
+            arrived++;
+            done.count_down();
+        });
+    }
+    done.wait();
+    CHECK(arrived.load() == THREADS);
+    CHECK(done.try_wait());
+    for (auto &t: threads)
+        t.join();
+
+    ytl::latch bulk(3);
+    bulk.arrive_and_wait(3);
+    CHECK(bulk.try_wait());
+}
+
+TEST_CASE("barrier separates generations", "[sync]")
+{
+    constexpr size_t PHASES = 100;
+    ytl::barrier sync(THREADS);
+    std::atomic<size_t> arrivals[PHASES] {};
+    std::atomic<bool> ordered { true };
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < THREADS; ++t)
+    {
+        threads.emplace_back([&]
+        {
+            for (size_t p = 0; p < PHASES; ++p)
+            {
+                arrivals[p]++;
+                sync.arrive_and_wait();
+                // Nobody may leave a phase before everyone entered it
+                if (arrivals[p].load() != THREADS)
+                    ordered = false;
+            }
+        });
+    }
+    for (auto &t: threads)
+        t.join();
+    CHECK(ordered.load());
+}
+
+TEST_CASE("seqlock readers never see a torn write", "[sync]")
+{
+    struct pair
+    {
+        uint64_t a;
+        uint64_t b;
+        uint64_t c;
+    };
+
+    ytl::seqlock<pair> value(pair { 0, 0, 0 });
+    std::atomic<bool> stop { false };
+    std::atomic<bool> torn { false };
+
+    std::vector<std::thread> readers;
+    for (size_t t = 0; t < THREADS - 1; ++t)
+    {
+        readers.emplace_back([&]
+        {
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                const pair p = value.load();
+                if (p.b != p.a * 2 || p.c != p.a * 3)
+                    torn = true;
+            }
+        });
+    }
+    for (uint64_t i = 1; i <= 20000; ++i)
+        value.store(pair { i, i * 2, i * 3 });
+    stop = true;
+    for (auto &t: readers)
+        t.join();
+
+    CHECK_FALSE(torn.load());
+    CHECK(value.load().a == 20000);
+}
+
+TEST_CASE("spsc_queue keeps order across threads", "[queue]")
+{
+    ytl::spsc_queue<uint64_t> queue(100);
+    CHECK(queue.capacity() == 128);
+    CHECK(queue.empty());
+
+    constexpr uint64_t COUNT = 200000;
+    std::thread producer([&]
+    {
+        for (uint64_t i = 0; i < COUNT; ++i)
+            queue.push(i);
+    });
+
+    bool ordered = true;
+    for (uint64_t i = 0; i < COUNT; ++i)
+        ordered = ordered && queue.pop() == i;
+    producer.join();
+    CHECK(ordered);
+    CHECK(queue.empty());
+}
+
+TEST_CASE("spsc_queue bounds and batches", "[queue]")
+{
+    ytl::spsc_queue<int> queue(4);
+    for (int i = 0; i < 4; ++i)
+        REQUIRE(queue.try_push(i));
+    CHECK_FALSE(queue.try_push(4));
+    CHECK(queue.size() == 4);
+
+    int out[8];
+    REQUIRE(queue.try_pop_batch(out, 8) == 4);
+    for (int i = 0; i < 4; ++i)
+        CHECK(out[i] == i);
+
+    int in[6] = { 10, 11, 12, 13, 14, 15 };
+    CHECK(queue.try_push_batch(in, 6) == 4);
+    int first = 0;
+    REQUIRE(queue.try_pop(first));
+    CHECK(first == 10);
+}
+
+TEST_CASE("mpmc_queue delivers every element exactly once", "[queue]")
+{
+    ytl::mpmc_queue<uint64_t> queue(64);
+    constexpr uint64_t PER_PRODUCER = 50000;
+    constexpr size_t PRODUCERS = 2;
+    constexpr size_t CONSUMERS = 2;
+
+    std::atomic<uint64_t> sum { 0 };
+    std::atomic<uint64_t> received { 0 };
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < PRODUCERS; ++p)
+    {
+        threads.emplace_back([&, p]
+        {
+            for (uint64_t i = 0; i < PER_PRODUCER; ++i)
+                queue.push(p * PER_PRODUCER + i + 1);
+        });
+    }
+    for (size_t c = 0; c < CONSUMERS; ++c)
+    {
+        threads.emplace_back([&]
+        {
+            while (received.fetch_add(1) < PRODUCERS * PER_PRODUCER)
+                sum += queue.pop();
+        });
+    }
+    for (auto &t: threads)
+        t.join();
+
+    const uint64_t n = PRODUCERS * PER_PRODUCER;
+    CHECK(sum.load() == n * (n + 1) / 2);
+    CHECK(queue.empty());
+}
+
+TEST_CASE("mpmc_queue bounds", "[queue]")
+{
+    ytl::mpmc_queue<int> queue(1);
+    CHECK(queue.capacity() == 2);
+    CHECK(queue.try_push(1));
+    CHECK(queue.try_push(2));
+    CHECK_FALSE(queue.try_push(3));
+
+    int out = 0;
+    REQUIRE(queue.try_pop(out));
+    CHECK(out == 1);
+    REQUIRE(queue.try_pop(out));
+    CHECK(out == 2);
+    CHECK_FALSE(queue.try_pop(out));
+}
+
+TEST_CASE("blocking_wait only wakes parked threads", "[queue]")
+{
+    SECTION("spinning rounds do not register a waiter")
+    {
+        ytl::blocking_wait wait;
+        for (uint32_t round = 0; round < ytl::blocking_wait::SPINS_BEFORE_PARK; ++round)
+        {
+            REQUIRE_FALSE(wait.spin(round));
+            wait.notify();
+        }
+        CHECK(wait.wakeups() == 0);
+        CHECK(wait.spin(ytl::blocking_wait::SPINS_BEFORE_PARK));
+    }
+    SECTION("a parked consumer gets the next push")
+    {
+        ytl::spsc_queue<int, ytl::blocking_wait> queue(4);
+        int value = 0;
+        std::thread consumer([&] { value = queue.pop(); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        queue.push(42);
+        consumer.join();
+        CHECK(value == 42);
+    }
+    SECTION("blocking queues deliver everything in order")
+    {
+        ytl::spsc_queue<uint64_t, ytl::blocking_wait> queue(8);
+        constexpr uint64_t COUNT = 50000;
+        std::thread producer([&]
+        {
+            for (uint64_t i = 0; i < COUNT; ++i)
+                queue.push(i);
+        });
+        bool ordered = true;
+        for (uint64_t i = 0; i < COUNT; ++i)
+            ordered = queue.pop() == i && ordered;
+        producer.join();
+        CHECK(ordered);
+    }
+}
+
+TEST_CASE("strand runs its work one at a time in order", "[strand]")
+{
+    ytl::executor ex(THREADS);
+    std::vector<size_t> order;
+    std::atomic<int> inside { 0 };
+    bool overlapped = false;
+    {
+        ytl::strand s(ex);
+        CHECK(&s.context() == &ex);
+        for (size_t i = 0; i < 5000; ++i)
+        {
+            s.post([&, i]
+            {
+                overlapped = overlapped || inside.fetch_add(1) != 0 || !s.running_in_this_thread();
+                order.push_back(i);
+                inside.fetch_sub(1);
+            });
+        }
+    }
+    CHECK_FALSE(overlapped);
+    REQUIRE(order.size() == 5000);
+    for (size_t i = 0; i < order.size(); ++i)
+        CHECK(order[i] == i);
+}
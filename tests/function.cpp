@@ -0,0 +1,197 @@
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <stdexcept>
+
+#include <catch2.hpp>
+
+#include <function.h>
+
+namespace
+{
+    /**
+     * @brief heap_allocator that counts its calls
+     */
+    struct counting_allocator
+    {
+        static inline size_t allocations = 0;
+        static inline size_t deallocations = 0;
+
+        static void *allocate(const size_t size) noexcept
+        {
+            allocations++;
+            return ::operator new(size, std::nothrow);
+        }
+
+        static void deallocate(void *ptr) noexcept
+        {
+            deallocations++;
+            ::operator delete(ptr);
+        }
+    };
+
+    /**
+     * @brief Callable that tracks how many of its instances are alive
+     */
+    template<size_t Padding>
+    struct tracked
+    {
+        static inline int alive = 0;
+        std::array<char, Padding> padding {};
+        int value;
+
+        explicit tracked(const int value) : value(value) { alive++; }
+
+        tracked(const tracked &other) : value(other.value) { alive++; }
+
+        tracked(tracked &&other) noexcept : value(other.value) { alive++; }
+
+        ~tracked() { alive--; }
+
+        int operator()(const int x) const { return value + x; }
+    };
+
+    /**
+     * @brief Callable whose copy throws, it is too large to be stored inline
+     */
+    struct throwing_copy
+    {
+        std::array<char, 128> padding {};
+
+        throwing_copy() = default;
+
+        throwing_copy(const throwing_copy &) { throw std::runtime_error("copy"); }
+
+        void operator()() const {}
+    };
+
+    struct counter
+    {
+        int value = 0;
+
+        int add(const int x) { return value += x; }
+    };
+
+    using small_fn = ytl::unique_function<int(int), 48, counting_allocator>;
+
+    void reset_counts()
+    {
+        counting_allocator::allocations = 0;
+        counting_allocator::deallocations = 0;
+    }
+}
+
+TEST_CASE("unique_function stores small callables inline", "[function]")
+{
+    reset_counts();
+    {
+        small_fn fn = tracked<8>(1);
+        CHECK(fn(2) == 3);
+        CHECK(tracked<8>::alive == 1);
+    }
+    CHECK(tracked<8>::alive == 0);
+    CHECK(counting_allocator::allocations == 0);
+}
+
+TEST_CASE("unique_function puts large callables on the allocator", "[function]")
+{
+    reset_counts();
+    {
+        small_fn fn = tracked<64>(1);
+        CHECK(fn(2) == 3);
+        CHECK(tracked<64>::alive == 1);
+        CHECK(counting_allocator::allocations == 1);
+
+        // Moving hands over the pointer, the callable itself stays put
+        small_fn moved = std::move(fn);
+        CHECK_FALSE(fn);
+        CHECK(moved(5) == 6);
+        CHECK(tracked<64>::alive == 1);
+        CHECK(counting_allocator::allocations == 1);
+    }
+    CHECK(tracked<64>::alive == 0);
+    CHECK(counting_allocator::deallocations == 1);
+}
+
+TEST_CASE("unique_function releases the allocation when the callable throws", "[function]")
+{
+    reset_counts();
+    const throwing_copy source;
+    CHECK_THROWS_AS((ytl::unique_function<void(), 48, counting_allocator>(source)), std::runtime_error);
+    CHECK(counting_allocator::allocations == 1);
+    CHECK(counting_allocator::deallocations == 1);
+}
+
+TEST_CASE("unique_function moves and destroys its target once", "[function]")
+{
+    {
+        small_fn a = tracked<8>(10);
+        small_fn b = tracked<8>(20);
+        CHECK(tracked<8>::alive == 2);
+
+        a = std::move(b);
+        CHECK(tracked<8>::alive == 1);
+        CHECK(a(0) == 20);
+        CHECK_FALSE(b);
+
+        b = tracked<8>(30);
+        a.swap(b);
+        CHECK(a(0) == 30);
+        CHECK(b(0) == 20);
+        CHECK(tracked<8>::alive == 2);
+
+        a = nullptr;
+        CHECK_FALSE(a);
+        CHECK(tracked<8>::alive == 1);
+    }
+    CHECK(tracked<8>::alive == 0);
+}
+
+TEST_CASE("unique_function empty states", "[function]")
+{
+    ytl::unique_function<int(int)> empty;
+    CHECK_FALSE(empty);
+    CHECK_THROWS_AS(empty(1), std::bad_function_call);
+
+    ytl::unique_function<int(int)> null = nullptr;
+    CHECK_FALSE(null);
+
+    int (*no_function)(int) = nullptr;
+    ytl::unique_function<int(int)> from_null_pointer = no_function;
+    CHECK_FALSE(from_null_pointer);
+
+    int (counter::*no_member)(int) = nullptr;
+    ytl::unique_function<int(counter &, int)> from_null_member = no_member;
+    CHECK_FALSE(from_null_member);
+}
+
+TEST_CASE("unique_function calls through pointers", "[function]")
+{
+    ytl::unique_function<int(int)> fn = +[](const int x) { return x * 2; };
+    CHECK(fn(4) == 8);
+
+    counter c;
+    ytl::unique_function<int(counter &, int)> add = &counter::add;
+    CHECK(add(c, 3) == 3);
+    CHECK(add(c, 4) == 7);
+
+    ytl::unique_function<int(const counter &)> value = &counter::value;
+    CHECK(value(c) == 7);
+
+    // Results are dropped for void signatures
+    ytl::unique_function<void(counter &, int)> discard = &counter::add;
+    discard(c, 1);
+    CHECK(c.value == 8);
+}
+
+TEST_CASE("unique_function holds move-only callables", "[function]")
+{
+    auto owned = std::make_unique<int>(41);
+    ytl::unique_function<int()> fn = [owned = std::move(owned)] { return *owned + 1; };
+    CHECK(fn() == 42);
+
+    ytl::unique_function<int()> other = std::move(fn);
+    CHECK(other() == 42);
+}
@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <vector>
+
+#include <catch2.hpp>
+
+#include <hash.h>
+
+// The stripe kernels are internal, compared here one against another
+#include "../hash/src/stripes.h"
+
+namespace
+{
+    std::vector<unsigned char> random_bytes(std::mt19937_64 &rng, const size_t length)
+    {
+        std::vector<unsigned char> bytes(length);
+        for (auto &b: bytes)
+            b = static_cast<unsigned char>(rng());
+        return bytes;
+    }
+}
+
+TEST_CASE("hasher digests equal the one-shot hash however the input is split", "[hash]")
+{
+    std::mt19937_64 rng(12);
+    const ytl::hash_key key(42);
+    // Lengths across the short path, the stripe buffer and several key blocks
+    for (size_t round = 0; round < 600; ++round)
+    {
+        const size_t length = round < 300 ? round : rng() % 5000;
+        const auto bytes = random_bytes(rng, length);
+        const uint64_t seed = rng() % 3;
+
+        ytl::hasher plain(seed);
+        ytl::hasher keyed(key, seed);
+        for (size_t at = 0; at < length;)
+        {
+            const size_t piece = std::min<size_t>(length - at, rng() % 2 ? rng() % 8 : rng() % 400);
+            plain.update(bytes.data() + at, piece);
+            keyed.update(bytes.data() + at, piece);
+            at += piece;
+        }
+
+        CAPTURE(length);
+        REQUIRE(plain.digest() == ytl::hash(bytes.data(), length, seed));
+        REQUIRE(keyed.digest() == ytl::hash(bytes.data(), length, key, seed));
+        REQUIRE(ytl::hash(bytes.data(), length, ytl::DEFAULT_HASH_KEY, seed) == ytl::hash(bytes.data(), length, seed));
+
+        // reset drops what was streamed so far
+        plain.update(bytes.data(), length);
+        plain.reset();
+        plain.update(bytes.data(), length);
+        REQUIRE(plain.digest() == ytl::hash(bytes.data(), length, seed));
+    }
+}
+
+TEST_CASE("hash separates lengths, seeds, keys and single bit flips", "[hash]")
+{
+    std::set<uint64_t> seen;
+    const std::vector<unsigned char> zeros(2048);
+    for (size_t length = 0; length <= zeros.size(); ++length)
+        seen.insert(ytl::hash(zeros.data(), length));
+    CHECK(seen.size() == zeros.size() + 1);
+
+    std::mt19937_64 rng(13);
+    for (const size_t length: { 8, 17, 64, 255, 300, 1100 })
+    {
+        auto bytes = random_bytes(rng, length);
+        seen.clear();
+        seen.insert(ytl::hash(bytes.data(), length));
+        for (size_t bit = 0; bit < length * 8; ++bit)
+        {
+            bytes[bit / 8] ^= static_cast<unsigned char>(1 << bit % 8);
+            seen.insert(ytl::hash(bytes.data(), length));
+            bytes[bit / 8] ^= static_cast<unsigned char>(1 << bit % 8);
+        }
+        CHECK(seen.size() == length * 8 + 1);
+
+        CHECK(ytl::hash(bytes.data(), length, 1) != ytl::hash(bytes.data(), length, 2));
+        CHECK(ytl::hash(bytes.data(), length, ytl::hash_key(1)) != ytl::hash(bytes.data(), length, ytl::hash_key(2)));
+    }
+}
+
+TEST_CASE("hash keys are deterministic and balanced", "[hash]")
+{
+    constexpr ytl::hash_key a(7);
+    constexpr ytl::hash_key b(7);
+    for (size_t i = 0; i < ytl::hash_key::WORDS; ++i)
+    {
+        CHECK(a.words()[i] == b.words()[i]);
+        CHECK(std::popcount(a.words()[i]) >= 28);
+        CHECK(std::popcount(a.words()[i]) <= 36);
+    }
+
+    const ytl::hash_key r1 = ytl::hash_key::random();
+    const ytl::hash_key r2 = ytl::hash_key::random();
+    CHECK(std::vector(r1.words(), r1.words() + ytl::hash_key::WORDS) !=
+          std::vector(r2.words(), r2.words() + ytl::hash_key::WORDS));
+}
+
+TEST_CASE("stripe kernels agree with the scalar one", "[hash]")
+{
+    using ytl::detail::accumulate_fn;
+    std::vector<accumulate_fn> kernels;
+#ifdef YTL_HASH_X86
+    kernels.push_back(ytl::detail::accumulate_sse2);
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        kernels.push_back(ytl::detail::accumulate_avx2);
+#endif
+#ifdef YTL_HASH_NEON
+    kernels.push_back(ytl::detail::accumulate_neon);
+#endif
+
+    const auto *key = reinterpret_cast<const unsigned char *>(ytl::DEFAULT_HASH_KEY.words());
+    std::mt19937_64 rng(14);
+    for (size_t round = 0; round < 500; ++round)
+    {
+        const size_t count = 1 + rng() % ytl::detail::BLOCK_STRIPES;
+        const auto bytes = random_bytes(rng, count * ytl::detail::STRIPE_BYTES);
+        uint64_t expected[8];
+        for (uint64_t &lane: expected)
+            lane = rng();
+        uint64_t start[8];
+        std::copy(expected, expected + 8, start);
+        ytl::detail::accumulate_scalar(expected, bytes.data(), key, count);
+
+        for (const accumulate_fn kernel: kernels)
+        {
+            uint64_t acc[8];
+            std::copy(start, start + 8, acc);
+            kernel(acc, bytes.data(), key, count);
+            REQUIRE(std::equal(acc, acc + 8, expected));
+        }
+    }
+}
@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <random>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include <catch2.hpp>
+
+#include <multi_searcher.h>
+
+#include "simd_level.h"
+
+namespace
+{
+    using found = std::tuple<uint32_t, size_t, size_t>;
+
+    std::string random_bytes(std::mt19937_64 &rng, const size_t length, const std::string_view alphabet)
+    {
+        std::string s(length, 'a');
+        for (char &c: s)
+            c = alphabet[rng() % alphabet.size()];
+        return s;
+    }
+
+    /**
+     * @brief Every occurrence of every non-empty pattern, sorted
+     */
+    std::vector<found> expected_matches(const std::vector<std::string> &patterns, const std::string &text)
+    {
+        std::vector<found> matches;
+        for (uint32_t p = 0; p < patterns.size(); ++p)
+        {
+            if (patterns[p].empty())
+                continue;
+            for (size_t at = text.find(patterns[p]); at != std::string::npos; at = text.find(patterns[p], at + 1))
+                matches.emplace_back(p, at, patterns[p].size());
+        }
+        std::sort(matches.begin(), matches.end());
+        return matches;
+    }
+
+    std::vector<found> all_matches(const ytl::multi_searcher &search, const std::string &text)
+    {
+        std::vector<found> matches;
+        search.find_all(text.data(), text.size(), [&](const ytl::multi_searcher::match &m)
+        {
+            matches.emplace_back(m.pattern, m.offset, m.length);
+        });
+        std::sort(matches.begin(), matches.end());
+        return matches;
+    }
+}
+
+TEST_CASE("multi_searcher reports every occurrence", "[multi_searcher]")
+{
+    const ytl::simd_level level = GENERATE(from_range(simd_levels()));
+    CAPTURE(level);
+    const simd_scope scope(level);
+
+    // Set sizes on both sides of the Teddy limit, over alphabets that make
+    // patterns share prefixes and suffixes, zeros included
+    const std::string_view alphabet = GENERATE(std::string_view("ab"), std::string_view("abcd\0\xff", 6));
+    std::mt19937_64 rng(4);
+    for (size_t round = 0; round < 300; ++round)
+    {
+        std::vector<std::string> patterns(1 + rng() % 40);
+        for (auto &p: patterns)
+            p = random_bytes(rng, rng() % 7, alphabet);
+        const std::string text = random_bytes(rng, rng() % 500, alphabet);
+
+        const std::vector<std::string_view> views(patterns.begin(), patterns.end());
+        const ytl::multi_searcher search(views);
+        const auto expected = expected_matches(patterns, text);
+
+        CAPTURE(patterns, text);
+        REQUIRE(search.size() == patterns.size());
+        REQUIRE(all_matches(search, text) == expected);
+        REQUIRE(search.contains(text.data(), text.size()) == !expected.empty());
+    }
+}
+
+TEST_CASE("multi_searcher finds rare and frequent patterns in long text", "[multi_searcher]")
+{
+    const ytl::simd_level level = GENERATE(from_range(simd_levels()));
+    CAPTURE(level);
+    const simd_scope scope(level);
+
+    // Rare patterns in a long text stay on the Teddy pass, frequent ones hand over to the automaton
+    std::string text(20000, '.');
+    text.replace(100, 6, "needle");
+    text.replace(19990, 5, "thorn");
+    const std::vector<std::string> rare = { "needle", "thorn", "hay" };
+    const std::vector<std::string_view> rare_views(rare.begin(), rare.end());
+    CHECK(all_matches(ytl::multi_searcher(rare_views), text) == expected_matches(rare, text));
+
+    const std::vector<std::string> frequent = { ".", "..", "needle" };
+    const std::vector<std::string_view> frequent_views(frequent.begin(), frequent.end());
+    CHECK(all_matches(ytl::multi_searcher(frequent_views), text) == expected_matches(frequent, text));
+}
+
+TEST_CASE("multi_searcher stops when the callback returns false", "[multi_searcher]")
+{
+    const ytl::multi_searcher search { "he", "she", "his", "hers" };
+    const std::string text = "ushers and his sheep";
+
+    size_t calls = 0;
+    search.find_all(text.data(), text.size(), [&](const ytl::multi_searcher::match &)
+    {
+        return ++calls < 2;
+    });
+    CHECK(calls == 2);
+
+    // Overlapping matches are all reported: she, he and hers near the start
+    const auto matches = all_matches(search, text);
+    CHECK(std::count_if(matches.begin(), matches.end(), [](const found &m) { return std::get<1>(m) <= 2; }) == 3);
+
+    const ytl::multi_searcher empty { "" };
+    CHECK_FALSE(empty.contains(text.data(), text.size()));
+    CHECK(all_matches(empty, text).empty());
+}
@@ -0,0 +1,231 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <catch2.hpp>
+
+#include <parallel.h>
+
+namespace
+{
+    constexpr size_t THREADS = 4;
+
+    std::vector<uint64_t> random_keys(const size_t n, const uint64_t modulo, const uint64_t seed)
+    {
+        std::mt19937_64 rng(seed);
+        std::vector<uint64_t> v(n);
+        for (uint64_t &x: v)
+            x = modulo ? rng() % modulo : rng();
+        return v;
+    }
+}
+
+TEST_CASE("parallel_for visits every index once", "[parallel]")
+{
+    ytl::executor ex(THREADS);
+    const size_t n = GENERATE(0, 1, 7, 1000, 100000);
+    const size_t grain = GENERATE(0, 1, 64, 1000000);
+
+    std::vector<std::atomic<uint32_t> > hits(n + 2);
+    SECTION("per index")
+    {
+        ytl::parallel_for(ex, 1, n + 1, grain, [&](const size_t i) { hits[i]++; });
+    }
+    SECTION("per sub-range")
+    {
+        ytl::parallel_for(ex, 1, n + 1, grain, [&](const size_t b, const size_t e)
+        {
+            CHECK(b < e);
+            for (size_t i = b; i < e; ++i)
+                hits[i]++;
+        });
+    }
+
+    CHECK(hits[0].load() == 0);
+    CHECK(hits[n + 1].load() == 0);
+    size_t wrong = 0;
+    for (size_t i = 1; i <= n; ++i)
+        wrong += hits[i].load() != 1;
+    CHECK(wrong == 0);
+}
+
+TEST_CASE("parallel_for handles empty and reversed ranges", "[parallel]")
+{
+    ytl::executor ex(2);
+    bool called = false;
+    ytl::parallel_for(ex, 5, 5, 0, [&](size_t) { called = true; });
+    ytl::parallel_for(ex, 6, 5, 1, [&](size_t) { called = true; });
+    CHECK_FALSE(called);
+}
+
+TEST_CASE("parallel_for nests inside workers", "[parallel]")
+{
+    ytl::executor ex(THREADS);
+    std::atomic<size_t> total { 0 };
+    ytl::parallel_for(ex, 0, 64, 1, [&](size_t)
+    {
+        ytl::parallel_for(ex, 0, 1000, 10, [&](const size_t b, const size_t e) { total += e - b; });
+    });
+    CHECK(total.load() == 64 * 1000);
+}
+
+TEST_CASE("parallel_reduce combines in index order", "[parallel]")
+{
+    ytl::executor ex(THREADS);
+    const size_t n = GENERATE(0, 1, 3, 5000);
+    const size_t grain = GENERATE(0, 1, 16, 100000);
+
+    // Concatenation is associative but not commutative, so any reordering shows
+    const auto digits = ytl::parallel_reduce(ex, 0, n, grain, std::vector<uint32_t> {},
+                                             [](const size_t b, const size_t e, std::vector<uint32_t> acc)
+                                             {
+                                                 for (size_t i = b; i < e; ++i)
+                                                     acc.push_back(static_cast<uint32_t>(i));
+                                                 return acc;
+                                             },
+                                             [](std::vector<uint32_t> lhs, const std::vector<uint32_t> &rhs)
+                                             {
+                                                 lhs.insert(lhs.end(), rhs.begin(), rhs.end());
+                                                 return lhs;
+                                             });
+    REQUIRE(digits.size() == n);
+    for (size_t i = 0; i < n; ++i)
+        CHECK(digits[i] == i);
+
+    const uint64_t identity = ytl::parallel_reduce(ex, 3, 3, grain, uint64_t { 42 },
+                                                   [](size_t, size_t, const uint64_t acc) { return acc + 1; },
+                                                   [](const uint64_t a, const uint64_t b) { return a + b; });
+    CHECK(identity == 42);
+}
+
+TEST_CASE("parallel numeric helpers", "[parallel]")
+{
+    ytl::executor ex(THREADS);
+    const size_t n = GENERATE(0, 1, 100, 200000);
+
+    std::vector<uint64_t> v(n);
+    ytl::parallel_fill(v.data(), n, uint64_t { 3 }, ex);
+    CHECK(std::all_of(v.begin(), v.end(), [](const uint64_t x) { return x == 3; }));
+    CHECK(ytl::parallel_accumulate(v.data(), n, uint64_t { 1 }, ex) == 3 * n + 1);
+    CHECK(ytl::parallel_count(v.data(), n, uint64_t { 3 }, ex) == n);
+    CHECK(ytl::parallel_count(v.data(), n, uint64_t { 4 }, ex) == 0);
+
+    for (size_t i = 0; i < n; ++i)
+        v[i] = i;
+    std::vector<uint64_t> copy(n);
+    ytl::parallel_copy(v.data(), copy.data(), n, ex);
+    CHECK(copy == v);
+}
+
+TEST_CASE("parallel_copy falls back on overlap", "[parallel]")
+{
+    ytl::executor ex(THREADS);
+    std::vector<int> v(100000);
+    for (size_t i = 0; i < v.size(); ++i)
+        v[i] = static_cast<int>(i);
+    ytl::parallel_copy(v.data() + 1, v.data(), v.size() - 1, ex);
+    for (size_t i = 0; i + 1 < v.size(); ++i)
+        REQUIRE(v[i] == static_cast<int>(i + 1));
+}
+
+TEST_CASE("parallel_sort matches std::sort", "[parallel][sort]")
+{
+    ytl::executor ex(THREADS);
+    const size_t n = GENERATE(0, 1, 2, 1000, 70000, 300000);
+    const uint64_t modulo = GENERATE(0, 2, 1000);
+
+    auto v = random_keys(n, modulo, n + modulo);
+    auto expected = v;
+    std::sort(expected.begin(), expected.end());
+
+    SECTION("random")
+    {
+        ytl::parallel_sort(v.data(), n, ex);
+        CHECK(v == expected);
+    }
+    SECTION("already sorted")
+    {
+        v = expected;
+        ytl::parallel_sort(v.data(), n, ex);
+        CHECK(v == expected);
+    }
+    SECTION("reversed with a comparator")
+    {
+        ytl::parallel_sort(v.data(), n, ytl::greater(), ex);
+        std::reverse(expected.begin(), expected.end());
+        CHECK(v == expected);
+    }
+}
+
+TEST_CASE("parallel_sort takes non-trivial and move-only elements", "[parallel][sort]")
+{
+    ytl::executor ex(THREADS);
+    const auto keys = random_keys(100000, 5000, 7);
+
+    std::vector<std::string> strings;
+    for (const uint64_t k: keys)
+        strings.push_back(std::to_string(k));
+    auto expected = strings;
+    std::sort(expected.begin(), expected.end());
+    ytl::parallel_sort(strings.data(), strings.size(), ex);
+    CHECK(strings == expected);
+
+    std::vector<std::unique_ptr<uint64_t> > boxes;
+    for (const uint64_t k: keys)
+        boxes.push_back(std::make_unique<uint64_t>(k));
+    const auto by_value = [](const std::unique_ptr<uint64_t> &a, const std::unique_ptr<uint64_t> &b)
+    {
+        return *a < *b;
+    };
+    ytl::parallel_sort(boxes.data(), boxes.size(), by_value, ex);
+    CHECK(std::is_sorted(boxes.begin(), boxes.end(), by_value));
+}
+
+TEST_CASE("parallel_nth_element partitions around the nth element", "[parallel][sort]")
+{
+    ytl::executor ex(THREADS);
+    const size_t n = GENERATE(1, 10, 1000, 70000, 300000);
+    const uint64_t modulo = GENERATE(0, 3);
+
+    const auto input = random_keys(n, modulo, n * 3 + modulo);
+    auto sorted = input;
+    std::sort(sorted.begin(), sorted.end());
+
+    for (const size_t nth: { size_t { 0 }, n / 3, n / 2, n - 1 })
+    {
+        auto v = input;
+        ytl::parallel_nth_element(v.data(), n, nth, ex);
+        REQUIRE(v[nth] == sorted[nth]);
+        CHECK(std::all_of(v.begin(), v.begin() + static_cast<std::ptrdiff_t>(nth),
+                          [&](const uint64_t x) { return x <= v[nth]; }));
+        CHECK(std::all_of(v.begin() + static_cast<std::ptrdiff_t>(nth), v.end(),
+                          [&](const uint64_t x) { return x >= v[nth]; }));
+    }
+
+    auto v = input;
+    ytl::parallel_nth_element(v.data(), n, n, ex);
+    CHECK(v == input);
+}
+
+TEST_CASE("parallel_partial_sort sorts the smallest elements", "[parallel][sort]")
+{
+    ytl::executor ex(THREADS);
+    const size_t n = GENERATE(0, 1, 1000, 200000);
+    const auto input = random_keys(n, 0, 11);
+    auto sorted = input;
+    std::sort(sorted.begin(), sorted.end());
+
+    for (const size_t m: { size_t { 0 }, size_t { 1 }, n / 10, n, n + 5 })
+    {
+        auto v = input;
+        ytl::parallel_partial_sort(v.data(), n, m, ex);
+        const auto k = static_cast<std::ptrdiff_t>(std::min(m, n));
+        CHECK(std::equal(v.begin(), v.begin() + k, sorted.begin()));
+        std::sort(v.begin(), v.end());
+        CHECK(v == sorted);
+    }
+}
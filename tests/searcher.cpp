@@ -0,0 +1,117 @@
+#include <cstring>
+#include <random>
+#include <string>
+#include <string_view>
+
+#include <catch2.hpp>
+
+#include <searcher.h>
+
+#include "simd_level.h"
+
+namespace
+{
+    /**
+     * @brief Bytes over a small alphabet, zeros included, so needles match often
+     */
+    std::string random_bytes(std::mt19937_64 &rng, const size_t length, const char *alphabet)
+    {
+        const size_t size = std::strlen(alphabet) + 1;
+        std::string s(length, 'a');
+        for (char &c: s)
+            c = alphabet[rng() % size];
+        return s;
+    }
+
+    const char *expected_find(const std::string &haystack, const std::string &needle)
+    {
+        const size_t at = std::string_view(haystack).find(needle);
+        return at == std::string_view::npos ? nullptr : haystack.data() + at;
+    }
+}
+
+TEST_CASE("searcher agrees with string_view::find", "[searcher]")
+{
+    const ytl::simd_level level = GENERATE(from_range(simd_levels()));
+    CAPTURE(level);
+    const simd_scope scope(level);
+
+    std::mt19937_64 rng(2);
+    // Needles up to twice the short needle limit, so both the filter and Two-Way run
+    for (size_t round = 0; round < 3000; ++round)
+    {
+        const std::string haystack = random_bytes(rng, rng() % 300, "ab");
+        std::string needle = random_bytes(rng, rng() % 64, "ab");
+        if (rng() % 2 && !haystack.empty())
+        {
+            const size_t from = rng() % haystack.size();
+            needle = haystack.substr(from, rng() % 64);
+        }
+
+        const ytl::searcher search(needle.data(), needle.size());
+        CAPTURE(haystack, needle);
+        REQUIRE(search.size() == needle.size());
+        REQUIRE(search.find(haystack.data(), haystack.size()) == expected_find(haystack, needle));
+    }
+}
+
+TEST_CASE("searcher finds needles in zero terminated strings", "[searcher]")
+{
+    const ytl::simd_level level = GENERATE(from_range(simd_levels()));
+    CAPTURE(level);
+    const simd_scope scope(level);
+
+    std::mt19937_64 rng(3);
+    for (size_t round = 0; round < 2000; ++round)
+    {
+        const std::string haystack = random_bytes(rng, rng() % 200, "abc").c_str();
+        const std::string needle = random_bytes(rng, 1 + rng() % 40, "abc").c_str();
+
+        CAPTURE(haystack, needle);
+        REQUIRE(ytl::searcher(needle.c_str()).find(haystack.c_str()) == std::strstr(haystack.c_str(), needle.c_str()));
+    }
+
+    // Matches straddling the windows a long string is delimited in
+    std::string haystack(100000, 'x');
+    const std::string needle = "needle-straddling-a-window";
+    for (const size_t at: { size_t { 16384 - 5 }, size_t { 3 * 16384 - 20 }, haystack.size() - needle.size() })
+    {
+        std::string text = haystack;
+        text.replace(at, needle.size(), needle);
+        REQUIRE(ytl::searcher(needle.c_str()).find(text.c_str()) == text.c_str() + at);
+    }
+    REQUIRE(ytl::searcher(needle.c_str()).find(haystack.c_str()) == nullptr);
+}
+
+TEST_CASE("searcher handles empty, periodic and adversarial needles", "[searcher]")
+{
+    const char *text = "abc";
+    CHECK(ytl::searcher("").find(text, 3) == text);
+    CHECK(ytl::searcher("").find(text) == text);
+    CHECK(ytl::searcher("c").find(text, 2) == nullptr);
+    CHECK(ytl::searcher("abcd").find(text, 3) == nullptr);
+
+    // Zeros are ordinary bytes in ranges
+    const std::string zeros("a\0b\0c", 5);
+    const std::string needle("b\0c", 3);
+    CHECK(ytl::searcher(needle.data(), needle.size()).find(zeros.data(), zeros.size()) == zeros.data() + 2);
+
+    // Periodic needles make Two-Way reuse the matched prefix of the previous window
+    for (const char *periodic: { "aabaabaabaabaabaabaabaabaabaabaabaabaabaac", "abababababababababababababababababab" })
+    {
+        std::string haystack;
+        for (size_t i = 0; i < 200; ++i)
+            haystack += "aab";
+        haystack += periodic;
+        const std::string p = periodic;
+        CHECK(ytl::searcher(periodic).find(haystack.data(), haystack.size()) == expected_find(haystack, p));
+    }
+
+    // A short needle whose first and last bytes match everywhere falls back to Two-Way
+    const std::string haystack(1 << 18, 'a');
+    const std::string hard = std::string(30, 'a') + "b" + "a";
+    CHECK(ytl::searcher(hard.c_str()).find(haystack.data(), haystack.size()) == nullptr);
+    std::string late = haystack;
+    late.replace(late.size() - hard.size(), hard.size(), hard);
+    CHECK(ytl::searcher(hard.c_str()).find(late.data(), late.size()) == late.data() + late.size() - hard.size());
+}
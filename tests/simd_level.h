@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>
+
+#include <catch2.hpp>
+
+// <string.h> is the libc header in this target, string_view.h brings in the ytl one
+#include <string_view.h>
+
+/**
+ * @brief Instruction sets the CPU and build support, pass to GENERATE to run a
+ * test case once per level
+ */
+inline std::vector<ytl::simd_level> simd_levels()
+{
+    const ytl::simd_level saved = ytl::active_simd();
+    std::vector<ytl::simd_level> levels;
+    for (const ytl::simd_level level: { ytl::simd_level::SCALAR, ytl::simd_level::SSE2, ytl::simd_level::AVX2,
+                                         ytl::simd_level::AVX512, ytl::simd_level::NEON })
+    {
+        if (ytl::select_simd(level))
+            levels.push_back(level);
+    }
+    ytl::select_simd(saved);
+    return levels;
+}
+
+/**
+ * @brief Selects an instruction set for the rest of the scope and restores the
+ * previous one afterwards
+ */
+class simd_scope
+{
+public:
+    explicit simd_scope(const ytl::simd_level level) : saved(ytl::active_simd())
+    {
+        REQUIRE(ytl::select_simd(level));
+    }
+
+    ~simd_scope()
+    {
+        ytl::select_simd(saved);
+    }
+
+    simd_scope(const simd_scope &) = delete;
+
+    simd_scope &operator=(const simd_scope &) = delete;
+
+private:
+    ytl::simd_level saved;
+};
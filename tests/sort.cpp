@@ -0,0 +1,189 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <catch2.hpp>
+
+#include <algorithm.h>
+
+namespace
+{
+    /**
+     * @brief Inputs that take plain quicksorts to their worst case, and random ones
+     */
+    std::vector<int64_t> pattern(const int kind, const size_t n)
+    {
+        std::mt19937_64 rng(static_cast<uint64_t>(kind) * 1000 + n);
+        std::vector<int64_t> v(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            const auto k = static_cast<int64_t>(i);
+            const auto size = static_cast<int64_t>(n);
+            switch (kind)
+            {
+            case 0:
+                v[i] = static_cast<int64_t>(rng());
+                break;
+            case 1:
+                v[i] = static_cast<int64_t>(rng() % 4) - 2;
+                break;
+            case 2:
+                v[i] = k;
+                break;
+            case 3:
+                v[i] = size - k;
+                break;
+            case 4:
+                v[i] = k < size / 2 ? k : size - k;
+                break;
+            default:
+                v[i] = rng() % 100 ? k : static_cast<int64_t>(rng() % n);
+                break;
+            }
+        }
+        return v;
+    }
+
+    template<typename T>
+    std::vector<T> sorted(std::vector<T> v)
+    {
+        std::sort(v.begin(), v.end());
+        return v;
+    }
+}
+
+TEST_CASE("sort matches std::sort", "[sort]")
+{
+    const int kind = GENERATE(range(0, 6));
+    const size_t n = GENERATE(0, 1, 2, 3, 23, 24, 25, 200, 5000, 100000);
+
+    auto v = pattern(kind, n);
+    const auto expected = sorted(v);
+
+    SECTION("default order")
+    {
+        ytl::sort(v.data(), n);
+        CHECK(v == expected);
+    }
+    SECTION("comparator")
+    {
+        ytl::sort(v.data(), n, ytl::greater());
+        CHECK(std::equal(v.begin(), v.end(), expected.rbegin()));
+    }
+}
+
+TEST_CASE("sort orders strings", "[sort]")
+{
+    std::mt19937_64 rng(3);
+    std::vector<std::string> v;
+    for (size_t i = 0; i < 5000; ++i)
+        v.push_back(std::to_string(rng() % 700));
+    const auto expected = sorted(v);
+    ytl::sort(v.data(), v.size());
+    CHECK(v == expected);
+}
+
+TEST_CASE("nth_element and partial_sort", "[sort]")
+{
+    const int kind = GENERATE(range(0, 6));
+    const size_t n = GENERATE(1, 2, 30, 5000, 100000);
+
+    const auto input = pattern(kind, n);
+    const auto expected = sorted(input);
+
+    for (const size_t nth: { size_t { 0 }, n / 4, n / 2, n - 1 })
+    {
+        auto v = input;
+        ytl::nth_element(v.data(), n, nth);
+        REQUIRE(v[nth] == expected[nth]);
+        CHECK(std::all_of(v.begin(), v.begin() + static_cast<std::ptrdiff_t>(nth),
+                          [&](const int64_t x) { return x <= v[nth]; }));
+        CHECK(std::all_of(v.begin() + static_cast<std::ptrdiff_t>(nth), v.end(),
+                          [&](const int64_t x) { return x >= v[nth]; }));
+    }
+
+    for (const size_t m: { size_t { 0 }, size_t { 1 }, n / 3, n })
+    {
+        auto v = input;
+        ytl::partial_sort(v.data(), n, m);
+        CHECK(std::equal(v.begin(), v.begin() + static_cast<std::ptrdiff_t>(m), expected.begin()));
+    }
+}
+
+TEMPLATE_TEST_CASE("radix_sort matches a comparison sort", "[sort][radix]", uint8_t, int16_t, uint32_t, int32_t,
+                   uint64_t, int64_t)
+{
+    const size_t n = GENERATE(0, 1, 100, 5000, 300000);
+    std::mt19937_64 rng(n);
+    std::vector<TestType> v(n);
+    for (auto &x: v)
+        x = static_cast<TestType>(rng());
+    const auto expected = sorted(v);
+
+    auto copy = v;
+    ytl::radix_sort(copy.data(), n);
+    CHECK(copy == expected);
+
+    ytl::radix_sort_in_place(v.data(), n);
+    CHECK(v == expected);
+}
+
+TEMPLATE_TEST_CASE("radix_sort orders floats by sign and magnitude", "[sort][radix]", float, double)
+{
+    const size_t n = GENERATE(0, 5, 5000, 300000);
+    std::mt19937_64 rng(n);
+    std::uniform_real_distribution<TestType> dist(-1e6, 1e6);
+    std::vector<TestType> v(n);
+    for (auto &x: v)
+        x = dist(rng);
+    if (n > 4)
+    {
+        v[0] = std::numeric_limits<TestType>::infinity();
+        v[1] = -std::numeric_limits<TestType>::infinity();
+        v[2] = -0.0;
+        v[3] = 0.0;
+    }
+
+    auto copy = v;
+    ytl::radix_sort(copy.data(), n);
+    CHECK(std::is_sorted(copy.begin(), copy.end()));
+    ytl::radix_sort_in_place(v.data(), n);
+    CHECK(std::is_sorted(v.begin(), v.end()));
+    CHECK(std::equal(v.begin(), v.end(), copy.begin(), [](const TestType a, const TestType b)
+    {
+        return a == b && std::signbit(a) == std::signbit(b);
+    }));
+    if (n > 4)
+    {
+        const auto zero = std::find(copy.begin(), copy.end(), TestType { 0 });
+        CHECK(std::signbit(*zero));
+        CHECK(!std::signbit(zero[1]));
+    }
+}
+
+TEST_CASE("radix_sort with values is stable", "[sort][radix]")
+{
+    const size_t n = GENERATE(0, 1, 100, 5000, 300000);
+    std::mt19937_64 rng(n);
+    std::vector<uint32_t> keys(n);
+    std::vector<uint32_t> values(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        keys[i] = static_cast<uint32_t>(rng() % 1000);
+        values[i] = static_cast<uint32_t>(i);
+    }
+    const auto original = keys;
+
+    ytl::radix_sort(keys.data(), values.data(), n);
+    CHECK(std::is_sorted(keys.begin(), keys.end()));
+    for (size_t i = 0; i < n; ++i)
+    {
+        REQUIRE(original[values[i]] == keys[i]);
+        if (i && keys[i] == keys[i - 1])
+            REQUIRE(values[i] > values[i - 1]);
+    }
+}
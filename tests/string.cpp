@@ -0,0 +1,290 @@
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <strings.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include <catch2.hpp>
+
+#include "simd_level.h"
+
+namespace
+{
+    int sign(const int x)
+    {
+        return (x > 0) - (x < 0);
+    }
+
+    // References for the functions libc lacks
+    const char *reference_strnchr(const char *s, size_t count, const int ch)
+    {
+        for (; count; --count, ++s)
+        {
+            if (*s == static_cast<char>(ch))
+                return s;
+            if (!*s)
+                break;
+        }
+        return nullptr;
+    }
+
+    const char *reference_strnstr(const char *s, const char *needle, const size_t length)
+    {
+        const size_t n = std::strlen(needle);
+        const size_t limit = strnlen(s, length);
+        for (size_t i = 0; i + n <= limit; ++i)
+        {
+            if (!std::memcmp(s + i, needle, n))
+                return s + i;
+        }
+        return nullptr;
+    }
+
+    size_t reference_strlcpy(char *dest, const char *src, const size_t size)
+    {
+        const size_t length = std::strlen(src);
+        if (size)
+        {
+            const size_t n = length < size - 1 ? length : size - 1;
+            std::memcpy(dest, src, n);
+            dest[n] = '\0';
+        }
+        return length;
+    }
+
+    /**
+     * @brief Two pages of which the second one faults, a string ending at the
+     * boundary catches kernels that read past the page holding its terminator
+     */
+    class guarded_page
+    {
+    public:
+        guarded_page() : size(static_cast<size_t>(sysconf(_SC_PAGESIZE)))
+        {
+            void *map = mmap(nullptr, 2 * size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            REQUIRE(map != MAP_FAILED);
+            base = static_cast<char *>(map);
+            REQUIRE(mprotect(base + size, size, PROT_NONE) == 0);
+        }
+
+        ~guarded_page()
+        {
+            munmap(base, 2 * size);
+        }
+
+        guarded_page(const guarded_page &) = delete;
+
+        guarded_page &operator=(const guarded_page &) = delete;
+
+        /**
+         * @brief Copy s with its terminator so that the terminator is the last readable byte
+         */
+        char *place(const std::string &s) const
+        {
+            char *at = base + size - s.size() - 1;
+            std::memcpy(at, s.c_str(), s.size() + 1);
+            return at;
+        }
+
+    private:
+        size_t size;
+        char *base;
+    };
+
+    /**
+     * @brief Strings over a small alphabet, so searches match and compares run long
+     */
+    std::string random_string(std::mt19937_64 &rng, const size_t max_length)
+    {
+        constexpr char ALPHABET[] = "abAB\x80 ";
+        std::string s(rng() % (max_length + 1), 'a');
+        for (char &c: s)
+            c = ALPHABET[rng() % (sizeof(ALPHABET) - 1)];
+        return s;
+    }
+
+    /**
+     * @brief Compare the string.h functions with libc on one pair of strings
+     */
+    void check_string_functions(const char *s1, const char *s2, const int ch, const size_t count)
+    {
+        const size_t len1 = std::strlen(s1);
+        const size_t len2 = std::strlen(s2);
+
+        REQUIRE(ytl::strlen(s1) == len1);
+        REQUIRE(ytl::strnlen(s1, count) == strnlen(s1, count));
+
+        REQUIRE(ytl::strchr(s1, ch) == std::strchr(s1, ch));
+        REQUIRE(ytl::strrchr(s1, ch) == std::strrchr(s1, ch));
+        REQUIRE(ytl::strnchr(s1, count, ch) == reference_strnchr(s1, count, ch));
+        REQUIRE(ytl::strstr(s1, s2) == std::strstr(s1, s2));
+        REQUIRE(ytl::strnstr(s1, s2, count) == reference_strnstr(s1, s2, count));
+
+        REQUIRE(sign(ytl::strcmp(s1, s2)) == sign(std::strcmp(s1, s2)));
+        REQUIRE(sign(ytl::strncmp(s1, s2, count)) == sign(std::strncmp(s1, s2, count)));
+        REQUIRE(sign(ytl::strcasecmp(s1, s2)) == sign(strcasecmp(s1, s2)));
+        REQUIRE(sign(ytl::strncasecmp(s1, s2, count)) == sign(strncasecmp(s1, s2, count)));
+
+        std::vector<char> dest(len1 + len2 + count + 2, 'x');
+        std::vector<char> expected(dest.size(), 'x');
+        REQUIRE(ytl::strcpy(dest.data(), s1) == dest.data());
+        REQUIRE(std::memcmp(dest.data(), s1, len1 + 1) == 0);
+
+        std::fill(dest.begin(), dest.end(), 'x');
+        std::strncpy(expected.data(), s1, count);
+        REQUIRE(ytl::strncpy(dest.data(), s1, count) == dest.data());
+        REQUIRE(dest == expected);
+
+        REQUIRE(ytl::strlcpy(dest.data(), s1, count) == reference_strlcpy(expected.data(), s1, count));
+        REQUIRE(dest == expected);
+
+        std::strcat(std::strcpy(expected.data(), s1), s2);
+        std::strcpy(dest.data(), s1);
+        REQUIRE(ytl::strcat(dest.data(), s2) == dest.data());
+        REQUIRE(dest == expected);
+
+        std::strncat(std::strcpy(expected.data(), s1), s2, count);
+        std::strcpy(dest.data(), s1);
+        REQUIRE(ytl::strncat(dest.data(), s2, count) == dest.data());
+        REQUIRE(dest == expected);
+
+        // strlcat appends what fits in size bytes, and reports the length it tried to create
+        std::strcpy(dest.data(), s1);
+        const size_t size = count;
+        const size_t full = size > len1 ? len1 + len2 : size + len2;
+        REQUIRE(ytl::strlcat(dest.data(), s2, size) == full);
+        if (size > len1)
+        {
+            const size_t kept = std::min(len2, size - len1 - 1);
+            REQUIRE(std::strlen(dest.data()) == len1 + kept);
+            REQUIRE(std::memcmp(dest.data() + len1, s2, kept) == 0);
+        }
+    }
+}
+
+TEST_CASE("string.h functions agree with libc", "[string]")
+{
+    const ytl::simd_level level = GENERATE(from_range(simd_levels()));
+    CAPTURE(level);
+    const simd_scope scope(level);
+    std::mt19937_64 rng(1);
+    for (size_t round = 0; round < 2000; ++round)
+    {
+        const std::string a = random_string(rng, 80);
+        std::string b = random_string(rng, 12);
+        // Half the time the second string is a piece of the first
+        if (rng() % 2 && !a.empty())
+        {
+            const size_t from = rng() % a.size();
+            b = a.substr(from, rng() % (a.size() - from + 1));
+        }
+        const int ch = "abA\x80z"[rng() % 5];
+        const size_t count = rng() % (a.size() + 3);
+        check_string_functions(a.c_str(), b.c_str(), ch, count);
+    }
+
+    check_string_functions("", "", 0, 0);
+    check_string_functions("abc", "", 'c', 10);
+    check_string_functions("", "abc", 0, 1);
+}
+
+TEST_CASE("scanning kernels stop at the page holding the terminator", "[string]")
+{
+    const ytl::simd_level level = GENERATE(from_range(simd_levels()));
+    CAPTURE(level);
+    const simd_scope scope(level);
+    const guarded_page page1;
+    const guarded_page page2;
+
+    // Every length up to a few vectors, so the start takes every alignment
+    for (size_t length = 0; length < 200; ++length)
+    {
+        std::string text(length, 'a');
+        for (size_t i = 0; i < length; ++i)
+            text[i] = static_cast<char>('a' + i % 23);
+
+        const char *s = page1.place(text);
+        char *copy = page2.place(text);
+        REQUIRE(ytl::strlen(s) == length);
+        REQUIRE(ytl::strchr(s, 0) == s + length);
+        REQUIRE(ytl::strchr(s, 'z') == nullptr);
+        REQUIRE(ytl::strrchr(s, 'a') == std::strrchr(s, 'a'));
+        REQUIRE(ytl::strnchr(s, length + 64, 'z') == nullptr);
+        REQUIRE(ytl::strcmp(s, copy) == 0);
+        if (length)
+        {
+            REQUIRE(ytl::strchr(s, text.back()) == std::strchr(s, text.back()));
+            copy[length - 1] = 'z';
+            REQUIRE(ytl::strcmp(s, copy) < 0);
+            REQUIRE(ytl::strcmp(copy, s) > 0);
+        }
+    }
+}
+
+TEST_CASE("case conversion and memcasecmp agree with the scalar rules", "[string]")
+{
+    const ytl::simd_level level = GENERATE(from_range(simd_levels()));
+    CAPTURE(level);
+    const simd_scope scope(level);
+
+    // The bytes around both letter ranges, high bytes and zeros
+    constexpr char BYTES[] = "@AZ[`az{\x80\xc1\xff";
+    std::mt19937_64 rng(7);
+    for (size_t round = 0; round < 3000; ++round)
+    {
+        const size_t length = rng() % 200;
+        const size_t offset = rng() % 64;
+        std::string buffer(offset + length, '\0');
+        for (char &c: buffer)
+            c = BYTES[rng() % sizeof(BYTES)];
+        const char *src = buffer.data() + offset;
+
+        std::string lower(length, '\0');
+        std::string upper(length, '\0');
+        for (size_t i = 0; i < length; ++i)
+        {
+            lower[i] = ytl::to_lower(src[i]);
+            upper[i] = ytl::to_upper(src[i]);
+        }
+
+        std::string dest(length, '\0');
+        ytl::to_lower(dest.data(), src, length);
+        REQUIRE(dest == lower);
+        ytl::to_upper(dest.data(), src, length);
+        REQUIRE(dest == upper);
+
+        std::string in_place(src, length);
+        ytl::to_lower(in_place.data(), length);
+        REQUIRE(in_place == lower);
+        ytl::to_upper(in_place.data(), length);
+        REQUIRE(in_place == upper);
+
+        // Strings differing in case only compare equal and hash alike
+        REQUIRE(ytl::memcasecmp(lower.data(), upper.data(), length) == 0);
+        REQUIRE(ytl::casehash(lower.data(), length) == ytl::casehash(upper.data(), length));
+        REQUIRE(ytl::casehash(src, length, 9) == ytl::hash(lower.data(), length, 9));
+
+        if (length)
+        {
+            const size_t at = rng() % length;
+            std::string other = upper;
+            other[at] = BYTES[rng() % sizeof(BYTES)];
+            const int expected = static_cast<unsigned char>(lower[at]) -
+                                 static_cast<unsigned char>(ytl::to_lower(other[at]));
+            REQUIRE(sign(ytl::memcasecmp(lower.data(), other.data(), length)) == sign(expected));
+        }
+    }
+}
+
+TEST_CASE("strnlen and the compares work at compile time", "[string]")
+{
+    STATIC_REQUIRE(ytl::strnlen("abc", 10) == 3);
+    STATIC_REQUIRE(ytl::strnlen("abc", 2) == 2);
+    STATIC_REQUIRE(ytl::strncmp("abc", "abd", 2) == 0);
+    STATIC_REQUIRE(ytl::strncmp("abc", "abd", 3) < 0);
+    STATIC_REQUIRE(ytl::strcasecmp("HeLLo", "hello") == 0);
+}
@@ -0,0 +1,244 @@
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <new>
+#include <random>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <sys/uio.h>
+
+#include <catch2.hpp>
+
+#include <string_builder.h>
+
+namespace
+{
+    /**
+     * @brief heap_allocator that counts the live allocations
+     */
+    struct counting_allocator
+    {
+        static inline size_t live = 0;
+
+        static void *allocate(const size_t size) noexcept
+        {
+            live++;
+            return ::operator new(size, std::nothrow);
+        }
+
+        static void deallocate(void *ptr) noexcept
+        {
+            live--;
+            ::operator delete(ptr);
+        }
+    };
+
+    using counted_builder = ytl::basic_string_builder<counting_allocator>;
+
+    std::string chunks_of(const counted_builder &builder)
+    {
+        std::string joined;
+        builder.for_each([&](const ytl::string_view s)
+        {
+            REQUIRE(!s.empty());
+            joined.append(s.data(), s.size());
+        });
+        return joined;
+    }
+
+    /**
+     * @brief Every way out of the builder yields the same bytes
+     */
+    void check_same(const counted_builder &builder, const std::string &expected)
+    {
+        REQUIRE(builder.size() == expected.size());
+        REQUIRE(builder.empty() == expected.empty());
+        REQUIRE(chunks_of(builder) == expected);
+        REQUIRE(std::string_view(builder.str()) == expected);
+
+        std::string copy(expected.size() + 1, '\0');
+        REQUIRE(builder.copy_to(copy.data()) == copy.data() + expected.size());
+        REQUIRE(copy.substr(0, expected.size()) == expected);
+    }
+
+    /**
+     * @brief Concatenate the first count entries of the scatter list from offset on
+     */
+    template<typename Entry>
+    std::string gathered(const counted_builder &builder, const size_t offset, const size_t count)
+    {
+        std::vector<Entry> entries(count);
+        const size_t filled = builder.gather(entries.data(), count, offset);
+        REQUIRE(filled <= count);
+        std::string joined;
+        for (size_t i = 0; i < filled; ++i)
+        {
+            if constexpr (std::is_same_v<Entry, iovec>)
+                joined.append(static_cast<const char *>(entries[i].iov_base), entries[i].iov_len);
+            else
+                joined.append(entries[i].data(), entries[i].size());
+        }
+        return joined;
+    }
+}
+
+TEST_CASE("string_builder agrees with std::string", "[string_builder]")
+{
+    std::mt19937_64 rng(17);
+    for (size_t round = 0; round < 300; ++round)
+    {
+        {
+            counted_builder builder;
+            std::string expected;
+            // Referenced ranges must outlive the builder
+            std::deque<std::string> referenced;
+
+            for (size_t op = 0; op < 60; ++op)
+            {
+                const size_t length = rng() % 4 ? rng() % 64 : rng() % 5000;
+                std::string text(length, '\0');
+                for (char &c: text)
+                    c = static_cast<char>('a' + rng() % 26);
+
+                switch (rng() % 9)
+                {
+                    case 0:
+                        builder.append(text.data(), text.size());
+                        expected += text;
+                        break;
+                    case 1:
+                        builder.append(length, '#');
+                        expected.append(length, '#');
+                        break;
+                    case 2:
+                    {
+                        const auto &stored = referenced.emplace_back(text);
+                        builder.append_reference(ytl::string_view(stored.data(), stored.size()));
+                        expected += stored;
+                        break;
+                    }
+                    case 3:
+                        builder.push_back('!');
+                        builder += "?";
+                        expected += "!?";
+                        break;
+                    case 4:
+                    {
+                        // Ask for more than gets written, only the committed bytes count
+                        char *room = builder.prepare(length + 16);
+                        for (size_t i = 0; i < length + 16; ++i)
+                            room[i] = 'z';
+                        std::copy(text.begin(), text.end(), room);
+                        builder.commit(length);
+                        expected += text;
+                        break;
+                    }
+                    case 5:
+                    {
+                        const size_t n = expected.empty() ? 0 : rng() % (expected.size() + 1);
+                        builder.consume(n);
+                        expected.erase(0, n);
+                        break;
+                    }
+                    case 6:
+                    {
+                        const ytl::string_view flat = builder.flatten();
+                        REQUIRE(std::string_view(flat) == expected);
+                        break;
+                    }
+                    case 7:
+                        if (rng() % 4 == 0)
+                        {
+                            builder.clear();
+                            expected.clear();
+                        }
+                        break;
+                    default:
+                    {
+                        const size_t offset = rng() % (expected.size() + 1);
+                        const size_t count = 1 + rng() % 8;
+                        const std::string by_view = gathered<ytl::string_view>(builder, offset, count);
+                        const std::string by_iovec = gathered<iovec>(builder, offset, count);
+                        REQUIRE(by_view == by_iovec);
+                        REQUIRE(std::string_view(expected).substr(offset).starts_with(by_view));
+                        REQUIRE(gathered<ytl::string_view>(builder, offset, 1000) == expected.substr(offset));
+                        break;
+                    }
+                }
+                CAPTURE(round, op);
+                check_same(builder, expected);
+            }
+
+            // Moves hand the chain over whole
+            counted_builder moved(std::move(builder));
+            check_same(moved, expected);
+            check_same(builder, "");
+            builder = std::move(moved);
+            check_same(builder, expected);
+        }
+        REQUIRE(counting_allocator::live == 0);
+    }
+}
+
+TEST_CASE("string_builder never moves what was written", "[string_builder]")
+{
+    counted_builder builder;
+    builder.append("first", 5);
+    const char *first = nullptr;
+    builder.for_each([&](const ytl::string_view s) { first = s.data(); });
+
+    for (size_t i = 0; i < 2000; ++i)
+        builder.append("0123456789abcdefghijklmnopqrstuvwxyz", 36);
+    char *room = builder.prepare(10);
+    builder.commit(0);
+    builder.append("x", 1);
+    CHECK(room[0] == 'x');
+
+    const char *still = nullptr;
+    builder.for_each([&](const ytl::string_view s)
+    {
+        if (!still)
+            still = s.data();
+    });
+    CHECK(still == first);
+    CHECK(std::string_view(first, 5) == "first");
+}
+
+TEST_CASE("string_builder consume follows a partial write", "[string_builder]")
+{
+    counted_builder builder;
+    std::string expected;
+    const std::string big(3000, 'b');
+    builder.append("head ", 5);
+    builder.append_reference(ytl::string_view(big.data(), big.size()));
+    builder.append(" tail", 5);
+    expected = "head " + big + " tail";
+
+    // A writev that manages a few bytes at a time
+    std::string written;
+    for (size_t step = 7; !builder.empty(); step = step * 3 % 1009 + 1)
+    {
+        iovec entries[4];
+        const size_t filled = builder.gather(entries, 4);
+        REQUIRE(filled > 0);
+        size_t n = 0;
+        for (size_t i = 0; i < filled && n < step; ++i)
+        {
+            const size_t take = std::min(step - n, entries[i].iov_len);
+            written.append(static_cast<const char *>(entries[i].iov_base), take);
+            n += take;
+        }
+        builder.consume(n);
+        check_same(builder, expected.substr(written.size()));
+    }
+    CHECK(written == expected);
+
+    // The writable chunk left over takes new appends from its start
+    builder.append("again", 5);
+    check_same(builder, "again");
+    builder.clear();
+    check_same(builder, "");
+}
@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <set>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <catch2.hpp>
+
+#include <string_interner.h>
+
+namespace
+{
+    std::vector<std::string> numbered(const size_t count)
+    {
+        std::vector<std::string> strings;
+        strings.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+            strings.push_back("symbol-" + std::to_string(i * 7919 % count) + std::string(i % 50, 'x'));
+        return strings;
+    }
+
+    ytl::string_view view_of(const std::string &s)
+    {
+        return { s.data(), s.size() };
+    }
+}
+
+TEST_CASE("string_interner stores each string once", "[string_interner]")
+{
+    ytl::string_interner interner;
+    CHECK(interner.size() == 0);
+    CHECK(interner.find("absent").id == ytl::string_interner::NONE);
+    CHECK_FALSE(interner.contains("absent"));
+
+    const auto a = interner.intern("alpha");
+    const auto b = interner.intern("beta");
+    const auto empty = interner.intern("");
+    const std::string zeros("a\0b", 3);
+    const auto z = interner.intern(view_of(zeros));
+
+    CHECK(a.id == 0);
+    CHECK(b.id == 1);
+    CHECK(empty.id == 2);
+    CHECK(z.id == 3);
+    CHECK(interner.intern("alpha") == a);
+    CHECK(interner.find("beta") == b);
+    CHECK(interner.find(ytl::string_view(zeros.data(), 1)).id == ytl::string_interner::NONE);
+    CHECK(interner.size() == 4);
+
+    CHECK(std::string_view(interner.view(a)) == "alpha");
+    CHECK(std::string_view(interner.view(empty)).empty());
+    CHECK(std::string_view(interner.view(z)) == zeros);
+    CHECK(std::string_view(interner.c_str(b)) == "beta");
+    CHECK(interner.c_str(z)[3] == '\0');
+    CHECK(interner.memory_usage() > 0);
+}
+
+TEST_CASE("string_interner views stay put while it grows", "[string_interner]")
+{
+    ytl::string_interner interner;
+    const auto first = interner.intern("first");
+    const char *bytes = interner.c_str(first);
+
+    const auto strings = numbered(100000);
+    for (const auto &s: strings)
+        interner.intern(view_of(s));
+
+    CHECK(interner.c_str(first) == bytes);
+    CHECK(std::string_view(bytes) == "first");
+    for (size_t i = 0; i < strings.size(); i += 997)
+    {
+        const auto symbol = interner.find(view_of(strings[i]));
+        REQUIRE(symbol.id != ytl::string_interner::NONE);
+        REQUIRE(std::string_view(interner.view(symbol)) == strings[i]);
+    }
+}
+
+TEST_CASE("string_interner hands every thread the same symbols", "[string_interner]")
+{
+    constexpr size_t THREADS = 4;
+    const auto strings = numbered(20000);
+    ytl::string_interner interner;
+
+    // Each writer interns every string in its own order, a reader looks them up meanwhile
+    std::vector<std::vector<ytl::string_interner::symbol> > symbols(THREADS);
+    std::atomic<bool> writing { true };
+    size_t torn = 0;
+    std::thread reader([&]
+    {
+        for (size_t i = 0; writing.load(std::memory_order_acquire); i = (i + 1) % strings.size())
+        {
+            const auto symbol = interner.find(view_of(strings[i]));
+            if (symbol.id == ytl::string_interner::NONE)
+                continue;
+            if (symbol.id >= interner.size() || std::string_view(interner.view(symbol)) != strings[i])
+                torn++;
+        }
+    });
+
+    std::vector<std::thread> writers;
+    for (size_t t = 0; t < THREADS; ++t)
+    {
+        writers.emplace_back([&, t]
+        {
+            std::vector<size_t> order(strings.size());
+            for (size_t i = 0; i < order.size(); ++i)
+                order[i] = i;
+            std::shuffle(order.begin(), order.end(), std::mt19937_64(t));
+
+            symbols[t].resize(strings.size());
+            for (const size_t i: order)
+                symbols[t][i] = interner.intern(view_of(strings[i]));
+        });
+    }
+    for (auto &writer: writers)
+        writer.join();
+    writing.store(false, std::memory_order_release);
+    reader.join();
+
+    CHECK(torn == 0);
+    CHECK(interner.size() == strings.size());
+
+    std::set<uint32_t> ids;
+    for (size_t i = 0; i < strings.size(); ++i)
+    {
+        for (size_t t = 1; t < THREADS; ++t)
+            REQUIRE(symbols[t][i] == symbols[0][i]);
+        REQUIRE(std::string_view(interner.view(symbols[0][i])) == strings[i]);
+        ids.insert(symbols[0][i].id);
+    }
+    // Dense ids
+    CHECK(ids.size() == strings.size());
+    CHECK(*ids.rbegin() == strings.size() - 1);
+}
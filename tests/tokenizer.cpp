@@ -0,0 +1,135 @@
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <catch2.hpp>
+
+#include <tokenizer.h>
+
+#include "simd_level.h"
+
+namespace
+{
+    /**
+     * @brief Pieces between delimiters, empty ones unless skipped
+     */
+    std::vector<std::string_view> reference_split(const std::string_view text, const std::string &delimiters,
+                                                  const bool skip_empty)
+    {
+        std::vector<std::string_view> pieces;
+        if (text.empty())
+            return pieces;
+        size_t begin = 0;
+        for (size_t i = 0; i <= text.size(); ++i)
+        {
+            if (i == text.size() || delimiters.find(text[i]) != std::string::npos)
+            {
+                if (!skip_empty || i > begin)
+                    pieces.push_back(text.substr(begin, i - begin));
+                begin = i + 1;
+            }
+        }
+        return pieces;
+    }
+
+    template<typename Range>
+    std::vector<std::string_view> collect(Range &&range)
+    {
+        std::vector<std::string_view> pieces;
+        for (const ytl::string_view piece: range)
+            pieces.emplace_back(piece);
+        return pieces;
+    }
+
+    /**
+     * @brief Same pieces, each a view into the text rather than a copy
+     */
+    bool same_views(const std::vector<std::string_view> &a, const std::vector<std::string_view> &b)
+    {
+        if (a.size() != b.size())
+            return false;
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            if (a[i].size() != b[i].size() || (!a[i].empty() && a[i].data() != b[i].data()))
+                return false;
+        }
+        return true;
+    }
+}
+
+TEST_CASE("char_set finds and skips its members", "[tokenizer]")
+{
+    const ytl::simd_level level = GENERATE(from_range(simd_levels()));
+    CAPTURE(level);
+    const simd_scope scope(level);
+
+    std::mt19937_64 rng(8);
+    for (size_t round = 0; round < 2000; ++round)
+    {
+        // Up to 40 members, so sets spanning more than 8 high nibbles share buckets
+        std::string members(rng() % 40, '\0');
+        for (char &c: members)
+            c = static_cast<char>(rng());
+        const ytl::char_set set(ytl::string_view(members.data(), members.size()));
+
+        std::string text(rng() % 300, '\0');
+        for (char &c: text)
+            c = rng() % 4 == 0 && !members.empty() ? members[rng() % members.size()] : static_cast<char>(rng());
+
+        const size_t first = text.find_first_of(members);
+        const size_t first_other = text.find_first_not_of(members);
+        CAPTURE(members, text);
+        REQUIRE(set.find(text.data(), text.size()) == (first == std::string::npos ? nullptr : text.data() + first));
+        REQUIRE(set.skip(text.data(), text.size()) ==
+                text.data() + (first_other == std::string::npos ? text.size() : first_other));
+        for (int b = 0; b < 256; ++b)
+            REQUIRE(set.contains(static_cast<char>(b)) == (members.find(static_cast<char>(b)) != std::string::npos));
+    }
+}
+
+TEST_CASE("tokenizer yields views of the pieces between delimiters", "[tokenizer]")
+{
+    const ytl::simd_level level = GENERATE(from_range(simd_levels()));
+    CAPTURE(level);
+    const simd_scope scope(level);
+
+    const std::string delimiters = GENERATE(std::string(" ,"), std::string("\t\n;\xe2"));
+    const ytl::char_set set(ytl::string_view(delimiters.data(), delimiters.size()));
+    const std::string alphabet = "ab" + delimiters;
+
+    std::mt19937_64 rng(9);
+    for (size_t round = 0; round < 2000; ++round)
+    {
+        std::string text(rng() % 120, 'a');
+        for (char &c: text)
+            c = alphabet[rng() % alphabet.size()];
+        const ytl::string_view view(text.data(), text.size());
+
+        CAPTURE(text);
+        REQUIRE(same_views(collect(ytl::tokenizer(view, set)), reference_split(text, delimiters, true)));
+        REQUIRE(same_views(collect(ytl::tokenizer(view, set, false)), reference_split(text, delimiters, false)));
+    }
+
+    // The unconsumed rest follows the last token
+    const ytl::char_set spaces(" ");
+    ytl::tokenizer words("one two three", spaces);
+    ytl::string_view token;
+    REQUIRE(words.next(token));
+    CHECK(token == "one");
+    CHECK(words.rest() == "two three");
+}
+
+TEST_CASE("split_lines drops the terminators", "[tokenizer]")
+{
+    const auto lines = [](const char *text)
+    {
+        return collect(ytl::split_lines(text));
+    };
+
+    CHECK(lines("").empty());
+    CHECK(lines("one") == std::vector<std::string_view> { "one" });
+    CHECK(lines("one\ntwo\r\n\nthree\r\n") == std::vector<std::string_view> { "one", "two", "", "three" });
+    CHECK(lines("\n\r\n") == std::vector<std::string_view> { "", "" });
+    CHECK(lines("cr\ronly") == std::vector<std::string_view> { "cr\ronly" });
+}
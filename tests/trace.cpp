@@ -0,0 +1,168 @@
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <latch>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2.hpp>
+
+#include <trace.h>
+
+namespace
+{
+    struct chrome_event
+    {
+        std::string ph;
+        uint32_t tid;
+        uint64_t id;
+    };
+
+    /**
+     * @brief Value of a numeric field of one exported event
+     */
+    uint64_t field(const std::string &line, const std::string &key)
+    {
+        const size_t at = line.find("\"" + key + "\":");
+        REQUIRE(at != std::string::npos);
+        return std::stoull(line.substr(at + key.size() + 3));
+    }
+
+    /**
+     * @brief Export the trace and check its JSON layout, one event per line
+     */
+    std::vector<chrome_event> export_events()
+    {
+        const char *path = "ytd_trace_test.json";
+        REQUIRE(ytl::trace::export_chrome(path));
+
+        std::ifstream file(path);
+        std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        file.close();
+        std::remove(path);
+
+        std::vector<std::string> lines;
+        std::istringstream stream(text);
+        for (std::string line; std::getline(stream, line);)
+            lines.push_back(line);
+        REQUIRE(lines.size() >= 2);
+        REQUIRE(lines.front() == "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+        REQUIRE(lines.back() == "]}");
+
+        std::vector<chrome_event> events;
+        for (size_t i = 1; i + 1 < lines.size(); ++i)
+        {
+            std::string &line = lines[i];
+            // Every event but the last is followed by a comma
+            REQUIRE((line.back() == ',') == (i + 2 < lines.size()));
+            if (line.back() == ',')
+                line.pop_back();
+            REQUIRE(line.front() == '{');
+            REQUIRE(line.back() == '}');
+
+            const size_t ph = line.find("\"ph\":\"");
+            REQUIRE(ph != std::string::npos);
+            events.push_back({ line.substr(ph + 6, 1), static_cast<uint32_t>(field(line, "tid")), field(line, "id") });
+        }
+        return events;
+    }
+}
+
+TEST_CASE("trace records from several threads and exports Chrome JSON", "[trace]")
+{
+    if (!ytl::trace::compiled)
+        SKIP("tracing is compiled out");
+
+    constexpr uint64_t THREADS = 4;
+    constexpr uint64_t SPANS = 100;
+    constexpr uint64_t CHURN = 32;
+
+    ytl::trace::clear();
+    ytl::trace::enable();
+
+    // The threads stay alive until all have recorded, so none reuses another's ring
+    std::latch recorded(THREADS);
+    std::vector<std::thread> threads;
+    for (uint64_t t = 0; t < THREADS; ++t)
+    {
+        threads.emplace_back([t, &recorded]
+        {
+            for (uint64_t i = 0; i < SPANS; ++i)
+            {
+                const uint64_t id = t * SPANS + i;
+                ytl::trace::emit(ytl::trace::event::ENQUEUE, ytl::trace::source::JOB, id);
+                ytl::trace::emit(ytl::trace::event::START, ytl::trace::source::JOB, id);
+                ytl::trace::detail::sample(1000 + i);
+                ytl::trace::emit(ytl::trace::event::END, ytl::trace::source::JOB, id);
+            }
+            recorded.arrive_and_wait();
+        });
+    }
+    for (auto &thread: threads)
+        thread.join();
+
+    // Threads that come and go one at a time take over the ring of the last one
+    constexpr uint64_t CHURN_BASE = 1 << 20;
+    for (uint64_t i = 0; i < CHURN; ++i)
+    {
+        std::thread([i]
+        {
+            ytl::trace::emit(ytl::trace::event::START, ytl::trace::source::TASK, CHURN_BASE + i);
+            ytl::trace::emit(ytl::trace::event::END, ytl::trace::source::TASK, CHURN_BASE + i);
+        }).join();
+    }
+    ytl::trace::enable(false);
+
+    const auto events = export_events();
+
+    std::map<uint32_t, int> depth;
+    std::map<std::string, size_t> phases;
+    std::map<uint64_t, std::set<uint32_t> > tids_of;
+    std::set<uint32_t> churn_tids;
+    bool balanced = true;
+    for (const auto &e: events)
+    {
+        phases[e.ph]++;
+        if (e.ph == "B")
+            depth[e.tid]++;
+        if (e.ph == "E")
+            balanced = balanced && --depth[e.tid] >= 0;
+        if (e.id >= CHURN_BASE)
+            churn_tids.insert(e.tid);
+        else
+            tids_of[e.id / SPANS].insert(e.tid);
+    }
+
+    CHECK(balanced);
+    for (const auto &[tid, open]: depth)
+        CHECK(open == 0);
+
+    // Exited threads keep their events for the export
+    CHECK(phases["B"] == THREADS * SPANS + CHURN);
+    CHECK(phases["E"] == THREADS * SPANS + CHURN);
+    CHECK(phases["s"] == THREADS * SPANS);
+    CHECK(phases["f"] == THREADS * SPANS);
+    CHECK(phases["i"] == THREADS * SPANS);
+
+    std::set<uint32_t> thread_tids;
+    for (const auto &[thread, tids]: tids_of)
+    {
+        CHECK(tids.size() == 1);
+        thread_tids.insert(*tids.begin());
+    }
+    CHECK(thread_tids.size() == THREADS);
+    CHECK(churn_tids.size() == 1);
+
+    const auto latency = ytl::trace::queue_latency();
+    CHECK(latency.count == THREADS * SPANS);
+    CHECK(latency.min == 1000);
+    CHECK(latency.max == 1000 + SPANS - 1);
+
+    ytl::trace::clear();
+    CHECK(export_events().empty());
+    CHECK(ytl::trace::queue_latency().count == 0);
+}
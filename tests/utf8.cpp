@@ -0,0 +1,276 @@
+#include <iterator>
+#include <random>
+#include <string>
+
+#include <catch2.hpp>
+
+#include <utf8.h>
+
+#include "simd_level.h"
+
+namespace
+{
+    void encode(std::string &out, const char32_t cp)
+    {
+        if (cp < 0x80)
+            out += static_cast<char>(cp);
+        else if (cp < 0x800)
+        {
+            out += static_cast<char>(0xC0 | cp >> 6);
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+        else if (cp < 0x10000)
+        {
+            out += static_cast<char>(0xE0 | cp >> 12);
+            out += static_cast<char>(0x80 | (cp >> 6 & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+        else
+        {
+            out += static_cast<char>(0xF0 | cp >> 18);
+            out += static_cast<char>(0x80 | (cp >> 12 & 0x3F));
+            out += static_cast<char>(0x80 | (cp >> 6 & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+    }
+
+    /**
+     * @brief Decode well formed UTF-8 after Unicode table 3-7
+     * @return Offset of the first ill formed sequence, or the length
+     */
+    size_t reference_decode(const std::string &s, std::u32string &out)
+    {
+        const auto byte = [&](const size_t i) { return static_cast<unsigned char>(s[i]); };
+        size_t i = 0;
+        while (i < s.size())
+        {
+            const unsigned char b = byte(i);
+            size_t n;
+            unsigned char lo = 0x80;
+            unsigned char hi = 0xBF;
+            if (b < 0x80)
+            {
+                out += b;
+                i++;
+                continue;
+            }
+            if (b >= 0xC2 && b <= 0xDF)
+                n = 1;
+            else if (b >= 0xE0 && b <= 0xEF)
+            {
+                n = 2;
+                lo = b == 0xE0 ? 0xA0 : 0x80;
+                hi = b == 0xED ? 0x9F : 0xBF;
+            }
+            else if (b >= 0xF0 && b <= 0xF4)
+            {
+                n = 3;
+                lo = b == 0xF0 ? 0x90 : 0x80;
+                hi = b == 0xF4 ? 0x8F : 0xBF;
+            }
+            else
+                return i;
+
+            if (i + n >= s.size())
+                return i;
+            if (byte(i + 1) < lo || byte(i + 1) > hi)
+                return i;
+            char32_t cp = b & (0x3F >> n);
+            cp = cp << 6 | (byte(i + 1) & 0x3F);
+            for (size_t k = 2; k <= n; ++k)
+            {
+                if ((byte(i + k) & 0xC0) != 0x80)
+                    return i;
+                cp = cp << 6 | (byte(i + k) & 0x3F);
+            }
+            out += cp;
+            i += n + 1;
+        }
+        return i;
+    }
+
+    /**
+     * @brief Mostly valid text around the encoding boundaries, now and then broken
+     */
+    std::string random_utf8(std::mt19937_64 &rng, const bool valid)
+    {
+        constexpr char32_t EDGES[] = { 0, 0x7F, 0x80, 0x7FF, 0x800, 0xD7FF, 0xE000, 0xFFFD, 0xFFFF,
+                                       0x10000, 0x10FFFF };
+        std::string s;
+        for (size_t count = rng() % 120; count; --count)
+        {
+            switch (rng() % 6)
+            {
+                case 0:
+                case 1:
+                    // ASCII runs long enough for the vector fast paths
+                    s.append(1 + rng() % 40, static_cast<char>('a' + rng() % 26));
+                    break;
+                case 2:
+                    encode(s, EDGES[rng() % std::size(EDGES)]);
+                    break;
+                case 3:
+                    encode(s, static_cast<char32_t>(0x80 + rng() % 0x780));
+                    break;
+                case 4:
+                {
+                    const auto cp = static_cast<char32_t>(0x800 + rng() % (0x110000 - 0x800));
+                    encode(s, cp >= 0xD800 && cp < 0xE000 ? cp + 0x800 : cp);
+                    break;
+                }
+                default:
+                    if (!valid)
+                    {
+                        // Stray continuation, truncated lead, overlong, surrogate or out of range
+                        constexpr const char *BROKEN[] = { "\x80", "\xBF", "\xC2", "\xE2\x82", "\xF0\x9F\x98",
+                                                           "\xC0\x80", "\xE0\x80\x80", "\xED\xA0\x80",
+                                                           "\xF4\x90\x80\x80", "\xF5", "\xFF" };
+                        s += BROKEN[rng() % std::size(BROKEN)];
+                    }
+                    break;
+            }
+        }
+        return s;
+    }
+
+    std::u16string to_utf16(const std::u32string &cps)
+    {
+        std::u16string out;
+        for (const char32_t cp: cps)
+        {
+            if (cp < 0x10000)
+                out += static_cast<char16_t>(cp);
+            else
+            {
+                out += static_cast<char16_t>(0xD800 + ((cp - 0x10000) >> 10));
+                out += static_cast<char16_t>(0xDC00 + ((cp - 0x10000) & 0x3FF));
+            }
+        }
+        return out;
+    }
+}
+
+TEST_CASE("utf8 validation and counting agree with a scalar decoder", "[utf8]")
+{
+    const ytl::simd_level level = GENERATE(from_range(simd_levels()));
+    CAPTURE(level);
+    const simd_scope scope(level);
+
+    std::mt19937_64 rng(15);
+    for (size_t round = 0; round < 4000; ++round)
+    {
+        const std::string s = random_utf8(rng, round % 2);
+        std::u32string cps;
+        const size_t invalid = reference_decode(s, cps);
+        const bool valid = invalid == s.size();
+
+        CAPTURE(s);
+        REQUIRE(ytl::validate_utf8(s.data(), s.size()) == valid);
+        REQUIRE(ytl::find_invalid_utf8(s.data(), s.size()) == s.data() + invalid);
+        if (!valid)
+            continue;
+
+        const std::u16string units = to_utf16(cps);
+        REQUIRE(ytl::count_utf8(s.data(), s.size()) == cps.size());
+        REQUIRE(ytl::utf16_length(s.data(), s.size()) == units.size());
+        REQUIRE(ytl::utf8_length(units.data(), units.size()) == s.size());
+        REQUIRE(ytl::utf8_length(cps.data(), cps.size()) == s.size());
+    }
+}
+
+TEST_CASE("utf8 transcoding round trips and reports where it stopped", "[utf8]")
+{
+    const ytl::simd_level level = GENERATE(from_range(simd_levels()));
+    CAPTURE(level);
+    const simd_scope scope(level);
+
+    std::mt19937_64 rng(16);
+    for (size_t round = 0; round < 3000; ++round)
+    {
+        const std::string s = random_utf8(rng, round % 2);
+        std::u32string cps;
+        const size_t invalid = reference_decode(s, cps);
+        const std::u16string units = to_utf16(cps);
+        CAPTURE(s);
+
+        std::u16string utf16(units.size() + 8, u'\0');
+        auto r = ytl::utf8_to_utf16(s.data(), s.size(), utf16.data(), utf16.size());
+        REQUIRE(r.read == invalid);
+        REQUIRE(r.written == units.size());
+        REQUIRE(r.ec == (invalid == s.size() ? std::errc {} : std::errc::illegal_byte_sequence));
+        REQUIRE(utf16.compare(0, units.size(), units) == 0);
+
+        std::u32string utf32(cps.size() + 8, U'\0');
+        r = ytl::utf8_to_utf32(s.data(), s.size(), utf32.data(), utf32.size());
+        REQUIRE(r.read == invalid);
+        REQUIRE(r.written == cps.size());
+        REQUIRE(utf32.compare(0, cps.size(), cps) == 0);
+
+        // Back to the valid prefix
+        std::string back(invalid + 8, '\0');
+        r = ytl::utf16_to_utf8(units.data(), units.size(), back.data(), back.size());
+        REQUIRE(r.ec == std::errc {});
+        REQUIRE(back.substr(0, r.written) == s.substr(0, invalid));
+        r = ytl::utf32_to_utf8(cps.data(), cps.size(), back.data(), back.size());
+        REQUIRE(r.ec == std::errc {});
+        REQUIRE(back.substr(0, r.written) == s.substr(0, invalid));
+
+        // A short destination stops before the first code point that does not fit
+        if (units.empty())
+            continue;
+        const size_t capacity = rng() % units.size();
+        size_t fits = 0;
+        size_t read = 0;
+        for (const char32_t cp: cps)
+        {
+            const size_t need = cp < 0x10000 ? 1 : 2;
+            if (fits + need > capacity)
+                break;
+            fits += need;
+            std::string one;
+            encode(one, cp);
+            read += one.size();
+        }
+        r = ytl::utf8_to_utf16(s.data(), s.size(), utf16.data(), capacity);
+        REQUIRE(r.ec == std::errc::value_too_large);
+        REQUIRE(r.read == read);
+        REQUIRE(r.written == fits);
+    }
+}
+
+TEST_CASE("utf16 and utf32 input is validated", "[utf8]")
+{
+    char out[16];
+    const char16_t lone_high[] = { u'a', 0xD800, u'b' };
+    auto r = ytl::utf16_to_utf8(lone_high, 3, out, sizeof(out));
+    CHECK(r.ec == std::errc::illegal_byte_sequence);
+    CHECK(r.read == 1);
+    CHECK(r.written == 1);
+
+    const char16_t lone_low[] = { 0xDC00 };
+    r = ytl::utf16_to_utf8(lone_low, 1, out, sizeof(out));
+    CHECK(r.ec == std::errc::illegal_byte_sequence);
+    CHECK(r.read == 0);
+
+    const char16_t cut_pair[] = { u'x', 0xD83D };
+    r = ytl::utf16_to_utf8(cut_pair, 2, out, sizeof(out));
+    CHECK(r.ec == std::errc::illegal_byte_sequence);
+    CHECK(r.read == 1);
+
+    const char32_t bad[] = { U'a', 0x110000 };
+    r = ytl::utf32_to_utf8(bad, 2, out, sizeof(out));
+    CHECK(r.ec == std::errc::illegal_byte_sequence);
+    CHECK(r.read == 1);
+
+    const char32_t surrogate[] = { 0xDFFF };
+    r = ytl::utf32_to_utf8(surrogate, 1, out, sizeof(out));
+    CHECK(r.ec == std::errc::illegal_byte_sequence);
+    CHECK(r.read == 0);
+
+    // The 4 byte form does not fit in 3 bytes and nothing is split
+    const char32_t emoji[] = { U'a', 0x1F600 };
+    r = ytl::utf32_to_utf8(emoji, 2, out, 4);
+    CHECK(r.ec == std::errc::value_too_large);
+    CHECK(r.read == 1);
+    CHECK(r.written == 1);
+}